@@ -0,0 +1,243 @@
+#ifndef LIB_ANALYSIS_LOOPCARRIEDANALYSIS_LOOPCARRIEDANALYSIS_H_
+#define LIB_ANALYSIS_LOOPCARRIEDANALYSIS_LOOPCARRIEDANALYSIS_H_
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <type_traits>
+#include <utility>
+
+#include "llvm/include/llvm/ADT/STLExtras.h"    // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlow/SparseAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Affine/Analysis/LoopAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Region.h"     // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"      // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+
+/// A lattice whose state can be pinned on the iter_args of an affine.for.
+///
+/// A pinned iter_arg ignores the values yielded for it by the loop body, so
+/// that analyses whose states grow in every iteration (noise,
+/// multiplicative depth) still reach a fixed point. The state of the iter_arg
+/// is then set from outside the solver, see solveWithLoopCarriedStates.
+template <typename ValueT>
+class LoopCarriedLattice : public dataflow::Lattice<ValueT> {
+ public:
+  using dataflow::Lattice<ValueT>::Lattice;
+  using dataflow::Lattice<ValueT>::join;
+
+  ChangeResult join(const dataflow::AbstractSparseLattice &rhs) override {
+    if (pinned && isBackEdge(rhs)) return ChangeResult::NoChange;
+    return dataflow::Lattice<ValueT>::join(rhs);
+  }
+
+  /// Joins `value` into the state, and ignores the yielded values from now on.
+  ChangeResult pin(const ValueT &value) {
+    pinned = true;
+    return join(value);
+  }
+
+ private:
+  // The values yielded for an iter_arg are defined in the loop body, while
+  // the init value is defined outside of it.
+  bool isBackEdge(const dataflow::AbstractSparseLattice &rhs) const {
+    auto arg = dyn_cast<BlockArgument>(this->getAnchor());
+    return arg &&
+           arg.getOwner()->getParent()->isAncestor(
+               rhs.getAnchor().getParentRegion());
+  }
+
+  bool pinned = false;
+};
+
+/// The maximal number of times the estimates of a loop are grown one iteration
+/// at a time, which is needed when they do not grow by a constant step.
+constexpr int64_t kMaxLoopCarriedRounds = 64;
+
+/// Runs a solver, with the analyses loaded by `loadAnalyses`, on `top` without
+/// unrolling its loops. LatticeT must be a LoopCarriedLattice, and its value
+/// type must provide `static ValueT extrapolate(from, to, iterations)`, which
+/// bounds the state after `iterations` more iterations of a loop taking a
+/// state from `from` to `to` in one.
+///
+/// The solver runs in rounds. In each round, the iter_args of every loop are
+/// pinned to an estimate, so each loop body is analysed once. A loop first
+/// grows its estimates by one iteration, as the first iteration often grows
+/// them the most (e.g., from a plaintext init value). It then measures the
+/// growth of one more iteration, and extrapolates it over the remaining
+/// iterations of its constant trip count. The next round checks that the
+/// extrapolated estimates grow by no more than one step; otherwise, the loop
+/// falls back to growing its estimates one iteration at a time. A loop whose
+/// estimates reach a fixed point is done early, which is the only way for a
+/// loop without a constant trip count to be done. The estimates of a loop
+/// only change once the loops nested in it are done, and changing them
+/// restarts the nested loops, as these run again in the next iteration. The
+/// states in the loop body and the loop results then bound those of every
+/// iteration, and the number of rounds does not depend on the trip counts.
+///
+/// Returns the solver of the last round, in which no estimate changed.
+template <typename LatticeT>
+FailureOr<std::unique_ptr<DataFlowSolver>> solveWithLoopCarriedStates(
+    Operation *top, function_ref<void(DataFlowSolver &)> loadAnalyses) {
+  using ValueT =
+      std::decay_t<decltype(std::declval<const LatticeT &>().getValue())>;
+
+  struct LoopState {
+    affine::AffineForOp forOp;
+    std::optional<uint64_t> tripCount;
+    // The init values the estimates were computed for.
+    SmallVector<ValueT> inits;
+    // The estimates the iter_args are pinned to.
+    SmallVector<ValueT> estimates;
+    // The number of iterations covered by the estimates, when they were grown
+    // one iteration at a time.
+    int64_t steps = 0;
+    // The states of the iter_args and the values yielded for them, when the
+    // growth was measured. Empty if the estimates are not extrapolated.
+    SmallVector<ValueT> base;
+    SmallVector<ValueT> next;
+    // Whether extrapolating the growth failed, so the estimates only grow one
+    // iteration at a time.
+    bool exact = false;
+
+    void restart() {
+      estimates.assign(estimates.size(), ValueT());
+      steps = 0;
+      base.clear();
+      next.clear();
+      exact = false;
+    }
+  };
+  SmallVector<LoopState> loops;
+  top->walk([&](affine::AffineForOp forOp) {
+    LoopState &loop = loops.emplace_back();
+    loop.forOp = forOp;
+    loop.tripCount = affine::getConstantTripCount(forOp);
+    loop.estimates.resize(forOp.getNumRegionIterArgs());
+  });
+
+  auto covers = [](const ValueT &lhs, const ValueT &rhs) {
+    return ValueT::join(lhs, rhs) == lhs;
+  };
+
+  while (true) {
+    auto solver = std::make_unique<DataFlowSolver>();
+    loadAnalyses(*solver);
+    for (LoopState &loop : loops) {
+      for (auto [arg, estimate] :
+           llvm::zip(loop.forOp.getRegionIterArgs(), loop.estimates)) {
+        (void)solver->template getOrCreateState<LatticeT>(arg)->pin(estimate);
+      }
+    }
+    if (failed(solver->initializeAndRun(top))) return failure();
+
+    auto lookup = [&](ValueRange values) {
+      SmallVector<ValueT> result;
+      for (Value value : values) {
+        const auto *lattice = solver->template lookupState<LatticeT>(value);
+        result.push_back(lattice ? lattice->getValue() : ValueT());
+      }
+      return result;
+    };
+
+    // The walk is in post-order, so nested loops come first.
+    SmallVector<Operation *> changedLoops;
+    for (LoopState &loop : loops) {
+      Operation *forOp = loop.forOp;
+      if (llvm::any_of(changedLoops, [&](Operation *other) {
+            return forOp->isProperAncestor(other);
+          }))
+        continue;
+
+      SmallVector<ValueT> inits = lookup(loop.forOp.getInits());
+      SmallVector<ValueT> states = lookup(loop.forOp.getRegionIterArgs());
+      SmallVector<ValueT> yielded = lookup(loop.forOp.getYieldedValues());
+      std::optional<int64_t> remaining;
+      if (loop.tripCount.has_value())
+        remaining = static_cast<int64_t>(*loop.tripCount) - 1 - loop.steps;
+
+      auto change = [&](SmallVector<ValueT> estimates) {
+        loop.estimates = std::move(estimates);
+        changedLoops.push_back(forOp);
+        for (LoopState &nested : loops) {
+          if (forOp->isProperAncestor(nested.forOp)) nested.restart();
+        }
+      };
+
+      // The estimates no longer hold when the init values change, e.g. when
+      // an enclosing loop grew its estimates. Unless they were not grown yet,
+      // the loop restarts in the next round.
+      if (inits != loop.inits) {
+        bool grown = loop.steps != 0 || !loop.base.empty();
+        loop.restart();
+        loop.inits = inits;
+        if (grown) {
+          change(loop.estimates);
+          continue;
+        }
+      }
+
+      if (!loop.base.empty()) {
+        bool withinOneStep = true;
+        for (auto [base, next, value] :
+             llvm::zip(loop.base, loop.next, yielded)) {
+          withinOneStep &=
+              covers(ValueT::extrapolate(base, next, *remaining + 1), value);
+        }
+        if (withinOneStep) continue;
+        // Go back to the estimates from which the growth was measured.
+        SmallVector<ValueT> estimates = std::move(loop.base);
+        loop.base.clear();
+        loop.next.clear();
+        loop.exact = true;
+        change(std::move(estimates));
+        continue;
+      }
+
+      if (llvm::all_of(llvm::zip(states, yielded), [&](auto pair) {
+            return covers(std::get<0>(pair), std::get<1>(pair));
+          }))
+        continue;
+      if (remaining.has_value() && *remaining <= 0) continue;
+
+      if (remaining.has_value() && loop.steps != 0 && !loop.exact) {
+        SmallVector<ValueT> estimates;
+        for (auto [state, value] : llvm::zip(states, yielded))
+          estimates.push_back(ValueT::extrapolate(state, value, *remaining));
+        loop.base = states;
+        loop.next = yielded;
+        change(std::move(estimates));
+        continue;
+      }
+
+      if (loop.steps >= kMaxLoopCarriedRounds) {
+        if (!remaining.has_value()) {
+          return loop.forOp.emitOpError()
+                 << "carries values that do not reach a fixed point, and has "
+                    "no constant trip count";
+        }
+        return loop.forOp.emitOpError()
+               << "carries values whose growth in one iteration cannot be "
+                  "extrapolated over its trip count";
+      }
+      SmallVector<ValueT> estimates;
+      for (auto [state, value] : llvm::zip(states, yielded))
+        estimates.push_back(ValueT::join(state, value));
+      ++loop.steps;
+      change(std::move(estimates));
+    }
+    if (changedLoops.empty()) return solver;
+  }
+}
+
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_ANALYSIS_LOOPCARRIEDANALYSIS_LOOPCARRIEDANALYSIS_H_
@@ -37,6 +37,11 @@ LogicalResult MulDepthAnalysis::visitOperation(
           propagate(blockArg, MulDepthState(0));
         }
       })
+      .Case<mgmt::BootstrapOp>([&](auto bootstrapOp) {
+        // bootstrap yields a fresh ciphertext, as for the level in
+        // LevelAnalysis
+        propagate(bootstrapOp.getResult(), MulDepthState(0));
+      })
       .Default([&](auto &op) {
         // condition on result secretness
         SmallVector<OpResult> secretDepths;
@@ -2,8 +2,10 @@
 #define LIB_ANALYSIS_MULDEPTHANALYSIS_MULDEPTHANALYSIS_H_
 
 #include <cassert>
+#include <cstdint>
 #include <optional>
 
+#include "lib/Analysis/LoopCarriedAnalysis/LoopCarriedAnalysis.h"
 #include "lib/Analysis/SecretnessAnalysis/SecretnessAnalysis.h"
 #include "llvm/include/llvm/Support/raw_ostream.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlow/SparseAnalysis.h"  // from @llvm-project
@@ -48,6 +50,17 @@ class MulDepthState {
     return MulDepthState{std::max(lhs.getMulDepth(), rhs.getMulDepth())};
   }
 
+  // The depth grows by the same amount in every iteration of a loop, at most.
+  static MulDepthState extrapolate(const MulDepthState &from,
+                                   const MulDepthState &to,
+                                   int64_t iterations) {
+    if (!from.isInitialized() || !to.isInitialized() ||
+        to.getMulDepth() <= from.getMulDepth())
+      return join(from, to);
+    return MulDepthState{from.getMulDepth() +
+                         iterations * (to.getMulDepth() - from.getMulDepth())};
+  }
+
   void print(llvm::raw_ostream &os) const {
     if (isInitialized()) {
       os << "MulDepthState(" << mulDepth.value() << ")";
@@ -66,9 +79,9 @@ class MulDepthState {
   std::optional<int64_t> mulDepth;
 };
 
-class MulDepthLattice : public dataflow::Lattice<MulDepthState> {
+class MulDepthLattice : public LoopCarriedLattice<MulDepthState> {
  public:
-  using Lattice::Lattice;
+  using LoopCarriedLattice::LoopCarriedLattice;
 };
 
 class MulDepthAnalysis
@@ -3,6 +3,8 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <optional>
 #include <string>
 
@@ -75,6 +77,18 @@ class NoiseState {
     return NoiseState::of(std::max(lhs.getValue(), rhs.getValue()));
   }
 
+  // Noise grows by a factor in each iteration of a loop, and the factor does
+  // not grow as the noise does, e.g. when multiplying by a fresh ciphertext.
+  static NoiseState extrapolate(const NoiseState &from, const NoiseState &to,
+                                int64_t iterations) {
+    if (!from.isKnown() || !to.isKnown() || from.getValue() <= 0.0 ||
+        to.getValue() <= from.getValue())
+      return join(from, to);
+    return NoiseState::of(from.getValue() *
+                          std::pow(to.getValue() / from.getValue(),
+                                   static_cast<double>(iterations)));
+  }
+
   void print(llvm::raw_ostream &os) const { os << value; }
 
   std::string toString() const;
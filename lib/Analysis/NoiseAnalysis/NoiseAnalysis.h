@@ -1,6 +1,7 @@
 #ifndef INCLUDE_ANALYSIS_NOISEANALYSIS_NOISEANALYSIS_H_
 #define INCLUDE_ANALYSIS_NOISEANALYSIS_NOISEANALYSIS_H_
 
+#include "lib/Analysis/LoopCarriedAnalysis/LoopCarriedAnalysis.h"
 #include "lib/Analysis/SecretnessAnalysis/SecretnessAnalysis.h"
 #include "mlir/include/mlir/Analysis/DataFlow/SparseAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
@@ -13,9 +14,9 @@ namespace heir {
 
 /// This lattice element represents the noise data of an SSA value.
 template <typename NoiseState>
-class NoiseLattice : public dataflow::Lattice<NoiseState> {
+class NoiseLattice : public LoopCarriedLattice<NoiseState> {
  public:
-  using dataflow::Lattice<NoiseState>::Lattice;
+  using LoopCarriedLattice<NoiseState>::LoopCarriedLattice;
 };
 
 /// This analysis template takes a noise model as argument and computes the
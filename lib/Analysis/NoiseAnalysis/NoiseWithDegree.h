@@ -3,6 +3,8 @@
 
 #include <algorithm>
 #include <cassert>
+#include <cmath>
+#include <cstdint>
 #include <optional>
 #include <string>
 
@@ -69,6 +71,26 @@ class NoiseWithDegree {
                                std::max(lhs.getDegree(), rhs.getDegree()));
   }
 
+  // Over the iterations of a loop, the noise is scaled by the same factor and
+  // the degree increased by the same amount, at most.
+  static NoiseWithDegree extrapolate(const NoiseWithDegree &from,
+                                     const NoiseWithDegree &to,
+                                     int64_t iterations) {
+    if (!from.isKnown() || !to.isKnown()) return join(from, to);
+    double value = std::max(from.getValue(), to.getValue());
+    if (from.getValue() > 0.0 && to.getValue() > from.getValue()) {
+      value = from.getValue() * std::pow(to.getValue() / from.getValue(),
+                                         static_cast<double>(iterations));
+    }
+    int degree = std::max(from.getDegree(), to.getDegree());
+    if (to.getDegree() > from.getDegree()) {
+      degree = from.getDegree() +
+               static_cast<int>(iterations) *
+                   (to.getDegree() - from.getDegree());
+    }
+    return NoiseWithDegree::of(value, degree);
+  }
+
   void print(llvm::raw_ostream &os) const { os << value; }
 
   std::string toString() const;
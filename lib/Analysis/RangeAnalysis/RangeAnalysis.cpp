@@ -0,0 +1,395 @@
+#include "lib/Analysis/RangeAnalysis/RangeAnalysis.h"
+
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <optional>
+
+#include "lib/Dialect/Secret/IR/SecretDialect.h"
+#include "lib/Dialect/Secret/IR/SecretOps.h"
+#include "lib/Dialect/TensorExt/IR/TensorExtOps.h"
+#include "lib/Utils/AttributeUtils.h"
+#include "llvm/include/llvm/ADT/SmallVector.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/TypeSwitch.h"              // from @llvm-project
+#include "llvm/include/llvm/Support/Debug.h"               // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"      // from @llvm-project
+#include "mlir/include/mlir/Dialect/Math/IR/Math.h"        // from @llvm-project
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"    // from @llvm-project
+#include "mlir/include/mlir/IR/Attributes.h"               // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinAttributes.h"        // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"                // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                    // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"                // from @llvm-project
+
+#define DEBUG_TYPE "RangeAnalysis"
+
+namespace mlir {
+namespace heir {
+
+namespace {
+
+// When we move to C++20, we can use std::numbers::pi
+inline constexpr double kPi = 3.14159265358979323846;
+inline constexpr double kInf = std::numeric_limits<double>::infinity();
+
+// Parse either a `range.bounds` annotation or a traced execution result, both
+// of which are array attributes of numbers, into the range they span.
+std::optional<RangeState> getRangeFromArrayAttr(Attribute attr) {
+  auto arrayAttr = dyn_cast_or_null<ArrayAttr>(attr);
+  if (!arrayAttr || arrayAttr.empty()) return std::nullopt;
+
+  SmallVector<double> values;
+  for (Attribute element : arrayAttr) {
+    if (auto floatAttr = dyn_cast<FloatAttr>(element)) {
+      values.push_back(floatAttr.getValueAsDouble());
+    } else if (auto intAttr = dyn_cast<IntegerAttr>(element)) {
+      values.push_back(static_cast<double>(intAttr.getInt()));
+    } else {
+      return std::nullopt;
+    }
+  }
+  return RangeState::hull(values);
+}
+
+std::optional<RangeState> getAnnotatedRange(BlockArgument blockArg) {
+  StringRef traceAttrName = secret::SecretDialect::kArgExecutionResultAttrName;
+  for (StringRef attrName : {kArgRangeAttrName, traceAttrName}) {
+    if (auto range = getRangeFromArrayAttr(
+            findAttributeForBlockArgument(blockArg, attrName))) {
+      return range;
+    }
+  }
+
+  // A secret.generic block argument inherits the annotation of the value
+  // passed to it, typically a function argument.
+  if (auto genericOp =
+          dyn_cast<secret::GenericOp>(blockArg.getOwner()->getParentOp())) {
+    Value operand = genericOp.getOperand(blockArg.getArgNumber());
+    if (auto operandArg = dyn_cast<BlockArgument>(operand)) {
+      return getAnnotatedRange(operandArg);
+    }
+  }
+  return std::nullopt;
+}
+
+std::optional<RangeState> getConstantRange(Attribute attr) {
+  auto toDouble = [](const APInt &value) {
+    // i1 true is 1, not -1.
+    return value.getBitWidth() == 1 ? static_cast<double>(value.getZExtValue())
+                                    : static_cast<double>(value.getSExtValue());
+  };
+
+  if (auto floatAttr = dyn_cast<FloatAttr>(attr)) {
+    return RangeState::hull({floatAttr.getValueAsDouble()});
+  }
+  if (auto intAttr = dyn_cast<IntegerAttr>(attr)) {
+    return RangeState::hull({toDouble(intAttr.getValue())});
+  }
+  auto denseAttr = dyn_cast<DenseElementsAttr>(attr);
+  if (!denseAttr) return std::nullopt;
+
+  SmallVector<double> values;
+  if (isa<FloatType>(denseAttr.getElementType())) {
+    for (const APFloat &value : denseAttr.getValues<APFloat>())
+      values.push_back(value.convertToDouble());
+  } else if (isa<IntegerType>(denseAttr.getElementType())) {
+    for (const APInt &value : denseAttr.getValues<APInt>())
+      values.push_back(toDouble(value));
+  } else {
+    return std::nullopt;
+  }
+  return RangeState::hull(values);
+}
+
+RangeState add(const RangeState &lhs, const RangeState &rhs) {
+  return RangeState::hull({lhs.getLower() + rhs.getLower(),
+                           lhs.getUpper() + rhs.getUpper()});
+}
+
+RangeState sub(const RangeState &lhs, const RangeState &rhs) {
+  return RangeState::hull({lhs.getLower() - rhs.getUpper(),
+                           lhs.getUpper() - rhs.getLower()});
+}
+
+RangeState mul(const RangeState &lhs, const RangeState &rhs) {
+  return RangeState::hull(
+      {lhs.getLower() * rhs.getLower(), lhs.getLower() * rhs.getUpper(),
+       lhs.getUpper() * rhs.getLower(), lhs.getUpper() * rhs.getUpper()});
+}
+
+RangeState div(const RangeState &lhs, const RangeState &rhs) {
+  if (rhs.getLower() <= 0.0 && rhs.getUpper() >= 0.0) {
+    return RangeState::unbounded();
+  }
+  return RangeState::hull(
+      {lhs.getLower() / rhs.getLower(), lhs.getLower() / rhs.getUpper(),
+       lhs.getUpper() / rhs.getLower(), lhs.getUpper() / rhs.getUpper()});
+}
+
+// The range of a function that is monotone on its domain [domainLower,
+// domainUpper]. Inputs leaving the domain produce an unbounded range.
+RangeState monotone(const std::function<double(double)> &func,
+                    const RangeState &input,
+                    double domainLower = -kInf, double domainUpper = kInf) {
+  if (input.getLower() < domainLower || input.getUpper() > domainUpper) {
+    return RangeState::unbounded();
+  }
+  return RangeState::hull({func(input.getLower()), func(input.getUpper())});
+}
+
+// The range of a function whose local extrema lie at `offset + k * period` for
+// integer k, such as sin and cos.
+RangeState periodic(const std::function<double(double)> &func,
+                    const RangeState &input, double offset, double period) {
+  if (!input.isBounded()) return RangeState::hull({-1.0, 1.0});
+
+  SmallVector<double> values = {func(input.getLower()),
+                                func(input.getUpper())};
+  double k = std::ceil((input.getLower() - offset) / period);
+  for (double x = offset + k * period; x <= input.getUpper(); x += period) {
+    values.push_back(func(x));
+    // Every extremum has been seen once a full period is covered.
+    if (values.size() > 4) break;
+  }
+  return RangeState::hull(values);
+}
+
+// Functions with a single extremum at zero, like abs and cosh.
+RangeState evenAboutZero(const std::function<double(double)> &func,
+                         const RangeState &input) {
+  SmallVector<double> values = {func(input.getLower()),
+                                func(input.getUpper())};
+  if (input.getLower() <= 0.0 && input.getUpper() >= 0.0) {
+    values.push_back(func(0.0));
+  }
+  return RangeState::hull(values);
+}
+
+std::optional<RangeState> visitUnaryMathOp(Operation *op,
+                                           const RangeState &input) {
+  return llvm::TypeSwitch<Operation *, std::optional<RangeState>>(op)
+      .Case<math::AbsFOp>([&](auto) {
+        return evenAboutZero([](double x) { return std::abs(x); }, input);
+      })
+      .Case<math::CoshOp>([&](auto) {
+        return evenAboutZero([](double x) { return std::cosh(x); }, input);
+      })
+      .Case<math::SinOp>([&](auto) {
+        return periodic([](double x) { return std::sin(x); }, input, kPi / 2,
+                        kPi);
+      })
+      .Case<math::CosOp>([&](auto) {
+        return periodic([](double x) { return std::cos(x); }, input, 0.0, kPi);
+      })
+      .Case<math::ExpOp>([&](auto) {
+        return monotone([](double x) { return std::exp(x); }, input);
+      })
+      .Case<math::Exp2Op>([&](auto) {
+        return monotone([](double x) { return std::exp2(x); }, input);
+      })
+      .Case<math::ExpM1Op>([&](auto) {
+        return monotone([](double x) { return std::expm1(x); }, input);
+      })
+      .Case<math::LogOp>([&](auto) {
+        return monotone([](double x) { return std::log(x); }, input, 0.0);
+      })
+      .Case<math::Log2Op>([&](auto) {
+        return monotone([](double x) { return std::log2(x); }, input, 0.0);
+      })
+      .Case<math::Log10Op>([&](auto) {
+        return monotone([](double x) { return std::log10(x); }, input, 0.0);
+      })
+      .Case<math::Log1pOp>([&](auto) {
+        return monotone([](double x) { return std::log1p(x); }, input, -1.0);
+      })
+      .Case<math::SqrtOp>([&](auto) {
+        return monotone([](double x) { return std::sqrt(x); }, input, 0.0);
+      })
+      .Case<math::RsqrtOp>([&](auto) {
+        return monotone([](double x) { return 1.0 / std::sqrt(x); }, input,
+                        std::numeric_limits<double>::min());
+      })
+      .Case<math::CbrtOp>([&](auto) {
+        return monotone([](double x) { return std::cbrt(x); }, input);
+      })
+      .Case<math::TanhOp>([&](auto) {
+        return monotone([](double x) { return std::tanh(x); }, input);
+      })
+      .Case<math::SinhOp>([&](auto) {
+        return monotone([](double x) { return std::sinh(x); }, input);
+      })
+      .Case<math::AtanOp>([&](auto) {
+        return monotone([](double x) { return std::atan(x); }, input);
+      })
+      .Case<math::AsinhOp>([&](auto) {
+        return monotone([](double x) { return std::asinh(x); }, input);
+      })
+      .Case<math::AsinOp>([&](auto) {
+        return monotone([](double x) { return std::asin(x); }, input, -1.0,
+                        1.0);
+      })
+      .Case<math::AcosOp>([&](auto) {
+        return monotone([](double x) { return std::acos(x); }, input, -1.0,
+                        1.0);
+      })
+      .Case<math::ErfOp>([&](auto) {
+        return monotone([](double x) { return std::erf(x); }, input);
+      })
+      .Case<math::ErfcOp>([&](auto) {
+        return monotone([](double x) { return std::erfc(x); }, input);
+      })
+      .Case<math::FloorOp>([&](auto) {
+        return monotone([](double x) { return std::floor(x); }, input);
+      })
+      .Case<math::CeilOp>([&](auto) {
+        return monotone([](double x) { return std::ceil(x); }, input);
+      })
+      .Case<math::RoundOp>([&](auto) {
+        return monotone([](double x) { return std::round(x); }, input);
+      })
+      .Case<math::TruncOp>([&](auto) {
+        return monotone([](double x) { return std::trunc(x); }, input);
+      })
+      .Default([](Operation *) { return std::nullopt; });
+}
+
+}  // namespace
+
+//===----------------------------------------------------------------------===//
+// RangeLattice
+//===----------------------------------------------------------------------===//
+
+ChangeResult RangeLattice::join(const RangeState &rhs) {
+  RangeState joined = RangeState::join(getValue(), rhs);
+  if (joined == getValue()) return ChangeResult::NoChange;
+
+  // Ranges around a loop may grow in every iteration, e.g. for x += 1.0.
+  if (getValue().isInitialized() && ++numUpdates > kRangeWideningThreshold) {
+    joined = RangeState::widen(getValue(), joined);
+  }
+  getValue() = joined;
+  return ChangeResult::Change;
+}
+
+//===----------------------------------------------------------------------===//
+// RangeAnalysis (Forward)
+//===----------------------------------------------------------------------===//
+
+void RangeAnalysis::setToEntryState(RangeLattice *lattice) {
+  RangeState state = RangeState::unbounded();
+  if (auto blockArg = dyn_cast<BlockArgument>(lattice->getAnchor())) {
+    if (auto annotated = getAnnotatedRange(blockArg)) {
+      state = annotated.value();
+    }
+  }
+  propagateIfChanged(lattice, lattice->join(state));
+}
+
+LogicalResult RangeAnalysis::visitOperation(
+    Operation *op, ArrayRef<const RangeLattice *> operands,
+    ArrayRef<RangeLattice *> results) {
+  auto propagate = [&](RangeLattice *lattice, const RangeState &state) {
+    ChangeResult changed = lattice->join(state);
+    propagateIfChanged(lattice, changed);
+  };
+
+  if (results.empty()) return success();
+
+  // Wait until every operand has been visited.
+  SmallVector<RangeState> inputs;
+  for (const RangeLattice *operand : operands) {
+    if (!operand->getValue().isInitialized()) return success();
+    inputs.push_back(operand->getValue());
+  }
+
+  auto hullOf = [&](ArrayRef<RangeState> states) {
+    RangeState result;
+    for (const RangeState &state : states) {
+      result = RangeState::join(result, state);
+    }
+    return result;
+  };
+
+  std::optional<RangeState> computed =
+      llvm::TypeSwitch<Operation *, std::optional<RangeState>>(op)
+          .Case<arith::ConstantOp>([&](auto constantOp) {
+            return getConstantRange(constantOp.getValue());
+          })
+          .Case<arith::AddFOp, arith::AddIOp>(
+              [&](auto) { return add(inputs[0], inputs[1]); })
+          .Case<arith::SubFOp, arith::SubIOp>(
+              [&](auto) { return sub(inputs[0], inputs[1]); })
+          .Case<arith::MulFOp, arith::MulIOp>(
+              [&](auto) { return mul(inputs[0], inputs[1]); })
+          .Case<arith::DivFOp>([&](auto) { return div(inputs[0], inputs[1]); })
+          .Case<arith::NegFOp>([&](auto) {
+            return RangeState(-inputs[0].getUpper(), -inputs[0].getLower());
+          })
+          .Case<arith::MaximumFOp, arith::MaxNumFOp, arith::MaxSIOp>(
+              [&](auto) {
+                return RangeState(
+                    std::max(inputs[0].getLower(), inputs[1].getLower()),
+                    std::max(inputs[0].getUpper(), inputs[1].getUpper()));
+              })
+          .Case<arith::MinimumFOp, arith::MinNumFOp, arith::MinSIOp>(
+              [&](auto) {
+                return RangeState(
+                    std::min(inputs[0].getLower(), inputs[1].getLower()),
+                    std::min(inputs[0].getUpper(), inputs[1].getUpper()));
+              })
+          .Case<arith::SelectOp>(
+              [&](auto) { return hullOf({inputs[1], inputs[2]}); })
+          .Case<arith::ExtFOp, arith::TruncFOp, arith::SIToFPOp,
+                arith::ExtSIOp>([&](auto) { return inputs[0]; })
+          .Case<arith::UIToFPOp, arith::ExtUIOp>(
+              [&](auto) -> std::optional<RangeState> {
+                if (inputs[0].getLower() < 0.0) return std::nullopt;
+                return inputs[0];
+              })
+          // Ops that only move elements around keep the hull of the
+          // elements they may read.
+          .Case<tensor::ExtractOp, tensor::ExtractSliceOp,
+                tensor::ExpandShapeOp, tensor::CollapseShapeOp,
+                tensor::ReshapeOp, tensor::SplatOp, tensor_ext::RotateOp>(
+              [&](auto) { return inputs[0]; })
+          .Case<tensor::InsertOp, tensor::InsertSliceOp>(
+              [&](auto) { return hullOf({inputs[0], inputs[1]}); })
+          .Case<tensor::FromElementsOp, tensor::ConcatOp>(
+              [&](auto) { return hullOf(inputs); })
+          .Default([&](Operation *other) -> std::optional<RangeState> {
+            if (other->getNumOperands() != 1) return std::nullopt;
+            return visitUnaryMathOp(other, inputs[0]);
+          });
+
+  for (RangeLattice *result : results) {
+    if (computed.has_value() && computed->isBounded()) {
+      propagate(result, computed.value());
+      continue;
+    }
+
+    // Fall back to the plaintext execution trace, if one was imported.
+    if (results.size() == 1) {
+      if (auto traced = getRangeFromArrayAttr(op->getAttr(
+              secret::SecretDialect::kArgExecutionResultAttrName))) {
+        propagate(result, traced.value());
+        continue;
+      }
+    }
+    propagate(result, computed.value_or(RangeState::unbounded()));
+  }
+  return success();
+}
+
+//===----------------------------------------------------------------------===//
+// Utils
+//===----------------------------------------------------------------------===//
+
+std::optional<RangeState> getBoundedRange(Value value, DataFlowSolver *solver) {
+  auto *lattice = solver->lookupState<RangeLattice>(value);
+  if (!lattice || !lattice->getValue().isBounded()) return std::nullopt;
+  return lattice->getValue();
+}
+
+}  // namespace heir
+}  // namespace mlir
@@ -0,0 +1,165 @@
+#ifndef LIB_ANALYSIS_RANGEANALYSIS_RANGEANALYSIS_H_
+#define LIB_ANALYSIS_RANGEANALYSIS_RANGEANALYSIS_H_
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <utility>
+
+#include "llvm/include/llvm/Support/raw_ostream.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlow/SparseAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"                // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                    // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"                // from @llvm-project
+
+namespace mlir {
+namespace heir {
+
+// A forward interval analysis over floating point (and small integer) values.
+//
+// Each value is assigned a closed interval [lower, upper] bounding every
+// element it may hold. Intervals are seeded at function and secret.generic
+// arguments from either a `range.bounds = [lower, upper]` annotation or, when
+// a plaintext execution trace was imported via
+// --secret-import-execution-result, from the hull of the traced values.
+// Ops whose semantics the analysis does not model produce an unbounded
+// interval, unless they carry a traced execution result themselves.
+//
+// This analysis is intended to run on secret-arithmetic IR before polynomial
+// approximation, so that non-polynomial ops can be approximated over the
+// tightest domain their inputs actually occupy.
+
+class RangeState {
+ public:
+  RangeState() : range(std::nullopt) {}
+  RangeState(double lower, double upper) : range(std::make_pair(lower, upper)) {
+    assert(lower <= upper && "invalid range");
+  }
+  ~RangeState() = default;
+
+  static RangeState unbounded() {
+    return RangeState(-std::numeric_limits<double>::infinity(),
+                      std::numeric_limits<double>::infinity());
+  }
+
+  // The smallest range containing all the given values, or an unbounded range
+  // if any of them is NaN.
+  static RangeState hull(ArrayRef<double> values) {
+    if (values.empty()) return unbounded();
+    double lower = std::numeric_limits<double>::infinity();
+    double upper = -std::numeric_limits<double>::infinity();
+    for (double value : values) {
+      if (std::isnan(value)) return unbounded();
+      lower = std::min(lower, value);
+      upper = std::max(upper, value);
+    }
+    return RangeState(lower, upper);
+  }
+
+  double getLower() const {
+    assert(isInitialized());
+    return range->first;
+  }
+  double getUpper() const {
+    assert(isInitialized());
+    return range->second;
+  }
+
+  bool operator==(const RangeState &rhs) const { return range == rhs.range; }
+
+  bool isInitialized() const { return range.has_value(); }
+
+  bool isBounded() const {
+    return isInitialized() && std::isfinite(range->first) &&
+           std::isfinite(range->second);
+  }
+
+  static RangeState join(const RangeState &lhs, const RangeState &rhs) {
+    if (!lhs.isInitialized()) return rhs;
+    if (!rhs.isInitialized()) return lhs;
+
+    return RangeState{std::min(lhs.getLower(), rhs.getLower()),
+                      std::max(lhs.getUpper(), rhs.getUpper())};
+  }
+
+  // Widens `lhs` by `rhs`: each bound of `rhs` that lies outside of `lhs` is
+  // moved to infinity, so that a chain of widenings is finite.
+  static RangeState widen(const RangeState &lhs, const RangeState &rhs) {
+    if (!lhs.isInitialized() || !rhs.isInitialized()) return join(lhs, rhs);
+
+    constexpr double inf = std::numeric_limits<double>::infinity();
+    return RangeState{rhs.getLower() < lhs.getLower() ? -inf : lhs.getLower(),
+                      rhs.getUpper() > lhs.getUpper() ? inf : lhs.getUpper()};
+  }
+
+  void print(llvm::raw_ostream &os) const {
+    if (isInitialized()) {
+      os << "RangeState([" << range->first << ", " << range->second << "])";
+    } else {
+      os << "RangeState(uninitialized)";
+    }
+  }
+
+  friend llvm::raw_ostream &operator<<(llvm::raw_ostream &os,
+                                       const RangeState &state) {
+    state.print(os);
+    return os;
+  }
+
+ private:
+  std::optional<std::pair<double, double>> range;
+};
+
+// The number of times the range of a value may grow before its growing bounds
+// are widened to infinity. Straight-line code sets each range once, so only
+// values carried around loops are widened.
+constexpr int64_t kRangeWideningThreshold = 8;
+
+class RangeLattice : public dataflow::Lattice<RangeState> {
+ public:
+  using Lattice::Lattice;
+
+  ChangeResult join(const dataflow::AbstractSparseLattice &rhs) override {
+    return join(static_cast<const RangeLattice &>(rhs).getValue());
+  }
+
+  // Joins `rhs` into the range, widening it once it has grown more than
+  // kRangeWideningThreshold times.
+  ChangeResult join(const RangeState &rhs);
+
+  // Forgets the range, e.g., when the value it belongs to is erased.
+  void reset() {
+    getValue() = RangeState();
+    numUpdates = 0;
+  }
+
+ private:
+  int64_t numUpdates = 0;
+};
+
+class RangeAnalysis
+    : public dataflow::SparseForwardDataFlowAnalysis<RangeLattice> {
+ public:
+  using SparseForwardDataFlowAnalysis::SparseForwardDataFlowAnalysis;
+
+  void setToEntryState(RangeLattice *lattice) override;
+
+  LogicalResult visitOperation(Operation *op,
+                               ArrayRef<const RangeLattice *> operands,
+                               ArrayRef<RangeLattice *> results) override;
+};
+
+// Returns the range computed for `value`, or std::nullopt if the analysis did
+// not reach it or could not bound it.
+std::optional<RangeState> getBoundedRange(Value value, DataFlowSolver *solver);
+
+constexpr StringRef kArgRangeAttrName = "range.bounds";
+
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_ANALYSIS_RANGEANALYSIS_RANGEANALYSIS_H_
@@ -8,13 +8,18 @@
 #include "lib/Dialect/Secret/IR/SecretDialect.h"
 #include "lib/Dialect/Secret/IR/SecretOps.h"
 #include "lib/Dialect/Secret/IR/SecretTypes.h"
+#include "llvm/include/llvm/ADT/STLExtras.h"              // from @llvm-project
 #include "llvm/include/llvm/Support/Casting.h"             // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"     // from @llvm-project
 #include "mlir/include/mlir/IR/Attributes.h"               // from @llvm-project
+#include "mlir/include/mlir/IR/Block.h"                    // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinAttributes.h"        // from @llvm-project
 #include "mlir/include/mlir/IR/OpDefinition.h"             // from @llvm-project
 #include "mlir/include/mlir/IR/Operation.h"                // from @llvm-project
+#include "mlir/include/mlir/IR/Region.h"                   // from @llvm-project
 #include "mlir/include/mlir/IR/Value.h"                    // from @llvm-project
 #include "mlir/include/mlir/IR/ValueRange.h"               // from @llvm-project
 #include "mlir/include/mlir/IR/Visitors.h"                 // from @llvm-project
@@ -255,5 +260,63 @@ void getSecretOperands(Operation *op,
   }
 }
 
+SecretnessAnalysisCache::SecretnessAnalysisCache(Operation *op) : top(op) {
+  solver.load<dataflow::DeadCodeAnalysis>();
+  solver.load<dataflow::SparseConstantPropagation>();
+  solver.load<SecretnessAnalysis>();
+  status = solver.initializeAndRun(top);
+}
+
+Secretness SecretnessAnalysisCache::getSecretness(Value value) const {
+  auto *lattice = solver.lookupState<SecretnessLattice>(value);
+  return lattice ? lattice->getValue() : Secretness();
+}
+
+void SecretnessAnalysisCache::setSecretness(Value value,
+                                            Secretness secretness) {
+  auto *lattice = solver.getOrCreateState<SecretnessLattice>(value);
+  // solver.propagateIfChanged is bogus outside of an analysis, and the users
+  // of a newly created value have no lattice to propagate to anyway.
+  (void)lattice->join(secretness);
+}
+
+void SecretnessAnalysisCache::inferSecretness(Operation *op) {
+  SmallVector<Secretness> operandSecretness = llvm::map_to_vector(
+      op->getOperands(), [&](Value value) { return getSecretness(value); });
+  // No operands results in public secretness, as for arith.constant
+  Secretness resultSecretness = Secretness::combine(operandSecretness);
+  // TODO (#888): Handle region-bearing ops via visitNonControlFlowArguments
+  if (op->getNumRegions() && resultSecretness.isInitialized() &&
+      !resultSecretness.getSecretness()) {
+    resultSecretness = Secretness();
+  }
+  for (Value result : op->getResults()) {
+    setSecretness(result, resultSecretness);
+  }
+}
+
+LogicalResult SecretnessAnalysisCache::recompute() {
+  // States of erased values would otherwise linger, and could be picked up by
+  // new values allocated at the same address.
+  solver.eraseAllStates();
+  status = solver.initializeAndRun(top);
+  return status;
+}
+
+void SecretnessAnalysisCache::seedSolver(DataFlowSolver &other) const {
+  auto seed = [&](Value value) {
+    const auto *lattice = solver.lookupState<SecretnessLattice>(value);
+    if (!lattice) return;
+    (void)other.getOrCreateState<SecretnessLattice>(value)->join(
+        lattice->getValue());
+  };
+  top->walk([&](Operation *op) {
+    for (Value result : op->getResults()) seed(result);
+    for (Region &region : op->getRegions())
+      for (Block &block : region)
+        for (Value arg : block.getArguments()) seed(arg);
+  });
+}
+
 }  // namespace heir
 }  // namespace mlir
@@ -11,6 +11,7 @@
 #include "mlir/include/mlir/IR/Value.h"                    // from @llvm-project
 #include "mlir/include/mlir/IR/ValueRange.h"               // from @llvm-project
 #include "mlir/include/mlir/Interfaces/CallInterfaces.h"   // from @llvm-project
+#include "mlir/include/mlir/Pass/AnalysisManager.h"        // from @llvm-project
 #include "mlir/include/mlir/Support/LLVM.h"                // from @llvm-project
 
 namespace mlir {
@@ -41,6 +42,7 @@ class Secretness {
   bool operator==(const Secretness &rhs) const {
     return secretness == rhs.secretness;
   }
+  bool operator!=(const Secretness &rhs) const { return !(*this == rhs); }
 
   // Join two Secretness states
   static Secretness join(const Secretness &lhs, const Secretness &rhs) {
@@ -234,6 +236,72 @@ void getSecretOperands(Operation *op,
                        SmallVectorImpl<OpOperand *> &secretOperands,
                        DataFlowSolver *solver);
 
+/**
+ * @class SecretnessAnalysisCache
+ * @brief Owns a DataFlowSolver that has run SecretnessAnalysis (and its
+ * required dead code and constant propagation analyses) on an operation, so
+ * that the result can be cached by MLIR's AnalysisManager and shared between
+ * passes instead of rebuilding the solver in every pass.
+ *
+ * Retrieve it in a pass with `getAnalysis<SecretnessAnalysisCache>()`. A pass
+ * that does not change the secretness of any value should call
+ * `markAnalysesPreserved<SecretnessAnalysisCache>()` so the next pass reuses
+ * the same solver. Rewrites that only create new values can keep the cache up
+ * to date with `setSecretness` and `inferSecretness` instead of re-running the
+ * solver on the whole operation.
+ *
+ * Passes that load other analyses depending on SecretnessAnalysis build their
+ * own solver, and fill it with the cached secretness via `seedSolver` instead
+ * of loading SecretnessAnalysis again. Passes whose solver must re-run the
+ * secretness analysis after rewriting the IR still load SecretnessAnalysis.
+ */
+class SecretnessAnalysisCache {
+ public:
+  explicit SecretnessAnalysisCache(Operation *op);
+
+  /// Returns failure if the solver failed to run on the operation.
+  LogicalResult getStatus() const { return status; }
+
+  /// Returns the underlying solver, e.g., for use with `isSecret` and
+  /// `annotateSecretness`.
+  DataFlowSolver *getSolver() { return &solver; }
+
+  /// Returns the secretness of a value, or an uninitialized Secretness if
+  /// the value has no lattice.
+  Secretness getSecretness(Value value) const;
+
+  bool isSecret(Value value) { return heir::isSecret(value, &solver); }
+
+  bool isSecret(ValueRange values) { return heir::isSecret(values, &solver); }
+
+  /// Joins the secretness of a value created by a rewrite into its lattice.
+  void setSecretness(Value value, Secretness secretness);
+
+  /// Sets the secretness of the results of a newly created op from the
+  /// secretness of its operands, following the same rules as
+  /// SecretnessAnalysis::visitOperation.
+  void inferSecretness(Operation *op);
+
+  /// Re-runs the solver on the whole operation. This is only needed when a
+  /// rewrite changes the secretness of existing values, or erases ops.
+  LogicalResult recompute();
+
+  /// Copies the secretness of every value under the operation into the
+  /// lattices of `solver`, which must not load SecretnessAnalysis itself.
+  /// Call this before running `solver`, so that analyses depending on
+  /// SecretnessAnalysis see the cached secretness.
+  void seedSolver(DataFlowSolver &solver) const;
+
+  bool isInvalidated(const AnalysisManager::PreservedAnalyses &pa) {
+    return !pa.isPreserved<SecretnessAnalysisCache>();
+  }
+
+ private:
+  Operation *top;
+  DataFlowSolver solver;
+  LogicalResult status = success();
+};
+
 }  // namespace heir
 }  // namespace mlir
 
@@ -0,0 +1,129 @@
+#include <memory>
+
+#include "gtest/gtest.h"  // from @googletest
+#include "lib/Analysis/SecretnessAnalysis/SecretnessAnalysis.h"
+#include "lib/Dialect/Secret/IR/SecretDialect.h"
+#include "lib/Dialect/Secret/IR/SecretOps.h"
+#include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"   // from @llvm-project
+#include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinOps.h"            // from @llvm-project
+#include "mlir/include/mlir/IR/MLIRContext.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/OwningOpRef.h"           // from @llvm-project
+#include "mlir/include/mlir/Parser/Parser.h"            // from @llvm-project
+#include "mlir/include/mlir/Pass/Pass.h"                // from @llvm-project
+#include "mlir/include/mlir/Pass/PassManager.h"         // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"             // from @llvm-project
+#include "mlir/include/mlir/Support/TypeID.h"           // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace {
+
+static constexpr char kModule[] = R"mlir(
+  func.func @add(%arg0: !secret.secret<i16>, %arg1: i16) -> !secret.secret<i16> {
+    %c1 = arith.constant 1 : i16
+    %0 = arith.addi %arg1, %c1 : i16
+    %1 = secret.generic ins(%arg0 : !secret.secret<i16>) {
+    ^body(%input0: i16):
+      %2 = arith.addi %input0, %0 : i16
+      secret.yield %2 : i16
+    } -> !secret.secret<i16>
+    return %1 : !secret.secret<i16>
+  }
+)mlir";
+
+// Gets the cached secretness, records its address and optionally preserves it.
+struct GetSecretnessPass
+    : public PassWrapper<GetSecretnessPass, OperationPass<ModuleOp>> {
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(GetSecretnessPass)
+
+  GetSecretnessPass(SecretnessAnalysisCache **cache, bool preserve)
+      : cache(cache), preserve(preserve) {}
+
+  void runOnOperation() override {
+    *cache = &getAnalysis<SecretnessAnalysisCache>();
+    if (preserve) markAnalysesPreserved<SecretnessAnalysisCache>();
+  }
+
+  SecretnessAnalysisCache **cache;
+  bool preserve;
+};
+
+// Records the cached secretness if there is one, without computing it.
+struct GetCachedSecretnessPass
+    : public PassWrapper<GetCachedSecretnessPass, OperationPass<ModuleOp>> {
+  MLIR_DEFINE_EXPLICIT_INTERNAL_INLINE_TYPE_ID(GetCachedSecretnessPass)
+
+  explicit GetCachedSecretnessPass(SecretnessAnalysisCache **cache)
+      : cache(cache) {}
+
+  void runOnOperation() override {
+    auto cached = getCachedAnalysis<SecretnessAnalysisCache>();
+    *cache = cached ? &cached->get() : nullptr;
+    markAllAnalysesPreserved();
+  }
+
+  SecretnessAnalysisCache **cache;
+};
+
+class SecretnessAnalysisCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    context.loadDialect<arith::ArithDialect, func::FuncDialect,
+                        secret::SecretDialect>();
+    module = parseSourceString<ModuleOp>(kModule, &context);
+    ASSERT_TRUE(module);
+  }
+
+  MLIRContext context;
+  OwningOpRef<ModuleOp> module;
+};
+
+TEST_F(SecretnessAnalysisCacheTest, PreservedCacheIsReused) {
+  SecretnessAnalysisCache *first = nullptr;
+  SecretnessAnalysisCache *second = nullptr;
+  PassManager pm(&context);
+  pm.addPass(std::make_unique<GetSecretnessPass>(&first, /*preserve=*/true));
+  pm.addPass(std::make_unique<GetCachedSecretnessPass>(&second));
+  ASSERT_TRUE(succeeded(pm.run(*module)));
+
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(first, second);
+}
+
+TEST_F(SecretnessAnalysisCacheTest, UnpreservedCacheIsDropped) {
+  SecretnessAnalysisCache *first = nullptr;
+  SecretnessAnalysisCache *second = nullptr;
+  PassManager pm(&context);
+  pm.addPass(std::make_unique<GetSecretnessPass>(&first, /*preserve=*/false));
+  pm.addPass(std::make_unique<GetCachedSecretnessPass>(&second));
+  ASSERT_TRUE(succeeded(pm.run(*module)));
+
+  ASSERT_NE(first, nullptr);
+  EXPECT_EQ(second, nullptr);
+}
+
+TEST_F(SecretnessAnalysisCacheTest, SeedSolverCopiesSecretness) {
+  SecretnessAnalysisCache secretness(*module);
+  ASSERT_TRUE(succeeded(secretness.getStatus()));
+
+  DataFlowSolver solver;
+  secretness.seedSolver(solver);
+
+  auto func = cast<func::FuncOp>(module->getBody()->front());
+  auto generic = *func.getOps<secret::GenericOp>().begin();
+  auto publicAdd = *func.getOps<arith::AddIOp>().begin();
+  auto secretAdd = *generic.getBody()->getOps<arith::AddIOp>().begin();
+
+  EXPECT_TRUE(isSecret(func.getArgument(0), &solver));
+  EXPECT_FALSE(isSecret(func.getArgument(1), &solver));
+  EXPECT_FALSE(isSecret(publicAdd.getResult(), &solver));
+  EXPECT_TRUE(isSecret(generic.getBody()->getArgument(0), &solver));
+  EXPECT_TRUE(isSecret(secretAdd.getResult(), &solver));
+  EXPECT_TRUE(isSecret(generic.getResult(0), &solver));
+}
+
+}  // namespace
+}  // namespace heir
+}  // namespace mlir
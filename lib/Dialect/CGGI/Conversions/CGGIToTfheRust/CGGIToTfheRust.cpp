@@ -1,5 +1,6 @@
 #include "lib/Dialect/CGGI/Conversions/CGGIToTfheRust/CGGIToTfheRust.h"
 
+#include <cstdint>
 #include <utility>
 
 #include "lib/Dialect/CGGI/IR/CGGIDialect.h"
@@ -12,7 +13,9 @@
 #include "lib/Dialect/TfheRust/IR/TfheRustTypes.h"
 #include "lib/Utils/ConversionUtils.h"
 #include "lib/Utils/Utils.h"
+#include "llvm/include/llvm/ADT/STLExtras.h"    // from @llvm-project
 #include "llvm/include/llvm/ADT/SmallVector.h"  // from @llvm-project
+#include "llvm/include/llvm/Support/MathExtras.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"   // from @llvm-project
@@ -203,6 +206,94 @@ struct ConvertLut2Op : public OpConversionPattern<cggi::Lut2Op> {
   }
 };
 
+/// Convert a MultiLutLinCombOp to:
+///   - generate_many_lookup_table
+///   - scalar_left_shift and add_op for the linear combination
+///   - apply_many_lookup_table
+///
+/// Only power-of-two coefficients are supported, as produced by
+/// --cggi-merge-luts, because they are implemented by shifts.
+struct ConvertMultiLutLinCombOp
+    : public OpConversionPattern<cggi::MultiLutLinCombOp> {
+  ConvertMultiLutLinCombOp(mlir::MLIRContext *context)
+      : OpConversionPattern<cggi::MultiLutLinCombOp>(context) {}
+
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      cggi::MultiLutLinCombOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    if (llvm::any_of(op.getCoefficients(), [](int32_t coefficient) {
+          return coefficient <= 0 || !llvm::isPowerOf2_32(coefficient);
+        })) {
+      return rewriter.notifyMatchFailure(
+          op, "expected positive power-of-two coefficients");
+    }
+
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    FailureOr<Value> result = getContextualServerKey(op.getOperation());
+    if (failed(result)) return result;
+
+    Value serverKey = result.value();
+    // A followup -cse pass should combine repeated LUT generation ops.
+    auto lut = b.create<tfhe_rust::GenerateManyLookupTableOp>(
+        serverKey, op.getLookupTablesAttr());
+
+    // Construct input = sum(input_i << log2(coefficient_i))
+    Value input;
+    for (auto [operand, coefficient] :
+         llvm::zip(adaptor.getInputs(), op.getCoefficients())) {
+      Value term = operand;
+      if (coefficient > 1) {
+        term = b.create<tfhe_rust::ScalarLeftShiftOp>(
+            serverKey, operand, b.getIndexAttr(llvm::Log2_32(coefficient)));
+      }
+      if (input) {
+        term = b.create<tfhe_rust::AddOp>(term.getType(), serverKey, input,
+                                          term);
+      }
+      input = term;
+    }
+
+    SmallVector<Type> outputTypes;
+    if (failed(getTypeConverter()->convertTypes(op.getResultTypes(),
+                                                outputTypes)))
+      return failure();
+    rewriter.replaceOp(op, b.create<tfhe_rust::ApplyManyLookupTableOp>(
+                               outputTypes, serverKey, input, lut));
+    return success();
+  }
+};
+
+struct ConvertMultiProgrammableBootstrapOp
+    : public OpConversionPattern<cggi::MultiProgrammableBootstrapOp> {
+  ConvertMultiProgrammableBootstrapOp(mlir::MLIRContext *context)
+      : OpConversionPattern<cggi::MultiProgrammableBootstrapOp>(context) {}
+
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      cggi::MultiProgrammableBootstrapOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    FailureOr<Value> result = getContextualServerKey(op.getOperation());
+    if (failed(result)) return result;
+
+    Value serverKey = result.value();
+    auto lut = b.create<tfhe_rust::GenerateManyLookupTableOp>(
+        serverKey, op.getLookupTablesAttr());
+
+    SmallVector<Type> outputTypes;
+    if (failed(getTypeConverter()->convertTypes(op.getResultTypes(),
+                                                outputTypes)))
+      return failure();
+    rewriter.replaceOp(
+        op, b.create<tfhe_rust::ApplyManyLookupTableOp>(
+                outputTypes, serverKey, adaptor.getInput(), lut));
+    return success();
+  }
+};
+
 static LogicalResult replaceBinaryGate(Operation *op, Value lhs, Value rhs,
                                        ConversionPatternRewriter &rewriter,
                                        int lut) {
@@ -580,7 +671,9 @@ class CGGIToTfheRust : public impl::CGGIToTfheRustBase<CGGIToTfheRust> {
     // needed and possible.
     patterns.add<
         AddServerKeyArg, AddServerKeyArgCall, ConvertEncodeOp, ConvertLut2Op,
-        ConvertLut3Op, ConvertNotOp, ConvertTrivialEncryptOp, ConvertTrivialOp,
+        ConvertLut3Op, ConvertMultiLutLinCombOp,
+        ConvertMultiProgrammableBootstrapOp, ConvertNotOp,
+        ConvertTrivialEncryptOp, ConvertTrivialOp,
         ConvertCGGITRBinOp<cggi::AddOp, tfhe_rust::AddOp>,
         ConvertCGGITRBinOp<cggi::MulOp, tfhe_rust::MulOp>,
         ConvertCGGITRBinOp<cggi::SubOp, tfhe_rust::SubOp>,
@@ -109,6 +109,37 @@ LogicalResult ProgrammableBootstrapOp::verify() {
   return success();
 }
 
+LogicalResult MultiProgrammableBootstrapOp::verify() {
+  if (getOutputs().empty())
+    return emitOpError("expected at least one lookup table");
+  if (getOutputs().size() != getLookupTables().size())
+    return emitOpError("number of outputs must match number of LUTs");
+  for (Type outputType : getOutputs().getTypes()) {
+    if (outputType != getInput().getType())
+      return emitOpError("output types must match the input type");
+  }
+
+  auto encoding = dyn_cast<lwe::BitFieldEncodingAttr>(
+      cast<lwe::LWECiphertextType>(getInput().getType()).getEncoding());
+
+  if (encoding) {
+    int64_t maxCoeff = (1 << encoding.getCleartextBitwidth()) - 1;
+    for (int64_t lut : getLookupTables()) {
+      APInt apintLut = APInt(64, lut);
+      if (apintLut.getActiveBits() > maxCoeff + 1) {
+        InFlightDiagnostic diag =
+            emitOpError("LUT is larger than available cleartext bit width");
+        diag.attachNote() << "LUT has " << apintLut.getActiveBits()
+                          << " active bits";
+        diag.attachNote() << "max LUT size is " << maxCoeff + 1 << " bits";
+        return diag;
+      }
+    }
+  }
+
+  return success();
+}
+
 LogicalResult MultiLutLinCombOp::verify() {
   if (getInputs().size() != getCoefficients().size())
     return emitOpError("number of coefficients must match number of inputs");
@@ -1,6 +1,8 @@
 #include "lib/Dialect/CGGI/Transforms/BooleanVectorizer.h"
 
+#include <algorithm>
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <vector>
 
@@ -8,11 +10,15 @@
 #include "lib/Dialect/CGGI/IR/CGGIEnums.h"
 #include "lib/Dialect/CGGI/IR/CGGIOps.h"
 #include "lib/Utils/Graph/Graph.h"
+#include "llvm/include/llvm/ADT/DenseMap.h"            // from @llvm-project
+#include "llvm/include/llvm/ADT/DenseSet.h"            // from @llvm-project
 #include "llvm/include/llvm/ADT/STLExtras.h"           // from @llvm-project
+#include "llvm/include/llvm/ADT/SetVector.h"           // from @llvm-project
 #include "llvm/include/llvm/ADT/SmallVector.h"         // from @llvm-project
 #include "llvm/include/llvm/ADT/TypeSwitch.h"          // from @llvm-project
 #include "llvm/include/llvm/Support/Casting.h"         // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"           // from @llvm-project
+#include "llvm/include/llvm/Support/MathExtras.h"      // from @llvm-project
 #include "mlir/include/mlir/Analysis/SliceAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/TopologicalSortUtils.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
@@ -186,15 +192,233 @@ DenseMap<Operation *, SmallVector<SmallVector<Operation *>>> buildCompatibleOps(
                           << " groups of compatible ops\n");
   return compatibleOps;
 }
-bool tryBoolVectorizeBlock(Block *block, MLIRContext &context,
-                           int parallelism) {
+bool areCompatibleForBatching(Operation *lhs, Operation *rhs) {
+  return (isa<NotOp>(lhs) && isa<NotOp>(rhs)) || areCompatibleBool(lhs, rhs);
+}
+
+// Partition each level into buckets of compatible ops of at most
+// `parallelism` ops. Keys with a single op in the level are not batched.
+SmallVector<SmallVector<Operation *>> scheduleByLevels(
+    const std::vector<std::vector<Operation *>> &levels, int parallelism) {
+  SmallVector<SmallVector<Operation *>> batches;
+  for (const auto &level : levels) {
+    DenseMap<Operation *, SmallVector<SmallVector<Operation *>>> compatibleOps =
+        buildCompatibleOps(level, parallelism);
+
+    LLVM_DEBUG({
+      llvm::dbgs()
+          << " ########## Overview of the Compatible Ops object ##########\n";
+      for (const auto &elem : compatibleOps) {
+        llvm::dbgs() << " KEY " << *elem.first << "\n";
+        for (const auto op : elem.getSecond()) {
+          for (const auto opp : op) {
+            llvm::dbgs() << " - " << *opp << "\n";
+          }
+          llvm::dbgs() << " next \n";
+        }
+      }
+    });
+
+    for (const auto &[key, buckets] : compatibleOps) {
+      if (bucketSize(buckets) < 2) {
+        continue;
+      }
+      batches.append(buckets.begin(), buckets.end());
+    }
+  }
+  return batches;
+}
+
+// Schedule the ops at the as-late-as-possible levels computed by
+// sortGraphByLevels, prioritizing the critical path. Each level is executed
+// as one batch per group of compatible ops that must run at that level, or
+// more if a group exceeds `parallelism`. Critical gates, which have no slack,
+// are placed first, and the remaining capacity of each batch is filled with
+// ready ops that could run at a later level, least slack first. Thus gates
+// are only moved earlier to fill batches, and never delayed.
+SmallVector<SmallVector<Operation *>> scheduleCriticalPathFirst(
+    graph::Graph<Operation *> &graph,
+    const std::vector<std::vector<Operation *>> &levels,
+    const DenseMap<Operation *, int> &programOrder, int parallelism) {
+  DenseMap<Operation *, int> alapLevel;
+  DenseMap<Operation *, int> asapLevel;
+  DenseMap<Operation *, int> pendingPredecessors;
+  for (const auto &[index, level] : llvm::enumerate(levels)) {
+    for (auto *op : level) {
+      alapLevel[op] = index;
+      int asap = 0;
+      std::vector<Operation *> predecessors = graph.edgesInto(op);
+      for (auto *pred : predecessors) {
+        asap = std::max(asap, asapLevel.lookup(pred) + 1);
+      }
+      asapLevel[op] = asap;
+      pendingPredecessors[op] = predecessors.size();
+    }
+  }
+
+  auto bySlack = [&](Operation *lhs, Operation *rhs) {
+    int lhsSlack = alapLevel.lookup(lhs) - asapLevel.lookup(lhs);
+    int rhsSlack = alapLevel.lookup(rhs) - asapLevel.lookup(rhs);
+    if (lhsSlack != rhsSlack) return lhsSlack < rhsSlack;
+    return programOrder.lookup(lhs) < programOrder.lookup(rhs);
+  };
+  auto byDeadline = [&](Operation *lhs, Operation *rhs) {
+    if (alapLevel.lookup(lhs) != alapLevel.lookup(rhs))
+      return alapLevel.lookup(lhs) < alapLevel.lookup(rhs);
+    return bySlack(lhs, rhs);
+  };
+
+  SmallVector<SmallVector<Operation *>> batches;
+  SetVector<Operation *> ready;
+  for (const auto &level : levels) {
+    for (auto *op : level) {
+      if (pendingPredecessors.lookup(op) == 0) ready.insert(op);
+    }
+  }
+
+  for (int level = 0; level < static_cast<int>(levels.size()); ++level) {
+    // Every op at this level is ready, since its predecessors have smaller
+    // levels and were scheduled no later than at those levels.
+    SmallVector<Operation *> mandatory;
+    SmallVector<Operation *> optional;
+    for (auto *op : ready) {
+      if (alapLevel.lookup(op) == level)
+        mandatory.push_back(op);
+      else
+        optional.push_back(op);
+    }
+    llvm::sort(mandatory, bySlack);
+    llvm::sort(optional, byDeadline);
+
+    SmallVector<SmallVector<Operation *>> groups;
+    for (auto *op : mandatory) {
+      auto *it = llvm::find_if(groups, [&](const auto &group) {
+        return areCompatibleForBatching(group.front(), op);
+      });
+      if (it == groups.end())
+        groups.push_back({op});
+      else
+        it->push_back(op);
+    }
+
+    SmallVector<Operation *> scheduled;
+    DenseSet<Operation *> taken;
+    for (auto &group : groups) {
+      if (parallelism > 0) {
+        size_t capacity =
+            llvm::divideCeil(group.size(), parallelism) * parallelism;
+        for (auto *op : optional) {
+          if (group.size() >= capacity) break;
+          if (!taken.contains(op) &&
+              areCompatibleForBatching(group.front(), op)) {
+            group.push_back(op);
+            taken.insert(op);
+          }
+        }
+        for (size_t i = 0; i < group.size(); i += parallelism) {
+          size_t batchEnd = std::min(group.size(), i + parallelism);
+          batches.emplace_back(group.begin() + i, group.begin() + batchEnd);
+        }
+      } else {
+        for (auto *op : optional) {
+          if (!taken.contains(op) &&
+              areCompatibleForBatching(group.front(), op)) {
+            group.push_back(op);
+            taken.insert(op);
+          }
+        }
+        batches.push_back(group);
+      }
+      scheduled.append(group.begin(), group.end());
+    }
+
+    for (auto *op : scheduled) {
+      ready.remove(op);
+    }
+    for (auto *op : scheduled) {
+      for (auto *succ : graph.edgesOutOf(op)) {
+        if (--pendingPredecessors[succ] == 0) ready.insert(succ);
+      }
+    }
+  }
+
+  // Batches of a single op are left as scalar ops.
+  llvm::erase_if(batches, [](const auto &batch) { return batch.size() < 2; });
+  return batches;
+}
+
+LogicalResult vectorizeBatch(const SmallVector<Operation *> &bucket,
+                             MLIRContext &context) {
+  Operation *key = bucket.front();
+  LLVM_DEBUG({
+    llvm::dbgs() << "[**START] Bucket (" << key->getName()
+                 << ") \t Vectorizing ops:\n"
+                 << *key << "\n";
+
+    for (const auto op : bucket) {
+      llvm::dbgs() << " - " << *op << "\n";
+    }
+  });
+
+  OpBuilder builder(bucket.back());
+  // relies on CGGI ops having a single result type
+  Type elementType = key->getResultTypes()[0];
+  RankedTensorType tensorType = RankedTensorType::get(
+      {static_cast<int64_t>(bucket.size())}, elementType);
+
+  SmallVector<Value> vectorizedOperands =
+      buildVectorizedOperands(key, bucket, tensorType, builder);
+  auto vectorizedGateOperands = buildGateOperands(bucket, context);
+  if (failed(vectorizedGateOperands)) return failure();
+
+  Operation *vectorizedOp;
+  if (llvm::isa<cggi::Lut3Op>(key)) {
+    auto oplist = builder.getArrayAttr(vectorizedGateOperands.value());
+    vectorizedOp = builder.create<cggi::PackedLut3Op>(
+        key->getLoc(), tensorType, oplist, vectorizedOperands[0],
+        vectorizedOperands[1], vectorizedOperands[2]);
+  } else if (llvm::isa<cggi::NotOp>(key)) {
+    vectorizedOp = builder.create<cggi::NotOp>(key->getLoc(), tensorType,
+                                               vectorizedOperands[0]);
+  } else {
+    auto operands = vectorizedGateOperands.value();
+    auto oplist = CGGIBoolGatesAttr::get(
+        &context, llvm::to_vector(llvm::map_range(
+                      operands, [](Attribute attr) -> CGGIBoolGateEnumAttr {
+                        return cast<CGGIBoolGateEnumAttr>(attr);
+                      })));
+    vectorizedOp = builder.create<cggi::PackedOp>(
+        key->getLoc(), tensorType, oplist, vectorizedOperands[0],
+        vectorizedOperands[1]);
+  }
+
+  int bucketIndex = 0;
+  for (auto *op : bucket) {
+    auto extractionIndex = builder.create<arith::ConstantOp>(
+        op->getLoc(), builder.getIndexAttr(bucketIndex));
+    auto extractOp = builder.create<tensor::ExtractOp>(
+        op->getLoc(), elementType, vectorizedOp->getResult(0),
+        extractionIndex.getResult());
+    op->replaceAllUsesWith(ValueRange{extractOp.getResult()});
+    bucketIndex++;
+  }
+  for (auto *op : bucket) {
+    op->erase();
+  }
+  return success();
+}
+
+SmallVector<SmallVector<Operation *>> scheduleBlock(
+    Block *block, int parallelism, bool prioritizeCriticalPath) {
   graph::Graph<Operation *> graph;
+  DenseMap<Operation *, int> programOrder;
   for (auto &op : block->getOperations()) {
     if (!op.hasTrait<OpTrait::Elementwise>()) {
       continue;
     }
 
     graph.addVertex(&op);
+    programOrder[&op] = programOrder.size();
     SetVector<Operation *> backwardSlice;
     BackwardSliceOptions options;
     options.omitBlockArguments = true;
@@ -208,7 +432,7 @@ bool tryBoolVectorizeBlock(Block *block, MLIRContext &context,
   }
 
   if (graph.empty()) {
-    return false;
+    return {};
   }
 
   auto result = graph.sortGraphByLevels();
@@ -228,97 +452,9 @@ bool tryBoolVectorizeBlock(Block *block, MLIRContext &context,
     }
   });
 
-  bool madeReplacement = false;
-  for (const auto &level : levels) {
-    DenseMap<Operation *, SmallVector<SmallVector<Operation *>>> compatibleOps =
-        buildCompatibleOps(level, parallelism);
-
-    LLVM_DEBUG({
-      llvm::dbgs()
-          << " ########## Overview of the Compatible Ops object ##########\n";
-      for (const auto &elem : compatibleOps) {
-        llvm::dbgs() << " KEY " << *elem.first << "\n";
-        for (const auto op : elem.getSecond()) {
-          for (const auto opp : op) {
-            llvm::dbgs() << " - " << *opp << "\n";
-          }
-          llvm::dbgs() << " next \n";
-        }
-      }
-    });
-
-    // Loop over all the compatibleOp groups
-    // Each loop will have the key and a bucket with all the operations in
-    for (const auto &[key, buckets] : compatibleOps) {
-      if (bucketSize(buckets) < 2) {
-        continue;
-      }
-      for (const auto &bucket : buckets) {
-        LLVM_DEBUG({
-          llvm::dbgs() << "[**START] Bucket (" << key->getName()
-                       << ") \t Vectorizing ops:\n"
-                       << *key << "\n";
-
-          for (const auto op : bucket) {
-            llvm::dbgs() << " - " << *op << "\n";
-          }
-        });
-
-        OpBuilder builder(bucket.back());
-        // relies on CGGI ops having a single result type
-        Type elementType = key->getResultTypes()[0];
-        RankedTensorType tensorType = RankedTensorType::get(
-            {static_cast<int64_t>(bucket.size())}, elementType);
-
-        SmallVector<Value> vectorizedOperands =
-            buildVectorizedOperands(key, bucket, tensorType, builder);
-        auto vectorizedGateOperands = buildGateOperands(bucket, context);
-        if (failed(vectorizedGateOperands)) return false;
-
-        Operation *vectorizedOp;
-        if (llvm::isa<cggi::Lut3Op>(key)) {
-          auto oplist = builder.getArrayAttr(vectorizedGateOperands.value());
-          vectorizedOp = builder.create<cggi::PackedLut3Op>(
-              key->getLoc(), tensorType, oplist, vectorizedOperands[0],
-              vectorizedOperands[1], vectorizedOperands[2]);
-        } else if (llvm::isa<cggi::NotOp>(key)) {
-          vectorizedOp = builder.create<cggi::NotOp>(key->getLoc(), tensorType,
-                                                     vectorizedOperands[0]);
-        } else {
-          auto operands = vectorizedGateOperands.value();
-          auto oplist = CGGIBoolGatesAttr::get(
-              &context,
-              llvm::to_vector(llvm::map_range(
-                  operands, [](Attribute attr) -> CGGIBoolGateEnumAttr {
-                    return cast<CGGIBoolGateEnumAttr>(attr);
-                  })));
-          vectorizedOp = builder.create<cggi::PackedOp>(
-              key->getLoc(), tensorType, oplist, vectorizedOperands[0],
-              vectorizedOperands[1]);
-        }
-
-        int bucketIndex = 0;
-        for (auto *op : bucket) {
-          auto extractionIndex = builder.create<arith::ConstantOp>(
-              op->getLoc(), builder.getIndexAttr(bucketIndex));
-          auto extractOp = builder.create<tensor::ExtractOp>(
-              op->getLoc(), elementType, vectorizedOp->getResult(0),
-              extractionIndex.getResult());
-          op->replaceAllUsesWith(ValueRange{extractOp.getResult()});
-          bucketIndex++;
-        }
-        madeReplacement = (bucketIndex > 0) || madeReplacement;
-      }
-      // Erase Ops that have been replaced for a specific key.
-      for (const auto &bucket : buckets) {
-        for (auto *op : bucket) {
-          op->erase();
-        }
-      }
-    }
-  }
-
-  return madeReplacement;
+  if (prioritizeCriticalPath)
+    return scheduleCriticalPathFirst(graph, levels, programOrder, parallelism);
+  return scheduleByLevels(levels, parallelism);
 }
 
 struct BooleanVectorizer : impl::BooleanVectorizerBase<BooleanVectorizer> {
@@ -327,11 +463,28 @@ struct BooleanVectorizer : impl::BooleanVectorizerBase<BooleanVectorizer> {
   void runOnOperation() override {
     MLIRContext &context = getContext();
 
+    int64_t totalBatches = 0;
+    int64_t batchedGates = 0;
     getOperation()->walk<WalkOrder::PreOrder>([&](Block *block) {
-      if (tryBoolVectorizeBlock(block, context, parallelism)) {
-        sortTopologically(block);
+      SmallVector<SmallVector<Operation *>> batches =
+          scheduleBlock(block, parallelism, prioritizeCriticalPath);
+      if (batches.empty()) return;
+
+      for (const auto &batch : batches) {
+        LLVM_DEBUG(llvm::dbgs() << "Batch occupancy: " << batch.size() << "/"
+                                << parallelism << "\n");
+        if (failed(vectorizeBatch(batch, context))) break;
+        ++totalBatches;
+        batchedGates += batch.size();
       }
+      sortTopologically(block);
     });
+
+    numBatches = totalBatches;
+    numBatchedGates = batchedGates;
+    if (parallelism > 0 && totalBatches > 0) {
+      batchOccupancy = 100 * batchedGates / (totalBatches * parallelism);
+    }
   }
 };
 
@@ -1,6 +1,7 @@
 #include "lib/Dialect/CGGI/Transforms/ExpandLUT.h"
 
 #include <cassert>
+#include <cstdint>
 #include <utility>
 
 #include "lib/Dialect/CGGI/IR/CGGIOps.h"
@@ -9,10 +10,12 @@
 #include "lib/Utils/ConversionUtils.h"
 #include "llvm/include/llvm/ADT/STLExtras.h"           // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Location.h"             // from @llvm-project
 #include "mlir/include/mlir/IR/MLIRContext.h"          // from @llvm-project
 #include "mlir/include/mlir/IR/PatternMatch.h"         // from @llvm-project
 #include "mlir/include/mlir/IR/Types.h"                // from @llvm-project
 #include "mlir/include/mlir/IR/Value.h"                // from @llvm-project
+#include "mlir/include/mlir/IR/ValueRange.h"           // from @llvm-project
 #include "mlir/include/mlir/Support/LLVM.h"            // from @llvm-project
 #include "mlir/include/mlir/Transforms/GreedyPatternRewriteDriver.h"  // from @llvm-project
 
@@ -28,33 +31,53 @@ namespace alignment {
 #include "lib/Dialect/CGGI/Transforms/ExpandLUT.cpp.inc"
 }  // namespace alignment
 
+// Use LWE operations to create the linear combination of inputs.
+static Value buildLinearCombination(Location loc, ValueRange inputs,
+                                    ArrayRef<int32_t> coefficients,
+                                    PatternRewriter &rewriter) {
+  Type scalarTy = rewriter.getIntegerType(widthFromEncodingAttr(
+      cast<lwe::LWECiphertextType>(inputs.front().getType()).getEncoding()));
+  Value result;
+  for (auto [input, coeff] : llvm::zip(inputs, coefficients)) {
+    auto scaled = rewriter.create<lwe::MulScalarOp>(
+        loc, input,
+        rewriter.create<arith::ConstantOp>(
+            loc, rewriter.getIntegerAttr(scalarTy, coeff)));
+    result = result
+                 ? rewriter.create<lwe::AddOp>(loc, result, scaled).getResult()
+                 : scaled.getResult();
+  }
+  return result;
+}
+
 struct ExpandLutLinComb : public OpRewritePattern<LutLinCombOp> {
   ExpandLutLinComb(mlir::MLIRContext *context)
       : OpRewritePattern<LutLinCombOp>(context, /*benefit=*/1) {}
 
   LogicalResult matchAndRewrite(LutLinCombOp op,
                                 PatternRewriter &rewriter) const override {
-    Type scalarTy = rewriter.getIntegerType(widthFromEncodingAttr(
-        cast<lwe::LWECiphertextType>(op.getInputs().front().getType())
-            .getEncoding()));
-    // Use LWE operations to create the linear combination of inputs.
-    Value result;
-    for (auto [input, coeff] :
-         llvm::zip(op.getInputs(), op.getCoefficients())) {
-      auto scaled = rewriter.create<lwe::MulScalarOp>(
-          op.getLoc(), input,
-          rewriter.create<arith::ConstantOp>(
-              op.getLoc(), rewriter.getIntegerAttr(scalarTy, coeff)));
-      result = result ? rewriter.create<lwe::AddOp>(op.getLoc(), result, scaled)
-                            .getResult()
-                      : scaled.getResult();
-    }
+    Value result = buildLinearCombination(op.getLoc(), op.getInputs(),
+                                          op.getCoefficients(), rewriter);
     rewriter.replaceOpWithNewOp<ProgrammableBootstrapOp>(op, result,
                                                          op.getLookupTable());
     return success();
   }
 };
 
+struct ExpandMultiLutLinComb : public OpRewritePattern<MultiLutLinCombOp> {
+  ExpandMultiLutLinComb(mlir::MLIRContext *context)
+      : OpRewritePattern<MultiLutLinCombOp>(context, /*benefit=*/1) {}
+
+  LogicalResult matchAndRewrite(MultiLutLinCombOp op,
+                                PatternRewriter &rewriter) const override {
+    Value result = buildLinearCombination(op.getLoc(), op.getInputs(),
+                                          op.getCoefficients(), rewriter);
+    rewriter.replaceOpWithNewOp<MultiProgrammableBootstrapOp>(
+        op, op.getResultTypes(), result, op.getLookupTablesAttr());
+    return success();
+  }
+};
+
 struct ExpandLUT : impl::ExpandLUTBase<ExpandLUT> {
   using ExpandLUTBase::ExpandLUTBase;
 
@@ -64,7 +87,7 @@ struct ExpandLUT : impl::ExpandLUTBase<ExpandLUT> {
     RewritePatternSet patterns(context);
     // Add patterns generated from DRR
     alignment::populateWithGenerated(patterns);
-    patterns.add<ExpandLutLinComb>(context);
+    patterns.add<ExpandLutLinComb, ExpandMultiLutLinComb>(context);
 
     // TODO (#1221): Investigate whether folding (default: on) can be skipped
     // here.
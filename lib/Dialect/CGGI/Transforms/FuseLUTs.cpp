@@ -0,0 +1,217 @@
+#include "lib/Dialect/CGGI/Transforms/FuseLUTs.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+
+#include "lib/Dialect/CGGI/IR/CGGIOps.h"
+#include "lib/Dialect/LWE/IR/LWEAttributes.h"
+#include "lib/Dialect/LWE/IR/LWETypes.h"
+#include "lib/Utils/ConversionUtils.h"
+#include "llvm/include/llvm/ADT/APInt.h"         // from @llvm-project
+#include "llvm/include/llvm/ADT/DenseMap.h"      // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"     // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"   // from @llvm-project
+#include "llvm/include/llvm/ADT/TypeSwitch.h"    // from @llvm-project
+#include "mlir/include/mlir/IR/MLIRContext.h"    // from @llvm-project
+#include "mlir/include/mlir/IR/PatternMatch.h"   // from @llvm-project
+#include "mlir/include/mlir/IR/TypeUtilities.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"          // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"      // from @llvm-project
+#include "mlir/include/mlir/Transforms/GreedyPatternRewriteDriver.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace cggi {
+
+#define GEN_PASS_DEF_FUSELUTS
+#include "lib/Dialect/CGGI/Transforms/Passes.h.inc"
+
+// The fused lookup table is stored in a 64-bit index attribute, which holds
+// the truth table of at most 6 inputs.
+static constexpr int64_t kMaxFusedInputs = 6;
+
+// The relative cost of a programmable bootstrap whose message space holds a
+// given number of cleartext bits. These follow the PBS latencies of the
+// tfhe-rs shortint parameter sets with 1 to 6 message and carry bits: the
+// polynomial size grows slowly up to 4 bits, and doubles with each bit after.
+static constexpr int64_t kPbsCost[kMaxFusedInputs + 1] = {0, 7, 8, 10, 12,
+                                                          27, 60};
+
+namespace {
+
+// A LUT operation viewed as a lookup table applied to a linear combination of
+// its inputs.
+struct LinearLut {
+  SmallVector<Value> inputs;
+  SmallVector<int32_t> coefficients;
+  APInt lookupTable;
+};
+
+FailureOr<LinearLut> getLinearLut(Operation *op) {
+  LinearLut lut;
+  LogicalResult matched =
+      llvm::TypeSwitch<Operation *, LogicalResult>(op)
+          .Case<Lut2Op>([&](Lut2Op op) {
+            lut.inputs = {op.getB(), op.getA()};
+            lut.coefficients = {2, 1};
+            lut.lookupTable = op.getLookupTable().getValue();
+            return success();
+          })
+          .Case<Lut3Op>([&](Lut3Op op) {
+            lut.inputs = {op.getC(), op.getB(), op.getA()};
+            lut.coefficients = {4, 2, 1};
+            lut.lookupTable = op.getLookupTable().getValue();
+            return success();
+          })
+          .Case<LutLinCombOp>([&](LutLinCombOp op) {
+            lut.inputs = llvm::to_vector(op.getInputs());
+            lut.coefficients = llvm::to_vector(op.getCoefficients());
+            lut.lookupTable = op.getLookupTable().getValue();
+            return success();
+          })
+          .Default([](Operation *) { return failure(); });
+  if (failed(matched)) return failure();
+  return lut;
+}
+
+// Evaluate the LUT on boolean inputs. The linear combination is computed
+// modulo the message space, as it is after cggi-expand-lut.
+bool evaluate(const LinearLut &lut, const DenseMap<Value, bool> &assignment,
+              int64_t width) {
+  uint64_t index = 0;
+  for (auto [input, coeff] : llvm::zip(lut.inputs, lut.coefficients)) {
+    if (assignment.lookup(input)) index += static_cast<uint64_t>(coeff);
+  }
+  index &= (uint64_t{1} << width) - 1;
+  return index < lut.lookupTable.getBitWidth() && lut.lookupTable[index];
+}
+
+}  // namespace
+
+// Fuse a LUT into its only user, replacing the user with a lut_lincomb over
+// the union of both input sets.
+struct FuseLutIntoUser : public RewritePattern {
+  FuseLutIntoUser(MLIRContext *context, int64_t maxInputs)
+      : RewritePattern(MatchAnyOpTypeTag(), /*benefit=*/1, context),
+        maxInputs(maxInputs) {}
+
+  LogicalResult matchAndRewrite(Operation *op,
+                                PatternRewriter &rewriter) const override {
+    FailureOr<LinearLut> consumer = getLinearLut(op);
+    if (failed(consumer)) return failure();
+
+    Type type = op->getResult(0).getType();
+    auto ctType = dyn_cast<lwe::LWECiphertextType>(getElementTypeOrSelf(type));
+    if (!ctType || !isa<lwe::BitFieldEncodingAttr,
+                        lwe::UnspecifiedBitFieldEncodingAttr>(
+                       ctType.getEncoding()))
+      return failure();
+    int64_t width = widthFromEncodingAttr(ctType.getEncoding());
+    // Each input of the fused LUT takes one cleartext bit of the index.
+    int64_t budget = std::min(width, kMaxFusedInputs);
+    if (maxInputs > 0) budget = std::min(budget, maxInputs);
+
+    for (Value operand : consumer->inputs) {
+      Operation *producerOp = operand.getDefiningOp();
+      // Fusing a LUT with other users would duplicate its bootstrap, and
+      // fusing across blocks could move it into a loop body.
+      if (!producerOp || !operand.hasOneUse() ||
+          producerOp->getBlock() != op->getBlock() ||
+          producerOp->getResult(0).getType() != type)
+        continue;
+      FailureOr<LinearLut> producer = getLinearLut(producerOp);
+      if (failed(producer)) continue;
+
+      SmallVector<Value> inputs;
+      for (Value input : consumer->inputs) {
+        if (input != operand && !llvm::is_contained(inputs, input))
+          inputs.push_back(input);
+      }
+      for (Value input : producer->inputs) {
+        if (!llvm::is_contained(inputs, input)) inputs.push_back(input);
+      }
+      int64_t numInputs = inputs.size();
+      if (numInputs > budget) continue;
+
+      // Inputs are ordered from most significant bit to least, as in lut3.
+      SmallVector<int32_t> coefficients;
+      for (int64_t i = 0; i < numInputs; ++i)
+        coefficients.push_back(1 << (numInputs - 1 - i));
+
+      uint64_t lookupTable = 0;
+      for (uint64_t index = 0; index < (uint64_t{1} << numInputs); ++index) {
+        DenseMap<Value, bool> assignment;
+        for (int64_t i = 0; i < numInputs; ++i)
+          assignment[inputs[i]] = (index >> (numInputs - 1 - i)) & 1;
+        assignment[operand] = evaluate(*producer, assignment, width);
+        if (evaluate(*consumer, assignment, width))
+          lookupTable |= uint64_t{1} << index;
+      }
+
+      rewriter.replaceOpWithNewOp<LutLinCombOp>(
+          op, type, inputs, rewriter.getDenseI32ArrayAttr(coefficients),
+          rewriter.getIndexAttr(lookupTable));
+      rewriter.eraseOp(producerOp);
+      return success();
+    }
+    return failure();
+  }
+
+ private:
+  int64_t maxInputs;
+};
+
+static void fuseLuts(Operation *root, int64_t maxInputs) {
+  MLIRContext *context = root->getContext();
+  RewritePatternSet patterns(context);
+  patterns.add<FuseLutIntoUser>(context, maxInputs);
+  (void)applyPatternsGreedily(root, std::move(patterns));
+}
+
+// Estimate the cost of bootstrapping every LUT under `root`. The CGGI
+// parameters are shared by all ciphertexts, so they are sized for the widest
+// LUT, which needs one cleartext bit per input.
+static int64_t estimateCost(Operation *root) {
+  int64_t numLuts = 0;
+  int64_t width = 1;
+  root->walk([&](Operation *op) {
+    FailureOr<LinearLut> lut = getLinearLut(op);
+    if (failed(lut)) return;
+    ++numLuts;
+    width = std::max<int64_t>(width, lut->inputs.size());
+  });
+  return numLuts * kPbsCost[std::min(width, kMaxFusedInputs)];
+}
+
+struct FuseLUTs : impl::FuseLUTsBase<FuseLUTs> {
+  using FuseLUTsBase::FuseLUTsBase;
+
+  void runOnOperation() override {
+    Operation *root = getOperation();
+    int64_t maxWidth = maxInputs > 0
+                           ? std::min<int64_t>(maxInputs, kMaxFusedInputs)
+                           : kMaxFusedInputs;
+
+    // Fusing fewer, wider LUTs saves bootstraps but may require larger
+    // parameters for every bootstrap. Fuse on a copy of the IR for each
+    // width cap, and keep the cheapest, preferring narrower LUTs on ties.
+    int64_t bestWidth = 0;
+    int64_t bestCost = estimateCost(root);
+    for (int64_t width = 2; width <= maxWidth; ++width) {
+      Operation *copy = root->clone();
+      fuseLuts(copy, width);
+      int64_t cost = estimateCost(copy);
+      copy->erase();
+      if (cost < bestCost) {
+        bestCost = cost;
+        bestWidth = width;
+      }
+    }
+    if (bestWidth > 0) fuseLuts(root, bestWidth);
+  }
+};
+
+}  // namespace cggi
+}  // namespace heir
+}  // namespace mlir
@@ -0,0 +1,157 @@
+#include "lib/Dialect/CGGI/Transforms/MergeLUTs.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <utility>
+
+#include "lib/Dialect/CGGI/IR/CGGIOps.h"
+#include "lib/Dialect/LWE/IR/LWEAttributes.h"
+#include "lib/Dialect/LWE/IR/LWETypes.h"
+#include "lib/Utils/ConversionUtils.h"
+#include "llvm/include/llvm/ADT/APInt.h"        // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"    // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"  // from @llvm-project
+#include "llvm/include/llvm/ADT/TypeSwitch.h"   // from @llvm-project
+#include "mlir/include/mlir/IR/Block.h"         // from @llvm-project
+#include "mlir/include/mlir/IR/Location.h"      // from @llvm-project
+#include "mlir/include/mlir/IR/PatternMatch.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Types.h"         // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"         // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"     // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace cggi {
+
+#define GEN_PASS_DEF_MERGELUTS
+#include "lib/Dialect/CGGI/Transforms/Passes.h.inc"
+
+namespace {
+
+// A LUT operation viewed as a lookup table applied to a linear combination of
+// its inputs.
+struct LinearLut {
+  Operation *op;
+  SmallVector<Value> inputs;
+  SmallVector<int32_t> coefficients;
+  APInt lookupTable;
+};
+
+// The inputs and coefficients of a LUT sorted by input, so that LUTs computing
+// the same linear combination with a different operand order compare equal.
+using LinearCombinationKey = SmallVector<std::pair<void *, int32_t>>;
+
+FailureOr<LinearLut> getLinearLut(Operation *op) {
+  LinearLut lut{op, {}, {}, APInt()};
+  LogicalResult matched =
+      llvm::TypeSwitch<Operation *, LogicalResult>(op)
+          .Case<Lut2Op>([&](Lut2Op op) {
+            lut.inputs = {op.getB(), op.getA()};
+            lut.coefficients = {2, 1};
+            lut.lookupTable = op.getLookupTable().getValue();
+            return success();
+          })
+          .Case<Lut3Op>([&](Lut3Op op) {
+            lut.inputs = {op.getC(), op.getB(), op.getA()};
+            lut.coefficients = {4, 2, 1};
+            lut.lookupTable = op.getLookupTable().getValue();
+            return success();
+          })
+          .Case<LutLinCombOp>([&](LutLinCombOp op) {
+            lut.inputs = llvm::to_vector(op.getInputs());
+            lut.coefficients = llvm::to_vector(op.getCoefficients());
+            lut.lookupTable = op.getLookupTable().getValue();
+            return success();
+          })
+          .Default([](Operation *) { return failure(); });
+  if (failed(matched)) return failure();
+
+  // MultiLutLinCombOp only supports scalar ciphertexts and i32 tables.
+  auto type = dyn_cast<lwe::LWECiphertextType>(op->getResult(0).getType());
+  if (!type || !isa<lwe::BitFieldEncodingAttr,
+                    lwe::UnspecifiedBitFieldEncodingAttr>(type.getEncoding()))
+    return failure();
+  if (lut.lookupTable.getActiveBits() > 31) return failure();
+  // The budget below assumes the linear combination does not wrap around.
+  if (llvm::any_of(lut.coefficients, [](int32_t c) { return c < 0; }))
+    return failure();
+  return lut;
+}
+
+// The number of lookup tables that can share one blind rotation, assuming
+// boolean inputs.
+int64_t getLutBudget(const LinearLut &lut) {
+  auto type = cast<lwe::LWECiphertextType>(lut.op->getResult(0).getType());
+  int64_t messageSpace = int64_t{1}
+                         << widthFromEncodingAttr(type.getEncoding());
+  int64_t range = 1;
+  for (int32_t c : lut.coefficients) range += c;
+  return messageSpace / range;
+}
+
+LinearCombinationKey getKey(const LinearLut &lut) {
+  LinearCombinationKey key;
+  for (auto [input, coeff] : llvm::zip(lut.inputs, lut.coefficients))
+    key.push_back({input.getAsOpaquePointer(), coeff});
+  llvm::sort(key);
+  return key;
+}
+
+}  // namespace
+
+struct MergeLUTs : impl::MergeLUTsBase<MergeLUTs> {
+  using MergeLUTsBase::MergeLUTsBase;
+
+  void runOnOperation() override {
+    // Groups of LUTs in the same block, in program order. Since all LUTs in a
+    // group have the same inputs, the inputs dominate the first LUT.
+    SmallVector<SmallVector<LinearLut>> groups;
+    getOperation()->walk([&](Block *block) {
+      std::map<LinearCombinationKey, size_t> openGroups;
+      for (Operation &op : *block) {
+        FailureOr<LinearLut> lut = getLinearLut(&op);
+        if (failed(lut)) continue;
+        int64_t budget = getLutBudget(*lut);
+        if (budget < 2) continue;
+
+        LinearCombinationKey key = getKey(*lut);
+        auto it = openGroups.find(key);
+        if (it != openGroups.end() &&
+            static_cast<int64_t>(groups[it->second].size()) < budget) {
+          groups[it->second].push_back(std::move(*lut));
+          continue;
+        }
+        openGroups[key] = groups.size();
+        groups.push_back({std::move(*lut)});
+      }
+    });
+
+    IRRewriter rewriter(&getContext());
+    for (SmallVector<LinearLut> &group : groups) {
+      if (group.size() < 2) continue;
+
+      SmallVector<Type> resultTypes;
+      SmallVector<int32_t> lookupTables;
+      SmallVector<Location> locs;
+      for (const LinearLut &lut : group) {
+        resultTypes.push_back(lut.op->getResult(0).getType());
+        lookupTables.push_back(lut.lookupTable.getZExtValue());
+        locs.push_back(lut.op->getLoc());
+      }
+
+      const LinearLut &first = group.front();
+      rewriter.setInsertionPoint(first.op);
+      auto multiLut = rewriter.create<MultiLutLinCombOp>(
+          rewriter.getFusedLoc(locs), resultTypes, first.inputs,
+          rewriter.getDenseI32ArrayAttr(first.coefficients),
+          rewriter.getDenseI32ArrayAttr(lookupTables));
+      for (auto [lut, result] : llvm::zip(group, multiLut.getOutputs()))
+        rewriter.replaceOp(lut.op, result);
+    }
+  }
+};
+
+}  // namespace cggi
+}  // namespace heir
+}  // namespace mlir
@@ -4,6 +4,8 @@
 #include "lib/Dialect/CGGI/IR/CGGIDialect.h"
 #include "lib/Dialect/CGGI/Transforms/BooleanVectorizer.h"
 #include "lib/Dialect/CGGI/Transforms/ExpandLUT.h"
+#include "lib/Dialect/CGGI/Transforms/FuseLUTs.h"
+#include "lib/Dialect/CGGI/Transforms/MergeLUTs.h"
 #include "lib/Dialect/CGGI/Transforms/SetDefaultParameters.h"
 
 namespace mlir {
@@ -4,6 +4,7 @@
 #include "lib/Analysis/LevelAnalysis/LevelAnalysis.h"
 #include "lib/Analysis/ScaleAnalysis/ScaleAnalysis.h"
 #include "lib/Analysis/SecretnessAnalysis/SecretnessAnalysis.h"
+#include "lib/Dialect/HEIRInterfaces.h"
 #include "lib/Dialect/Mgmt/IR/MgmtAttributes.h"
 #include "lib/Dialect/Mgmt/IR/MgmtDialect.h"
 #include "lib/Dialect/Mgmt/IR/MgmtOps.h"
@@ -13,13 +14,14 @@
 #include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
-#include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"     // from @llvm-project
-#include "mlir/include/mlir/IR/Attributes.h"               // from @llvm-project
-#include "mlir/include/mlir/IR/BuiltinAttributes.h"        // from @llvm-project
-#include "mlir/include/mlir/IR/Operation.h"                // from @llvm-project
-#include "mlir/include/mlir/IR/SymbolTable.h"              // from @llvm-project
-#include "mlir/include/mlir/IR/Visitors.h"                 // from @llvm-project
-#include "mlir/include/mlir/Support/LLVM.h"                // from @llvm-project
+#include "mlir/include/mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Attributes.h"            // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinAttributes.h"     // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/SymbolTable.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/Visitors.h"              // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"             // from @llvm-project
 
 namespace mlir {
 namespace heir {
@@ -78,6 +80,23 @@ void annotateMgmtAttr(Operation *top) {
                     mergeIntoMgmtAttr(levelAttr, dimensionAttr, scaleAttr));
       });
 
+      // Loops may carry values at different levels, so each result of an
+      // affine.for gets the attribute of the value yielded for it, as for
+      // secret.generic below.
+      genericOp.getBody()->walk([&](affine::AffineForOp forOp) {
+        Operation *yieldOp = forOp.getBody()->getTerminator();
+        auto resultAttrInterface = cast<OperandAndResultAttrInterface>(*forOp);
+        for (auto &opOperand : yieldOp->getOpOperands()) {
+          FailureOr<Attribute> attrResult = findAttributeAssociatedWith(
+              opOperand.get(), MgmtDialect::kArgMgmtAttrName);
+
+          if (failed(attrResult)) continue;
+          resultAttrInterface.setResultAttr(opOperand.getOperandNumber(),
+                                            MgmtDialect::kArgMgmtAttrName,
+                                            attrResult.value());
+        }
+      });
+
       // Add yielded result as attribute on secret.generic
       secret::YieldOp yieldOp = genericOp.getYieldOp();
       for (auto &opOperand : yieldOp->getOpOperands()) {
@@ -112,11 +131,19 @@ struct AnnotateMgmt : impl::AnnotateMgmtBase<AnnotateMgmt> {
   using AnnotateMgmtBase::AnnotateMgmtBase;
 
   void runOnOperation() override {
+    auto &secretness = getAnalysis<SecretnessAnalysisCache>();
+    if (failed(secretness.getStatus())) {
+      getOperation()->emitOpError() << "Failed to run the analysis.\n";
+      signalPassFailure();
+      return;
+    }
+
     DataFlowSolver solver;
     SymbolTableCollection symbolTable;
     solver.load<dataflow::DeadCodeAnalysis>();
     solver.load<dataflow::SparseConstantPropagation>();
-    solver.load<SecretnessAnalysis>();
+    // LevelAnalysis and DimensionAnalysis depend on the cached secretness
+    secretness.seedSolver(solver);
     solver.load<LevelAnalysis>();
     solver.load<LevelAnalysisBackward>(symbolTable);
     solver.load<DimensionAnalysis>();
@@ -134,6 +161,9 @@ struct AnnotateMgmt : impl::AnnotateMgmtBase<AnnotateMgmt> {
     // The optional scale is passed by annotateScale() when calling
     // this pass.
     annotateMgmtAttr(getOperation());
+
+    // Only attributes are added, so the secretness of every value is unchanged.
+    markAnalysesPreserved<SecretnessAnalysisCache>();
   }
 };
 
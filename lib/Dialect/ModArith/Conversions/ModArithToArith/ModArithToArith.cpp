@@ -246,6 +246,37 @@ struct ConvertMac : public OpConversionPattern<MacOp> {
   }
 };
 
+// Shoup multiplication by a constant w with precomputed w' = floor(w 2^W / q):
+// the quotient estimate floor(x w' / 2^W) is off by at most one, so
+// x w - floor(x w' / 2^W) q lies in [0, 2q) and can be computed in W-bit
+// wrapping arithmetic, followed by a single conditional subtraction.
+struct ConvertMulShoup : public OpConversionPattern<MulShoupOp> {
+  ConvertMulShoup(mlir::MLIRContext *context)
+      : OpConversionPattern<MulShoupOp>(context) {}
+
+  using OpConversionPattern::OpConversionPattern;
+
+  LogicalResult matchAndRewrite(
+      MulShoupOp op, OpAdaptor adaptor,
+      ConversionPatternRewriter &rewriter) const override {
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+
+    auto cmod = b.create<arith::ConstantOp>(modulusAttr(op));
+    auto quotient = b.create<arith::MulUIExtendedOp>(adaptor.getLhs(),
+                                                     adaptor.getRhsShoup());
+    auto product = b.create<arith::MulIOp>(adaptor.getLhs(), adaptor.getRhs());
+    auto quotientTimesMod = b.create<arith::MulIOp>(quotient.getHigh(), cmod);
+    auto remainder = b.create<arith::SubIOp>(product, quotientTimesMod);
+    auto geq =
+        b.create<arith::CmpIOp>(arith::CmpIPredicate::uge, remainder, cmod);
+    auto sub = b.create<arith::SubIOp>(remainder, cmod);
+    auto select = b.create<arith::SelectOp>(geq, sub, remainder);
+
+    rewriter.replaceOp(op, select);
+    return success();
+  }
+};
+
 namespace rewrites {
 // In an inner namespace to avoid conflicts with canonicalization patterns
 #include "lib/Dialect/ModArith/Conversions/ModArithToArith/ModArithToArith.cpp.inc"
@@ -329,9 +360,10 @@ void ModArithToArith::runOnOperation() {
   rewrites::populateWithGenerated(patterns);
   patterns
       .add<ConvertEncapsulate, ConvertExtract, ConvertReduce, ConvertAdd,
-           ConvertSub, ConvertMul, ConvertMac, ConvertBarrettReduce,
-           ConvertConstant, ConvertAny<>, ConvertAny<affine::AffineForOp>,
-           ConvertAny<affine::AffineYieldOp>, ConvertAny<linalg::GenericOp> >(
+           ConvertSub, ConvertMul, ConvertMac, ConvertMulShoup,
+           ConvertBarrettReduce, ConvertConstant, ConvertAny<>,
+           ConvertAny<affine::AffineForOp>, ConvertAny<affine::AffineYieldOp>,
+           ConvertAny<linalg::GenericOp> >(
           typeConverter, context);
 
   addStructuralConversionPatterns(typeConverter, patterns, target);
@@ -87,6 +87,15 @@ LogicalResult MacOp::verify() {
   return verifyModArithType(*this, getResultModArithType(*this));
 }
 
+LogicalResult MulShoupOp::verify() {
+  auto modArithType = getResultModArithType(*this);
+  auto result = verifySameWidth(
+      *this, modArithType,
+      cast<IntegerType>(getElementTypeOrSelf(getRhsShoup().getType())));
+  if (result.failed()) return result;
+  return verifyModArithType(*this, modArithType);
+}
+
 LogicalResult BarrettReduceOp::verify() {
   auto inputType = getInput().getType();
   unsigned bitWidth;
@@ -18,7 +18,10 @@
 #include "lib/Dialect/Openfhe/IR/OpenfheTypes.h"
 #include "lib/Dialect/RNS/IR/RNSTypes.h"
 #include "lib/Utils/TransformUtils.h"
+#include "llvm/include/llvm/ADT/STLExtras.h"           // from @llvm-project
+#include "llvm/include/llvm/ADT/StringExtras.h"         // from @llvm-project
 #include "llvm/include/llvm/Support/raw_ostream.h"      // from @llvm-project
+#include "llvm/include/llvm/Support/xxhash.h"           // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinAttributes.h"     // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinOps.h"            // from @llvm-project
@@ -204,6 +207,101 @@ struct ConfigureCryptoContext
     return success();
   }
 
+  // Derive a key identifying the serialized crypto context and keys. It covers
+  // every parameter that affects the generated context or the set of
+  // evaluation keys, so a changed configuration never loads stale keys. A
+  // stable hash is used so that the key is identical across compilations.
+  std::string getKeyCacheId(func::FuncOp op) {
+    std::string description;
+    llvm::raw_string_ostream os(description);
+    os << "mulDepth=" << config.mulDepth
+       << ";plainMod=" << config.plaintextModulus
+       << ";ringDim=" << config.ringDim << ";batchSize=" << config.batchSize
+       << ";firstModSize=" << config.firstModSize
+       << ";scalingModSize=" << config.scalingModSize
+       << ";evalAddCount=" << config.evalAddCount
+       << ";keySwitchCount=" << config.keySwitchCount
+       << ";digitSize=" << config.digitSize
+       << ";numLargeDigits=" << config.numLargeDigits
+       << ";maxRelinSkDeg=" << config.maxRelinSkDeg
+       << ";insecure=" << config.insecure
+       << ";encryptionTechniqueExtended="
+       << config.encryptionTechniqueExtended
+       << ";keySwitchingTechniqueBV=" << config.keySwitchingTechniqueBV
+       << ";scalingTechniqueFixedManual="
+       << config.scalingTechniqueFixedManual
+       << ";relin=" << config.hasRelinOp
+       << ";bootstrap=" << config.hasBootstrapOp;
+    if (config.hasBootstrapOp) {
+      os << ";levelBudgetEncode=" << config.levelBudgetEncode
+         << ";levelBudgetDecode=" << config.levelBudgetDecode;
+    }
+    os << ";rotIndices=";
+    llvm::interleave(config.rotIndices, os, ",");
+
+    std::string key(op.getSymName());
+    key += "_";
+    key += llvm::utohexstr(llvm::xxh3_64bits(description), /*LowerCase=*/true,
+                           /*Width=*/16);
+    return key;
+  }
+
+  // function that serializes the configured crypto context and its keys
+  LogicalResult generateSaveFunc(func::FuncOp op,
+                                 const std::string &saveFuncName,
+                                 const std::string &key,
+                                 ImplicitLocOpBuilder &builder) {
+    Type openfheContextType =
+        openfhe::CryptoContextType::get(builder.getContext());
+    SmallVector<Type> funcArgTypes;
+    funcArgTypes.push_back(openfheContextType);
+    SmallVector<Type> funcResultTypes;
+    funcResultTypes.push_back(openfheContextType);
+
+    FunctionType saveFuncType =
+        FunctionType::get(builder.getContext(), funcArgTypes, funcResultTypes);
+    auto saveFuncOp = builder.create<func::FuncOp>(saveFuncName, saveFuncType);
+    builder.setInsertionPointToEnd(saveFuncOp.addEntryBlock());
+
+    Value cryptoContext = saveFuncOp.getArgument(0);
+    builder.create<openfhe::SaveCryptoContextOp>(cryptoContext, key);
+    builder.create<func::ReturnOp>(cryptoContext);
+    return success();
+  }
+
+  // function that deserializes a crypto context and its keys, replacing both
+  // __generate_crypto_context and __configure_crypto_context
+  LogicalResult generateLoadFunc(func::FuncOp op,
+                                 const std::string &loadFuncName,
+                                 const std::string &key,
+                                 ImplicitLocOpBuilder &builder) {
+    Type openfheContextType =
+        openfhe::CryptoContextType::get(builder.getContext());
+    SmallVector<Type> funcArgTypes;
+    SmallVector<Type> funcResultTypes;
+    funcResultTypes.push_back(openfheContextType);
+
+    FunctionType loadFuncType =
+        FunctionType::get(builder.getContext(), funcArgTypes, funcResultTypes);
+    auto loadFuncOp = builder.create<func::FuncOp>(loadFuncName, loadFuncType);
+    builder.setInsertionPointToEnd(loadFuncOp.addEntryBlock());
+
+    Value cryptoContext = builder.create<openfhe::LoadCryptoContextOp>(
+        openfheContextType, key);
+    // The bootstrapping precomputations are not serialized with the keys.
+    if (config.hasBootstrapOp) {
+      builder.create<openfhe::SetupBootstrapOp>(
+          cryptoContext,
+          IntegerAttr::get(IndexType::get(builder.getContext()),
+                           config.levelBudgetEncode),
+          IntegerAttr::get(IndexType::get(builder.getContext()),
+                           config.levelBudgetDecode));
+    }
+
+    builder.create<func::ReturnOp>(cryptoContext);
+    return success();
+  }
+
   LogicalResult convertFunc(func::FuncOp op) {
     auto module = op->getParentOfType<ModuleOp>();
     std::string genFuncName("");
@@ -226,6 +324,26 @@ struct ConfigureCryptoContext
     if (failed(generateConfigFunc(op, configFuncName, builder))) {
       return failure();
     }
+
+    if (!emitKeyCache) {
+      return success();
+    }
+
+    std::string key = getKeyCacheId(op);
+    std::string saveFuncName =
+        (op.getSymName() + "__save_crypto_context").str();
+    std::string loadFuncName =
+        (op.getSymName() + "__load_crypto_context").str();
+
+    builder.setInsertionPointToEnd(module.getBody());
+    if (failed(generateSaveFunc(op, saveFuncName, key, builder))) {
+      return failure();
+    }
+
+    builder.setInsertionPointToEnd(module.getBody());
+    if (failed(generateLoadFunc(op, loadFuncName, key, builder))) {
+      return failure();
+    }
     return success();
   }
 
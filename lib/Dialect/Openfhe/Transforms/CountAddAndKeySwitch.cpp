@@ -26,10 +26,18 @@ struct CountAddAndKeySwitch
       return;
     }
 
+    auto &secretness = getAnalysis<SecretnessAnalysisCache>();
+    if (failed(secretness.getStatus())) {
+      getOperation()->emitOpError() << "Failed to run the analysis.\n";
+      signalPassFailure();
+      return;
+    }
+
     DataFlowSolver solver;
     solver.load<dataflow::DeadCodeAnalysis>();
     solver.load<dataflow::SparseConstantPropagation>();
-    solver.load<SecretnessAnalysis>();
+    // CountAnalysis depends on the cached secretness
+    secretness.seedSolver(solver);
 
     // calculate addCount/keySwitchCount
     solver.load<CountAnalysis>();
@@ -39,6 +47,9 @@ struct CountAddAndKeySwitch
       return;
     }
     annotateCount(getOperation(), &solver);
+
+    // Only attributes are added, so the secretness of every value is unchanged.
+    markAnalysesPreserved<SecretnessAnalysisCache>();
   }
 };
 }  // namespace openfhe
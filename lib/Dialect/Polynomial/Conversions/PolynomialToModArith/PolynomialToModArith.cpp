@@ -43,6 +43,7 @@
 #include "mlir/include/mlir/IR/OpDefinition.h"           // from @llvm-project
 #include "mlir/include/mlir/IR/PatternMatch.h"           // from @llvm-project
 #include "mlir/include/mlir/IR/TypeRange.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/TypeUtilities.h"          // from @llvm-project
 #include "mlir/include/mlir/IR/ValueRange.h"             // from @llvm-project
 #include "mlir/include/mlir/IR/Visitors.h"               // from @llvm-project
 #include "mlir/include/mlir/Support/LLVM.h"              // from @llvm-project
@@ -901,24 +902,63 @@ static SmallVector<APInt> precomputeRoots(APInt root, const APInt &cmod,
   return vals;
 }
 
-static Value computeReverseBitOrder(ImplicitLocOpBuilder &b,
-                                    RankedTensorType tensorType, Type modType,
-                                    Value tensor) {
-  unsigned degree = tensorType.getShape()[0];
+// Gather the twiddle factors used by each stage of fastNTT into one contiguous
+// table. The stage with butterfly batch size m (m = 2, 4, ..., degree) uses
+// the m / 2 factors roots[(2 * j + 1) * (degree / m)] for j in [0, m / 2),
+// which are stored at offset m / 2 - 1, so the innermost loop of each stage
+// reads consecutive entries.
+static SmallVector<APInt> precomputeStageTwiddles(ArrayRef<APInt> roots,
+                                                  unsigned degree) {
+  SmallVector<APInt> twiddles;
+  twiddles.reserve(degree - 1);
+  for (unsigned m = 2; m <= degree; m *= 2) {
+    unsigned rootExp = degree / m;
+    for (unsigned j = 0; j < m / 2; j++) {
+      twiddles.push_back(roots[(2 * j + 1) * rootExp]);
+    }
+  }
+  return twiddles;
+}
+
+// Compute the Shoup companion floor(w * 2^W / cmod) of each value w, where W
+// is the bit width of cmod. See mod_arith.mul_shoup.
+static SmallVector<APInt> precomputeShoup(ArrayRef<APInt> values,
+                                          const APInt &cmod) {
+  unsigned width = cmod.getBitWidth();
+  APInt wideMod = cmod.zext(2 * width);
+  SmallVector<APInt> result;
+  result.reserve(values.size());
+  for (const APInt &value : values) {
+    APInt wide = value.zext(2 * width).shl(width);
+    result.push_back(wide.udiv(wideMod).trunc(width));
+  }
+  return result;
+}
+
+// A tensor<degree x index> mapping each index to its bit reversal.
+static Value getReverseBitOrderIndices(ImplicitLocOpBuilder &b,
+                                       unsigned degree) {
   double degreeLog = std::log2((double)degree);
   assert(std::floor(degreeLog) == degreeLog &&
          "expected the degree to be a power of 2");
 
   unsigned indexBitWidth = (unsigned)degreeLog;
-  auto indicesType = RankedTensorType::get(tensorType.getShape(),
-                                           IndexType::get(b.getContext()));
+  auto indicesType =
+      RankedTensorType::get({degree}, IndexType::get(b.getContext()));
 
   SmallVector<APInt> _indices(degree);
   for (unsigned index = 0; index < degree; index++) {
     _indices[index] = APInt(indexBitWidth, index).reverseBits();
   }
-  auto indices = b.create<arith::ConstantOp>(
+  return b.create<arith::ConstantOp>(
       indicesType, DenseElementsAttr::get(indicesType, _indices));
+}
+
+static Value computeReverseBitOrder(ImplicitLocOpBuilder &b,
+                                    RankedTensorType tensorType, Type modType,
+                                    Value tensor) {
+  unsigned degree = tensorType.getShape()[0];
+  Value indices = getReverseBitOrderIndices(b, degree);
 
   SmallVector<utils::IteratorType> iteratorTypes(1,
                                                  utils::IteratorType::parallel);
@@ -931,7 +971,7 @@ static Value computeReverseBitOrder(ImplicitLocOpBuilder &b,
   auto modOut = b.create<mod_arith::EncapsulateOp>(modType, out);
   auto shuffleOp = b.create<linalg::GenericOp>(
       /*resultTypes=*/TypeRange{modType},
-      /*inputs=*/ValueRange{indices.getResult()},
+      /*inputs=*/ValueRange{indices},
       /*outputs=*/ValueRange{modOut.getResult()},
       /*indexingMaps=*/indexingMaps,
       /*iteratorTypes=*/iteratorTypes,
@@ -945,103 +985,157 @@ static Value computeReverseBitOrder(ImplicitLocOpBuilder &b,
   return shuffleOp.getResult(0);
 }
 
+// Transpose a rank-2 tensor, converting a tensor<k x n> of k polynomials to
+// the tensor<n x k> layout of a batched NTT and back. If bitReversedDim is
+// set, the result is also permuted into bit-reversed order along that
+// dimension, e.g., result[i][j] = tensor[j][rev(i)] for bitReversedDim = 0.
+static Value transposeBatch(ImplicitLocOpBuilder &b, Value tensor,
+                            std::optional<unsigned> bitReversedDim) {
+  auto tensorType = cast<RankedTensorType>(tensor.getType());
+  SmallVector<int64_t> resultShape = {tensorType.getDimSize(1),
+                                      tensorType.getDimSize(0)};
+  Value indices;
+  if (bitReversedDim.has_value())
+    indices =
+        getReverseBitOrderIndices(b, resultShape[bitReversedDim.value()]);
+
+  auto out = b.create<tensor::EmptyOp>(resultShape,
+                                       tensorType.getElementType());
+  SmallVector<utils::IteratorType> iteratorTypes(2,
+                                                 utils::IteratorType::parallel);
+  SmallVector<AffineMap> indexingMaps = {
+      AffineMap::getMultiDimIdentityMap(2, b.getContext())};
+  auto transposeOp = b.create<linalg::GenericOp>(
+      /*resultTypes=*/TypeRange{out.getType()},
+      /*inputs=*/ValueRange{},
+      /*outputs=*/ValueRange{out.getResult()},
+      /*indexingMaps=*/indexingMaps,
+      /*iteratorTypes=*/iteratorTypes,
+      /*bodyBuilder=*/
+      [&](OpBuilder &nestedBuilder, Location nestedLoc, ValueRange args) {
+        ImplicitLocOpBuilder b(nestedLoc, nestedBuilder);
+        SmallVector<Value> resultIndices = {b.create<linalg::IndexOp>(0),
+                                            b.create<linalg::IndexOp>(1)};
+        if (bitReversedDim.has_value()) {
+          Value &index = resultIndices[bitReversedDim.value()];
+          index = b.create<tensor::ExtractOp>(indices, index);
+        }
+        auto elem = b.create<tensor::ExtractOp>(
+            tensor, ValueRange{resultIndices[1], resultIndices[0]});
+        b.create<linalg::YieldOp>(elem.getResult());
+      });
+  return transposeOp.getResult(0);
+}
+
 static std::pair<Value, Value> bflyCT(ImplicitLocOpBuilder &b, Value A, Value B,
-                                      Value root) {
-  auto rootB = b.create<mod_arith::MulOp>(B, root);
+                                      Value root, Value rootShoup) {
+  auto rootB = b.create<mod_arith::MulShoupOp>(B, root, rootShoup);
   auto ctPlus = b.create<mod_arith::AddOp>(A, rootB);
   auto ctMinus = b.create<mod_arith::SubOp>(A, rootB);
   return {ctPlus, ctMinus};
 }
 
 static std::pair<Value, Value> bflyGS(ImplicitLocOpBuilder &b, Value A, Value B,
-                                      Value root) {
+                                      Value root, Value rootShoup) {
   auto gsPlus = b.create<mod_arith::AddOp>(A, B);
   auto gsMinus = b.create<mod_arith::SubOp>(A, B);
-  auto gsMinusRoot = b.create<mod_arith::MulOp>(gsMinus, root);
+  auto gsMinusRoot = b.create<mod_arith::MulShoupOp>(gsMinus, root, rootShoup);
   return {gsPlus, gsMinusRoot};
 }
 
-template <bool inverse>
-static Value fastNTT(ImplicitLocOpBuilder &b, RingAttr ring,
-                     PrimitiveRootAttr rootAttr, RankedTensorType tensorType,
-                     Type modType, Value input) {
-  // Compute the number of stages required to compute the NTT
-  auto degree = tensorType.getShape()[0];
-  unsigned stages = (unsigned)std::log2((double)degree);
+struct NTTLoweringOptions {
+  NTTSchedule schedule = NTTSchedule::Automatic;
+  int64_t blockBytes = 32768;
+};
 
-  // Precompute the roots
-  auto modArithType = cast<ModArithType>(ring.getCoefficientType());
-  APInt cmod = modArithType.getModulus().getValue();
-  APInt root = rootAttr.getValue().getValue();
-  root = !inverse ? root
-                  : multiplicativeInverse(root.zext(cmod.getBitWidth()), cmod)
-                        .trunc(root.getBitWidth());
-  // Initialize the mod_arith roots constant
-  auto rootsType = tensorType.clone({degree});
-  Value roots = b.create<arith::ConstantOp>(
-      rootsType,
-      DenseElementsAttr::get(rootsType, precomputeRoots(root, cmod, degree)));
-  roots = b.create<mod_arith::EncapsulateOp>(modType, roots);
+// The precomputed twiddle table and Shoup companions shared by all stages of
+// one NTT. See fastNTT for the layout.
+//
+// A batched NTT transforms numPolys polynomials at once, stored as a
+// tensor<n x numPolys> with the batch innermost. Its butterflies then operate
+// on whole rows of numPolys coefficients, and each twiddle is loaded once and
+// broadcast across the row.
+struct NTTTwiddles {
+  Value twiddles;
+  Value twiddlesShoup;
+  // The twiddles before encapsulation, used to broadcast a twiddle to a row.
+  Value twiddlesInt;
+  RankedTensorType rowType;
+  int64_t numPolys = 0;
+
+  bool isBatched() const { return numPolys > 0; }
+};
 
-  // Here is a slightly modified implementation of the standard iterative NTT
-  // computation using Cooley-Turkey/Gentleman-Sande butterfly. For reader
-  // reference: https://doi.org/10.1007/978-3-031-46077-7_22, and,
-  // https://doi.org/10.1109/ACCESS.2023.3294446
-  //
-  // We modify the standard implementation by pre-computing the root
-  // exponential values during compilation instead of doing so at runtime.
-  //
-  // Let roots be a tensor of <n x ix> where roots[i] = \psi^i, n be the
-  // degree of the polynomial and inverse denote the direction. Then we
-  // implement the following:
-  //
-  // def fastNTT(coeffs, n, cmod, roots, inverse):
-  //  m = inverse ? n : 2             # m denotes the batchSize or stride
-  //  r = inverse ? 1 : degree / 2    # r denotes the exponent of the root
-  //  for (s = 0; s < log2(n); s++):
-  //    for (k = 0; k < n / m; k++):
-  //      for (j = 0; j < m / 2; j++):
-  //        A = coeffs[k * m + j]
-  //        B = coeffs[k * m + j + m / 2]
-  //        root = roots[(2 * j + 1) * rootExp]
-  //        coeffs[k * m + j], coeffs[k * m + j + m / 2]
-  //          = bflyOp(A, B, root, cmod)
-  //      end
-  //    end
-  //    m = inverse ? m / 2 : m * 2
-  //    r = inverse ? r * 2 : m / 2
-  //  end
-  //
-  //  where bflyOp is one of:
-  //    bflyCT(A, B, root, cmod):
-  //      (A + root * B % cmod, A - root * B % cmod)
-  //
-  //    bflyGS(A, B, root, cmod):
-  //      (A + B % cmod, (A - B) * root % cmod)
+static std::pair<Value, Value> extractTwiddle(ImplicitLocOpBuilder &b,
+                                              const NTTTwiddles &tw,
+                                              Value index) {
+  Value rootShoup = b.create<tensor::ExtractOp>(tw.twiddlesShoup, index);
+  if (!tw.isBatched()) {
+    Value root = b.create<tensor::ExtractOp>(tw.twiddles, index);
+    return {root, rootShoup};
+  }
+  Value rootInt = b.create<tensor::ExtractOp>(tw.twiddlesInt, index);
+  auto intRowType = tw.rowType.clone(rootInt.getType());
+  Value root = b.create<mod_arith::EncapsulateOp>(
+      tw.rowType, b.create<tensor::SplatOp>(rootInt, intRowType));
+  rootShoup = b.create<tensor::SplatOp>(rootShoup, intRowType);
+  return {root, rootShoup};
+}
 
-  // Initialize the variables
-  Value initialValue = b.create<mod_arith::ReduceOp>(input);
-  Value initialBatchSize =
-      b.create<arith::ConstantIndexOp>(inverse ? degree : 2);
-  Value initialRootExp =
-      b.create<arith::ConstantIndexOp>(inverse ? 1 : degree / 2);
+static SmallVector<OpFoldResult> getRowOffsets(ImplicitLocOpBuilder &b,
+                                               Value index) {
+  return {index, b.getIndexAttr(0)};
+}
+
+static SmallVector<OpFoldResult> getRowSizes(ImplicitLocOpBuilder &b,
+                                             const NTTTwiddles &tw) {
+  return {b.getIndexAttr(1), b.getIndexAttr(tw.numPolys)};
+}
+
+// Load the coefficient at `index`, or the row of coefficients at `index` for a
+// batched NTT.
+static Value loadCoeff(ImplicitLocOpBuilder &b, const NTTTwiddles &tw,
+                       Value target, Value index) {
+  if (!tw.isBatched()) return b.create<tensor::ExtractOp>(target, index);
+  SmallVector<OpFoldResult> strides(2, b.getIndexAttr(1));
+  return b.create<tensor::ExtractSliceOp>(tw.rowType, target,
+                                          getRowOffsets(b, index),
+                                          getRowSizes(b, tw), strides);
+}
+
+static Value storeCoeff(ImplicitLocOpBuilder &b, const NTTTwiddles &tw,
+                        Value value, Value target, Value index) {
+  if (!tw.isBatched())
+    return b.create<tensor::InsertOp>(value, target, index);
+  SmallVector<OpFoldResult> strides(2, b.getIndexAttr(1));
+  return b.create<tensor::InsertSliceOp>(value, target,
+                                         getRowOffsets(b, index),
+                                         getRowSizes(b, tw), strides);
+}
+
+// Emit numStages radix-2 stages over `input`, a tensor of `extent`
+// coefficients, starting from butterfly batch size firstBatchSize.
+template <bool inverse>
+static Value emitRadix2Stages(ImplicitLocOpBuilder &b, const NTTTwiddles &tw,
+                              Value input, int64_t extent,
+                              int64_t firstBatchSize, unsigned numStages) {
+  Value initialBatchSize = b.create<arith::ConstantIndexOp>(firstBatchSize);
   Value zero = b.create<arith::ConstantIndexOp>(0);
   Value two = b.create<arith::ConstantIndexOp>(2);
-  Value n = b.create<arith::ConstantIndexOp>(degree);
+  Value n = b.create<arith::ConstantIndexOp>(extent);
 
   // Define index affine mappings
   AffineExpr x, y;
   bindDims(b.getContext(), x, y);
 
   auto stagesLoop = b.create<affine::AffineForOp>(
-      /*lowerBound=*/0, /* upperBound=*/stages, /*step=*/1,
-      /*iterArgs=*/ValueRange{initialValue, initialBatchSize, initialRootExp},
+      /*lowerBound=*/0, /* upperBound=*/numStages, /*step=*/1,
+      /*iterArgs=*/ValueRange{input, initialBatchSize},
       /*bodyBuilder=*/
       [&](OpBuilder &nestedBuilder, Location nestedLoc, Value index,
           ValueRange args) {
         ImplicitLocOpBuilder b(nestedLoc, nestedBuilder);
         Value batchSize = args[1];
-        Value rootExp = args[2];
 
         auto innerLoop = b.create<affine::AffineForOp>(
             /*lbOperands=*/zero, /*lbMap=*/AffineMap::get(1, 0, x),
@@ -1070,28 +1164,29 @@ static Value fastNTT(ImplicitLocOpBuilder &b, RingAttr ring,
                     // Get A
                     Value indexA = b.create<affine::AffineApplyOp>(
                         x + y, ValueRange{indexJ, indexK});
-                    Value A = b.create<tensor::ExtractOp>(target, indexA);
+                    Value A = loadCoeff(b, tw, target, indexA);
 
                     // Get B
                     Value indexB = b.create<affine::AffineApplyOp>(
                         x + y.floorDiv(2), ValueRange{indexA, batchSize});
-                    Value B = b.create<tensor::ExtractOp>(target, indexB);
+                    Value B = loadCoeff(b, tw, target, indexB);
 
-                    // Get root
+                    // Get root and its Shoup companion
                     Value rootIndex = b.create<affine::AffineApplyOp>(
-                        (2 * x + 1) * y, ValueRange{indexJ, rootExp});
-                    Value root = b.create<tensor::ExtractOp>(roots, rootIndex);
+                        x + y.floorDiv(2) - 1, ValueRange{indexJ, batchSize});
+                    auto [root, rootShoup] = extractTwiddle(b, tw, rootIndex);
 
-                    auto bflyResult =
-                        inverse ? bflyGS(b, A, B, root) : bflyCT(b, A, B, root);
+                    auto bflyResult = inverse
+                                          ? bflyGS(b, A, B, root, rootShoup)
+                                          : bflyCT(b, A, B, root, rootShoup);
 
                     // Store updated values into accumulator
-                    auto insertPlus = b.create<tensor::InsertOp>(
-                        bflyResult.first, target, indexA);
-                    auto insertMinus = b.create<tensor::InsertOp>(
-                        bflyResult.second, insertPlus, indexB);
+                    Value insertPlus =
+                        storeCoeff(b, tw, bflyResult.first, target, indexA);
+                    Value insertMinus = storeCoeff(b, tw, bflyResult.second,
+                                                   insertPlus, indexB);
 
-                    b.create<affine::AffineYieldOp>(insertMinus.getResult());
+                    b.create<affine::AffineYieldOp>(insertMinus);
                   });
 
               b.create<affine::AffineYieldOp>(arithLoop.getResult(0));
@@ -1101,14 +1196,356 @@ static Value fastNTT(ImplicitLocOpBuilder &b, RingAttr ring,
                         ? b.create<arith::DivUIOp>(batchSize, two).getResult()
                         : b.create<arith::MulIOp>(batchSize, two).getResult();
 
-        rootExp = inverse ? b.create<arith::MulIOp>(rootExp, two).getResult()
-                          : b.create<arith::DivUIOp>(rootExp, two).getResult();
+        b.create<affine::AffineYieldOp>(
+            ValueRange{innerLoop.getResult(0), batchSize});
+      });
+
+  return stagesLoop.getResult(0);
+}
+
+// Emit numPairs radix-4 passes over `input`, a tensor of `extent`
+// coefficients, starting from butterfly batch size firstBatchSize. Each pass
+// fuses two consecutive radix-2 stages, so every coefficient is loaded and
+// stored once per two stages.
+//
+// With quarter size Q, a pass loads a_i = coeffs[k * 4Q + j + i * Q] for
+// i in [0, 4) and j in [0, Q), and applies the butterflies of the stages with
+// batch sizes 2Q and 4Q, whose twiddles are twiddles[Q - 1 + j] for the
+// former and twiddles[2Q - 1 + j], twiddles[3Q - 1 + j] for the latter:
+//
+//   forward (2Q then 4Q):  (a0, a1), (a2, a3), then (a0, a2), (a1, a3)
+//   inverse (4Q then 2Q):  (a0, a2), (a1, a3), then (a0, a1), (a2, a3)
+template <bool inverse>
+static Value emitRadix4Stages(ImplicitLocOpBuilder &b, const NTTTwiddles &tw,
+                              Value input, int64_t extent,
+                              int64_t firstBatchSize, unsigned numPairs) {
+  Value initialQuarter = b.create<arith::ConstantIndexOp>(
+      inverse ? firstBatchSize / 4 : firstBatchSize / 2);
+  Value zero = b.create<arith::ConstantIndexOp>(0);
+  Value four = b.create<arith::ConstantIndexOp>(4);
+  Value n = b.create<arith::ConstantIndexOp>(extent);
+
+  AffineExpr x, y;
+  bindDims(b.getContext(), x, y);
+
+  auto butterfly = [&](ImplicitLocOpBuilder &b, SmallVector<Value> &values,
+                       int lhs, int rhs, Value rootIndex) {
+    auto [root, rootShoup] = extractTwiddle(b, tw, rootIndex);
+    auto bflyResult =
+        inverse ? bflyGS(b, values[lhs], values[rhs], root, rootShoup)
+                : bflyCT(b, values[lhs], values[rhs], root, rootShoup);
+    values[lhs] = bflyResult.first;
+    values[rhs] = bflyResult.second;
+  };
+
+  auto stagesLoop = b.create<affine::AffineForOp>(
+      /*lowerBound=*/0, /* upperBound=*/numPairs, /*step=*/1,
+      /*iterArgs=*/ValueRange{input, initialQuarter},
+      /*bodyBuilder=*/
+      [&](OpBuilder &nestedBuilder, Location nestedLoc, Value index,
+          ValueRange args) {
+        ImplicitLocOpBuilder b(nestedLoc, nestedBuilder);
+        Value quarter = args[1];
+
+        auto innerLoop = b.create<affine::AffineForOp>(
+            /*lbOperands=*/zero, /*lbMap=*/AffineMap::get(1, 0, x),
+            /*ubOperands=*/ValueRange{n, quarter},
+            /*ubMap=*/AffineMap::get(2, 0, x.floorDiv(y * 4)),
+            /*step=*/1, /*iterArgs=*/args[0],
+            /*bodyBuilder=*/
+            [&](OpBuilder &nestedBuilder, Location nestedLoc, Value index,
+                ValueRange args) {
+              ImplicitLocOpBuilder b(nestedLoc, nestedBuilder);
+              Value indexK = b.create<affine::AffineApplyOp>(
+                  x * y * 4, ValueRange{quarter, index});
+
+              auto arithLoop = b.create<affine::AffineForOp>(
+                  /*lbOperands=*/zero, /*lbMap=*/AffineMap::get(1, 0, x),
+                  /*ubOperands=*/quarter, /*ubMap=*/AffineMap::get(1, 0, x),
+                  /*step=*/1, /*iterArgs=*/args[0],
+                  /*bodyBuilder=*/
+                  [&](OpBuilder &nestedBuilder, Location nestedLoc,
+                      Value indexJ, ValueRange args) {
+                    ImplicitLocOpBuilder b(nestedLoc, nestedBuilder);
+
+                    Value target = args[0];
+                    Value index0 = b.create<affine::AffineApplyOp>(
+                        x + y, ValueRange{indexJ, indexK});
+                    SmallVector<Value> indices = {index0};
+                    for (int i = 1; i < 4; ++i) {
+                      indices.push_back(b.create<affine::AffineApplyOp>(
+                          x + y * i, ValueRange{index0, quarter}));
+                    }
+                    SmallVector<Value> values;
+                    for (Value index : indices) {
+                      values.push_back(loadCoeff(b, tw, target, index));
+                    }
+
+                    Value lowIndex = b.create<affine::AffineApplyOp>(
+                        x + y - 1, ValueRange{indexJ, quarter});
+                    Value highIndex0 = b.create<affine::AffineApplyOp>(
+                        x + y * 2 - 1, ValueRange{indexJ, quarter});
+                    Value highIndex1 = b.create<affine::AffineApplyOp>(
+                        x + y * 3 - 1, ValueRange{indexJ, quarter});
+
+                    if (inverse) {
+                      butterfly(b, values, 0, 2, highIndex0);
+                      butterfly(b, values, 1, 3, highIndex1);
+                      butterfly(b, values, 0, 1, lowIndex);
+                      butterfly(b, values, 2, 3, lowIndex);
+                    } else {
+                      butterfly(b, values, 0, 1, lowIndex);
+                      butterfly(b, values, 2, 3, lowIndex);
+                      butterfly(b, values, 0, 2, highIndex0);
+                      butterfly(b, values, 1, 3, highIndex1);
+                    }
+
+                    for (int i = 0; i < 4; ++i) {
+                      target =
+                          storeCoeff(b, tw, values[i], target, indices[i]);
+                    }
+                    b.create<affine::AffineYieldOp>(target);
+                  });
+
+              b.create<affine::AffineYieldOp>(arithLoop.getResult(0));
+            });
+
+        quarter = inverse
+                      ? b.create<arith::DivUIOp>(quarter, four).getResult()
+                      : b.create<arith::MulIOp>(quarter, four).getResult();
 
         b.create<affine::AffineYieldOp>(
-            ValueRange{innerLoop.getResult(0), batchSize, rootExp});
+            ValueRange{innerLoop.getResult(0), quarter});
       });
 
-  Value result = stagesLoop.getResult(0);
+  return stagesLoop.getResult(0);
+}
+
+// Emit numStages consecutive stages over `input`, a tensor of `extent`
+// coefficients, starting from butterfly batch size firstBatchSize. With
+// radix-4, an odd stage count is handled by a single radix-2 stage at the
+// smallest batch size.
+template <bool inverse>
+static Value emitStages(ImplicitLocOpBuilder &b, const NTTTwiddles &tw,
+                        Value input, int64_t extent, int64_t firstBatchSize,
+                        unsigned numStages, bool radix4) {
+  if (numStages == 0) return input;
+  if (!radix4)
+    return emitRadix2Stages<inverse>(b, tw, input, extent, firstBatchSize,
+                                     numStages);
+
+  Value result = input;
+  if (!inverse && numStages % 2 == 1) {
+    result = emitRadix2Stages<inverse>(b, tw, result, extent, firstBatchSize,
+                                       /*numStages=*/1);
+    firstBatchSize *= 2;
+  }
+  unsigned numPairs = numStages / 2;
+  if (numPairs > 0) {
+    result = emitRadix4Stages<inverse>(b, tw, result, extent, firstBatchSize,
+                                       numPairs);
+  }
+  if (inverse && numStages % 2 == 1) {
+    result = emitRadix2Stages<inverse>(b, tw, result, extent,
+                                       firstBatchSize >> (2 * numPairs),
+                                       /*numStages=*/1);
+  }
+  return result;
+}
+
+// Emit all stages with a cache-blocked schedule. The stages with batch size
+// at most blockSize only combine coefficients within aligned blocks of
+// blockSize coefficients, so they are run block by block on an extracted
+// slice that stays resident in L1, and only the remaining stages sweep the
+// whole tensor. The forward transform runs the block-local stages first, the
+// inverse transform last.
+template <bool inverse>
+static Value emitBlockedStages(ImplicitLocOpBuilder &b, const NTTTwiddles &tw,
+                               Value input, int64_t degree, int64_t blockSize,
+                               bool radix4) {
+  unsigned localStages = (unsigned)std::log2((double)blockSize);
+  unsigned globalStages = (unsigned)std::log2((double)degree) - localStages;
+  auto tensorType = cast<RankedTensorType>(input.getType());
+  SmallVector<int64_t> blockShape(tensorType.getShape());
+  blockShape[0] = blockSize;
+  auto blockType = tensorType.clone(blockShape);
+
+  Value result = input;
+  if (inverse) {
+    result = emitStages<inverse>(b, tw, result, degree, degree, globalStages,
+                                 radix4);
+  }
+
+  AffineExpr x;
+  bindDims(b.getContext(), x);
+  auto blockLoop = b.create<affine::AffineForOp>(
+      /*lowerBound=*/0, /*upperBound=*/degree / blockSize, /*step=*/1,
+      /*iterArgs=*/result,
+      /*bodyBuilder=*/
+      [&](OpBuilder &nestedBuilder, Location nestedLoc, Value index,
+          ValueRange args) {
+        ImplicitLocOpBuilder b(nestedLoc, nestedBuilder);
+        Value offset = b.create<affine::AffineApplyOp>(x * blockSize, index);
+        SmallVector<OpFoldResult> offsets(blockType.getRank(),
+                                          b.getIndexAttr(0));
+        offsets[0] = offset;
+        SmallVector<OpFoldResult> sizes;
+        for (int64_t size : blockShape) sizes.push_back(b.getIndexAttr(size));
+        SmallVector<OpFoldResult> strides(blockType.getRank(),
+                                          b.getIndexAttr(1));
+        Value block = b.create<tensor::ExtractSliceOp>(blockType, args[0],
+                                                       offsets, sizes, strides);
+        block = emitStages<inverse>(b, tw, block, blockSize,
+                                    inverse ? blockSize : 2, localStages,
+                                    radix4);
+        Value inserted = b.create<tensor::InsertSliceOp>(block, args[0],
+                                                         offsets, sizes,
+                                                         strides);
+        b.create<affine::AffineYieldOp>(inserted);
+      });
+  result = blockLoop.getResult(0);
+
+  if (!inverse) {
+    result = emitStages<inverse>(b, tw, result, degree, 2 * blockSize,
+                                 globalStages, radix4);
+  }
+  return result;
+}
+
+// The number of coefficients per block of the cache-blocked schedule: the
+// largest power of two whose coefficients fit in blockBytes.
+static int64_t getNTTBlockSize(int64_t blockBytes, unsigned coeffWidth) {
+  int64_t coeffBytes = std::max<int64_t>(1, (coeffWidth + 7) / 8);
+  int64_t blockSize = 2;
+  while (blockSize * 2 * coeffBytes <= blockBytes) blockSize *= 2;
+  return blockSize;
+}
+
+// Below this degree the transform is small enough that the number of passes
+// over memory does not matter, and the simpler radix-2 loop nest is used.
+constexpr int64_t kRadix4MinDegree = 64;
+
+static NTTSchedule selectNTTSchedule(const NTTLoweringOptions &options,
+                                     int64_t degree, unsigned coeffWidth) {
+  if (options.schedule != NTTSchedule::Automatic) return options.schedule;
+  if (getNTTBlockSize(options.blockBytes, coeffWidth) < degree)
+    return NTTSchedule::Blocked;
+  if (degree >= kRadix4MinDegree) return NTTSchedule::Radix4;
+  return NTTSchedule::Radix2;
+}
+
+template <bool inverse>
+static Value fastNTT(ImplicitLocOpBuilder &b, RingAttr ring,
+                     PrimitiveRootAttr rootAttr, RankedTensorType tensorType,
+                     Type modType, Value input,
+                     const NTTLoweringOptions &options) {
+  // Compute the number of stages required to compute the NTT
+  auto degree = tensorType.getShape()[0];
+  unsigned stages = (unsigned)std::log2((double)degree);
+
+  // Precompute the roots
+  auto modArithType = cast<ModArithType>(ring.getCoefficientType());
+  APInt cmod = modArithType.getModulus().getValue();
+  APInt root = rootAttr.getValue().getValue();
+  root = !inverse ? root
+                  : multiplicativeInverse(root.zext(cmod.getBitWidth()), cmod)
+                        .trunc(root.getBitWidth());
+  auto workType = cast<RankedTensorType>(modType);
+  auto rootsType = tensorType.clone(workType.getShape());
+  SmallVector<APInt> twiddleValues =
+      precomputeStageTwiddles(precomputeRoots(root, cmod, degree), degree);
+
+  // Initialize the mod_arith twiddle table and its Shoup companions
+  auto twiddlesType = tensorType.clone({degree - 1});
+  NTTTwiddles tw;
+  tw.twiddlesInt = b.create<arith::ConstantOp>(
+      twiddlesType, DenseElementsAttr::get(twiddlesType, twiddleValues));
+  tw.twiddles = b.create<mod_arith::EncapsulateOp>(
+      workType.clone({degree - 1}), tw.twiddlesInt);
+  tw.twiddlesShoup = b.create<arith::ConstantOp>(
+      twiddlesType,
+      DenseElementsAttr::get(twiddlesType,
+                             precomputeShoup(twiddleValues, cmod)));
+
+  // A batched NTT works on a tensor<n x numPolys>, so a block of the blocked
+  // schedule holds fewer rows.
+  NTTLoweringOptions scheduleOptions = options;
+  if (workType.getRank() == 2) {
+    tw.numPolys = workType.getDimSize(1);
+    tw.rowType = workType.clone({tw.numPolys});
+    scheduleOptions.blockBytes /= tw.numPolys;
+  }
+
+  // Here is a slightly modified implementation of the standard iterative NTT
+  // computation using Cooley-Turkey/Gentleman-Sande butterfly. For reader
+  // reference: https://doi.org/10.1007/978-3-031-46077-7_22, and,
+  // https://doi.org/10.1109/ACCESS.2023.3294446
+  //
+  // We modify the standard implementation by pre-computing the twiddle
+  // factors of every stage during compilation, laid out so that each stage
+  // reads a contiguous slice, together with their Shoup companions so that
+  // each butterfly multiplication avoids a double-width remainder.
+  //
+  // Let roots be the powers \psi^i, n be the degree of the polynomial and
+  // inverse denote the direction. The twiddle table has n - 1 entries, with
+  // twiddles[m / 2 - 1 + j] = roots[(2 * j + 1) * (n / m)] for the stage with
+  // batch size m, and twiddlesShoup[i] = floor(twiddles[i] * 2^W / cmod). Then
+  // we implement the following:
+  //
+  // def fastNTT(coeffs, n, cmod, twiddles, twiddlesShoup, inverse):
+  //  m = inverse ? n : 2             # m denotes the batchSize or stride
+  //  for (s = 0; s < log2(n); s++):
+  //    for (k = 0; k < n / m; k++):
+  //      for (j = 0; j < m / 2; j++):
+  //        A = coeffs[k * m + j]
+  //        B = coeffs[k * m + j + m / 2]
+  //        root = twiddles[m / 2 - 1 + j]
+  //        rootShoup = twiddlesShoup[m / 2 - 1 + j]
+  //        coeffs[k * m + j], coeffs[k * m + j + m / 2]
+  //          = bflyOp(A, B, root, rootShoup, cmod)
+  //      end
+  //    end
+  //    m = inverse ? m / 2 : m * 2
+  //  end
+  //
+  //  where bflyOp is one of:
+  //    bflyCT(A, B, root, rootShoup, cmod):
+  //      (A + root * B % cmod, A - root * B % cmod)
+  //
+  //    bflyGS(A, B, root, rootShoup, cmod):
+  //      (A + B % cmod, (A - B) * root % cmod)
+  //
+  //  and the multiplications by root are Shoup multiplications.
+  //
+  // This is the radix-2 schedule. The radix-4 schedule fuses pairs of stages
+  // (see emitRadix4Stages) and the blocked schedule reorders the stages so
+  // that most of them run on L1-resident blocks (see emitBlockedStages).
+  Value initialValue = b.create<mod_arith::ReduceOp>(input);
+  Value result;
+  switch (selectNTTSchedule(scheduleOptions, degree, cmod.getBitWidth())) {
+    case NTTSchedule::Blocked: {
+      int64_t blockSize =
+          getNTTBlockSize(scheduleOptions.blockBytes, cmod.getBitWidth());
+      if (blockSize < degree) {
+        result = emitBlockedStages<inverse>(b, tw, initialValue, degree,
+                                            blockSize, /*radix4=*/true);
+        break;
+      }
+      // The whole transform fits in one block.
+      [[fallthrough]];
+    }
+    case NTTSchedule::Radix4:
+      result = emitStages<inverse>(b, tw, initialValue, degree,
+                                   inverse ? degree : 2, stages,
+                                   /*radix4=*/true);
+      break;
+    case NTTSchedule::Automatic:
+    case NTTSchedule::Radix2:
+      result = emitRadix2Stages<inverse>(b, tw, initialValue, degree,
+                                         inverse ? degree : 2, stages);
+      break;
+  }
+
   if (inverse) {
     APInt degreeInv =
         multiplicativeInverse(APInt(cmod.getBitWidth(), degree), cmod)
@@ -1123,8 +1560,9 @@ static Value fastNTT(ImplicitLocOpBuilder &b, RingAttr ring,
 }
 
 struct ConvertNTT : public OpConversionPattern<NTTOp> {
-  ConvertNTT(mlir::MLIRContext *context)
-      : OpConversionPattern<NTTOp>(context) {}
+  ConvertNTT(const TypeConverter &typeConverter, mlir::MLIRContext *context,
+             NTTLoweringOptions options)
+      : OpConversionPattern<NTTOp>(typeConverter, context), options(options) {}
 
   using OpConversionPattern::OpConversionPattern;
 
@@ -1133,19 +1571,13 @@ struct ConvertNTT : public OpConversionPattern<NTTOp> {
       ConversionPatternRewriter &rewriter) const override {
     ImplicitLocOpBuilder b(op.getLoc(), rewriter);
 
-    auto polyTy = dyn_cast<PolynomialType>(op.getInput().getType());
-    if (!polyTy) {
-      op.emitError(
-          "Can't directly lower for a tensor of polynomials. "
-          "First run --convert-elementwise-to-affine.");
-      return failure();
-    }
-
     if (!op.getRoot()) {
       op.emitError("missing root attribute");
       return failure();
     }
 
+    auto polyTy =
+        cast<PolynomialType>(getElementTypeOrSelf(op.getInput().getType()));
     RingAttr ring = polyTy.getRing();
     auto inputType = dyn_cast<RankedTensorType>(adaptor.getInput().getType());
     auto coeffType =
@@ -1155,14 +1587,26 @@ struct ConvertNTT : public OpConversionPattern<NTTOp> {
       return failure();
     }
     auto coeffStorageType = coeffType.getModulus().getType();
-    auto intTensorType =
-        RankedTensorType::get(inputType.getShape(), coeffStorageType);
-    auto modType = adaptor.getInput().getType();
+    auto intTensorType = RankedTensorType::get({inputType.getShape().back()},
+                                               coeffStorageType);
 
     // Compute the ntt and extract the values
-    Value nttResult = fastNTT<false>(
-        b, ring, op.getRoot().value(), intTensorType, modType,
-        computeReverseBitOrder(b, intTensorType, modType, adaptor.getInput()));
+    Value nttResult;
+    if (inputType.getRank() == 1) {
+      auto modType = adaptor.getInput().getType();
+      nttResult = fastNTT<false>(
+          b, ring, op.getRoot().value(), intTensorType, modType,
+          computeReverseBitOrder(b, intTensorType, modType,
+                                 adaptor.getInput()),
+          options);
+    } else {
+      // Transform a tensor of polynomials with the batch innermost.
+      Value batch =
+          transposeBatch(b, adaptor.getInput(), /*bitReversedDim=*/0);
+      nttResult = fastNTT<false>(b, ring, op.getRoot().value(), intTensorType,
+                                 batch.getType(), batch, options);
+      nttResult = transposeBatch(b, nttResult, std::nullopt);
+    }
 
     // Insert the ring encoding here to the input type
     auto outputType =
@@ -1172,18 +1616,23 @@ struct ConvertNTT : public OpConversionPattern<NTTOp> {
 
     return success();
   }
+
+ private:
+  NTTLoweringOptions options;
 };
 
 struct ConvertINTT : public OpConversionPattern<INTTOp> {
-  ConvertINTT(mlir::MLIRContext *context)
-      : OpConversionPattern<INTTOp>(context) {}
+  ConvertINTT(const TypeConverter &typeConverter, mlir::MLIRContext *context,
+              NTTLoweringOptions options)
+      : OpConversionPattern<INTTOp>(typeConverter, context), options(options) {}
 
   using OpConversionPattern::OpConversionPattern;
 
   LogicalResult matchAndRewrite(
       INTTOp op, OpAdaptor adaptor,
       ConversionPatternRewriter &rewriter) const override {
-    auto res = getCommonConversionInfo(op, typeConverter);
+    auto res = getCommonConversionInfo(
+        op, typeConverter, getElementTypeOrSelf(op.getOutput().getType()));
     if (failed(res)) return failure();
     auto typeInfo = res.value();
 
@@ -1201,22 +1650,37 @@ struct ConvertINTT : public OpConversionPattern<INTTOp> {
     }
     auto coeffStorageType = coeffType.getModulus().getType();
     auto inputType = dyn_cast<RankedTensorType>(adaptor.getInput().getType());
-    auto intTensorType =
-        RankedTensorType::get(inputType.getShape(), coeffStorageType);
+    auto intTensorType = RankedTensorType::get({inputType.getShape().back()},
+                                               coeffStorageType);
     auto modType = typeConverter->convertType(op.getOutput().getType());
 
     // Remove the encoded ring from input tensor type and convert to mod_arith
     // type
-    auto input = b.create<tensor::CastOp>(modType, adaptor.getInput());
-    auto nttResult = fastNTT<true>(b, typeInfo.ringAttr, op.getRoot().value(),
-                                   intTensorType, modType, input);
+    Value input = b.create<tensor::CastOp>(modType, adaptor.getInput());
+    if (inputType.getRank() == 1) {
+      auto nttResult =
+          fastNTT<true>(b, typeInfo.ringAttr, op.getRoot().value(),
+                        intTensorType, modType, input, options);
+
+      auto reversedBitOrder =
+          computeReverseBitOrder(b, intTensorType, modType, nttResult);
+      rewriter.replaceOp(op, reversedBitOrder);
+      return success();
+    }
 
-    auto reversedBitOrder =
-        computeReverseBitOrder(b, intTensorType, modType, nttResult);
-    rewriter.replaceOp(op, reversedBitOrder);
+    // Transform a tensor of polynomials with the batch innermost.
+    Value batch = transposeBatch(b, input, std::nullopt);
+    Value nttResult =
+        fastNTT<true>(b, typeInfo.ringAttr, op.getRoot().value(),
+                      intTensorType, batch.getType(), batch, options);
+    rewriter.replaceOp(op,
+                       transposeBatch(b, nttResult, /*bitReversedDim=*/1));
 
     return success();
   }
+
+ private:
+  NTTLoweringOptions options;
 };
 
 void PolynomialToModArith::runOnOperation() {
@@ -1244,9 +1708,10 @@ void PolynomialToModArith::runOnOperation() {
                ConvertPolyBinop<AddOp, arith::AddIOp, mod_arith::AddOp>,
                ConvertPolyBinop<SubOp, arith::SubIOp, mod_arith::SubOp>,
                ConvertLeadingTerm, ConvertMonomial, ConvertMonicMonomialMul,
-               ConvertConstant, ConvertMulScalar, ConvertNTT, ConvertINTT>(
-      typeConverter, context);
+               ConvertConstant, ConvertMulScalar>(typeConverter, context);
   patterns.add<ConvertMul>(typeConverter, patterns.getContext(), getDivmodOp);
+  NTTLoweringOptions nttOptions{nttSchedule, nttBlockBytes};
+  patterns.add<ConvertNTT, ConvertINTT>(typeConverter, context, nttOptions);
   addStructuralConversionPatterns(typeConverter, patterns, target);
   addTensorOfTensorConversionPatterns(typeConverter, patterns, target);
 
@@ -7,6 +7,14 @@ namespace mlir {
 namespace heir {
 namespace polynomial {
 
+// The loop schedule used to lower polynomial.ntt and polynomial.intt.
+enum class NTTSchedule {
+  Automatic,
+  Radix2,
+  Radix4,
+  Blocked,
+};
+
 #define GEN_PASS_DECL
 #include "lib/Dialect/Polynomial/Conversions/PolynomialToModArith/PolynomialToModArith.h.inc"
 
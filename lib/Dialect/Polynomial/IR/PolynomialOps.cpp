@@ -11,6 +11,7 @@
 #include "lib/Dialect/Polynomial/IR/PolynomialTypes.h"
 #include "lib/Utils/Polynomial/Polynomial.h"
 #include "llvm/include/llvm/ADT/APInt.h"                 // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"  // from @llvm-project
 #include "llvm/include/llvm/ADT/TypeSwitch.h"            // from @llvm-project
 #include "llvm/include/llvm/Support/ErrorHandling.h"     // from @llvm-project
 #include "mlir/include/mlir/IR/Attributes.h"             // from @llvm-project
@@ -174,9 +175,30 @@ bool isPrimitiveNthRootOfUnity(const APInt &root, const APInt &n,
 
 /// Verify that the types involved in an NTT or INTT operation are
 /// compatible.
-static LogicalResult verifyNTTOp(Operation *op, PolynomialType poly,
+static LogicalResult verifyNTTOp(Operation *op, Type polyLike,
                                  RankedTensorType tensorType,
                                  std::optional<PrimitiveRootAttr> root) {
+  PolynomialType poly;
+  SmallVector<int64_t> expectedShape;
+  if (auto polyTensorType = dyn_cast<RankedTensorType>(polyLike)) {
+    if (polyTensorType.getRank() != 1 || polyTensorType.isDynamicDim(0)) {
+      return op->emitOpError()
+             << "expects a tensor of polynomials to have a static rank-1 "
+                "shape, but found "
+             << polyTensorType;
+    }
+    poly = cast<PolynomialType>(polyTensorType.getElementType());
+    expectedShape.push_back(polyTensorType.getDimSize(0));
+  } else {
+    poly = dyn_cast<PolynomialType>(polyLike);
+    if (!poly) {
+      return op->emitOpError()
+             << "expects a polynomial or a ranked tensor of polynomials, but "
+                "found "
+             << polyLike;
+    }
+  }
+
   Attribute encoding = tensorType.getEncoding();
   if (!encoding) {
     return op->emitOpError()
@@ -196,15 +218,15 @@ static LogicalResult verifyNTTOp(Operation *op, PolynomialType poly,
   }
 
   unsigned polyDegree = ring.getPolynomialModulus().getPolynomial().getDegree();
-  ArrayRef<int64_t> tensorShape = tensorType.getShape();
-  bool compatible = tensorShape.size() == 1 && tensorShape[0] == polyDegree;
-  if (!compatible) {
+  expectedShape.push_back(polyDegree);
+  if (tensorType.getShape() != ArrayRef<int64_t>(expectedShape)) {
     InFlightDiagnostic diag = op->emitOpError()
                               << "tensor type " << tensorType
                               << " does not match output type " << ring;
-    diag.attachNote() << "the tensor must have shape [d] where d "
-                         "is exactly the degree of the polynomialModulus of "
-                         "the polynomial type's ring attribute";
+    diag.attachNote() << "the tensor must have shape [d], or [k, d] for a "
+                         "tensor of k polynomials, where d is exactly the "
+                         "degree of the polynomialModulus of the polynomial "
+                         "type's ring attribute";
     return diag;
   }
 
@@ -124,10 +124,11 @@ LogicalResult AssignLayoutOp::verify() {
 
 LogicalResult PermuteOp::verify() {
   auto tensorTy = getInput().getType();
+  // A 2-D input is a list of ciphertexts, permuted as a flattened row-major
+  // tensor.
   // TODO(#924): Support more general vector inputs.
-  if (tensorTy.getRank() != 1) {
-    return emitOpError() << "requires a 1-D input tensor"
-                            "single non-unit dimension, but found "
+  if (tensorTy.getRank() != 1 && tensorTy.getRank() != 2) {
+    return emitOpError() << "requires a 1-D or 2-D input tensor, but found "
                          << tensorTy;
   }
 
@@ -2,7 +2,9 @@
 
 #include <cassert>
 #include <cstdint>
+#include <map>
 #include <optional>
+#include <string>
 #include <unordered_map>
 #include <utility>
 
@@ -10,19 +12,21 @@
 #include "lib/Utils/ADT/FrozenVector.h"
 #include "lib/Utils/AffineMapUtils.h"
 #include "lib/Utils/Graph/Graph.h"
-#include "llvm/include/llvm/ADT/STLExtras.h"           // from @llvm-project
-#include "llvm/include/llvm/ADT/SmallVectorExtras.h"   // from @llvm-project
-#include "llvm/include/llvm/Support/Debug.h"           // from @llvm-project
-#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"  // from @llvm-project
-#include "mlir/include/mlir/IR/AffineMap.h"            // from @llvm-project
-#include "mlir/include/mlir/IR/Attributes.h"           // from @llvm-project
-#include "mlir/include/mlir/IR/BuiltinAttributes.h"    // from @llvm-project
-#include "mlir/include/mlir/IR/BuiltinTypes.h"         // from @llvm-project
-#include "mlir/include/mlir/IR/Diagnostics.h"          // from @llvm-project
-#include "mlir/include/mlir/IR/PatternMatch.h"         // from @llvm-project
-#include "mlir/include/mlir/IR/Value.h"                // from @llvm-project
-#include "mlir/include/mlir/Support/LLVM.h"            // from @llvm-project
-#include "mlir/include/mlir/Support/LogicalResult.h"   // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVectorExtras.h"     // from @llvm-project
+#include "llvm/include/llvm/ADT/StringRef.h"             // from @llvm-project
+#include "llvm/include/llvm/Support/Debug.h"             // from @llvm-project
+#include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/AffineMap.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/Attributes.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinAttributes.h"      // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/Diagnostics.h"            // from @llvm-project
+#include "mlir/include/mlir/IR/PatternMatch.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                  // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"              // from @llvm-project
+#include "mlir/include/mlir/Support/LogicalResult.h"     // from @llvm-project
 
 #define DEBUG_TYPE "implement-shift-network"
 
@@ -153,8 +157,24 @@ class ShiftStrategy {
 // for an explanation of the algorithm.
 class VosVosErkinShiftNetworks {
  public:
-  VosVosErkinShiftNetworks(int64_t ciphertextSize)
-      : ciphertextSize(ciphertextSize) {}
+  VosVosErkinShiftNetworks(int64_t ciphertextSize,
+                           StringRef coloringStrategy = kDSatur,
+                           int coloringMaxIterations = 1000,
+                           int64_t coloringMaxSearchNodes = 100000)
+      : ciphertextSize(ciphertextSize),
+        coloringStrategy(coloringStrategy),
+        coloringMaxIterations(coloringMaxIterations),
+        coloringMaxSearchNodes(coloringMaxSearchNodes) {}
+
+  static constexpr StringLiteral kDSatur = "dsatur";
+  static constexpr StringLiteral kIteratedGreedy = "iterated-greedy";
+  static constexpr StringLiteral kExact = "exact";
+  static constexpr StringLiteral kBest = "best";
+
+  static bool isValidColoringStrategy(StringRef strategy) {
+    return strategy == kDSatur || strategy == kIteratedGreedy ||
+           strategy == kExact || strategy == kBest;
+  }
 
   // Computes a partition of the slot indices of a ciphertext into
   // RotationGroups that are compatible with respect to the target permutation.
@@ -204,19 +224,8 @@ class VosVosErkinShiftNetworks {
       }
     });
 
-    graph::GreedyGraphColoring<int64_t> colorer;
-    std::unordered_map<int64_t, int> coloring = colorer.color(conflictGraph);
-
-    SmallVector<RotationGroup> resultRotationGroups;
-    resultRotationGroups.reserve(64);
-    for (const auto &entry : coloring) {
-      int64_t index = entry.first;
-      int64_t color = entry.second;
-      if (color >= resultRotationGroups.size()) {
-        resultRotationGroups.resize(color + 1);
-      }
-      resultRotationGroups[color].insert(index);
-    }
+    SmallVector<RotationGroup> resultRotationGroups =
+        colorConflictGraph(permutation, conflictGraph);
 
     LLVM_DEBUG({
       llvm::dbgs() << "Splitting permutation into permutation groups:\n";
@@ -239,7 +248,79 @@ class VosVosErkinShiftNetworks {
   int64_t getCiphertextSize() const { return ciphertextSize; }
 
  private:
+  // The cost of a shift network: the number of rotations, each of which also
+  // needs a masking multiplication, and then the number of groups, each of
+  // which needs an addition.
+  static std::pair<int64_t, int64_t> cost(
+      const Permutation &permutation, ArrayRef<RotationGroup> groups) {
+    int64_t numRotations = 0;
+    for (const RotationGroup &group : groups) {
+      ShiftStrategy strategy;
+      strategy.evaluate(permutation, group);
+      for (const ShiftRound &round : strategy.getRounds()) {
+        if (!round.rotatedIndices.empty()) ++numRotations;
+      }
+    }
+    return {numRotations, static_cast<int64_t>(groups.size())};
+  }
+
+  static SmallVector<RotationGroup> toRotationGroups(
+      const std::unordered_map<int64_t, int> &coloring) {
+    SmallVector<RotationGroup> groups;
+    for (const auto &[index, color] : coloring) {
+      if (color >= groups.size()) {
+        groups.resize(color + 1);
+      }
+      groups[color].insert(index);
+    }
+    return groups;
+  }
+
+  // Partition the indices into rotation groups by coloring the conflict graph
+  // with the configured strategy. The "best" strategy runs every colorer and
+  // keeps the partition with the cheapest shift network.
+  SmallVector<RotationGroup> colorConflictGraph(
+      const Permutation &permutation,
+      const graph::UndirectedGraph<int64_t> &conflictGraph) {
+    SmallVector<SmallVector<RotationGroup>> candidates;
+    if (coloringStrategy == kDSatur || coloringStrategy == kBest) {
+      graph::GreedyGraphColoring<int64_t> colorer;
+      candidates.push_back(toRotationGroups(colorer.color(conflictGraph)));
+    }
+    if (coloringStrategy == kIteratedGreedy || coloringStrategy == kBest) {
+      graph::IteratedGreedyGraphColoring<int64_t> colorer(
+          coloringMaxIterations);
+      candidates.push_back(toRotationGroups(colorer.color(conflictGraph)));
+    }
+    if (coloringStrategy == kExact || coloringStrategy == kBest) {
+      graph::ExactGraphColoring<int64_t> colorer(/*maxVertices=*/256,
+                                                 coloringMaxSearchNodes);
+      candidates.push_back(toRotationGroups(colorer.color(conflictGraph)));
+    }
+    assert(!candidates.empty() && "unknown coloring strategy");
+
+    // Ties keep the earliest candidate, so "best" never does worse than
+    // DSatur.
+    SmallVector<RotationGroup> *best = &candidates.front();
+    std::pair<int64_t, int64_t> bestCost = cost(permutation, *best);
+    for (SmallVector<RotationGroup> &candidate :
+         llvm::drop_begin(candidates)) {
+      std::pair<int64_t, int64_t> candidateCost = cost(permutation, candidate);
+      if (candidateCost < bestCost) {
+        best = &candidate;
+        bestCost = candidateCost;
+      }
+    }
+    LLVM_DEBUG(llvm::dbgs() << "Chose a shift network with " << bestCost.first
+                            << " rotations in " << bestCost.second
+                            << " groups\n");
+    return std::move(*best);
+  }
+
   int64_t ciphertextSize;
+  std::string coloringStrategy;
+  int coloringMaxIterations;
+  int64_t coloringMaxSearchNodes;
   DenseMap<Permutation, llvm::SmallVector<RotationGroup>> rotationGroups;
 };
 
@@ -298,6 +379,105 @@ Value rotateGroup(TypedValue<RankedTensorType> tensor,
   return result.has_value() ? result.value() : tensor;
 }
 
+// Implement a permutation of a tensor<k x N> of k ciphertexts, given as a
+// permutation of the row-major flattened tensor.
+//
+// Each input ciphertext is handled as in the single-ciphertext case, except
+// that its slots are mapped to their target slots while ignoring which
+// ciphertext they are sent to. Slots sent to different ciphertexts but the
+// same target slot collide, so the Vos-Vos-Erkin graph coloring places them
+// in different rotation groups. The rotations of each group are then shared
+// by all output ciphertexts the group feeds: if a group feeds more than one
+// output ciphertext, each output ciphertext masks out its own slots from the
+// rotated group.
+LogicalResult convertMultiCiphertextPermuteOp(
+    PermuteOp op, ArrayRef<int64_t> permutation,
+    VosVosErkinShiftNetworks &shiftNetworks, IRRewriter &rewriter) {
+  RankedTensorType tensorTy = op.getInput().getType();
+  int64_t numCiphertexts = tensorTy.getDimSize(0);
+  int64_t ciphertextSize = tensorTy.getDimSize(1);
+  if (ciphertextSize != shiftNetworks.getCiphertextSize()) {
+    return op.emitError() << "expected the trailing dimension to match the "
+                             "ciphertext size "
+                          << shiftNetworks.getCiphertextSize() << ", but found "
+                          << tensorTy;
+  }
+
+  Location loc = op.getLoc();
+  RankedTensorType ciphertextTy =
+      RankedTensorType::get({ciphertextSize}, tensorTy.getElementType());
+  SmallVector<OpFoldResult> sizes = {rewriter.getIndexAttr(1),
+                                     rewriter.getIndexAttr(ciphertextSize)};
+  SmallVector<OpFoldResult> strides = {rewriter.getIndexAttr(1),
+                                       rewriter.getIndexAttr(1)};
+  auto offsetsFor = [&](int64_t ciphertext) -> SmallVector<OpFoldResult> {
+    return {rewriter.getIndexAttr(ciphertext), rewriter.getIndexAttr(0)};
+  };
+
+  rewriter.setInsertionPointAfter(op);
+  SmallVector<std::optional<Value>> outputs(numCiphertexts, std::nullopt);
+  for (int64_t source = 0; source < numCiphertexts; ++source) {
+    // The target slot and target ciphertext of each slot of this ciphertext.
+    SmallVector<int64_t> slotMapping;
+    SmallVector<int64_t> targetCiphertexts;
+    for (int64_t slot = 0; slot < ciphertextSize; ++slot) {
+      int64_t target = permutation[source * ciphertextSize + slot];
+      slotMapping.push_back(target % ciphertextSize);
+      targetCiphertexts.push_back(target / ciphertextSize);
+    }
+
+    auto extractOp = rewriter.create<tensor::ExtractSliceOp>(
+        loc, ciphertextTy, op.getInput(), offsetsFor(source), sizes, strides);
+    TypedValue<RankedTensorType> input = extractOp.getResult();
+
+    Permutation mappingKey = FrozenVector<int64_t>(std::move(slotMapping));
+    ArrayRef<RotationGroup> rotationGroups =
+        shiftNetworks.computeShiftNetwork(mappingKey);
+    [[maybe_unused]] int groupIndex = 0;
+    for (const RotationGroup &group : rotationGroups) {
+      LLVM_DEBUG(llvm::dbgs() << "Implementing rotations for ciphertext "
+                              << source << " group " << groupIndex++ << "\n");
+      Value rotated =
+          rotateGroup(input, group, ciphertextSize, mappingKey, rewriter);
+
+      // The target slots of this group, split by target ciphertext.
+      std::map<int64_t, SmallVector<int64_t>> targetSlots;
+      for (int64_t index : group) {
+        targetSlots[targetCiphertexts[index]].push_back(mappingKey[index]);
+      }
+
+      // A group that needs no rotation is returned unmasked, so it must be
+      // masked if it does not cover the whole ciphertext.
+      bool unmasked = rotated == input &&
+                      static_cast<int64_t>(group.size()) < ciphertextSize;
+      for (auto &[target, slots] : targetSlots) {
+        Value piece = rotated;
+        if (targetSlots.size() > 1 || unmasked) {
+          Value mask = createMask(cast<TypedValue<RankedTensorType>>(rotated),
+                                  slots, rewriter);
+          piece = rewriter.create<arith::MulIOp>(loc, rotated, mask);
+        }
+        if (outputs[target].has_value())
+          outputs[target] =
+              rewriter.create<arith::AddIOp>(loc, *outputs[target], piece);
+        else
+          outputs[target] = piece;
+      }
+    }
+  }
+
+  Value result = rewriter.create<arith::ConstantOp>(
+      loc, tensorTy, rewriter.getZeroAttr(tensorTy));
+  for (int64_t target = 0; target < numCiphertexts; ++target) {
+    if (!outputs[target].has_value()) continue;
+    result = rewriter.create<tensor::InsertSliceOp>(
+        loc, *outputs[target], result, offsetsFor(target), sizes, strides);
+  }
+
+  rewriter.replaceOp(op, result);
+  return success();
+}
+
 LogicalResult convertPermuteOp(PermuteOp op,
                                VosVosErkinShiftNetworks &shiftNetworks,
                                int64_t ciphertextSize) {
@@ -305,9 +485,9 @@ LogicalResult convertPermuteOp(PermuteOp op,
   IRRewriter rewriter(op.getContext());
   RankedTensorType tensorTy = op.getInput().getType();
 
-  // Only support a 1-D tensor until sharding is supported
-  if (op.getInput().getType().getRank() != 1) {
-    return op.emitError("requires a one-dimensional tensor");
+  // Only support a 1-D tensor, or a 2-D tensor whose rows are ciphertexts.
+  if (tensorTy.getRank() != 1 && tensorTy.getRank() != 2) {
+    return op.emitError("requires a one- or two-dimensional tensor");
   }
 
   SmallVector<int64_t> permutation;
@@ -347,6 +527,11 @@ LogicalResult convertPermuteOp(PermuteOp op,
     printPermutation(permutation, llvm::dbgs());
   });
 
+  if (tensorTy.getRank() == 2) {
+    return convertMultiCiphertextPermuteOp(op, permutation, shiftNetworks,
+                                           rewriter);
+  }
+
   FrozenVector<int64_t> permKey = FrozenVector<int64_t>(std::move(permutation));
   ArrayRef<RotationGroup> rotationGroup =
       shiftNetworks.computeShiftNetwork(permKey);
@@ -379,7 +564,16 @@ struct ImplementShiftNetwork
   using ImplementShiftNetworkBase::ImplementShiftNetworkBase;
 
   void runOnOperation() override {
-    VosVosErkinShiftNetworks shiftNetworks{ciphertextSize};
+    if (!VosVosErkinShiftNetworks::isValidColoringStrategy(coloringStrategy)) {
+      getOperation()->emitError()
+          << "unknown coloring strategy '" << coloringStrategy
+          << "', expected one of dsatur, iterated-greedy, exact, best";
+      signalPassFailure();
+      return;
+    }
+    VosVosErkinShiftNetworks shiftNetworks{ciphertextSize, coloringStrategy,
+                                           coloringMaxIterations,
+                                           coloringMaxSearchNodes};
 
     getOperation()->walk([&](PermuteOp op) {
       if (failed(convertPermuteOp(op, shiftNetworks, ciphertextSize))) {
@@ -29,6 +29,18 @@ namespace tensor_ext {
 #define GEN_PASS_DEF_ROTATEANDREDUCE
 #include "lib/Dialect/TensorExt/Transforms/Passes.h.inc"
 
+Value buildRotateAndReduceTree(
+    ImplicitLocOpBuilder &b, Value tensor,
+    llvm::function_ref<Value(Value, Value)> combine) {
+  auto tensorShape = mlir::cast<RankedTensorType>(tensor.getType()).getShape();
+  for (int64_t shiftSize = tensorShape[0] / 2; shiftSize > 0; shiftSize /= 2) {
+    auto rotatedTensor = b.create<tensor_ext::RotateOp>(
+        tensor, b.create<arith::ConstantOp>(b.getIndexAttr(shiftSize)));
+    tensor = combine(tensor, rotatedTensor);
+  }
+  return tensor;
+}
+
 /// A pass that searches for a length N sequence of binary operations that
 /// reduces a length N vector to a single scalar, and replaces it with a
 /// logarithmic number of rotations and binary operations.
@@ -42,32 +54,23 @@ struct RotateAndReduce : impl::RotateAndReduceBase<RotateAndReduce> {
     LLVM_DEBUG(llvm::dbgs()
                << "Trying to replace rotations ending in " << *op << "\n");
     auto b = ImplicitLocOpBuilder(op->getLoc(), op);
-    auto tensor = reduction.getTensor();
-    Operation *finalOp = nullptr;
-    auto tensorShape =
-        mlir::cast<RankedTensorType>(tensor.getType()).getShape();
-    for (int64_t shiftSize = tensorShape[0] / 2; shiftSize > 0;
-         shiftSize /= 2) {
-      auto rotatedTensor = b.create<tensor_ext::RotateOp>(
-          tensor, b.create<arith::ConstantOp>(b.getIndexAttr(shiftSize)));
-      auto addOp = b.create<ArithOp>(tensor, rotatedTensor);
-      finalOp = addOp;
-      tensor = addOp->getResult(0);
-    }
+    Value finalValue = buildRotateAndReduceTree(
+        b, reduction.getTensor(), [&](Value lhs, Value rhs) -> Value {
+          return b.create<ArithOp>(lhs, rhs);
+        });
 
     [[maybe_unused]] auto *parentOp = op->getParentOp();
     if (extraction) {
       // We can extract at any index; every index contains the same reduced
       // value.
-      auto extractOp = b.create<tensor::ExtractOp>(
-          finalOp->getResult(0),
-          b.create<arith::ConstantIndexOp>(0).getResult());
-      finalOp = extractOp;
+      finalValue = b.create<tensor::ExtractOp>(
+          finalValue, b.create<arith::ConstantIndexOp>(0).getResult());
     }
     for (auto value : reduction.getSavedValues()) {
-      finalOp = b.create<ArithOp>(finalOp->getResult(0), value);
+      finalValue = b.create<ArithOp>(finalValue, value);
     }
-    if (finalOp) op->replaceAllUsesWith(finalOp);
+    if (finalValue != op->getResult(0))
+      op->getResult(0).replaceAllUsesWith(finalValue);
     LLVM_DEBUG(llvm::dbgs() << "Post-replacement: " << *parentOp << "\n");
   }
 
@@ -1,7 +1,10 @@
 #ifndef LIB_DIALECT_TENSOREXT_TRANSFORMS_ROTATEANDREDUCE_H_
 #define LIB_DIALECT_TENSOREXT_TRANSFORMS_ROTATEANDREDUCE_H_
 
-#include "mlir/include/mlir/Pass/Pass.h"  // from @llvm-project
+#include "llvm/include/llvm/ADT/STLFunctionalExtras.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/ImplicitLocOpBuilder.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                 // from @llvm-project
+#include "mlir/include/mlir/Pass/Pass.h"                // from @llvm-project
 
 namespace mlir {
 namespace heir {
@@ -10,6 +13,13 @@ namespace tensor_ext {
 #define GEN_PASS_DECL_ROTATEANDREDUCE
 #include "lib/Dialect/TensorExt/Transforms/Passes.h.inc"
 
+/// Reduce all entries of a one-dimensional tensor whose length is a power of
+/// two using log2(n) rotations, each followed by a call to `combine` on the
+/// running value and its rotation. Every entry of the returned tensor contains
+/// the fully reduced value.
+Value buildRotateAndReduceTree(ImplicitLocOpBuilder &b, Value tensor,
+                               llvm::function_ref<Value(Value, Value)> combine);
+
 }  // namespace tensor_ext
 }  // namespace heir
 }  // namespace mlir
@@ -19,7 +19,10 @@ struct SimdVectorizerOptions
     : public PassPipelineOptions<SimdVectorizerOptions> {
   PassOptions::Option<bool> experimentalDisableLoopUnroll{
       *this, "experimental-disable-loop-unroll",
-      llvm::cl::desc("Experimental: disable loop unroll, may break analyses "
+      llvm::cl::desc("Experimental: disable loop unroll. Loops with secret "
+                     "iter_args are kept through ciphertext management and "
+                     "scheme lowering; loops whose carried values grow in "
+                     "multiplicative depth are still unrolled for BGV "
                      "(default to false)"),
       llvm::cl::init(false)};
 };
@@ -9,6 +9,7 @@
 #include "lib/Dialect/CGGI/Conversions/CGGIToTfheRust/CGGIToTfheRust.h"
 #include "lib/Dialect/CGGI/Conversions/CGGIToTfheRustBool/CGGIToTfheRustBool.h"
 #include "lib/Dialect/CGGI/Transforms/BooleanVectorizer.h"
+#include "lib/Dialect/CGGI/Transforms/MergeLUTs.h"
 #include "lib/Dialect/Secret/Conversions/SecretToCGGI/SecretToCGGI.h"
 #include "lib/Dialect/Secret/Transforms/DistributeGeneric.h"
 #include "lib/Pipelines/PipelineRegistration.h"
@@ -45,16 +46,18 @@ static std::vector<unsigned> bitWidths = {1, 2, 4, 8, 16};
 
 #ifndef HEIR_NO_YOSYS
 CGGIPipelineBuilder mlirToCGGIPipelineBuilder(const std::string &yosysFilesPath,
-                                              const std::string &abcPath) {
+                                              const std::string &abcPath,
+                                              const std::string &yosysPath) {
   return [=](OpPassManager &pm, const MLIRToCGGIPipelineOptions &options) {
-    mlirToCGGIPipeline(pm, options, yosysFilesPath, abcPath);
+    mlirToCGGIPipeline(pm, options, yosysFilesPath, abcPath, yosysPath);
   };
 }
 
 void mlirToCGGIPipeline(OpPassManager &pm,
                         const MLIRToCGGIPipelineOptions &options,
                         const std::string &yosysFilesPath,
-                        const std::string &abcPath) {
+                        const std::string &abcPath,
+                        const std::string &yosysPath) {
   // TOSA to linalg
   ::mlir::heir::tosaToLinalg(pm);
 
@@ -101,9 +104,11 @@ void mlirToCGGIPipeline(OpPassManager &pm,
       pm.addPass(secret::createSecretDistributeGeneric(distributeOpts));
       pm.addPass(createCanonicalizerPass());
 
-      pm.addPass(createYosysOptimizer(yosysFilesPath, abcPath, options.abcFast,
-                                      options.unrollFactor,
-                                      options.useSubmodules, options.mode));
+      pm.addPass(createYosysOptimizer(
+          yosysFilesPath, abcPath, yosysPath, options.abcFast,
+          options.unrollFactor, options.useSubmodules, options.mode,
+          /*printStats=*/false, options.numWorkers, options.cacheDir,
+          options.objective));
       // Cleanup
       pm.addPass(mlir::createCSEPass());
       pm.addPass(createCanonicalizerPass());
@@ -128,6 +133,10 @@ void mlirToCGGIPipeline(OpPassManager &pm,
   pm.addPass(createRemoveUnusedMemRef());
   pm.addPass(createCSEPass());
   pm.addPass(createSCCPPass());
+
+  if (options.mergeLuts) {
+    pm.addPass(cggi::createMergeLUTs());
+  }
 }
 #else
 CGGIPipelineBuilder mlirToCGGIPipelineBuilder() {
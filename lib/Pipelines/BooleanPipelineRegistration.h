@@ -28,18 +28,27 @@ struct MLIRToCGGIPipelineOptions : public YosysOptimizerPipelineOptions {
       llvm::cl::values(
           clEnumVal(Bool, "booleanize with Yosys"),
           clEnumVal(Integer, "decompose operations into 32 bit data types"))};
+
+  PassOptions::Option<bool> mergeLuts{
+      *this, "merge-luts",
+      llvm::cl::desc("Merge lookup tables applied to the same inputs into "
+                     "multi-output lookup tables, which share a single "
+                     "bootstrap. Only the tfhe-rs backend supports these."),
+      llvm::cl::init(false)};
 };
 
 using CGGIPipelineBuilder =
     std::function<void(OpPassManager &, const MLIRToCGGIPipelineOptions &)>;
 
 CGGIPipelineBuilder mlirToCGGIPipelineBuilder(const std::string &yosysFilesPath,
-                                              const std::string &abcPath);
+                                              const std::string &abcPath,
+                                              const std::string &yosysPath);
 
 void mlirToCGGIPipeline(OpPassManager &pm,
                         const MLIRToCGGIPipelineOptions &options,
                         const std::string &yosysFilesPath,
-                        const std::string &abcPath);
+                        const std::string &abcPath,
+                        const std::string &yosysPath);
 
 #else
 struct MLIRToCGGIPipelineOptions
@@ -9,10 +9,13 @@
 #include "lib/Transforms/ConvertSecretWhileToStaticFor/ConvertSecretWhileToStaticFor.h"
 #include "lib/Transforms/ElementwiseToAffine/ElementwiseToAffine.h"
 #include "lib/Transforms/MemrefToArith/MemrefToArith.h"
+#include "lib/Transforms/ParallelizeTensorLoops/ParallelizeTensorLoops.h"
 #include "mlir/include/mlir/Conversion/AffineToStandard/AffineToStandard.h"  // from @llvm-project
 #include "mlir/include/mlir/Conversion/BufferizationToMemRef/BufferizationToMemRef.h"  // from @llvm-project
 #include "mlir/include/mlir/Conversion/ConvertToLLVM/ToLLVMPass.h"  // from @llvm-project
+#include "mlir/include/mlir/Conversion/OpenMPToLLVM/ConvertOpenMPToLLVM.h"  // from @llvm-project
 #include "mlir/include/mlir/Conversion/SCFToControlFlow/SCFToControlFlow.h"  // from @llvm-project
+#include "mlir/include/mlir/Conversion/SCFToOpenMP/SCFToOpenMP.h"  // from @llvm-project
 #include "mlir/include/mlir/Conversion/TensorToLinalg/TensorToLinalgPass.h"  // from @llvm-project
 #include "mlir/include/mlir/Conversion/TosaToArith/TosaToArith.h"  // from @llvm-project
 #include "mlir/include/mlir/Conversion/TosaToLinalg/TosaToLinalg.h"  // from @llvm-project
@@ -24,6 +27,7 @@
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Linalg/Passes.h"    // from @llvm-project
 #include "mlir/include/mlir/Dialect/MemRef/Transforms/Passes.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/SCF/Transforms/Passes.h"  // from @llvm-project
 #include "mlir/include/mlir/Pass/PassManager.h"   // from @llvm-project
 #include "mlir/include/mlir/Pass/PassOptions.h"   // from @llvm-project
 #include "mlir/include/mlir/Pass/PassRegistry.h"  // from @llvm-project
@@ -91,7 +95,9 @@ void tosaPipelineBuilder(OpPassManager &manager, bool unroll) {
   manager.addPass(createSymbolDCEPass());
 }
 
-void polynomialToLLVMPipelineBuilder(OpPassManager &manager) {
+void polynomialToLLVMPipelineBuilder(OpPassManager &manager, bool parallelize,
+                                     int64_t numThreads, int64_t loopTileSize,
+                                     int64_t linalgTileSize) {
   // Poly
   manager.addPass(createElementwiseToAffine());
   manager.addPass(::mlir::heir::polynomial::createPolynomialToModArith());
@@ -100,6 +106,15 @@ void polynomialToLLVMPipelineBuilder(OpPassManager &manager) {
 
   // Linalg
   manager.addNestedPass<FuncOp>(createConvertElementwiseToLinalgPass());
+  if (parallelize) {
+    // Must run before affine is lowered, while loops over tensors of
+    // polynomials are still recognizable.
+    ParallelizeTensorLoopsOptions parallelizeOptions;
+    parallelizeOptions.loopTileSize = loopTileSize;
+    parallelizeOptions.linalgTileSize = linalgTileSize;
+    manager.addNestedPass<FuncOp>(
+        createParallelizeTensorLoops(parallelizeOptions));
+  }
   // Needed to lower affine.map and affine.apply
   manager.addNestedPass<FuncOp>(affine::createAffineExpandIndexOpsPass());
   manager.addNestedPass<FuncOp>(affine::createSimplifyAffineStructuresPass());
@@ -115,6 +130,12 @@ void polynomialToLLVMPipelineBuilder(OpPassManager &manager) {
   manager.addNestedPass<FuncOp>(createConvertLinalgToLoopsPass());
   manager.addPass(createLowerAffinePass());
   manager.addPass(createConvertBufferizationToMemRefPass());
+  if (parallelize) {
+    manager.addNestedPass<FuncOp>(createForallToParallelLoopPass());
+    ConvertSCFToOpenMPPassOptions openMPOptions;
+    openMPOptions.numThreads = numThreads;
+    manager.addPass(createConvertSCFToOpenMPPass(openMPOptions));
+  }
 
   // Cleanup
   manager.addPass(createCanonicalizerPass());
@@ -131,6 +152,7 @@ void polynomialToLLVMPipelineBuilder(OpPassManager &manager) {
   manager.addNestedPass<FuncOp>(affine::createAffineExpandIndexOpsPass());
   manager.addNestedPass<FuncOp>(affine::createSimplifyAffineStructuresPass());
   manager.addPass(createLowerAffinePass());
+  if (parallelize) manager.addPass(createConvertOpenMPToLLVMPass());
   manager.addPass(createConvertToLLVMPass());
 
   // Cleanup
@@ -1,6 +1,8 @@
 #ifndef LIB_PIPELINES_PIPELINEREGISTRATION_H_
 #define LIB_PIPELINES_PIPELINEREGISTRATION_H_
 
+#include <cstdint>
+
 #include "mlir/include/mlir/Pass/PassManager.h"   // from @llvm-project
 #include "mlir/include/mlir/Pass/PassOptions.h"   // from @llvm-project
 #include "mlir/include/mlir/Pass/PassRegistry.h"  // from @llvm-project
@@ -19,7 +21,36 @@ struct TosaToArithOptions : public PassPipelineOptions<TosaToArithOptions> {
 
 void tosaPipelineBuilder(OpPassManager &manager, bool unroll);
 
-void polynomialToLLVMPipelineBuilder(OpPassManager &manager);
+struct PolynomialToLLVMOptions
+    : public PassPipelineOptions<PolynomialToLLVMOptions> {
+  PassOptions::Option<bool> parallelize{
+      *this, "parallelize",
+      llvm::cl::desc("Run independent loops over tensors (e.g., over a tensor "
+                     "of polynomials or pointwise over coefficients) in "
+                     "parallel with OpenMP."),
+      llvm::cl::init(false)};
+  PassOptions::Option<int64_t> numThreads{
+      *this, "num-threads",
+      llvm::cl::desc("The number of OpenMP threads used when parallelizing. "
+                     "Zero defers to the OpenMP runtime."),
+      llvm::cl::init(0)};
+  PassOptions::Option<int64_t> loopTileSize{
+      *this, "loop-tile-size",
+      llvm::cl::desc("The number of iterations of an independent loop, e.g., "
+                     "polynomials of a tensor, run by each parallel task."),
+      llvm::cl::init(1)};
+  PassOptions::Option<int64_t> linalgTileSize{
+      *this, "linalg-tile-size",
+      llvm::cl::desc("The number of iterations of the leading loop of a "
+                     "pointwise op run by each parallel task."),
+      llvm::cl::init(256)};
+};
+
+void polynomialToLLVMPipelineBuilder(OpPassManager &manager,
+                                     bool parallelize = false,
+                                     int64_t numThreads = 0,
+                                     int64_t loopTileSize = 1,
+                                     int64_t linalgTileSize = 256);
 
 void basicMLIRToLLVMPipelineBuilder(OpPassManager &manager);
 
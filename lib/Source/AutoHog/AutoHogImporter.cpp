@@ -1,19 +1,24 @@
 #include "lib/Source/AutoHog/AutoHogImporter.h"
 
 #include <cassert>
+#include <cstddef>
 #include <cstdint>
 #include <cstring>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "lib/Dialect/CGGI/IR/CGGIDialect.h"
 #include "lib/Dialect/CGGI/IR/CGGIOps.h"
 #include "lib/Dialect/LWE/IR/LWEAttributes.h"
 #include "lib/Dialect/LWE/IR/LWEDialect.h"
 #include "lib/Dialect/LWE/IR/LWETypes.h"
-#include "lib/Utils/Graph/Graph.h"
+#include "lib/Utils/Graph/CompactGraph.h"
 #include "llvm/include/llvm/ADT/STLExtras.h"             // from @llvm-project
 #include "llvm/include/llvm/ADT/StringMap.h"             // from @llvm-project
 #include "llvm/include/llvm/ADT/StringRef.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/Twine.h"                 // from @llvm-project
+#include "llvm/include/llvm/Support/CommandLine.h"       // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"             // from @llvm-project
 #include "llvm/include/llvm/Support/ErrorHandling.h"     // from @llvm-project
 #include "llvm/include/llvm/Support/raw_ostream.h"       // from @llvm-project
@@ -33,6 +38,7 @@
 
 // JSON headers separated to prevent copybara reordering.
 #include "rapidjson/document.h"      // from @rapidjson
+#include "rapidjson/error/en.h"      // from @rapidjson
 #include "rapidjson/reader.h"        // from @rapidjson
 #include "rapidjson/stringbuffer.h"  // from @rapidjson
 #include "rapidjson/writer.h"        // from @rapidjson
@@ -44,11 +50,20 @@ namespace heir {
 
 using llvm::StringMap;
 
+static llvm::cl::opt<bool> autoHogStreaming(
+    "autohog-streaming",
+    llvm::cl::desc("Import the AutoHoG cells one at a time instead of "
+                   "parsing the whole JSON document into memory"),
+    llvm::cl::init(false));
+
 void registerFromAutoHogTranslation() {
   TranslateToMLIRRegistration reg(
       "import-autohog", "Import from AutoHoG JSON to HEIR MLIR",
       [](llvm::StringRef inputString,
          MLIRContext *context) -> OwningOpRef<Operation *> {
+        if (autoHogStreaming) {
+          return translateFromAutoHogStreaming(inputString, context);
+        }
         return translateFromAutoHog(inputString, context);
       },
       [](DialectRegistry &registry) {
@@ -60,9 +75,8 @@ void registerFromAutoHogTranslation() {
       });
 }
 
-void parseIOPorts(const rapidjson::Value &document, StringMap<Port> &ports) {
+void parseIOPorts(const rapidjson::Value &docPorts, StringMap<Port> &ports) {
   LLVM_DEBUG(llvm::dbgs() << "Parsing IO ports\n");
-  auto &docPorts = document["ports"];
   assert(docPorts.IsArray() && "Expected 'ports' to be an array");
   for (rapidjson::Value::ConstValueIterator itr = docPorts.Begin();
        itr != docPorts.End(); ++itr) {
@@ -117,15 +131,10 @@ void parseIOPorts(const rapidjson::Value &document, StringMap<Port> &ports) {
 
 /// Parse the connections field of a cell object in the JSON document.
 /// - Populates the connections map, mapping the local port name to the
-/// connected
-///   Port object (an IO port or another cell).
-/// - Populates the outputPortToConnectedCellPort map, mapping an output ioPort
-///   to the corresponding local CELL type Port of the current cell.
-void parseCellConnections(const char *cellName,
-                          const rapidjson::Value &cellData,
+///   connected Port object (an IO port or another cell).
+void parseCellConnections(const rapidjson::Value &cellData,
                           const StringMap<Port> &ioPorts,
-                          StringMap<Port> &connections,
-                          StringMap<Port> &outputPortToConnectedCellPort) {
+                          StringMap<Port> &connections) {
   LLVM_DEBUG(llvm::dbgs() << "Parsing cell connections\n");
   auto &jsonConnections = cellData["connections"];
   assert(jsonConnections.IsObject() &&
@@ -148,23 +157,19 @@ void parseCellConnections(const char *cellName,
       port.cellName = connectedCell;
     } else {
       port.type = ioPorts.at(connectedPortName).type;
-      if (port.type == PortType::OUTPUT) {
-        Port localPort(PortType::CELL, std::string(localPortName),
-                       std::string(cellName));
-        outputPortToConnectedCellPort[StringRef(connectedPortName)] = localPort;
-      }
     }
     connections[StringRef(localPortName)] = port;
   }
 }
 
 /// Construct the cell graph from the JSON document.
-/// - Returns a graph::Graph<const char *> object where the nodes are cell names
-///   and the edges are dependencies between cells.
-graph::Graph<std::string> constructCellGraph(
+/// - Returns a graph::IdMappedGraph<std::string> object where the nodes are
+///   cell names, numbered in the order they are first seen, and the edges are
+///   dependencies between cells.
+graph::IdMappedGraph<std::string> constructCellGraph(
     const rapidjson::Document &document) {
   LLVM_DEBUG(llvm::dbgs() << "Topologically sorting cells\n");
-  graph::Graph<std::string> cellGraph;
+  graph::IdMappedGraph<std::string> cellGraph;
   auto &cells = document["cells"];
   assert(cells.IsObject() && "Expected 'cells' to be an object");
   for (rapidjson::Value::ConstMemberIterator itr = cells.MemberBegin();
@@ -172,7 +177,8 @@ graph::Graph<std::string> constructCellGraph(
     const rapidjson::Value &cell = itr->value;
     assert(cell.IsObject() && "Expected cell to be an object");
     const char *cellName = cell["cell_name"].GetString();
-    cellGraph.addVertex(std::string(cellName));
+    graph::CompactGraph::VertexId cellId =
+        cellGraph.addVertex(std::string(cellName));
     auto &connections = cell["connections"];
     assert(connections.IsObject() && "Expected 'connections' to be an object");
     for (rapidjson::Value::ConstMemberIterator itr = connections.MemberBegin();
@@ -187,12 +193,11 @@ graph::Graph<std::string> constructCellGraph(
         const char *connectedCell = portData["cell"].GetString();
         // Since the input is not toposorted, we may need to add the incident
         // vertex.
-        if (!cellGraph.contains(std::string(connectedCell))) {
-          cellGraph.addVertex(std::string(connectedCell));
-        }
+        graph::CompactGraph::VertexId connectedId =
+            cellGraph.addVertex(std::string(connectedCell));
         LLVM_DEBUG(llvm::dbgs() << "Adding edge from " << cellName << " to "
                                 << connectedCell << "\n");
-        cellGraph.addEdge(std::string(cellName), std::string(connectedCell));
+        cellGraph.getGraph().addEdge(cellId, connectedId);
       }
     }
   }
@@ -238,8 +243,53 @@ void parseLinCombCoefficients(
   }
 }
 
-OwningOpRef<Operation *> translateFromAutoHog(llvm::StringRef inputString,
-                                              MLIRContext *context) {
+namespace {
+
+// Creates the function for a circuit and the ops for its cells. A cell must be
+// emitted after the cells it reads from.
+class CircuitEmitter {
+ public:
+  CircuitEmitter(MLIRContext *context, StringRef circuitName,
+                 const StringMap<Port> &ioPorts);
+
+  OwningOpRef<Operation *> takeModule() { return std::move(opRef); }
+
+  // Creates the op for the given cell.
+  LogicalResult emitCell(StringRef cellName, const rapidjson::Value &cell);
+
+  // Forgets the results of an emitted cell, which may not be read by any
+  // cell emitted afterwards.
+  void releaseCell(StringRef cellName) {
+    cellsByName.erase(cellName);
+    cellOutputPortToResultIndex.erase(cellName);
+  }
+
+  // Returns the values of the output ports from the function.
+  LogicalResult emitReturn();
+
+ private:
+  OpBuilder builder;
+  OwningOpRef<Operation *> opRef;
+  func::FuncOp funcOp;
+  BlockArgument funcArg;
+  Type ciphertextType;
+  const StringMap<Port> &ioPorts;
+
+  // The maps created here will be used to access the input and output tensors
+  // during operation creation.
+  StringMap<int> inputPortToTensorIndex;
+  StringMap<int> outputPortToTensorIndex;
+
+  StringMap<Operation *> cellsByName;
+  // Keep track of which result index a cell's output port corresponds to.
+  StringMap<StringMap<int>> cellOutputPortToResultIndex;
+  // The values of the output ports that are connected to cells.
+  SmallVector<Value> outputValues;
+};
+
+CircuitEmitter::CircuitEmitter(MLIRContext *context, StringRef circuitName,
+                               const StringMap<Port> &ioPorts)
+    : builder(context), ioPorts(ioPorts) {
   // Have to manually load dialects because they are loaded at parse time,
   // but we have no MLIR inputs.
   context->getOrLoadDialect<arith::ArithDialect>();
@@ -248,41 +298,15 @@ OwningOpRef<Operation *> translateFromAutoHog(llvm::StringRef inputString,
   context->getOrLoadDialect<lwe::LWEDialect>();
   context->getOrLoadDialect<tensor::TensorDialect>();
 
-  LLVM_DEBUG(llvm::dbgs() << "Translating from AutoHoG JSON to MLIR\n");
-  LLVM_DEBUG(llvm::dbgs() << "Input string: \n" << inputString << "\n");
-  const char *json = inputString.data();
-  rapidjson::StringStream ss(json);
-  rapidjson::Document document;
-  document.ParseStream(ss);
-
-  LLVM_DEBUG({
-    rapidjson::StringBuffer buffer;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
-    document.Accept(writer);
-    const char *output = buffer.GetString();
-    llvm::dbgs() << "Parsed JSON: " << output << "\n";
-  });
-  assert(document.IsObject() && "JSON failed to parse");
-
-  StringMap<Port> ioPorts;
-  parseIOPorts(document, ioPorts);
-
-  OpBuilder builder(context);
   ModuleOp moduleOp = builder.create<ModuleOp>(builder.getUnknownLoc());
-  OwningOpRef<Operation *> opRef(moduleOp);
-  moduleOp->setAttr(
-      "cggi.circuit_name",
-      StringAttr::get(context, document["circuit_name"].GetString()));
+  opRef = OwningOpRef<Operation *>(moduleOp);
+  moduleOp->setAttr("cggi.circuit_name", StringAttr::get(context, circuitName));
 
   builder.setInsertionPointToStart(&moduleOp.getBodyRegion().front());
 
   // Parse "ports" field to assemble input and output types
   // The function will always be a tensor<Nxi1> -> tensor<Mxi1>
   // for N = #inputs and M = #outputs
-  // The maps created here will be used to access the input and output tensors
-  // during operation creation.
-  StringMap<int> inputPortToTensorIndex;
-  StringMap<int> outputPortToTensorIndex;
   int numInputs = 0;
   int numOutputs = 0;
   for (auto &[portName, port] : ioPorts) {
@@ -292,210 +316,190 @@ OwningOpRef<Operation *> translateFromAutoHog(llvm::StringRef inputString,
       outputPortToTensorIndex[portName] = numOutputs++;
     }
   }
+  outputValues.resize(numOutputs);
 
   // TODO(#686): detect proper minBitWidth from the circuit
   int minBitWidth = 3;
-  Type ciphertextType = lwe::LWECiphertextType::get(
+  ciphertextType = lwe::LWECiphertextType::get(
       context, lwe::UnspecifiedBitFieldEncodingAttr::get(context, minBitWidth),
       lwe::LWEParamsAttr());
   Type inputType = RankedTensorType::get({numInputs}, ciphertextType);
   Type outputType = RankedTensorType::get({numOutputs}, ciphertextType);
   auto functionType = builder.getFunctionType({inputType}, {outputType});
 
-  std::string funcName = std::string(document["circuit_name"].GetString());
-  auto funcOp =
-      builder.create<func::FuncOp>(moduleOp->getLoc(), funcName, functionType);
+  funcOp = builder.create<func::FuncOp>(moduleOp->getLoc(), circuitName,
+                                        functionType);
   funcOp.setPrivate();
   auto *entryBlock = funcOp.addEntryBlock();
   builder.setInsertionPointToEnd(entryBlock);
-  BlockArgument funcArg = funcOp.getArgument(0);
+  funcArg = funcOp.getArgument(0);
+}
 
-  // Parse "cells" field to construct ops
-  StringMap<Operation *> cellsByName;
-  // Keep track of which result index a cell's output port corresponds to.
-  StringMap<StringMap<int>> cellOutputPortToResultIndex;
-  StringMap<Port> outputPortToConnectedCellPort;
+LogicalResult CircuitEmitter::emitCell(StringRef cellName,
+                                       const rapidjson::Value &cell) {
+  assert(cell.IsObject() && "Expected cell to be an object");
 
-  auto &cells = document["cells"];
-  assert(cells.IsObject() && "Expected 'cells' to be an object");
+  const char *cellType = cell["type"].GetString();
+  Operation *op = nullptr;
 
-  // First we must topologically sort the cells to ensure that we create
-  // Operations for all inputs to a cell before visiting the cell itself.
-  graph::Graph<std::string> cellGraph = constructCellGraph(document);
-  auto sortResult = cellGraph.topologicalSort();
-  assert(succeeded(sortResult) && "Circuit contains a cycle in its cell graph");
-  LLVM_DEBUG({
-    llvm::dbgs() << "Topological sort of cells:\n";
-    for (std::string &cellName : sortResult.value()) {
-      llvm::dbgs() << "  " << cellName << "\n";
-    }
-  });
+  SmallVector<Value> operands;
+  // Because all the JSON fields are objects, iteration order is arbitrary,
+  // and we need this to ensure the coefficient order matches the operand
+  // order.
+  StringMap<int> inputPortNameToOperandIndex;
+  SmallVector<Type> resultTypes;
 
-  for (std::string &cellName : llvm::reverse(sortResult.value())) {
-    const rapidjson::Value &cell = cells[cellName.c_str()];
-    assert(cell.IsObject() && "Expected cell to be an object");
+  // Cell-local port mapping to input/output
+  StringMap<bool> isInput;
+  for (rapidjson::Value::ConstMemberIterator itr =
+           cell["port_directions"].MemberBegin();
+       itr != cell["port_directions"].MemberEnd(); ++itr) {
+    const char *wireName = itr->name.GetString();
+    const char *wireDirection = itr->value.GetString();
+    isInput[StringRef(wireName)] = strcmp(wireDirection, "input") == 0;
+  }
 
-    const char *cellType = cell["type"].GetString();
-    Operation *op = nullptr;
-
-    SmallVector<Value> operands;
-    // Because all the JSON fields are objects, iteration order is arbitrary,
-    // and we need this to ensure the coefficient order matches the operand
-    // order.
-    StringMap<int> inputPortNameToOperandIndex;
-    SmallVector<Type> resultTypes;
-
-    // Cell-local port mapping to input/output
-    StringMap<bool> isInput;
-    for (rapidjson::Value::ConstMemberIterator itr =
-             cell["port_directions"].MemberBegin();
-         itr != cell["port_directions"].MemberEnd(); ++itr) {
-      const char *wireName = itr->name.GetString();
-      const char *wireDirection = itr->value.GetString();
-      isInput[StringRef(wireName)] = strcmp(wireDirection, "input") == 0;
-    }
+  // Collect operands and result types for the new op
+  StringMap<Port> connections;
+  int resultIndex = 0;
+  int operandIndex = 0;
+  parseCellConnections(cell, ioPorts, connections);
 
-    // Collect operands and result types for the new op
-    StringMap<Port> connections;
-    int resultIndex = 0;
-    int operandIndex = 0;
-    parseCellConnections(cellName.c_str(), cell, ioPorts, connections,
-                         outputPortToConnectedCellPort);
-
-    LLVM_DEBUG(llvm::dbgs() << "Collecting operands and results for cell: "
-                            << cellName << " of type " << cellType << "\n");
-    for (const auto &[localPortName, connectedPort] : connections) {
-      if (isInput[localPortName]) {
-        LLVM_DEBUG(llvm::dbgs()
-                   << "Processing local input port: " << localPortName << "\n");
-        if (connectedPort.type == PortType::INPUT) {
-          int tensorIndex = inputPortToTensorIndex[connectedPort.portName];
-          auto indexValue =
-              builder
-                  .create<arith::ConstantIndexOp>(funcOp.getLoc(), tensorIndex)
-                  .getResult();
-          Value operand = builder.create<tensor::ExtractOp>(
-              funcOp.getLoc(), funcArg, indexValue);
-          operands.push_back(operand);
-          inputPortNameToOperandIndex[localPortName] = operandIndex++;
-        } else if (connectedPort.type == PortType::CELL) {
-          const char *connectedCellName =
-              connectedPort.cellName.value().c_str();
-          if (!cellsByName.contains(connectedCellName)) {
-            llvm::errs() << "Cell " << cellName
-                         << " refers to unknown input cell "
-                         << connectedCellName
-                         << ", maybe topological sort failed or input parsing "
-                            "failed, try debug mode for more info.";
-            return opRef;
-          }
-          Operation *upstreamOp = cellsByName[connectedCellName];
-          Value operand =
-              upstreamOp->getResult(cellOutputPortToResultIndex
-                                        .at(connectedPort.cellName.value_or(""))
-                                        .at(connectedPort.portName));
-          operands.push_back(operand);
-          inputPortNameToOperandIndex[localPortName] = operandIndex++;
-        } else {
-          llvm::errs() << "Detected invalid JSON input: Cell input may not be "
-                          "an output port\n";
-          return opRef;
+  LLVM_DEBUG(llvm::dbgs() << "Collecting operands and results for cell: "
+                          << cellName << " of type " << cellType << "\n");
+  for (const auto &[localPortName, connectedPort] : connections) {
+    if (isInput[localPortName]) {
+      LLVM_DEBUG(llvm::dbgs()
+                 << "Processing local input port: " << localPortName << "\n");
+      if (connectedPort.type == PortType::INPUT) {
+        int tensorIndex = inputPortToTensorIndex[connectedPort.portName];
+        auto indexValue =
+            builder.create<arith::ConstantIndexOp>(funcOp.getLoc(), tensorIndex)
+                .getResult();
+        Value operand = builder.create<tensor::ExtractOp>(funcOp.getLoc(),
+                                                          funcArg, indexValue);
+        operands.push_back(operand);
+        inputPortNameToOperandIndex[localPortName] = operandIndex++;
+      } else if (connectedPort.type == PortType::CELL) {
+        const char *connectedCellName = connectedPort.cellName.value().c_str();
+        if (!cellsByName.contains(connectedCellName)) {
+          llvm::errs() << "Cell " << cellName
+                       << " refers to unknown input cell " << connectedCellName
+                       << ", maybe topological sort failed or input parsing "
+                          "failed, try debug mode for more info.";
+          return failure();
         }
-      } else {  // wire is a cell output
-        LLVM_DEBUG(llvm::dbgs() << "Processing local output port: "
-                                << localPortName << "\n");
-        resultTypes.push_back(ciphertextType);
-        cellOutputPortToResultIndex[cellName][localPortName] = resultIndex;
-        resultIndex++;
+        Operation *upstreamOp = cellsByName[connectedCellName];
+        Value operand =
+            upstreamOp->getResult(cellOutputPortToResultIndex
+                                      .at(connectedPort.cellName.value_or(""))
+                                      .at(connectedPort.portName));
+        operands.push_back(operand);
+        inputPortNameToOperandIndex[localPortName] = operandIndex++;
+      } else {
+        llvm::errs() << "Detected invalid JSON input: Cell input may not be "
+                        "an output port\n";
+        return failure();
       }
+    } else {  // wire is a cell output
+      LLVM_DEBUG(llvm::dbgs()
+                 << "Processing local output port: " << localPortName << "\n");
+      resultTypes.push_back(ciphertextType);
+      cellOutputPortToResultIndex[cellName][localPortName] = resultIndex;
+      resultIndex++;
     }
+  }
 
-    LLVM_DEBUG({
-      llvm::dbgs() << "Operands:\n";
-      for (Value operand : operands) {
-        operand.print(llvm::dbgs());
-        llvm::dbgs() << "\n";
-      }
-      llvm::dbgs() << "Results:\n";
-      for (Type resultType : resultTypes) {
-        resultType.print(llvm::dbgs());
-        llvm::dbgs() << "\n";
-      }
-    });
-
-    // Actually construct the op
-    if (strcmp(cellType, "HomGateM") == 0) {
-      SmallVector<int> coefficients;
-      coefficients.resize(operands.size());
-      parseLinCombCoefficients(cell["weights"].GetObject(),
-                               inputPortNameToOperandIndex, coefficients);
-      SmallVector<int32_t> lookupTables;
-      const auto &jsonTables = cell["tableT"];
-      assert(jsonTables.IsObject() && "Expected 'tableT' to be an object");
-
-      for (rapidjson::Value::ConstMemberIterator itr = jsonTables.MemberBegin();
-           itr != jsonTables.MemberEnd(); ++itr) {
-        [[maybe_unused]] const char *portName = itr->name.GetString();
-        const rapidjson::Value &table = itr->value;
-        assert(!isInput[portName] &&
-               "Expected key to tableT to be an output port");
-        assert(table.IsArray() && "Expected 'tableT' to be an array");
-        int lookupTable = parseLut(table.GetArray());
-        lookupTables.push_back(lookupTable);
-      }
-      op = builder.create<cggi::MultiLutLinCombOp>(
-          funcOp.getLoc(), resultTypes, operands, coefficients,
-          builder.getDenseI32ArrayAttr(lookupTables));
-    } else if (strcmp(cellType, "HomGateS") == 0) {
-      SmallVector<int> coefficients;
-      coefficients.resize(operands.size());
-      parseLinCombCoefficients(cell["weights"].GetObject(),
-                               inputPortNameToOperandIndex, coefficients);
-      // Only one output port, so just take the first LUT
-      auto lookupTableJson = cell["tableT"].MemberBegin()->value.GetArray();
-      int lookupTable = parseLut(lookupTableJson);
-      op = builder.create<cggi::LutLinCombOp>(
-          funcOp.getLoc(), resultTypes, operands, coefficients,
-          builder.getI32IntegerAttr(lookupTable));
-    } else if (strcmp(cellType, "AND") == 0) {
-      op = builder.create<cggi::AndOp>(funcOp.getLoc(), resultTypes, operands);
-    } else if (strcmp(cellType, "NAND") == 0) {
-      op = builder.create<cggi::NandOp>(funcOp.getLoc(), resultTypes, operands);
-    } else if (strcmp(cellType, "NOR") == 0) {
-      op = builder.create<cggi::NorOp>(funcOp.getLoc(), resultTypes, operands);
-    } else if (strcmp(cellType, "OR") == 0) {
-      op = builder.create<cggi::OrOp>(funcOp.getLoc(), resultTypes, operands);
-    } else if (strcmp(cellType, "XOR") == 0) {
-      op = builder.create<cggi::XorOp>(funcOp.getLoc(), resultTypes, operands);
-    } else if (strcmp(cellType, "XNOR") == 0) {
-      op = builder.create<cggi::XNorOp>(funcOp.getLoc(), resultTypes, operands);
-    } else if (strcmp(cellType, "NOT") == 0) {
-      op = builder.create<cggi::NotOp>(funcOp.getLoc(), resultTypes, operands);
-    } else {
-      llvm::errs() << "Detected invalid JSON input: unknown cell type: "
-                   << cellType << "\n";
-      return opRef;
+  LLVM_DEBUG({
+    llvm::dbgs() << "Operands:\n";
+    for (Value operand : operands) {
+      operand.print(llvm::dbgs());
+      llvm::dbgs() << "\n";
+    }
+    llvm::dbgs() << "Results:\n";
+    for (Type resultType : resultTypes) {
+      resultType.print(llvm::dbgs());
+      llvm::dbgs() << "\n";
+    }
+  });
+
+  // Actually construct the op
+  if (strcmp(cellType, "HomGateM") == 0) {
+    SmallVector<int> coefficients;
+    coefficients.resize(operands.size());
+    parseLinCombCoefficients(cell["weights"].GetObject(),
+                             inputPortNameToOperandIndex, coefficients);
+    SmallVector<int32_t> lookupTables;
+    const auto &jsonTables = cell["tableT"];
+    assert(jsonTables.IsObject() && "Expected 'tableT' to be an object");
+
+    for (rapidjson::Value::ConstMemberIterator itr = jsonTables.MemberBegin();
+         itr != jsonTables.MemberEnd(); ++itr) {
+      [[maybe_unused]] const char *portName = itr->name.GetString();
+      const rapidjson::Value &table = itr->value;
+      assert(!isInput[portName] &&
+             "Expected key to tableT to be an output port");
+      assert(table.IsArray() && "Expected 'tableT' to be an array");
+      int lookupTable = parseLut(table.GetArray());
+      lookupTables.push_back(lookupTable);
     }
+    op = builder.create<cggi::MultiLutLinCombOp>(
+        funcOp.getLoc(), resultTypes, operands, coefficients,
+        builder.getDenseI32ArrayAttr(lookupTables));
+  } else if (strcmp(cellType, "HomGateS") == 0) {
+    SmallVector<int> coefficients;
+    coefficients.resize(operands.size());
+    parseLinCombCoefficients(cell["weights"].GetObject(),
+                             inputPortNameToOperandIndex, coefficients);
+    // Only one output port, so just take the first LUT
+    auto lookupTableJson = cell["tableT"].MemberBegin()->value.GetArray();
+    int lookupTable = parseLut(lookupTableJson);
+    op = builder.create<cggi::LutLinCombOp>(
+        funcOp.getLoc(), resultTypes, operands, coefficients,
+        builder.getI32IntegerAttr(lookupTable));
+  } else if (strcmp(cellType, "AND") == 0) {
+    op = builder.create<cggi::AndOp>(funcOp.getLoc(), resultTypes, operands);
+  } else if (strcmp(cellType, "NAND") == 0) {
+    op = builder.create<cggi::NandOp>(funcOp.getLoc(), resultTypes, operands);
+  } else if (strcmp(cellType, "NOR") == 0) {
+    op = builder.create<cggi::NorOp>(funcOp.getLoc(), resultTypes, operands);
+  } else if (strcmp(cellType, "OR") == 0) {
+    op = builder.create<cggi::OrOp>(funcOp.getLoc(), resultTypes, operands);
+  } else if (strcmp(cellType, "XOR") == 0) {
+    op = builder.create<cggi::XorOp>(funcOp.getLoc(), resultTypes, operands);
+  } else if (strcmp(cellType, "XNOR") == 0) {
+    op = builder.create<cggi::XNorOp>(funcOp.getLoc(), resultTypes, operands);
+  } else if (strcmp(cellType, "NOT") == 0) {
+    op = builder.create<cggi::NotOp>(funcOp.getLoc(), resultTypes, operands);
+  } else {
+    llvm::errs() << "Detected invalid JSON input: unknown cell type: "
+                 << cellType << "\n";
+    return failure();
+  }
+
+  cellsByName[cellName] = op;
 
-    cellsByName[cellName] = op;
+  // Record the values of the output ports this cell drives, so that its
+  // results can be released before the function returns.
+  for (const auto &[localPortName, connectedPort] : connections) {
+    if (isInput[localPortName] || connectedPort.type != PortType::OUTPUT) {
+      continue;
+    }
+    LLVM_DEBUG(llvm::dbgs()
+               << "Output port " << connectedPort.portName
+               << " is connected to cell port " << localPortName << " of cell "
+               << cellName << "\n");
+    outputValues[outputPortToTensorIndex[connectedPort.portName]] =
+        op->getResult(cellOutputPortToResultIndex[cellName][localPortName]);
   }
+  return success();
+}
 
+LogicalResult CircuitEmitter::emitReturn() {
   LLVM_DEBUG(llvm::dbgs() << "Ops created for circuit cells. Func (which "
                              "should not verify because it has no return): "
                           << funcOp << "\n");
 
-  LLVM_DEBUG({
-    llvm::dbgs() << "cellOutputPortToResultIndex=\n";
-    for (auto &[cellName, portToIndex] : cellOutputPortToResultIndex) {
-      llvm::dbgs() << "  " << cellName << ":\n";
-      for (auto &[portName, index] : portToIndex) {
-        llvm::dbgs() << "    " << portName << " -> " << index << "\n";
-      }
-    }
-  });
-
-  SmallVector<Value> outputValues;
-  outputValues.resize(numOutputs);
   for (auto &[portName, port] : ioPorts) {
     if (port.type != PortType::OUTPUT) continue;
     LLVM_DEBUG(llvm::dbgs()
@@ -514,30 +518,262 @@ OwningOpRef<Operation *> translateFromAutoHog(llvm::StringRef inputString,
       continue;
     }
 
-    if (outputPortToConnectedCellPort.contains(portName)) {
-      Port cellPort = outputPortToConnectedCellPort[portName];
-      LLVM_DEBUG(llvm::dbgs()
-                 << "Output port " << portName << " is connected to cell port "
-                 << cellPort.portName << " of cell "
-                 << cellPort.cellName.value_or("") << "\n");
-      Operation *op = cellsByName[cellPort.cellName.value().c_str()];
-      int resultIndex =
-          cellOutputPortToResultIndex.at(cellPort.cellName.value_or(""))
-              .at(cellPort.portName);
-      outputValues[outputPortToTensorIndex[portName]] =
-          op->getResult(resultIndex);
+    if (outputValues[outputPortToTensorIndex[portName]]) {
       continue;
     }
 
     llvm::errs() << "Detected invalid JSON input: Output port " << portName
                  << " is not connected to any input or cell output\n";
-    return opRef;
+    return failure();
   }
 
   auto fromElementsOp =
       builder.create<tensor::FromElementsOp>(funcOp.getLoc(), outputValues);
   builder.create<func::ReturnOp>(funcOp.getLoc(), fromElementsOp.getResult());
-  return opRef;
+  return success();
+}
+
+// A SAX handler that scans an AutoHoG JSON document without building it in
+// memory. It records the circuit name, the byte ranges of the "ports" array
+// and of each cell, and a compact graph of the cells whose vertices are the
+// interned cell names, with an edge from each cell to the cells reading it.
+class CellScanner
+    : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>, CellScanner> {
+ public:
+  using Range = std::pair<size_t, size_t>;
+
+  explicit CellScanner(const rapidjson::StringStream &stream)
+      : stream(stream) {}
+
+  bool StartObject() { return startContainer(/*isObject=*/true); }
+  bool StartArray() { return startContainer(/*isObject=*/false); }
+  bool EndObject(rapidjson::SizeType) { return endContainer(); }
+  bool EndArray(rapidjson::SizeType) { return endContainer(); }
+
+  bool Key(const char *str, rapidjson::SizeType length, bool) {
+    keys[depth].assign(str, length);
+    return true;
+  }
+
+  bool String(const char *str, rapidjson::SizeType length, bool) {
+    StringRef value(str, length);
+    if (depth == 1 && keys[1] == "circuit_name") {
+      circuitName = value.str();
+    } else if (depth == 3 && inCells() && keys[3] == "cell_name") {
+      cellName = value.str();
+    } else if (depth == 4 && inCells() && keys[3] == "port_directions") {
+      isInput[keys[4]] = value == "input";
+    } else if (depth == 5 && inCells() && keys[3] == "connections" &&
+               keys[5] == "cell") {
+      connectedCells.emplace_back(keys[4], value.str());
+    }
+    return true;
+  }
+
+  std::string circuitName;
+  Range portsRange = {0, 0};
+  graph::IdMappedGraph<std::string> cellGraph;
+  // The byte range of each cell, indexed by the id of its name. The range is
+  // empty for cells that are read but not defined.
+  std::vector<Range> cellRanges;
+  std::string error;
+
+ private:
+  bool inCells() const { return keys[1] == "cells"; }
+
+  bool fail(const Twine &message) {
+    error = message.str();
+    return false;
+  }
+
+  bool startContainer(bool isObject) {
+    ++depth;
+    if (keys.size() <= static_cast<size_t>(depth)) keys.resize(depth + 1);
+    keys[depth].clear();
+    // The opening bracket has already been consumed.
+    size_t begin = stream.Tell() - 1;
+    if (depth == 2 && keys[1] == "ports") {
+      if (isObject) return fail("Expected 'ports' to be an array");
+      portsRange.first = begin;
+    } else if (depth == 2 && inCells()) {
+      if (!isObject) return fail("Expected 'cells' to be an object");
+    } else if (depth == 3 && inCells()) {
+      if (!isObject) return fail("Expected cell to be an object");
+      cellBegin = begin;
+      cellName.clear();
+      isInput.clear();
+      connectedCells.clear();
+    }
+    return true;
+  }
+
+  bool endContainer() {
+    size_t end = stream.Tell();
+    if (depth == 2 && keys[1] == "ports") {
+      portsRange.second = end;
+    } else if (depth == 3 && inCells() && !finishCell(end)) {
+      return false;
+    }
+    --depth;
+    return true;
+  }
+
+  bool finishCell(size_t end) {
+    if (cellName.empty()) return fail("Expected cell to have a 'cell_name'");
+    graph::CompactGraph::VertexId id = cellGraph.addVertex(cellName);
+    cellRanges.resize(cellGraph.size());
+    if (cellRanges[id].second != 0) return fail("Duplicate cell " + cellName);
+    cellRanges[id] = {cellBegin, end};
+    for (const auto &[localPortName, connectedCell] : connectedCells) {
+      if (!isInput.lookup(localPortName)) continue;
+      LLVM_DEBUG(llvm::dbgs() << "Adding edge from " << connectedCell << " to "
+                              << cellName << "\n");
+      graph::CompactGraph::VertexId connectedId =
+          cellGraph.addVertex(connectedCell);
+      cellGraph.getGraph().addEdge(connectedId, id);
+    }
+    cellRanges.resize(cellGraph.size());
+    return true;
+  }
+
+  const rapidjson::StringStream &stream;
+  int depth = 0;
+  // keys[d] is the last key seen in the object at depth d.
+  std::vector<std::string> keys = {""};
+
+  // The state of the cell being scanned.
+  size_t cellBegin = 0;
+  std::string cellName;
+  StringMap<bool> isInput;
+  std::vector<std::pair<std::string, std::string>> connectedCells;
+};
+
+}  // namespace
+
+OwningOpRef<Operation *> translateFromAutoHog(llvm::StringRef inputString,
+                                              MLIRContext *context) {
+  LLVM_DEBUG(llvm::dbgs() << "Translating from AutoHoG JSON to MLIR\n");
+  LLVM_DEBUG(llvm::dbgs() << "Input string: \n" << inputString << "\n");
+  const char *json = inputString.data();
+  rapidjson::StringStream ss(json);
+  rapidjson::Document document;
+  document.ParseStream(ss);
+
+  LLVM_DEBUG({
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    document.Accept(writer);
+    const char *output = buffer.GetString();
+    llvm::dbgs() << "Parsed JSON: " << output << "\n";
+  });
+  assert(document.IsObject() && "JSON failed to parse");
+
+  StringMap<Port> ioPorts;
+  parseIOPorts(document["ports"], ioPorts);
+
+  CircuitEmitter emitter(context, document["circuit_name"].GetString(),
+                         ioPorts);
+
+  auto &cells = document["cells"];
+  assert(cells.IsObject() && "Expected 'cells' to be an object");
+
+  // First we must topologically sort the cells to ensure that we create
+  // Operations for all inputs to a cell before visiting the cell itself.
+  graph::IdMappedGraph<std::string> cellGraph = constructCellGraph(document);
+  auto sortResult = cellGraph.topologicalSort();
+  assert(succeeded(sortResult) && "Circuit contains a cycle in its cell graph");
+  LLVM_DEBUG({
+    llvm::dbgs() << "Topological sort of cells:\n";
+    for (std::string &cellName : sortResult.value()) {
+      llvm::dbgs() << "  " << cellName << "\n";
+    }
+  });
+
+  for (std::string &cellName : llvm::reverse(sortResult.value())) {
+    if (failed(emitter.emitCell(cellName, cells[cellName.c_str()]))) {
+      return emitter.takeModule();
+    }
+  }
+
+  (void)emitter.emitReturn();
+  return emitter.takeModule();
+}
+
+OwningOpRef<Operation *> translateFromAutoHogStreaming(
+    llvm::StringRef inputString, MLIRContext *context) {
+  LLVM_DEBUG(llvm::dbgs() << "Streaming from AutoHoG JSON to MLIR\n");
+  const char *json = inputString.data();
+  rapidjson::StringStream ss(json);
+  CellScanner scanner(ss);
+  rapidjson::Reader reader;
+  rapidjson::ParseResult parseResult = reader.Parse(ss, scanner);
+  if (!scanner.error.empty()) {
+    llvm::errs() << "Detected invalid JSON input: " << scanner.error << "\n";
+    return nullptr;
+  }
+  if (parseResult.IsError()) {
+    llvm::errs() << "JSON failed to parse at offset " << parseResult.Offset()
+                 << ": " << rapidjson::GetParseError_En(parseResult.Code())
+                 << "\n";
+    return nullptr;
+  }
+  auto [portsBegin, portsEnd] = scanner.portsRange;
+  if (portsBegin == portsEnd || scanner.circuitName.empty()) {
+    llvm::errs() << "Detected invalid JSON input: expected 'circuit_name' and "
+                    "'ports'\n";
+    return nullptr;
+  }
+
+  // The ports and each cell are small, so they are parsed into documents of
+  // their own when needed.
+  rapidjson::Document ports;
+  ports.Parse(json + portsBegin, portsEnd - portsBegin);
+  StringMap<Port> ioPorts;
+  parseIOPorts(ports, ioPorts);
+
+  CircuitEmitter emitter(context, scanner.circuitName, ioPorts);
+
+  graph::CompactGraph &cellGraph = scanner.cellGraph.getGraph();
+  auto sortResult = cellGraph.topologicalSort();
+  if (failed(sortResult)) {
+    llvm::errs() << "Circuit contains a cycle in its cell graph\n";
+    return nullptr;
+  }
+
+  // The number of readers of each cell that are not yet emitted. A cell's
+  // results are released when this reaches zero, so the emitter only holds
+  // the cells on the frontier of the sort.
+  std::vector<int64_t> pendingReaders(cellGraph.size());
+  for (graph::CompactGraph::VertexId id = 0; id < cellGraph.size(); ++id) {
+    pendingReaders[id] = cellGraph.edgesOutOf(id).size();
+  }
+
+  for (graph::CompactGraph::VertexId id : sortResult.value()) {
+    const std::string &cellName = scanner.cellGraph.getVertex(id);
+    auto [cellBegin, cellEnd] = scanner.cellRanges[id];
+    if (cellBegin == cellEnd) {
+      llvm::errs() << "Detected invalid JSON input: unknown cell " << cellName
+                   << "\n";
+      return emitter.takeModule();
+    }
+    rapidjson::Document cell;
+    cell.Parse(json + cellBegin, cellEnd - cellBegin);
+    if (failed(emitter.emitCell(cellName, cell))) {
+      return emitter.takeModule();
+    }
+
+    if (pendingReaders[id] == 0) {
+      emitter.releaseCell(cellName);
+    }
+    for (graph::CompactGraph::VertexId source : cellGraph.edgesInto(id)) {
+      if (--pendingReaders[source] == 0) {
+        emitter.releaseCell(scanner.cellGraph.getVertex(source));
+      }
+    }
+  }
+
+  (void)emitter.emitReturn();
+  return emitter.takeModule();
 }
 
 }  // namespace heir
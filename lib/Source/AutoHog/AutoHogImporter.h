@@ -44,6 +44,13 @@ void registerFromAutoHogTranslation();
 OwningOpRef<Operation *> translateFromAutoHog(llvm::StringRef inputString,
                                               MLIRContext *context);
 
+/// Translates the given operation from AutoHog without parsing the whole JSON
+/// document into memory. The cells are scanned first, interning their names
+/// to dense ids, and then parsed and emitted one at a time in a topological
+/// order of the cell graph.
+OwningOpRef<Operation *> translateFromAutoHogStreaming(
+    llvm::StringRef inputString, MLIRContext *context);
+
 }  // namespace heir
 }  // namespace mlir
 
@@ -1,5 +1,7 @@
 #include "lib/Target/Jaxite/JaxiteEmitter.h"
 
+#include <algorithm>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <iterator>
@@ -14,13 +16,17 @@
 #include "lib/Dialect/LWE/IR/LWETypes.h"
 #include "lib/Target/Jaxite/JaxiteTemplates.h"
 #include "lib/Utils/TargetUtils.h"
+#include "llvm/include/llvm/ADT/DenseMap.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"          // from @llvm-project
 #include "llvm/include/llvm/ADT/TypeSwitch.h"            // from @llvm-project
+#include "llvm/include/llvm/Support/CommandLine.h"       // from @llvm-project
 #include "llvm/include/llvm/Support/FormatVariadic.h"    // from @llvm-project
 #include "llvm/include/llvm/Support/raw_ostream.h"       // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"   // from @llvm-project
 #include "mlir/include/mlir/Dialect/MemRef/IR/MemRef.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Block.h"                  // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinAttributes.h"      // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinOps.h"             // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinTypeInterfaces.h"  // from @llvm-project
@@ -30,6 +36,7 @@
 #include "mlir/include/mlir/IR/Value.h"                  // from @llvm-project
 #include "mlir/include/mlir/IR/ValueRange.h"             // from @llvm-project
 #include "mlir/include/mlir/IR/Visitors.h"               // from @llvm-project
+#include "mlir/include/mlir/Interfaces/SideEffectInterfaces.h"  // from @llvm-project
 #include "mlir/include/mlir/Support/LLVM.h"              // from @llvm-project
 #include "mlir/include/mlir/Support/LogicalResult.h"     // from @llvm-project
 #include "mlir/include/mlir/Tools/mlir-translate/Translation.h"  // from @llvm-project
@@ -38,11 +45,17 @@ namespace mlir {
 namespace heir {
 namespace jaxite {
 
+static llvm::cl::opt<bool> batchLevels(
+    "jaxite-batch-levels",
+    llvm::cl::desc("Run the lut3 ops of each dependency level as one "
+                   "jit-compiled batched call"),
+    llvm::cl::init(false));
+
 void registerToJaxiteTranslation() {
   TranslateFromMLIRRegistration reg(
       "emit-jaxite", "translate the jaxite dialect to python code for jaxite",
       [](Operation *op, llvm::raw_ostream &output) {
-        return translateToJaxite(op, output);
+        return translateToJaxite(op, output, batchLevels);
       },
       [](DialectRegistry &registry) {
         registry.insert<func::FuncDialect, jaxite::JaxiteDialect,
@@ -51,9 +64,10 @@ void registerToJaxiteTranslation() {
       });
 }
 
-LogicalResult translateToJaxite(Operation *op, llvm::raw_ostream &os) {
+LogicalResult translateToJaxite(Operation *op, llvm::raw_ostream &os,
+                                bool batchLevels) {
   SelectVariableNames variableNames(op);
-  JaxiteEmitter emitter(os, &variableNames);
+  JaxiteEmitter emitter(os, &variableNames, batchLevels);
   return emitter.translate(*op);
 }
 
@@ -87,8 +101,103 @@ LogicalResult JaxiteEmitter::translate(Operation &op) {
   return success();
 }
 
+LogicalResult JaxiteEmitter::translateBlock(Block &block) {
+  if (!batchLevels) {
+    for (Operation &op : block.getOperations()) {
+      if (failed(translate(op))) {
+        return failure();
+      }
+    }
+    return success();
+  }
+
+  // The depth of a value is the number of lut3 levels it depends on. The lut3
+  // ops of depth k + 1 form level k, and the other ops are grouped into
+  // stages, where stage k holds the ops that must run before level k. Ops with
+  // side effects, like memref.load and memref.store, keep their program order.
+  DenseMap<Value, int64_t> depths;
+  auto maxDepth = [&](ValueRange values) {
+    int64_t depth = 0;
+    for (Value value : values) depth = std::max(depth, depths.lookup(value));
+    return depth;
+  };
+  SmallVector<SmallVector<Lut3Op>> levels;
+  SmallVector<SmallVector<Operation *>> stages;
+  int64_t sideEffectStage = 0;
+  for (Operation &op : block.without_terminator()) {
+    if (auto lut3Op = dyn_cast<Lut3Op>(op)) {
+      int64_t level = maxDepth(op.getOperands());
+      depths[lut3Op.getResult()] = level + 1;
+      if (static_cast<int64_t>(levels.size()) <= level)
+        levels.resize(level + 1);
+      levels[level].push_back(lut3Op);
+      continue;
+    }
+
+    int64_t stage = maxDepth(op.getOperands());
+    if (!isMemoryEffectFree(&op)) {
+      stage = std::max(stage, sideEffectStage);
+      sideEffectStage = stage;
+    }
+    for (Value result : op.getResults()) depths[result] = stage;
+    if (static_cast<int64_t>(stages.size()) <= stage)
+      stages.resize(stage + 1);
+    stages[stage].push_back(&op);
+  }
+
+  for (size_t k = 0; k < std::max(levels.size(), stages.size()); ++k) {
+    if (k < stages.size()) {
+      for (Operation *op : stages[k]) {
+        if (failed(translate(*op))) {
+          return failure();
+        }
+      }
+    }
+    if (k < levels.size() && !levels[k].empty()) {
+      emitLut3Level(levels[k]);
+    }
+  }
+
+  if (block.mightHaveTerminator()) {
+    return translate(*block.getTerminator());
+  }
+  return success();
+}
+
+void JaxiteEmitter::emitLut3Level(ArrayRef<Lut3Op> level) {
+  // The level becomes one batched call, with the operands of its ops stacked
+  // in program order.
+  auto tempNode = [&](Value value) {
+    return "temp_nodes[" +
+           std::to_string(variableNames->getIntForValue(value)) + "]";
+  };
+  SmallVector<Value> results, a, b, c;
+  SmallVector<uint64_t> truthTables;
+  for (Lut3Op lut3Op : level) {
+    results.push_back(lut3Op.getResult());
+    a.push_back(lut3Op.getA());
+    b.push_back(lut3Op.getB());
+    c.push_back(lut3Op.getC());
+    truthTables.push_back(
+        cast<IntegerAttr>(dyn_cast<arith::ConstantOp>(
+                              lut3Op.getTruthTable().getDefiningOp())
+                              .getValue())
+            .getValue()
+            .getZExtValue());
+  }
+  os << "[" << commaSeparatedValues(results, tempNode)
+     << "] = run_lut3_level([" << commaSeparatedValues(a, tempNode) << "], ["
+     << commaSeparatedValues(b, tempNode) << "], ["
+     << commaSeparatedValues(c, tempNode) << "], ["
+     << commaSeparated<uint64_t>(truthTables) << "], " << serverKeySetArg_
+     << ", " << paramsArg_ << ")\n";
+}
+
 LogicalResult JaxiteEmitter::printOperation(ModuleOp moduleOp) {
   os << kModulePrelude << "\n";
+  if (batchLevels) {
+    os << kLevelledPrelude << "\n";
+  }
   for (Operation &op : moduleOp) {
     if (failed(translate(op))) {
       return failure();
@@ -149,10 +258,8 @@ LogicalResult JaxiteEmitter::printOperation(func::FuncOp funcOp) {
   os << "temp_nodes: Dict[int, Any] = {}" << "\n";
 
   for (Block &block : funcOp.getBlocks()) {
-    for (Operation &op : block.getOperations()) {
-      if (failed(translate(op))) {
-        return failure();
-      }
+    if (failed(translateBlock(block))) {
+      return failure();
     }
   }
 
@@ -387,8 +494,9 @@ LogicalResult JaxiteEmitter::emitType(Type type) {
 }
 
 JaxiteEmitter::JaxiteEmitter(raw_ostream &os,
-                             SelectVariableNames *variableNames)
-    : os(os), variableNames(variableNames) {}
+                             SelectVariableNames *variableNames,
+                             bool batchLevels)
+    : batchLevels(batchLevels), os(os), variableNames(variableNames) {}
 
 }  // namespace jaxite
 }  // namespace heir
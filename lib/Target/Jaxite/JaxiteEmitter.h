@@ -25,15 +25,21 @@ void registerToJaxiteTranslation();
 
 /// Translates the given operation to Jaxire.
 ::mlir::LogicalResult translateToJaxite(::mlir::Operation *op,
-                                        llvm::raw_ostream &os);
+                                        llvm::raw_ostream &os,
+                                        bool batchLevels);
 
 class JaxiteEmitter {
  public:
-  JaxiteEmitter(raw_ostream &os, SelectVariableNames *variableNames);
+  JaxiteEmitter(raw_ostream &os, SelectVariableNames *variableNames,
+                bool batchLevels);
 
   LogicalResult translate(::mlir::Operation &operation);
+  LogicalResult translateBlock(::mlir::Block &block);
 
  private:
+  // Whether to run the lut3 ops of each level as one batched call.
+  bool batchLevels;
+
   // Output stream to emit to.
   raw_indented_ostream os;
 
@@ -63,6 +69,9 @@ class JaxiteEmitter {
   FailureOr<std::string> convertType(Type type);
 
   void emitAssignPrefix(Value result);
+
+  // Emits the lut3 ops of one dependency level as a single batched call.
+  void emitLut3Level(ArrayRef<Lut3Op> level);
 };
 
 }  // namespace jaxite
@@ -17,6 +17,49 @@ from jaxite.jaxite_lib import types
 
 )python";
 
+// Helpers for the level-batched emission. All the lut3 gates of a level are
+// stacked into arrays and run as one jit-compiled call, vmapped over the
+// gates, so that XLA can fuse and vectorize their bootstrapping.
+constexpr std::string_view kLevelledPrelude = R"python(
+import jax
+import jax.numpy as jnp
+
+
+@jax.jit
+def _lut3_batch(a, b, c, truth_tables, server_key_set, params):
+  return jax.vmap(jaxite_bool.lut3, in_axes=(0, 0, 0, 0, None, None))(
+      a, b, c, truth_tables, server_key_set, params
+  )
+
+
+def _stack(ciphertexts: List[types.LweCiphertext]):
+  return jax.tree_util.tree_map(lambda *xs: jnp.stack(xs), *ciphertexts)
+
+
+def _unstack(batch, size: int) -> List[types.LweCiphertext]:
+  return [jax.tree_util.tree_map(lambda x: x[i], batch) for i in range(size)]
+
+
+def run_lut3_level(
+    a: List[types.LweCiphertext],
+    b: List[types.LweCiphertext],
+    c: List[types.LweCiphertext],
+    truth_tables: List[int],
+    server_key_set: jaxite_bool.ServerKeySet,
+    params: jaxite_bool.Parameters,
+) -> List[types.LweCiphertext]:
+  batch = _lut3_batch(
+      _stack(a),
+      _stack(b),
+      _stack(c),
+      jnp.array(truth_tables, dtype=jnp.uint8),
+      server_key_set,
+      params,
+  )
+  return _unstack(batch, len(truth_tables))
+
+)python";
+
 }  // namespace jaxite
 }  // namespace heir
 }  // namespace mlir
@@ -271,7 +271,8 @@ LogicalResult OpenFhePkeEmitter::translate(Operation &op) {
                 ModReduceOp, LevelReduceOp, RotOp, AutomorphOp, KeySwitchOp,
                 EncryptOp, DecryptOp, GenParamsOp, GenContextOp, GenMulKeyOp,
                 GenRotKeyOp, GenBootstrapKeyOp, MakePackedPlaintextOp,
-                MakeCKKSPackedPlaintextOp, SetupBootstrapOp, BootstrapOp>(
+                MakeCKKSPackedPlaintextOp, SetupBootstrapOp, BootstrapOp,
+                SaveCryptoContextOp, LoadCryptoContextOp>(
               [&](auto op) { return printOperation(op); })
           .Default([&](Operation &) {
             return emitError(op.getLoc(), "unable to find printer for op");
@@ -301,6 +302,19 @@ LogicalResult OpenFhePkeEmitter::printOperation(ModuleOp moduleOp) {
   if (!weightsFile_.empty()) {
     os << getWeightsPrelude() << "\n";
   }
+
+  bool usesKeyCache = false;
+  moduleOp.walk([&](Operation *op) {
+    if (isa<SaveCryptoContextOp, LoadCryptoContextOp>(op)) {
+      usesKeyCache = true;
+      return WalkResult::interrupt();
+    }
+    return WalkResult::advance();
+  });
+  if (usesKeyCache) {
+    os << getKeyCachePrelude(scheme, importType_) << "\n";
+  }
+
   for (Operation &op : moduleOp) {
     if (failed(translate(op))) {
       return failure();
@@ -1468,6 +1482,67 @@ LogicalResult OpenFhePkeEmitter::printOperation(SetupBootstrapOp op) {
   return success();
 }
 
+LogicalResult OpenFhePkeEmitter::printOperation(SaveCryptoContextOp op) {
+  auto contextName = variableNames->getNameForValue(op.getCryptoContext());
+  os << "{\n";
+  os.indent();
+  os << "const std::string prefix = HeirKeyCachePath(\"" << op.getKey()
+     << "\");\n";
+  os << "if (!Serial::SerializeToFile(prefix + \".cc\", " << contextName
+     << ", SerType::BINARY)) {\n";
+  os << "  throw std::runtime_error(\"Failed to write \" + prefix + "
+        "\".cc\");\n";
+  os << "}\n";
+  os << "std::ofstream multKeyFile(prefix + \".multkey\", "
+        "std::ios::out | std::ios::binary);\n";
+  os << "if (!multKeyFile.is_open() || !" << contextName
+     << "->SerializeEvalMultKey(multKeyFile, SerType::BINARY)) {\n";
+  os << "  throw std::runtime_error(\"Failed to write \" + prefix + "
+        "\".multkey\");\n";
+  os << "}\n";
+  os << "std::ofstream rotKeyFile(prefix + \".rotkey\", "
+        "std::ios::out | std::ios::binary);\n";
+  os << "if (!rotKeyFile.is_open() || !" << contextName
+     << "->SerializeEvalAutomorphismKey(rotKeyFile, SerType::BINARY)) {\n";
+  os << "  throw std::runtime_error(\"Failed to write \" + prefix + "
+        "\".rotkey\");\n";
+  os << "}\n";
+  os.unindent();
+  os << "}\n";
+  return success();
+}
+
+LogicalResult OpenFhePkeEmitter::printOperation(LoadCryptoContextOp op) {
+  auto contextName = variableNames->getNameForValue(op.getResult());
+  os << "CryptoContextT " << contextName << ";\n";
+  os << "{\n";
+  os.indent();
+  os << "const std::string prefix = HeirKeyCachePath(\"" << op.getKey()
+     << "\");\n";
+  os << "if (!Serial::DeserializeFromFile(prefix + \".cc\", " << contextName
+     << ", SerType::BINARY)) {\n";
+  os << "  throw std::runtime_error(\"Failed to read \" + prefix + "
+        "\".cc\");\n";
+  os << "}\n";
+  os << "std::ifstream multKeyFile(prefix + \".multkey\", "
+        "std::ios::in | std::ios::binary);\n";
+  os << "if (!multKeyFile.is_open() || !" << contextName
+     << "->DeserializeEvalMultKey(multKeyFile, SerType::BINARY)) {\n";
+  os << "  throw std::runtime_error(\"Failed to read \" + prefix + "
+        "\".multkey\");\n";
+  os << "}\n";
+  os << "std::ifstream rotKeyFile(prefix + \".rotkey\", "
+        "std::ios::in | std::ios::binary);\n";
+  os << "if (!rotKeyFile.is_open() || !" << contextName
+     << "->DeserializeEvalAutomorphismKey(rotKeyFile, SerType::BINARY)) {\n";
+  os << "  throw std::runtime_error(\"Failed to read \" + prefix + "
+        "\".rotkey\");\n";
+  os << "}\n";
+  os.unindent();
+  os << "}\n";
+  return success();
+}
+
 LogicalResult OpenFhePkeEmitter::emitType(Type type, Location loc,
                                           bool constant) {
   auto result = convertType(type, loc, constant);
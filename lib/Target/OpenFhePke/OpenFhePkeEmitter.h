@@ -125,6 +125,7 @@ class OpenFhePkeEmitter {
   LogicalResult printOperation(GenBootstrapKeyOp op);
   LogicalResult printOperation(KeySwitchOp op);
   LogicalResult printOperation(LevelReduceOp op);
+  LogicalResult printOperation(LoadCryptoContextOp op);
   LogicalResult printOperation(MakePackedPlaintextOp op);
   LogicalResult printOperation(MakeCKKSPackedPlaintextOp op);
   LogicalResult printOperation(ModReduceOp op);
@@ -135,6 +136,7 @@ class OpenFhePkeEmitter {
   LogicalResult printOperation(NegateOp op);
   LogicalResult printOperation(RelinOp op);
   LogicalResult printOperation(RotOp op);
+  LogicalResult printOperation(SaveCryptoContextOp op);
   LogicalResult printOperation(SetupBootstrapOp op);
   LogicalResult printOperation(SquareOp op);
   LogicalResult printOperation(SubOp op);
@@ -67,6 +67,34 @@ Weights GetWeightModule(const std::string& filename) {
 )cpp";
 // clang-format on
 
+// The serialization headers for each import type, to be formatted into
+// kKeyCachePreludeTemplate.
+constexpr std::string_view kSourceRelativeOpenfheSerPrefix = "src/pke/include/";
+constexpr std::string_view kInstallationRelativeOpenfheSerPrefix =
+    "openfhe/pke/";
+constexpr std::string_view kEmbeddedOpenfheSerPrefix = "";
+
+// clang-format off
+constexpr std::string_view kKeyCachePreludeTemplate = R"cpp(
+#include <cstdlib>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "{0}cryptocontext-ser.h"  // from @openfhe
+#include "{0}key/key-ser.h"  // from @openfhe
+#include "{0}scheme/{1}rns/{1}rns-ser.h"  // from @openfhe
+
+// Serialized crypto contexts and keys are stored in the directory named by
+// HEIR_OPENFHE_KEY_CACHE_DIR, or the working directory if it is unset. Point
+// it at a tmpfs mount like /dev/shm to share keys between processes in memory.
+std::string HeirKeyCachePath(const std::string& key) {{
+  const char* dir = std::getenv("HEIR_OPENFHE_KEY_CACHE_DIR");
+  return std::string(dir == nullptr ? "." : dir) + "/" + key;
+}
+)cpp";
+// clang-format on
+
 // clang-format off
 constexpr std::string_view kPybindImports = R"cpp(
 #include <pybind11/pybind11.h>
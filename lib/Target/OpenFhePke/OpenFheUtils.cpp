@@ -41,6 +41,20 @@ std::string getModulePrelude(OpenfheScheme scheme,
 
 std::string getWeightsPrelude() { return std::string(kWeightsPreludeTemplate); }
 
+std::string getKeyCachePrelude(OpenfheScheme scheme,
+                               OpenfheImportType importType) {
+  auto prefix = importType == OpenfheImportType::SOURCE_RELATIVE
+                    ? kSourceRelativeOpenfheSerPrefix
+                    : (importType == OpenfheImportType::INSTALL_RELATIVE
+                           ? kInstallationRelativeOpenfheSerPrefix
+                           : kEmbeddedOpenfheSerPrefix);
+  return std::string(
+      llvm::formatv(kKeyCachePreludeTemplate.data(), prefix,
+                    scheme == OpenfheScheme::CKKS
+                        ? "ckks"
+                        : (scheme == OpenfheScheme::BGV ? "bgv" : "bfv")));
+}
+
 FailureOr<std::string> convertType(Type type, Location loc, bool constant) {
   return llvm::TypeSwitch<Type &, FailureOr<std::string>>(type)
       // For now, these types are defined in the prelude as aliases.
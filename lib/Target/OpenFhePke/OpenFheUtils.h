@@ -42,6 +42,11 @@ std::string getModulePrelude(OpenfheScheme scheme,
 
 std::string getWeightsPrelude();
 
+/// The includes and helpers needed by the generated code to serialize crypto
+/// contexts and evaluation keys.
+std::string getKeyCachePrelude(OpenfheScheme scheme,
+                               OpenfheImportType importType);
+
 /// Convert a type to a string, using a const specifier if constant is true.
 ::mlir::FailureOr<std::string> convertType(::mlir::Type type,
                                            ::mlir::Location loc,
@@ -16,7 +16,7 @@
 #include "lib/Dialect/TfheRust/IR/TfheRustTypes.h"
 #include "lib/Target/TfheRust/TfheRustTemplates.h"
 #include "lib/Target/TfheRust/Utils.h"
-#include "lib/Utils/Graph/Graph.h"
+#include "lib/Utils/Graph/CompactGraph.h"
 #include "lib/Utils/TargetUtils.h"
 #include "llvm/include/llvm/ADT/STLExtras.h"           // from @llvm-project
 #include "llvm/include/llvm/ADT/SmallVector.h"         // from @llvm-project
@@ -68,13 +68,16 @@ bool usedByNonLevelledOp(Value value) {
                       [](Operation *op) { return !isLevelledOp(op); });
 }
 
-std::pair<graph::Graph<Operation *>, Operation *> getGraph(Operation *op) {
-  graph::Graph<Operation *> graph;
+// Returns the graph of the run of levelled ops starting at `op`, whose
+// vertices are numbered in program order, and the first op after the run.
+std::pair<graph::IdMappedGraph<Operation *>, Operation *> getGraph(
+    Operation *op) {
+  graph::IdMappedGraph<Operation *> graph;
 
   auto block = op->getBlock();
   while (op != nullptr) {
     if (!isLevelledOp(op)) {
-      return {graph, op};
+      return {std::move(graph), op};
     }
     graph.addVertex(op);
     for (auto operand : op->getOperands()) {
@@ -88,7 +91,7 @@ std::pair<graph::Graph<Operation *>, Operation *> getGraph(Operation *op) {
     op = op->getNextNode();
   }
 
-  return {graph, op};
+  return {std::move(graph), op};
 }
 
 SmallVector<Value> getCiphertextOperands(ValueRange inputs) {
@@ -178,7 +181,7 @@ LogicalResult TfheRustEmitter::emitBlock(::mlir::Operation *op, int batch) {
       llvm_unreachable("Only possible failure is a cycle in the SSA graph!");
     }
     auto levels = sortedGraph.value();
-    // Print lists of operations per level.
+    // Print lists of operations per level, each in program order.
     for (size_t level = 0; level < levels.size(); ++level) {
       os << "static LEVEL_" << batch << "_" << level
          << " : [((OpType, usize), &[GateInput]); " << levels[level].size()
@@ -245,7 +248,8 @@ LogicalResult TfheRustEmitter::translate(Operation &op) {
                 arith::ShLIOp, arith::TruncIOp, arith::AndIOp>(
               [&](auto op) { return printOperation(op); })
           // TfheRust ops
-          .Case<AddOp, ApplyLookupTableOp, BitAndOp, GenerateLookupTableOp,
+          .Case<AddOp, ApplyLookupTableOp, ApplyManyLookupTableOp, BitAndOp,
+                GenerateLookupTableOp, GenerateManyLookupTableOp,
                 ScalarLeftShiftOp, CreateTrivialOp>(
               [&](auto op) { return printOperation(op); })
           // Tensor ops
@@ -494,6 +498,45 @@ LogicalResult TfheRustEmitter::printOperation(GenerateLookupTableOp op) {
   return success();
 }
 
+LogicalResult TfheRustEmitter::printOperation(ApplyManyLookupTableOp op) {
+  os << "let [" << commaSeparatedValues(op.getOutputs(), [&](Value value) {
+    return variableNames->getNameForValue(value);
+  }) << "] : [Ciphertext; " << op.getNumResults() << "] = ";
+
+  // The input is only held in temp_nodes if a levelled op produced it.
+  std::string input = variableNames->getNameForValue(op.getInput());
+  Operation *definingOp = op.getInput().getDefiningOp();
+  if (useLevels && definingOp && isLevelledOp(definingOp)) {
+    input = llvm::formatv("temp_nodes[&{0}]",
+                          variableNames->getIntForValue(op.getInput()))
+                .str();
+  }
+  os << variableNames->getNameForValue(op.getServerKey())
+     << ".apply_many_lookup_table(&" << input << ", &"
+     << variableNames->getNameForValue(op.getLookupTables())
+     << ").try_into().ok().unwrap();\n";
+
+  for (Value output : op.getOutputs()) {
+    if (usedByLevelledOp(output) && useLevels) {
+      os << llvm::formatv("temp_nodes.insert({0}, {1}.clone());\n",
+                          variableNames->getIntForValue(output),
+                          variableNames->getNameForValue(output));
+    }
+  }
+  return success();
+}
+
+LogicalResult TfheRustEmitter::printOperation(GenerateManyLookupTableOp op) {
+  emitAssignPrefix(op.getResult());
+  os << variableNames->getNameForValue(op.getServerKey())
+     << ".generate_many_lookup_table(&[";
+  llvm::interleaveComma(op.getTruthTables(), os, [&](int32_t truthTable) {
+    os << "&|x: u64| (" << truthTable << " >> x) & 1";
+  });
+  os << "]);\n";
+  return success();
+}
+
 std::string TfheRustEmitter::operationType(Operation *op) {
   return llvm::TypeSwitch<Operation *, std::string>(op)
       .Case<tfhe_rust::ApplyLookupTableOp>([&](ApplyLookupTableOp op) {
@@ -799,6 +842,11 @@ FailureOr<std::string> TfheRustEmitter::convertType(Type type) {
       .Case<ServerKeyType>([&](auto type) { return std::string("ServerKey"); })
       .Case<LookupTableType>(
           [&](auto type) { return std::string("LookupTableOwned"); })
+      .Case<ManyLookupTableType>(
+          [&](auto type) {
+            return std::string(
+                "tfhe::shortint::server_key::ManyLookupTableOwned");
+          })
       .Default([&](Type &) { return failure(); });
 }
 
@@ -75,7 +75,9 @@ class TfheRustEmitter {
   LogicalResult printOperation(memref::LoadOp op);
   LogicalResult printOperation(memref::StoreOp op);
   LogicalResult printOperation(ApplyLookupTableOp op);
+  LogicalResult printOperation(ApplyManyLookupTableOp op);
   LogicalResult printOperation(GenerateLookupTableOp op);
+  LogicalResult printOperation(GenerateManyLookupTableOp op);
   LogicalResult printOperation(ScalarLeftShiftOp op);
   LogicalResult emitBlock(::mlir::Operation *op, int batch);
 
@@ -36,7 +36,8 @@ LogicalResult canEmitFuncForTfheRust(func::FuncOp &funcOp) {
               memref::AllocOp, memref::DeallocOp, memref::DeallocOp,
               memref::GetGlobalOp, memref::LoadOp, memref::StoreOp, AddOp,
               SubOp, BitAndOp, CreateTrivialOp, ApplyLookupTableOp,
-              GenerateLookupTableOp, ScalarLeftShiftOp, ScalarRightShiftOp,
+              ApplyManyLookupTableOp, GenerateLookupTableOp,
+              GenerateManyLookupTableOp, ScalarLeftShiftOp, ScalarRightShiftOp,
               CastOp, MulOp, ::mlir::heir::tfhe_rust_bool::CreateTrivialOp,
               ::mlir::heir::tfhe_rust_bool::AndOp,
               ::mlir::heir::tfhe_rust_bool::PackedOp,
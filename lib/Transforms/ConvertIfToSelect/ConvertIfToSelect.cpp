@@ -6,8 +6,6 @@
 #include "llvm/include/llvm/ADT/STLExtras.h"    // from @llvm-project
 #include "llvm/include/llvm/Support/Casting.h"  // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"    // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"      // from @llvm-project
 #include "mlir/include/mlir/Dialect/SCF/IR/SCF.h"          // from @llvm-project
@@ -33,14 +31,14 @@ struct IfToSelectConversion : OpRewritePattern<scf::IfOp> {
   using OpRewritePattern<scf::IfOp>::OpRewritePattern;
 
  public:
-  IfToSelectConversion(Operation *top, DataFlowSolver *solver,
+  IfToSelectConversion(SecretnessAnalysisCache *secretnessAnalysis,
                        MLIRContext *context)
-      : OpRewritePattern(context), top(top), solver(solver) {}
+      : OpRewritePattern(context), secretnessAnalysis(secretnessAnalysis) {}
 
   LogicalResult matchAndRewrite(scf::IfOp ifOp,
                                 PatternRewriter &rewriter) const override {
-    auto *lattice = solver->lookupState<SecretnessLattice>(ifOp.getOperand());
-    Secretness secretness = lattice ? lattice->getValue() : Secretness();
+    Secretness secretness =
+        secretnessAnalysis->getSecretness(ifOp.getOperand());
 
     // Convert ops with "secret" and, conservatively, "unknown" (uninitialized)
     // conditions but skip conversion if the condition is known to be non-secret
@@ -78,6 +76,7 @@ struct IfToSelectConversion : OpRewritePattern<scf::IfOp> {
     auto elseYieldArgs = ifOp.elseYield().getOperands();
 
     SmallVector<Value> newResults(ifOp->getNumResults());
+    bool secretnessChanged = false;
     if (ifOp->getNumResults() > 0) {
       rewriter.setInsertionPoint(ifOp);
 
@@ -85,22 +84,30 @@ struct IfToSelectConversion : OpRewritePattern<scf::IfOp> {
            llvm::enumerate(llvm::zip(thenYieldArgs, elseYieldArgs))) {
         Value trueVal = std::get<0>(it.value());
         Value falseVal = std::get<1>(it.value());
-        newResults[it.index()] = rewriter.create<arith::SelectOp>(
+        auto selectOp = rewriter.create<arith::SelectOp>(
             ifOp.getLoc(), cond, trueVal, falseVal);
+        // Hoisted ops keep their secretness, so only the new selects need
+        // to be added to the analysis.
+        secretnessAnalysis->inferSecretness(selectOp);
+        // The select also depends on the condition, unlike the scf.if result,
+        // so users of the result may need to become secret.
+        secretnessChanged |=
+            secretnessAnalysis->getSecretness(selectOp) !=
+            secretnessAnalysis->getSecretness(ifOp->getResult(it.index()));
+        newResults[it.index()] = selectOp;
       }
 
       rewriter.replaceOp(ifOp, newResults);
     }
 
-    // re-run the analysis propagate secretness across
-    // newly created Values
-    return solver->initializeAndRun(top);
+    // Only re-run the analysis when secretness has to be propagated to
+    // existing users of the replaced values.
+    if (secretnessChanged) return secretnessAnalysis->recompute();
+    return success();
   }
 
  private:
-  // root operation the pass is on, should never be altered hence never null
-  Operation *top;
-  DataFlowSolver *solver;
+  SecretnessAnalysisCache *secretnessAnalysis;
 };
 
 struct ConvertIfToSelect : impl::ConvertIfToSelectBase<ConvertIfToSelect> {
@@ -111,25 +118,21 @@ struct ConvertIfToSelect : impl::ConvertIfToSelectBase<ConvertIfToSelect> {
 
     RewritePatternSet patterns(context);
 
-    DataFlowSolver solver;
-    solver.load<dataflow::DeadCodeAnalysis>();
-    solver.load<dataflow::SparseConstantPropagation>();
-    solver.load<SecretnessAnalysis>();
+    auto &secretness = getAnalysis<SecretnessAnalysisCache>();
 
-    auto result = solver.initializeAndRun(getOperation());
-
-    if (failed(result)) {
+    if (failed(secretness.getStatus())) {
       getOperation()->emitOpError() << "Failed to run the analysis.\n";
       signalPassFailure();
       return;
     }
 
-    patterns.add<IfToSelectConversion>(getOperation(), &solver, context);
+    patterns.add<IfToSelectConversion>(&secretness, context);
     // TODO (#1221): Investigate whether folding (default: on) can be skipped
     // here.
     (void)applyPatternsGreedily(getOperation(), std::move(patterns));
 
-    LLVM_DEBUG({ annotateSecretness(getOperation(), &solver, true); });
+    LLVM_DEBUG(
+        { annotateSecretness(getOperation(), secretness.getSolver(), true); });
   }
 };
 
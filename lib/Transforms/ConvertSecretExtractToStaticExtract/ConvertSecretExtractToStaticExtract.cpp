@@ -1,17 +1,21 @@
 #include "lib/Transforms/ConvertSecretExtractToStaticExtract/ConvertSecretExtractToStaticExtract.h"
 
+#include <cstdint>
 #include <utility>
 
 #include "lib/Analysis/SecretnessAnalysis/SecretnessAnalysis.h"
-#include "llvm/include/llvm/Support/Debug.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
+#include "lib/Dialect/TensorExt/Transforms/RotateAndReduce.h"
+#include "llvm/include/llvm/ADT/STLExtras.h"       // from @llvm-project
+#include "llvm/include/llvm/ADT/Sequence.h"        // from @llvm-project
+#include "llvm/include/llvm/Support/Debug.h"       // from @llvm-project
+#include "llvm/include/llvm/Support/MathExtras.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
 #include "mlir/include/mlir/Dialect/SCF/IR/SCF.h"        // from @llvm-project
 #include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
 #include "mlir/include/mlir/IR/Builders.h"               // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"           // from @llvm-project
 #include "mlir/include/mlir/IR/Diagnostics.h"            // from @llvm-project
 #include "mlir/include/mlir/IR/ImplicitLocOpBuilder.h"   // from @llvm-project
 #include "mlir/include/mlir/IR/MLIRContext.h"            // from @llvm-project
@@ -35,9 +39,12 @@ struct SecretExtractToStaticExtractConversion
   using OpRewritePattern<tensor::ExtractOp>::OpRewritePattern;
 
  public:
-  SecretExtractToStaticExtractConversion(Operation *top, DataFlowSolver *solver,
-                                         MLIRContext *context)
-      : OpRewritePattern(context), top(top), solver(solver) {}
+  SecretExtractToStaticExtractConversion(
+      SecretnessAnalysisCache *secretnessAnalysis, MLIRContext *context,
+      bool useRotateAndReduce)
+      : OpRewritePattern(context),
+        secretnessAnalysis(secretnessAnalysis),
+        useRotateAndReduce(useRotateAndReduce) {}
 
   LogicalResult matchAndRewrite(tensor::ExtractOp extractOp,
                                 PatternRewriter &rewriter) const override {
@@ -50,13 +57,8 @@ struct SecretExtractToStaticExtractConversion
 
     auto index = extractOp.getIndices().front();
 
-    auto *indexSecretnessLattice =
-        solver->lookupState<SecretnessLattice>(index);
-
     // Use secretness from lattice or, if no lattice found, set to unknown
-    auto indexSecretness = indexSecretnessLattice
-                               ? indexSecretnessLattice->getValue()
-                               : Secretness();
+    auto indexSecretness = secretnessAnalysis->getSecretness(index);
 
     // If lattice is set to unknown,
     // apply transformation anyway but emit a warning
@@ -72,10 +74,15 @@ struct SecretExtractToStaticExtractConversion
 
     ImplicitLocOpBuilder builder(extractOp->getLoc(), rewriter);
 
+    if (useRotateAndReduce && supportsRotateAndReduce(extractOp)) {
+      return rewriteWithRotateAndReduce(extractOp, builder, rewriter,
+                                        indexSecretness);
+    }
+
     // Create index 0
     auto zero = builder.create<arith::ConstantIndexOp>(0);
     // Set secretness for index 0
-    setValueToSecretness(solver, zero, Secretness(false));
+    secretnessAnalysis->setSecretness(zero, Secretness(false));
 
     // Extract tensor value at index 0
     SmallVector<Value> i = {zero};
@@ -83,16 +90,16 @@ struct SecretExtractToStaticExtractConversion
         builder.create<tensor::ExtractOp>(extractOp.getTensor(), i);
     // Set secretness for initialValue
     auto tensorSecretness =
-        solver->getOrCreateState<SecretnessLattice>(extractOp.getTensor())
-            ->getValue();
-    setValueToSecretness(solver, initialValue, tensorSecretness);
+        secretnessAnalysis->getSecretness(extractOp.getTensor());
+    secretnessAnalysis->setSecretness(initialValue, tensorSecretness);
 
     int size = extractOp.getTensor().getType().getShape().front();
 
     SmallVector<Value> iterArgs = {initialValue};
     auto forOp = builder.create<affine::AffineForOp>(0, size, 1, iterArgs);
     // Set secretness for induction variable
-    setValueToSecretness(solver, forOp.getInductionVar(), Secretness(false));
+    secretnessAnalysis->setSecretness(forOp.getInductionVar(),
+                                      Secretness(false));
 
     builder.setInsertionPointToStart(forOp.getBody());
 
@@ -101,7 +108,7 @@ struct SecretExtractToStaticExtractConversion
                                               forOp.getInductionVar(), index);
     // Set secretness for cond
     for (auto result : cond->getResults()) {
-      setValueToSecretness(solver, result, indexSecretness);
+      secretnessAnalysis->setSecretness(result, indexSecretness);
     }
 
     // Extract value at current index
@@ -109,7 +116,7 @@ struct SecretExtractToStaticExtractConversion
         extractOp.getTensor(), forOp.getInductionVar());
     // Set secretness for newExtractOp
     for (auto result : newExtractOp->getResults()) {
-      setValueToSecretness(solver, result, tensorSecretness);
+      secretnessAnalysis->setSecretness(result, tensorSecretness);
     }
 
     auto ifOp = builder.create<scf::IfOp>(
@@ -127,7 +134,7 @@ struct SecretExtractToStaticExtractConversion
     auto combinedSecretness =
         Secretness::combine({indexSecretness, tensorSecretness});
     for (auto result : ifOp->getResults()) {
-      setValueToSecretness(solver, result, combinedSecretness);
+      secretnessAnalysis->setSecretness(result, combinedSecretness);
     }
 
     // Create YieldOp for affine.for
@@ -135,28 +142,114 @@ struct SecretExtractToStaticExtractConversion
     builder.create<affine::AffineYieldOp>(results);
     // Set secretness for forOp results
     for (auto result : forOp->getResults()) {
-      setValueToSecretness(solver, result, combinedSecretness);
+      secretnessAnalysis->setSecretness(result, combinedSecretness);
     }
 
-    // Replace the old tensor.insert op with forOp's result
-    rewriter.replaceOp(extractOp, forOp);
-
-    // re-run the analysis propagate secretness across
-    // newly created Values
-    return solver->initializeAndRun(top);
+    // Replace the old tensor.extract op with forOp's result
+    return replaceAndUpdateSecretness(extractOp, forOp.getResult(0),
+                                      combinedSecretness, rewriter);
   }
 
  private:
-  // root operation the pass is on, should never be altered hence never null
-  Operation *top;
-  DataFlowSolver *solver;
-
-  static inline void setValueToSecretness(DataFlowSolver *solver, Value value,
-                                          Secretness secretness) {
-    auto *lattice = solver->getOrCreateState<SecretnessLattice>(value);
-    // solver->propagateIfChanged is bogus
-    (void)lattice->join(secretness);
+  // The packed lowering reduces with a rotation tree, so the tensor length
+  // must be a power of two, and the one-hot mask is materialized by
+  // converting an i1 tensor to the element type.
+  static bool supportsRotateAndReduce(tensor::ExtractOp extractOp) {
+    RankedTensorType tensorType = extractOp.getTensor().getType();
+    Type elementType = tensorType.getElementType();
+    bool isWideInteger = isa<IntegerType>(elementType) &&
+                         elementType.getIntOrFloatBitWidth() > 1;
+    return llvm::isPowerOf2_64(tensorType.getShape().front()) &&
+           (isWideInteger || isa<FloatType>(elementType));
   }
+
+  // Replace the extract with a one-hot mask multiplication followed by a
+  // rotate-and-reduce, so that only one ciphertext-ciphertext multiplication
+  // and log2(n) rotations are needed instead of n comparisons and selects.
+  LogicalResult rewriteWithRotateAndReduce(tensor::ExtractOp extractOp,
+                                           ImplicitLocOpBuilder &builder,
+                                           PatternRewriter &rewriter,
+                                           Secretness indexSecretness) const {
+    Value tensor = extractOp.getTensor();
+    Value index = extractOp.getIndices().front();
+    RankedTensorType tensorType = extractOp.getTensor().getType();
+    Type elementType = tensorType.getElementType();
+    int64_t size = tensorType.getShape().front();
+    bool isInteger = isa<IntegerType>(elementType);
+
+    auto tensorSecretness = secretnessAnalysis->getSecretness(tensor);
+    auto combinedSecretness =
+        Secretness::combine({indexSecretness, tensorSecretness});
+
+    // Build the one-hot selection vector [i == index for i in 0..n-1]
+    auto indexTensorType =
+        RankedTensorType::get({size}, builder.getIndexType());
+    SmallVector<int64_t> positions =
+        llvm::to_vector(llvm::seq<int64_t>(0, size));
+    auto positionsOp = builder.create<arith::ConstantOp>(
+        builder.getIndexTensorAttr(positions));
+    secretnessAnalysis->setSecretness(positionsOp, Secretness(false));
+    auto splatIndex = builder.create<tensor::SplatOp>(indexTensorType, index);
+    secretnessAnalysis->setSecretness(splatIndex, indexSecretness);
+    auto cond = builder.create<arith::CmpIOp>(arith::CmpIPredicate::eq,
+                                              positionsOp, splatIndex);
+    secretnessAnalysis->setSecretness(cond, indexSecretness);
+
+    Value oneHot;
+    if (isInteger) {
+      oneHot = builder.create<arith::ExtUIOp>(tensorType, cond);
+    } else {
+      oneHot = builder.create<arith::UIToFPOp>(tensorType, cond);
+    }
+    secretnessAnalysis->setSecretness(oneHot, indexSecretness);
+
+    Value masked;
+    if (isInteger) {
+      masked = builder.create<arith::MulIOp>(tensor, oneHot);
+    } else {
+      masked = builder.create<arith::MulFOp>(tensor, oneHot);
+    }
+    secretnessAnalysis->setSecretness(masked, combinedSecretness);
+
+    // Every slot of the reduced tensor holds the selected value.
+    Value reduced = tensor_ext::buildRotateAndReduceTree(
+        builder, masked, [&](Value lhs, Value rhs) -> Value {
+          secretnessAnalysis->setSecretness(rhs, combinedSecretness);
+          Value sum;
+          if (isInteger) {
+            sum = builder.create<arith::AddIOp>(lhs, rhs);
+          } else {
+            sum = builder.create<arith::AddFOp>(lhs, rhs);
+          }
+          secretnessAnalysis->setSecretness(sum, combinedSecretness);
+          return sum;
+        });
+
+    auto zero = builder.create<arith::ConstantIndexOp>(0);
+    secretnessAnalysis->setSecretness(zero, Secretness(false));
+    auto result = builder.create<tensor::ExtractOp>(reduced, zero.getResult());
+    secretnessAnalysis->setSecretness(result, combinedSecretness);
+
+    return replaceAndUpdateSecretness(extractOp, result, combinedSecretness,
+                                      rewriter);
+  }
+
+  // All values created by the rewrite already have their secretness set, so
+  // the analysis only needs to be re-run when users of the replaced value
+  // would see a different secretness.
+  LogicalResult replaceAndUpdateSecretness(Operation *op, Value replacement,
+                                           Secretness replacementSecretness,
+                                           PatternRewriter &rewriter) const {
+    bool secretnessChanged =
+        secretnessAnalysis->getSecretness(op->getResult(0)) !=
+        replacementSecretness;
+    rewriter.replaceOp(op, replacement);
+    if (secretnessChanged) return secretnessAnalysis->recompute();
+    return success();
+  }
+
+  SecretnessAnalysisCache *secretnessAnalysis;
+  bool useRotateAndReduce;
 };
 
 struct ConvertSecretExtractToStaticExtract
@@ -170,26 +263,22 @@ struct ConvertSecretExtractToStaticExtract
 
     RewritePatternSet patterns(context);
 
-    DataFlowSolver solver;
-    solver.load<dataflow::DeadCodeAnalysis>();
-    solver.load<dataflow::SparseConstantPropagation>();
-    solver.load<SecretnessAnalysis>();
-
-    auto result = solver.initializeAndRun(getOperation());
+    auto &secretness = getAnalysis<SecretnessAnalysisCache>();
 
-    if (failed(result)) {
+    if (failed(secretness.getStatus())) {
       getOperation()->emitOpError() << "Failed to run the analysis.\n";
       signalPassFailure();
       return;
     }
 
-    patterns.add<SecretExtractToStaticExtractConversion>(getOperation(),
-                                                         &solver, context);
+    patterns.add<SecretExtractToStaticExtractConversion>(&secretness, context,
+                                                         useRotateAndReduce);
     // TODO (#1221): Investigate whether folding (default: on) can be skipped
     // here.
     (void)applyPatternsGreedily(getOperation(), std::move(patterns));
 
-    LLVM_DEBUG({ annotateSecretness(getOperation(), &solver, true); });
+    LLVM_DEBUG(
+        { annotateSecretness(getOperation(), secretness.getSolver(), true); });
   }
 };
 
@@ -1,7 +1,9 @@
 #ifndef LIB_TRANSFORMS_CONVERTSECRETEXTRACTTOSTATICEXTRACT_CONVERTSECRETEXTRACTTOSTATICEXTRACT_H_
 #define LIB_TRANSFORMS_CONVERTSECRETEXTRACTTOSTATICEXTRACT_CONVERTSECRETEXTRACTTOSTATICEXTRACT_H_
 
-#include "mlir/include/mlir/Pass/Pass.h"  // from @llvm-project
+#include "lib/Dialect/TensorExt/IR/TensorExtDialect.h"
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/Pass/Pass.h"                 // from @llvm-project
 
 namespace mlir {
 namespace heir {
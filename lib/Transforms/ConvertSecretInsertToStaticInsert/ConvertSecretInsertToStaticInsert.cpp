@@ -1,17 +1,19 @@
 #include "lib/Transforms/ConvertSecretInsertToStaticInsert/ConvertSecretInsertToStaticInsert.h"
 
+#include <cstdint>
 #include <utility>
 
 #include "lib/Analysis/SecretnessAnalysis/SecretnessAnalysis.h"
+#include "llvm/include/llvm/ADT/STLExtras.h"  // from @llvm-project
+#include "llvm/include/llvm/ADT/Sequence.h"   // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
 #include "mlir/include/mlir/Dialect/SCF/IR/SCF.h"        // from @llvm-project
 #include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
 #include "mlir/include/mlir/IR/Builders.h"               // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"           // from @llvm-project
 #include "mlir/include/mlir/IR/Diagnostics.h"            // from @llvm-project
 #include "mlir/include/mlir/IR/ImplicitLocOpBuilder.h"   // from @llvm-project
 #include "mlir/include/mlir/IR/MLIRContext.h"            // from @llvm-project
@@ -35,9 +37,12 @@ struct SecretInsertToStaticInsertConversion
   using OpRewritePattern<tensor::InsertOp>::OpRewritePattern;
 
  public:
-  SecretInsertToStaticInsertConversion(Operation *top, DataFlowSolver *solver,
-                                       MLIRContext *context)
-      : OpRewritePattern(context), top(top), solver(solver) {}
+  SecretInsertToStaticInsertConversion(
+      SecretnessAnalysisCache *secretnessAnalysis, MLIRContext *context,
+      bool useOneHotMask)
+      : OpRewritePattern(context),
+        secretnessAnalysis(secretnessAnalysis),
+        useOneHotMask(useOneHotMask) {}
 
   LogicalResult matchAndRewrite(tensor::InsertOp insertOp,
                                 PatternRewriter &rewriter) const override {
@@ -51,13 +56,8 @@ struct SecretInsertToStaticInsertConversion
     auto tensor = insertOp.getDest();
     auto insertedValue = insertOp.getScalar();
 
-    auto *indexSecretnessLattice =
-        solver->lookupState<SecretnessLattice>(index);
-
     // use secretness from lattice or, if no lattice found, set to unknown
-    auto indexSecretness = indexSecretnessLattice
-                               ? indexSecretnessLattice->getValue()
-                               : Secretness();
+    auto indexSecretness = secretnessAnalysis->getSecretness(index);
 
     // If lattice is set to unknown,
     // apply transformation anyway but emit a warning
@@ -73,11 +73,17 @@ struct SecretInsertToStaticInsertConversion
 
     ImplicitLocOpBuilder builder(insertOp->getLoc(), rewriter);
 
+    if (useOneHotMask && supportsOneHotMask(insertOp)) {
+      return rewriteWithOneHotMask(insertOp, builder, rewriter,
+                                   indexSecretness);
+    }
+
     int size = insertOp.getDest().getType().getShape().front();
 
     SmallVector<Value> iterArgs = {tensor};
     auto forOp = builder.create<affine::AffineForOp>(0, size, 1, iterArgs);
-    setValueToSecretness(solver, forOp.getInductionVar(), Secretness(false));
+    secretnessAnalysis->setSecretness(forOp.getInductionVar(),
+                                      Secretness(false));
 
     builder.setInsertionPointToStart(forOp.getBody());
 
@@ -86,17 +92,16 @@ struct SecretInsertToStaticInsertConversion
                                               forOp.getInductionVar(), index);
     // Set secretness for cond
     for (auto result : cond->getResults()) {
-      setValueToSecretness(solver, result, indexSecretness);
+      secretnessAnalysis->setSecretness(result, indexSecretness);
     }
 
     // Insert value at current index
     auto newInsertOp = builder.create<tensor::InsertOp>(
         insertedValue, forOp.getRegionIterArgs()[0], forOp.getInductionVar());
     // Set secretness for newInsertOp
-    auto tensorSecretness =
-        solver->getOrCreateState<SecretnessLattice>(tensor)->getValue();
+    auto tensorSecretness = secretnessAnalysis->getSecretness(tensor);
     for (auto result : newInsertOp->getResults()) {
-      setValueToSecretness(solver, result, tensorSecretness);
+      secretnessAnalysis->setSecretness(result, tensorSecretness);
     }
 
     auto ifOp = builder.create<scf::IfOp>(
@@ -114,7 +119,7 @@ struct SecretInsertToStaticInsertConversion
     auto combinedSecretness =
         Secretness::combine({indexSecretness, tensorSecretness});
     for (auto result : ifOp->getResults()) {
-      setValueToSecretness(solver, result, combinedSecretness);
+      secretnessAnalysis->setSecretness(result, combinedSecretness);
     }
 
     // Create YieldOp for affine.for
@@ -122,26 +127,117 @@ struct SecretInsertToStaticInsertConversion
     builder.create<affine::AffineYieldOp>(results);
     // Set secretness for forOp results
     for (auto result : forOp->getResults()) {
-      setValueToSecretness(solver, result, combinedSecretness);
+      secretnessAnalysis->setSecretness(result, combinedSecretness);
     }
 
     // Replace the old tensor.insert op with forOp's result
-    rewriter.replaceOp(insertOp, forOp);
-
-    return solver->initializeAndRun(top);
+    return replaceAndUpdateSecretness(insertOp, forOp.getResult(0),
+                                      combinedSecretness, rewriter);
   }
 
  private:
-  // root operation the pass is on, should never be altered hence never null
-  Operation *top;
-  DataFlowSolver *solver;
-
-  static inline void setValueToSecretness(DataFlowSolver *solver, Value value,
-                                          Secretness secretness) {
-    auto *lattice = solver->getOrCreateState<SecretnessLattice>(value);
-    // solver->propagateIfChanged is bogus
-    (void)lattice->join(secretness);
+  // The one-hot mask is materialized by converting an i1 tensor to the
+  // element type, which requires a wide integer or float element type.
+  static bool supportsOneHotMask(tensor::InsertOp insertOp) {
+    Type elementType = insertOp.getDest().getType().getElementType();
+    bool isWideInteger = isa<IntegerType>(elementType) &&
+                         elementType.getIntOrFloatBitWidth() > 1;
+    return isWideInteger || isa<FloatType>(elementType);
+  }
+
+  // Replace the insert with a blend of the original tensor and a splat of the
+  // inserted value, weighted by a one-hot mask, so that only two ciphertext
+  // multiplications are needed instead of n comparisons and selects.
+  LogicalResult rewriteWithOneHotMask(tensor::InsertOp insertOp,
+                                      ImplicitLocOpBuilder &builder,
+                                      PatternRewriter &rewriter,
+                                      Secretness indexSecretness) const {
+    Value tensor = insertOp.getDest();
+    Value index = insertOp.getIndices().front();
+    Value insertedValue = insertOp.getScalar();
+    RankedTensorType tensorType = insertOp.getDest().getType();
+    Type elementType = tensorType.getElementType();
+    int64_t size = tensorType.getShape().front();
+    bool isInteger = isa<IntegerType>(elementType);
+
+    auto tensorSecretness = secretnessAnalysis->getSecretness(tensor);
+    auto valueSecretness = secretnessAnalysis->getSecretness(insertedValue);
+    auto combinedSecretness = Secretness::combine(
+        {indexSecretness, tensorSecretness, valueSecretness});
+
+    // Build the one-hot selection vector [i == index for i in 0..n-1] and its
+    // complement.
+    auto indexTensorType =
+        RankedTensorType::get({size}, builder.getIndexType());
+    SmallVector<int64_t> positions =
+        llvm::to_vector(llvm::seq<int64_t>(0, size));
+    auto positionsOp = builder.create<arith::ConstantOp>(
+        builder.getIndexTensorAttr(positions));
+    secretnessAnalysis->setSecretness(positionsOp, Secretness(false));
+    auto splatIndex = builder.create<tensor::SplatOp>(indexTensorType, index);
+    secretnessAnalysis->setSecretness(splatIndex, indexSecretness);
+    auto cond = builder.create<arith::CmpIOp>(arith::CmpIPredicate::eq,
+                                              positionsOp, splatIndex);
+    secretnessAnalysis->setSecretness(cond, indexSecretness);
+    auto notCond = builder.create<arith::CmpIOp>(arith::CmpIPredicate::ne,
+                                                 positionsOp, splatIndex);
+    secretnessAnalysis->setSecretness(notCond, indexSecretness);
+
+    auto toElementType = [&](Value mask) -> Value {
+      Value converted;
+      if (isInteger) {
+        converted = builder.create<arith::ExtUIOp>(tensorType, mask);
+      } else {
+        converted = builder.create<arith::UIToFPOp>(tensorType, mask);
+      }
+      secretnessAnalysis->setSecretness(converted, indexSecretness);
+      return converted;
+    };
+    Value oneHot = toElementType(cond);
+    Value complement = toElementType(notCond);
+
+    auto splatValue =
+        builder.create<tensor::SplatOp>(tensorType, insertedValue);
+    secretnessAnalysis->setSecretness(splatValue, valueSecretness);
+
+    Value kept;
+    Value inserted;
+    Value result;
+    if (isInteger) {
+      kept = builder.create<arith::MulIOp>(tensor, complement);
+      inserted = builder.create<arith::MulIOp>(splatValue, oneHot);
+      result = builder.create<arith::AddIOp>(kept, inserted);
+    } else {
+      kept = builder.create<arith::MulFOp>(tensor, complement);
+      inserted = builder.create<arith::MulFOp>(splatValue, oneHot);
+      result = builder.create<arith::AddFOp>(kept, inserted);
+    }
+    secretnessAnalysis->setSecretness(
+        kept, Secretness::combine({indexSecretness, tensorSecretness}));
+    secretnessAnalysis->setSecretness(
+        inserted, Secretness::combine({indexSecretness, valueSecretness}));
+    secretnessAnalysis->setSecretness(result, combinedSecretness);
+
+    return replaceAndUpdateSecretness(insertOp, result, combinedSecretness,
+                                      rewriter);
+  }
+
+  // All values created by the rewrite already have their secretness set, so
+  // the analysis only needs to be re-run when users of the replaced value
+  // would see a different secretness.
+  LogicalResult replaceAndUpdateSecretness(Operation *op, Value replacement,
+                                           Secretness replacementSecretness,
+                                           PatternRewriter &rewriter) const {
+    bool secretnessChanged =
+        secretnessAnalysis->getSecretness(op->getResult(0)) !=
+        replacementSecretness;
+    rewriter.replaceOp(op, replacement);
+    if (secretnessChanged) return secretnessAnalysis->recompute();
+    return success();
   }
+
+  SecretnessAnalysisCache *secretnessAnalysis;
+  bool useOneHotMask;
 };
 
 struct ConvertSecretInsertToStaticInsert
@@ -155,26 +251,22 @@ struct ConvertSecretInsertToStaticInsert
 
     RewritePatternSet patterns(context);
 
-    DataFlowSolver solver;
-    solver.load<dataflow::DeadCodeAnalysis>();
-    solver.load<dataflow::SparseConstantPropagation>();
-    solver.load<SecretnessAnalysis>();
-
-    auto result = solver.initializeAndRun(getOperation());
+    auto &secretness = getAnalysis<SecretnessAnalysisCache>();
 
-    if (failed(result)) {
+    if (failed(secretness.getStatus())) {
       getOperation()->emitOpError() << "Failed to run the analysis.\n";
       signalPassFailure();
       return;
     }
 
-    patterns.add<SecretInsertToStaticInsertConversion>(getOperation(), &solver,
-                                                       context);
+    patterns.add<SecretInsertToStaticInsertConversion>(&secretness, context,
+                                                       useOneHotMask);
     // TODO (#1221): Investigate whether folding (default: on) can be skipped
     // here.
     (void)applyPatternsGreedily(getOperation(), std::move(patterns));
 
-    LLVM_DEBUG({ annotateSecretness(getOperation(), &solver, true); });
+    LLVM_DEBUG(
+        { annotateSecretness(getOperation(), secretness.getSolver(), true); });
   }
 };
 
@@ -1,7 +1,8 @@
 #ifndef LIB_TRANSFORMS_CONVERTSECRETINSERTTOSTATICINSERT_CONVERTSECRETINSERTTOSTATICINSERT_H_
 #define LIB_TRANSFORMS_CONVERTSECRETINSERTTOSTATICINSERT_CONVERTSECRETINSERTTOSTATICINSERT_H_
 
-#include "mlir/include/mlir/Pass/Pass.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/Pass/Pass.h"                 // from @llvm-project
 
 namespace mlir {
 namespace heir {
@@ -1,7 +1,9 @@
 #include "lib/Transforms/ConvertToCiphertextSemantics/ConvertToCiphertextSemantics.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
+#include <map>
 #include <numeric>
 #include <optional>
 #include <set>
@@ -25,6 +27,7 @@
 #include "lib/Utils/Utils.h"
 #include "llvm/include/llvm/ADT/ArrayRef.h"         // from @llvm-project
 #include "llvm/include/llvm/ADT/STLExtras.h"        // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallBitVector.h"   // from @llvm-project
 #include "llvm/include/llvm/ADT/StringExtras.h"     // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"        // from @llvm-project
 #include "llvm/include/llvm/Support/raw_ostream.h"  // from @llvm-project
@@ -299,6 +302,332 @@ int64_t getMinUnusedInput(llvm::ArrayRef<int64_t> perm) {
   return -1;
 }
 
+// If the mapping is a partial rotation, return the rotation shift amount.
+std::optional<int64_t> tryDetectPartialRotation(
+    ::llvm::ArrayRef<int64_t> perm) {
+  std::optional<int64_t> rotation = std::nullopt;
+  for (int64_t i = 0; i < perm.size(); ++i) {
+    int64_t input = i;
+    int64_t output = perm[i];
+    if (output == kUnset) continue;
+    // We rotate left in this codebase, so invert normal output - input
+    int64_t shiftAmount = -(output - input);
+    if (!rotation.has_value()) {
+      rotation = shiftAmount;
+    } else if (shiftAmount != rotation.value()) {
+      return std::nullopt;
+    }
+  }
+  return rotation;
+}
+
+// Extend a partial permutation to a full permutation in an FHE-friendly way.
+void extendPermutationGreedily(::llvm::MutableArrayRef<int64_t> perm) {
+  std::set<int64_t> unmappedInputs;
+
+  // Start with values 0..n-1 and remove when found in the permutation
+  std::vector<int64_t> unmappedOutputsVector(perm.size());
+  std::iota(unmappedOutputsVector.begin(), unmappedOutputsVector.end(), 0);
+  std::set<int64_t> unmappedOutputs(unmappedOutputsVector.begin(),
+                                    unmappedOutputsVector.end());
+
+  for (int64_t i = 0; i < perm.size(); ++i) {
+    if (perm[i] == kUnset) {
+      unmappedInputs.insert(i);
+    } else {
+      unmappedOutputs.erase(perm[i]);
+    }
+  }
+
+  // Set iteration is in sorted order, so we're mapping each unused input to
+  // the first output index that hasn't been mapped to yet.
+  for (const auto &[input, output] :
+       llvm::zip(unmappedInputs, unmappedOutputs)) {
+    perm[input] = output;
+  }
+}
+
+// Extend a partial permutation to a full permutation in an FHE-friendly way.
+//
+// FHE-friendly means that the output permutation should lower to a small shift
+// network. For example, if the permutation can be extended to a single
+// rotation, it should be.
+//
+// The input partialPermutation must already be correctly sized (size n for a
+// permutation on 1..n). Unset entries of the permutation are indicated by
+// kUnset.
+void extendPartialPermutation(MutableArrayRef<int64_t> partialPermutation) {
+  // If the partially set entries correspond to a single rotation, extend it.
+  std::optional<int64_t> rotation =
+      tryDetectPartialRotation(partialPermutation);
+  if (rotation.has_value()) {
+    LLVM_DEBUG(llvm::dbgs() << "Detected partial rotation of offset "
+                            << rotation.value() << "\n");
+    for (int64_t i = 0; i < partialPermutation.size(); ++i) {
+      if (partialPermutation[i] == kUnset) {
+        int64_t target = i - rotation.value();
+        if (target < 0) target += partialPermutation.size();
+        partialPermutation[i] = target;
+      }
+    }
+    return;
+  }
+
+  // Otherwise, try to fill in the unset entries greedily.
+  extendPermutationGreedily(partialPermutation);
+}
+
+// Return the index of the ciphertext that a layout evaluation refers to. The
+// last result of a layout is the slot, and for a ciphertext-semantic tensor
+// with a single ciphertext dimension the first result is the ciphertext.
+int64_t getCiphertextIndex(ArrayRef<int64_t> layoutResults) {
+  return layoutResults.size() == 1 ? 0 : layoutResults.front();
+}
+
+// Return the ciphertext at the given index of a ciphertext-semantic tensor as
+// a 1D tensor of slots. A 1D ciphertext-semantic tensor is its own single
+// ciphertext.
+Value extractCiphertext(ImplicitLocOpBuilder &b, Value packed,
+                        OpFoldResult ciphertextIndex) {
+  auto packedType = cast<RankedTensorType>(packed.getType());
+  if (packedType.getRank() == 1) return packed;
+
+  int64_t numSlots = packedType.getShape().back();
+  RankedTensorType ciphertextType =
+      RankedTensorType::get({numSlots}, packedType.getElementType());
+  SmallVector<OpFoldResult> offsets = {ciphertextIndex, b.getIndexAttr(0)};
+  SmallVector<OpFoldResult> sizes = {b.getIndexAttr(1),
+                                     b.getIndexAttr(numSlots)};
+  SmallVector<OpFoldResult> strides = {b.getIndexAttr(1), b.getIndexAttr(1)};
+  auto extractOp = b.create<tensor::ExtractSliceOp>(ciphertextType, packed,
+                                                    offsets, sizes, strides);
+  setMaterializedAttr(extractOp);
+  return extractOp.getResult();
+}
+
+// Insert a 1D tensor of slots as the ciphertext at the given index of a
+// ciphertext-semantic tensor.
+Value insertCiphertext(ImplicitLocOpBuilder &b, Value ciphertext, Value packed,
+                       OpFoldResult ciphertextIndex) {
+  auto packedType = cast<RankedTensorType>(packed.getType());
+  if (packedType.getRank() == 1) return ciphertext;
+
+  int64_t numSlots = packedType.getShape().back();
+  SmallVector<OpFoldResult> offsets = {ciphertextIndex, b.getIndexAttr(0)};
+  SmallVector<OpFoldResult> sizes = {b.getIndexAttr(1),
+                                     b.getIndexAttr(numSlots)};
+  SmallVector<OpFoldResult> strides = {b.getIndexAttr(1), b.getIndexAttr(1)};
+  auto insertOp = b.create<tensor::InsertSliceOp>(ciphertext, packed, offsets,
+                                                  sizes, strides);
+  setMaterializedAttr(insertOp);
+  return insertOp.getResult();
+}
+
+// Return the shape of a tensor after the alignment of its layout, i.e., the
+// shape the layout map is applied to.
+SmallVector<int64_t> getAlignedShape(Type originalType, LayoutAttr layout) {
+  if (layout.getAlignment())
+    return SmallVector<int64_t>(layout.getAlignment().getOut());
+  return SmallVector<int64_t>(cast<RankedTensorType>(originalType).getShape());
+}
+
+// Whether the alignment of the layout, if any, pads with zeros. Kernels that
+// multiply and sum padded entries rely on them not contributing to the result.
+bool isZeroPadded(LayoutAttr layout) {
+  tensor_ext::AlignmentAttr alignment = layout.getAlignment();
+  if (!alignment || alignment.getPadding().empty()) return true;
+  TypedAttr paddingValue = alignment.getPaddingValue();
+  return paddingValue == Builder(paddingValue.getContext())
+                             .getZeroAttr(paddingValue.getType());
+}
+
+// Create a plaintext mask that is one in the slots set by the given partial
+// permutation's targets, and zero elsewhere.
+Value makeTargetMask(ImplicitLocOpBuilder &b, ArrayRef<int64_t> permutation,
+                     RankedTensorType ciphertextType) {
+  Type elementType = ciphertextType.getElementType();
+  SmallVector<Attribute> maskValues(permutation.size(),
+                                    b.getZeroAttr(elementType));
+  for (int64_t target : permutation) {
+    if (target != kUnset) maskValues[target] = b.getOneAttr(elementType);
+  }
+  auto maskOp = b.create<arith::ConstantOp>(
+      ciphertextType, DenseElementsAttr::get(ciphertextType, maskValues));
+  setMaterializedAttr(maskOp);
+  return maskOp.getResult();
+}
+
+// Return the layout of the given (converted) value, or nullptr if it has
+// none.
+LayoutAttr getLayoutAttr(const ContextAwareTypeConverter *typeConverter,
+                         Value value) {
+  auto layoutLookup = typeConverter->getContextualAttr(value);
+  if (failed(layoutLookup)) {
+    return nullptr;
+  }
+  return cast<LayoutAttr>(layoutLookup.value());
+}
+
+// Whether the alignment of the layout inserts dimensions, in which case its
+// map is defined on the aligned shape rather than the shape of the tensor.
+bool hasInsertedDims(LayoutAttr layout) {
+  tensor_ext::AlignmentAttr alignment = layout.getAlignment();
+  return alignment && !alignment.getInsertedDims().empty();
+}
+
+// Return the slots that hold each entry of a tensor of the given shape packed
+// in a single ciphertext with the given layout, keyed by the row-major index
+// of the entry. The copies made by the replication in the layout's alignment
+// are listed in the order of their aligned indices, and padding slots are
+// left out.
+std::map<int64_t, SmallVector<int64_t>> getSlotsOfEntries(
+    ArrayRef<int64_t> shape, LayoutAttr layout) {
+  tensor_ext::AlignmentAttr alignment = layout.getAlignment();
+  SmallVector<int64_t> alignedShape(shape);
+  ArrayRef<int64_t> insertedDims;
+  ArrayRef<int64_t> padding;
+  if (alignment) {
+    alignedShape.assign(alignment.getOut().asArrayRef().begin(),
+                        alignment.getOut().asArrayRef().end());
+    insertedDims = alignment.getInsertedDims().asArrayRef();
+    padding = alignment.getPadding().asArrayRef();
+  }
+
+  std::map<int64_t, SmallVector<int64_t>> slots;
+  IndexTupleConsumer addSlot = [&](const std::vector<int64_t> &indices) {
+    int64_t entry = 0;
+    int64_t dim = 0;
+    for (int64_t alignedDim = 0; alignedDim < indices.size(); ++alignedDim) {
+      if (llvm::is_contained(insertedDims, alignedDim)) continue;
+      int64_t paddedSize = shape[dim] + (padding.empty() ? 0 : padding[dim]);
+      int64_t index = indices[alignedDim] % paddedSize;
+      if (index >= shape[dim]) return;
+      entry = entry * shape[dim] + index;
+      ++dim;
+    }
+    SmallVector<int64_t> results;
+    evaluateStatic(layout.getMap(), indices, results);
+    slots[entry].push_back(results.back());
+  };
+  iterateIndices(alignedShape, addSlot);
+  return slots;
+}
+
+// Create the elementwise binary op with the given name on two ciphertexts of
+// the same type.
+Value createBinop(ImplicitLocOpBuilder &b, StringRef opName, Value lhs,
+                  Value rhs) {
+  Operation *binop = b.create(
+      OperationState(b.getLoc(), opName, {lhs, rhs}, {lhs.getType()}));
+  setMaterializedAttr(binop);
+  return binop->getResult(0);
+}
+
+// Create the elementwise product of two ciphertexts of the same type, with the
+// integer or floating point op for their element type.
+Value createMul(ImplicitLocOpBuilder &b, Value lhs, Value rhs) {
+  bool isInteger = isa<IntegerType>(getElementTypeOrSelf(lhs.getType()));
+  return createBinop(b, isInteger ? "arith.muli" : "arith.mulf", lhs, rhs);
+}
+
+// Create the elementwise sum of two ciphertexts of the same type, with the
+// integer or floating point op for their element type.
+Value createAdd(ImplicitLocOpBuilder &b, Value lhs, Value rhs) {
+  bool isInteger = isa<IntegerType>(getElementTypeOrSelf(lhs.getType()));
+  return createBinop(b, isInteger ? "arith.addi" : "arith.addf", lhs, rhs);
+}
+
+// Rotate a ciphertext left by `shift`, which moves slot i to slot i - shift.
+Value createRotate(ImplicitLocOpBuilder &b, Value value, int64_t shift) {
+  auto shiftOp = b.create<arith::ConstantIntOp>(shift, 64);
+  auto rotateOp = b.create<tensor_ext::RotateOp>(value, shiftOp);
+  setMaterializedAttr({shiftOp, rotateOp});
+  return rotateOp.getResult();
+}
+
+// Return the number of ciphertexts of a ciphertext-semantic tensor type.
+int64_t getNumCiphertexts(RankedTensorType type) {
+  return type.getRank() == 1 ? 1 : type.getDimSize(0);
+}
+
+// Return the leading ciphertexts of `packed` as a tensor of the given
+// ciphertext-semantic type, appending zero ciphertexts if `packed` has fewer.
+Value resizeCiphertexts(ImplicitLocOpBuilder &b, Value packed,
+                        RankedTensorType type) {
+  auto packedType = cast<RankedTensorType>(packed.getType());
+  if (packedType == type) return packed;
+  if (type.getRank() == 1)
+    return extractCiphertext(b, packed, b.getIndexAttr(0));
+
+  int64_t numSlots = type.getShape().back();
+  int64_t numPacked = getNumCiphertexts(packedType);
+  SmallVector<OpFoldResult> offsets = {b.getIndexAttr(0), b.getIndexAttr(0)};
+  SmallVector<OpFoldResult> strides = {b.getIndexAttr(1), b.getIndexAttr(1)};
+  if (packedType.getRank() == 2 && numPacked >= type.getDimSize(0)) {
+    SmallVector<OpFoldResult> sizes = {b.getIndexAttr(type.getDimSize(0)),
+                                       b.getIndexAttr(numSlots)};
+    auto extractOp = b.create<tensor::ExtractSliceOp>(type, packed, offsets,
+                                                      sizes, strides);
+    setMaterializedAttr(extractOp);
+    return extractOp.getResult();
+  }
+
+  auto zeroOp = b.create<arith::ConstantOp>(type, b.getZeroAttr(type));
+  setMaterializedAttr(zeroOp);
+  if (packedType.getRank() == 1)
+    return insertCiphertext(b, packed, zeroOp.getResult(), b.getIndexAttr(0));
+  SmallVector<OpFoldResult> sizes = {b.getIndexAttr(numPacked),
+                                     b.getIndexAttr(numSlots)};
+  auto insertOp = b.create<tensor::InsertSliceOp>(packed, zeroOp.getResult(),
+                                                  offsets, sizes, strides);
+  setMaterializedAttr(insertOp);
+  return insertOp.getResult();
+}
+
+// Move the slots of the ciphertexts of `input` to the ciphertexts of a
+// tensor of type `resultType`, according to a set of partial slot
+// permutations keyed by (source ciphertext, target ciphertext). The partial
+// permutations are combined into a single partial permutation of the
+// row-major flattened list of ciphertexts, which is extended to a full one
+// and applied as one `tensor_ext.permute` of a `tensor<k x N>`, where k is
+// the larger of the input and result number of ciphertexts. The input is
+// padded with zero ciphertexts, and the result truncated, to match. As in the
+// single-ciphertext case, slots that are not the target of any entry hold
+// unspecified values.
+Value applyCiphertextPermutations(
+    ImplicitLocOpBuilder &b, Value input, RankedTensorType resultType,
+    const std::map<std::pair<int64_t, int64_t>, SmallVector<int64_t>>
+        &permutations) {
+  auto inputType = cast<RankedTensorType>(input.getType());
+  int64_t numSlots = resultType.getShape().back();
+  int64_t numInputCiphertexts = getNumCiphertexts(inputType);
+  RankedTensorType permutedType =
+      numInputCiphertexts <= getNumCiphertexts(resultType)
+          ? resultType
+          : RankedTensorType::get({numInputCiphertexts, numSlots},
+                                  resultType.getElementType());
+
+  SmallVector<int64_t> permutation(permutedType.getNumElements(), kUnset);
+  for (const auto &[key, slotPermutation] : permutations) {
+    auto [source, target] = key;
+    for (int64_t slot = 0; slot < numSlots; ++slot) {
+      if (slotPermutation[slot] == kUnset) continue;
+      permutation[source * numSlots + slot] =
+          target * numSlots + slotPermutation[slot];
+    }
+  }
+  extendPartialPermutation(permutation);
+
+  Value permuted = resizeCiphertexts(b, input, permutedType);
+  if (permutation != identity(permutation.size())) {
+    auto permuteOp = b.create<tensor_ext::PermuteOp>(
+        permuted, b.getI64TensorAttr(permutation));
+    setMaterializedAttr(permuteOp);
+    permuted = permuteOp.getResult();
+  }
+  return resizeCiphertexts(b, permuted, resultType);
+}
+
 class ConvertConvertLayout
     : public ContextAwareOpConversionPattern<tensor_ext::ConvertLayoutOp> {
  public:
@@ -318,13 +647,24 @@ class ConvertConvertLayout
     LayoutAttr fromLayout = op.getFromLayout();
     LayoutAttr toLayout = op.getToLayout();
 
-    // TODO(#1542): support multi-packed ciphertexts
-    if (ciphertextSemanticType.getRank() != 1) {
+    int64_t numSlots = ciphertextSemanticType.getShape().back();
+    RankedTensorType resultType = ciphertextSemanticType;
+    if (auto tensorTy = dyn_cast<RankedTensorType>(dataSemanticType)) {
+      resultType = cast<RankedTensorType>(
+          materializeLayout(tensorTy, toLayout, numSlots));
+    }
+
+    if (ciphertextSemanticType.getRank() > 2 || resultType.getRank() > 2) {
       return op.emitError()
-             << "Does not support packing into multiple ciphertexts yet";
+             << "Does not support more than one ciphertext dimension";
+    }
+    if (ciphertextSemanticType.getRank() != 1 || resultType.getRank() != 1) {
+      return convertMultiCiphertextLayout(op, adaptor, resultType, rewriter);
+    }
+    if (hasInsertedDims(fromLayout) || hasInsertedDims(toLayout)) {
+      return convertAlignedLayout(op, adaptor, rewriter);
     }
 
-    int64_t numSlots = ciphertextSemanticType.getShape().back();
     SmallVector<int64_t> permutation(numSlots, kUnset);
 
     // The algorithm here allows the permutation to be built up "cyclically"
@@ -386,82 +726,109 @@ class ConvertConvertLayout
     rewriter.replaceOp(op, permuteOp);
     return success();
   };
-};
 
-// If the mapping is a partial rotation, return the rotation shift amount.
-std::optional<int64_t> tryDetectPartialRotation(
-    ::llvm::ArrayRef<int64_t> perm) {
-  std::optional<int64_t> rotation = std::nullopt;
-  for (int64_t i = 0; i < perm.size(); ++i) {
-    int64_t input = i;
-    int64_t output = perm[i];
-    if (output == kUnset) continue;
-    // We rotate left in this codebase, so invert normal output - input
-    int64_t shiftAmount = -(output - input);
-    if (!rotation.has_value()) {
-      rotation = shiftAmount;
-    } else if (shiftAmount != rotation.value()) {
-      return std::nullopt;
+ private:
+  // When either layout inserts dimensions in its alignment, such as the
+  // rotated replicas of a vector, its map cannot be evaluated on the indices
+  // of the tensor. Instead, each copy of an entry in the target layout takes
+  // the slot of a distinct copy of that entry in the source layout, which
+  // requires the source layout to have at least as many copies.
+  LogicalResult convertAlignedLayout(
+      tensor_ext::ConvertLayoutOp op, OpAdaptor adaptor,
+      ContextAwareConversionPatternRewriter &rewriter) const {
+    auto tensorType = dyn_cast<RankedTensorType>(op.getValue().getType());
+    if (!tensorType) {
+      return op.emitError() << "Expected a tensor for a layout with inserted "
+                               "dimensions";
+    }
+    LayoutAttr toLayout = op.getToLayout();
+    if (!isZeroPadded(toLayout)) {
+      return op.emitError() << "Unsupported padding value in " << toLayout;
     }
-  }
-  return rotation;
-}
 
-// Extend a partial permutation to a full permutation in an FHE-friendly way.
-void extendPermutationGreedily(::llvm::MutableArrayRef<int64_t> perm) {
-  std::set<int64_t> unmappedInputs;
+    auto ciphertextType = cast<RankedTensorType>(adaptor.getValue().getType());
+    int64_t numSlots = ciphertextType.getDimSize(0);
+    std::map<int64_t, SmallVector<int64_t>> sourceSlots =
+        getSlotsOfEntries(tensorType.getShape(), op.getFromLayout());
+    std::map<int64_t, SmallVector<int64_t>> targetSlots =
+        getSlotsOfEntries(tensorType.getShape(), toLayout);
 
-  // Start with values 0..n-1 and remove when found in the permutation
-  std::vector<int64_t> unmappedOutputsVector(perm.size());
-  std::iota(unmappedOutputsVector.begin(), unmappedOutputsVector.end(), 0);
-  std::set<int64_t> unmappedOutputs(unmappedOutputsVector.begin(),
-                                    unmappedOutputsVector.end());
+    SmallVector<int64_t> permutation(numSlots, kUnset);
+    for (const auto &[entry, targets] : targetSlots) {
+      const SmallVector<int64_t> &sources = sourceSlots[entry];
+      if (sources.size() < targets.size()) {
+        return op.emitError()
+               << "Target layout has " << targets.size() << " copies of entry "
+               << entry << ", but the source layout has only "
+               << sources.size();
+      }
+      for (int64_t i = 0; i < targets.size(); ++i) {
+        permutation[sources[i]] = targets[i];
+      }
+    }
 
-  for (int64_t i = 0; i < perm.size(); ++i) {
-    if (perm[i] == kUnset) {
-      unmappedInputs.insert(i);
-    } else {
-      unmappedOutputs.erase(perm[i]);
+    // The slots that receive no entry are zeroed if the target layout has
+    // padding, and are otherwise left unspecified.
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    tensor_ext::AlignmentAttr alignment = toLayout.getAlignment();
+    bool padded = alignment && !alignment.getPadding().empty();
+    Value mask =
+        padded ? makeTargetMask(b, permutation, ciphertextType) : Value();
+    extendPartialPermutation(permutation);
+
+    Value result = adaptor.getValue();
+    if (permutation != identity(numSlots)) {
+      auto permuteOp = b.create<tensor_ext::PermuteOp>(
+          result, b.getI64TensorAttr(permutation));
+      setMaterializedAttr(permuteOp);
+      result = permuteOp.getResult();
     }
+    if (mask) result = createMul(b, result, mask);
+    setAttributeAssociatedWith(result, kLayoutAttrName,
+                               op->getAttr(kLayoutAttrName));
+    rewriter.replaceOp(op, result);
+    return success();
   }
 
-  // Set iteration is in sorted order, so we're mapping each unused input to
-  // the first output index that hasn't been mapped to yet.
-  for (const auto &[input, output] :
-       llvm::zip(unmappedInputs, unmappedOutputs)) {
-    perm[input] = output;
-  }
-}
+  // When either layout spans multiple ciphertexts, the conversion is a single
+  // permutation of the list of ciphertexts, which may move slots between
+  // ciphertexts.
+  //
+  // Unlike the single-ciphertext case, this does not cyclically repeat the
+  // layout to fill unused slots, so replicated target layouts are not
+  // supported here.
+  LogicalResult convertMultiCiphertextLayout(
+      tensor_ext::ConvertLayoutOp op, OpAdaptor adaptor,
+      RankedTensorType resultType,
+      ContextAwareConversionPatternRewriter &rewriter) const {
+    LayoutAttr fromLayout = op.getFromLayout();
+    LayoutAttr toLayout = op.getToLayout();
+    int64_t numSlots = resultType.getShape().back();
+
+    std::map<std::pair<int64_t, int64_t>, SmallVector<int64_t>> permutations;
+    IndexTupleConsumer evaluateNextIndex =
+        [&](const std::vector<int64_t> &indices) {
+          SmallVector<int64_t> fromResults;
+          SmallVector<int64_t> toResults;
+          evaluateStatic(fromLayout.getMap(), indices, fromResults);
+          evaluateStatic(toLayout.getMap(), indices, toResults);
+          SmallVector<int64_t> &permutation = permutations[{
+              getCiphertextIndex(fromResults), getCiphertextIndex(toResults)}];
+          if (permutation.empty()) permutation.assign(numSlots, kUnset);
+          permutation[fromResults.back()] = toResults.back();
+        };
+    iterateIndices(cast<RankedTensorType>(op.getValue().getType()).getShape(),
+                   evaluateNextIndex);
 
-// Extend a partial permutation to a full permutation in an FHE-friendly way.
-//
-// FHE-friendly means that the output permutation should lower to a small shift
-// network. For example, if the permutation can be extended to a single
-// rotation, it should be.
-//
-// The input partialPermutation must already be correctly sized (size n for a
-// permutation on 1..n). Unset entries of the permutation are indicated by
-// kUnset.
-void extendPartialPermutation(MutableArrayRef<int64_t> partialPermutation) {
-  // If the partially set entries correspond to a single rotation, extend it.
-  std::optional<int64_t> rotation =
-      tryDetectPartialRotation(partialPermutation);
-  if (rotation.has_value()) {
-    LLVM_DEBUG(llvm::dbgs() << "Detected partial rotation of offset "
-                            << rotation.value() << "\n");
-    for (int64_t i = 0; i < partialPermutation.size(); ++i) {
-      if (partialPermutation[i] == kUnset) {
-        int64_t target = i - rotation.value();
-        if (target < 0) target += partialPermutation.size();
-        partialPermutation[i] = target;
-      }
-    }
-    return;
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    Value result = applyCiphertextPermutations(b, adaptor.getValue(),
+                                               resultType, permutations);
+    setAttributeAssociatedWith(result, kLayoutAttrName,
+                               op->getAttr(kLayoutAttrName));
+    rewriter.replaceOp(op, result);
+    return success();
   }
-
-  // Otherwise, try to fill in the unset entries greedily.
-  extendPermutationGreedily(partialPermutation);
-}
+};
 
 class ConvertLinalgReduce
     : public ContextAwareOpConversionPattern<linalg::ReduceOp> {
@@ -480,15 +847,9 @@ class ConvertLinalgReduce
           "linalg.reduce only supported with a single reduction operation");
     }
 
-    // TODO(#1543): support multi-dimension reductions
-    if (op.getDimensions().size() != 1) {
-      return op.emitError(
-          "linalg.reduce only supported with a single reduction dimension");
-    }
-
     if (!op.isSingleInputOutput()) {
       return op.emitError(
-          "linalg.reduce only supported with a single reduction dimension");
+          "linalg.reduce only supported with a single input and output");
     }
 
     Operation *innerOp = &body->getOperations().front();
@@ -509,7 +870,8 @@ class ConvertLinalgReduce
     // row-major, then that permutation corresponds to a simple set of
     // rotations.
     //
-    // TODO(#1542): support multi-packed ciphertexts
+    // If the input spans multiple ciphertexts, the permutation is over the
+    // list of ciphertexts, and may move entries between ciphertexts.
 
     RankedTensorType dataSemanticType =
         cast<RankedTensorType>(op.getInputs()[0].getType());
@@ -540,9 +902,6 @@ class ConvertLinalgReduce
                << "\n  - op: " << innerOp->getName() << "\n  - init: " << init
                << "\n\n");
 
-    int64_t reductionDim = op.getDimensions()[0];
-    int64_t reductionDimSize = dataSemanticType.getShape()[reductionDim];
-
     // In the example from above (row-major <32x32> -> <1024>), all values
     // in the reduced dimension need to map to the same slot. E.g.,
     //
@@ -579,13 +938,64 @@ class ConvertLinalgReduce
     //
     // TODO(#521): Extend rotate-and-reduce so it can be run after this kernel
     // and find additional rotation optimizations.
+    RankedTensorType initType = cast<RankedTensorType>(init.getType());
+    if (ciphertextSemanticType.getRank() > 2 || initType.getRank() > 2) {
+      return op.emitError()
+             << "Does not support more than one ciphertext dimension";
+    }
+    int64_t numSlots = ciphertextSemanticType.getShape().back();
+    int64_t numInitCiphertexts =
+        initType.getRank() == 1 ? 1 : initType.getDimSize(0);
+    bool singleCiphertext =
+        ciphertextSemanticType.getRank() == 1 && initType.getRank() == 1;
+    RankedTensorType ciphertextType =
+        RankedTensorType::get({numSlots}, initType.getElementType());
+
     ImplicitLocOpBuilder b(op.getLoc(), rewriter);
-    Value result = init;
-    for (int64_t dimIndex = 0; dimIndex < reductionDimSize; ++dimIndex) {
-      SmallVector<int64_t> permutation(ciphertextSemanticType.getNumElements(),
-                                       kUnset);
-      SmallVector<int64_t> fixedIndices = {reductionDim};
-      SmallVector<int64_t> fixedValues = {dimIndex};
+    ArrayRef<int64_t> reducedDims = op.getDimensions();
+    // A reduction over several dimensions of a single ciphertext, whose
+    // layout moves each reduced dimension by a fixed slot stride, composes
+    // one rotate-and-reduce tree per dimension. This needs the sum of the
+    // log2 of the reduced dimension sizes in rotations, instead of one
+    // permutation per summand. The trees leave each sum in the slot of the
+    // entry whose reduced indices are zero, so this is only correct if the
+    // init is laid out like the input with the reduced dimensions projected
+    // out.
+    AffineMap reducedMap = getReducedLayoutMap(layout, reducedDims);
+    LayoutAttr initLayout = getLayoutAttr(getTypeConverter(), init);
+    AffineMap resultMap = initLayout && !hasInsertedDims(initLayout)
+                              ? initLayout.getMap()
+                              : reducedMap;
+    if (reducedDims.size() > 1 && singleCiphertext &&
+        resultMap == reducedMap) {
+      std::optional<SmallVector<int64_t>> strides =
+          getReducedDimStrides(dataSemanticType, layout, reducedDims, numSlots);
+      if (strides.has_value()) {
+        rewriter.replaceOp(op, rotateAndReduce(b, op, input, init, *strides,
+                                               ciphertextType));
+        return success();
+      }
+    }
+
+    // With multiple reduced dimensions, there is one summand for each tuple
+    // of indices along the reduced dimensions.
+    SmallVector<int64_t> reducedShape;
+    for (int64_t dim : reducedDims) {
+      reducedShape.push_back(dataSemanticType.getDimSize(dim));
+    }
+    std::vector<std::vector<int64_t>> reducedIndexTuples;
+    iterateIndices(reducedShape, [&](const std::vector<int64_t> &indices) {
+      reducedIndexTuples.push_back(indices);
+    });
+
+    // The running reduction, starting from the init.
+    Value accumulator;
+    for (const std::vector<int64_t> &reducedIndices : reducedIndexTuples) {
+      std::map<std::pair<int64_t, int64_t>, SmallVector<int64_t>>
+          permutations;
+      SmallVector<int64_t> fixedIndices(reducedDims);
+      SmallVector<int64_t> fixedValues(reducedIndices.begin(),
+                                       reducedIndices.end());
 
       // For each entry with the reduced index fixed, populate the permutation
       // with the desired partial mapping.
@@ -594,50 +1004,163 @@ class ConvertLinalgReduce
             SmallVector<int64_t> results;
             evaluateStatic(layout.getMap(), indices, results);
 
-            // Since we are reducing along a dimension, the input that gives us
-            // the desired output slot should be the slot that the layout maps
-            // the first entry of the reduced dimension to.
+            // Since we are reducing along a dimension, the desired output slot
+            // is the slot that the init layout maps the entry with the
+            // reduced dimensions dropped to. When the init is laid out like
+            // the input with the reduced dimensions projected out, this is
+            // the slot of the first entry of the reduced dimension.
             //
             // From the running example tensor<32x32> -> tensor<1024> row-major
             // layout reducing dim 0, if we're at entry dimIndex = 3, then we're
             // saying that all entries (3, j) should map to (0, j) so that all
             // the values (0, j), (1, j), (2, j), ... (31, j) are aligned.
-            std::vector<int64_t> inputsForDesiredResults(indices);
-            for (int64_t fixedIndex : fixedIndices) {
-              inputsForDesiredResults[fixedIndex] = 0;
+            std::vector<int64_t> resultIndices;
+            for (int64_t dim = 0; dim < (int64_t)indices.size(); ++dim) {
+              if (!llvm::is_contained(reducedDims, dim))
+                resultIndices.push_back(indices[dim]);
             }
             SmallVector<int64_t> desiredResults;
-            evaluateStatic(layout.getMap(), inputsForDesiredResults,
-                           desiredResults);
+            evaluateStatic(resultMap, resultIndices, desiredResults);
 
             // The last dimension of the layout output is the ciphertext
             // dimension, and it contains the slot that the entry is mapped to.
+            SmallVector<int64_t> &permutation =
+                permutations[{getCiphertextIndex(results),
+                              getCiphertextIndex(desiredResults)}];
+            if (permutation.empty()) permutation.assign(numSlots, kUnset);
             permutation[results[results.size() - 1]] =
                 desiredResults[desiredResults.size() - 1];
           };
 
       iterateIndices(dataSemanticType.getShape(), evaluateNextIndex,
                      fixedIndices, fixedValues);
-      extendPartialPermutation(permutation);
 
-      auto permuteOp = b.create<tensor_ext::PermuteOp>(
-          input, b.getI64TensorAttr(permutation));
+      for (const auto &[key, permutation] : permutations) {
+        if (key.second >= numInitCiphertexts) {
+          return op.emitError()
+                 << "reduced values are laid out in ciphertext " << key.second
+                 << ", but the output only has " << numInitCiphertexts;
+        }
+      }
 
-      SmallVector<Value> operands = {result, permuteOp};
-      SmallVector<Type> newResultTypes = {permuteOp.getType()};
+      // Align the entries of this summand with their target slots. A single
+      // ciphertext keeps its own permute, even if it is the identity, so that
+      // each summand is visible to later rotation optimizations.
+      Value aligned;
+      if (singleCiphertext) {
+        SmallVector<int64_t> &permutation = permutations[{0, 0}];
+        extendPartialPermutation(permutation);
+        auto permuteOp = b.create<tensor_ext::PermuteOp>(
+            input, b.getI64TensorAttr(permutation));
+        setMaterializedAttr(permuteOp);
+        permuteOp->setAttr(kLayoutAttrName, op->getAttr(kLayoutAttrName));
+        aligned = permuteOp.getResult();
+      } else {
+        aligned = applyCiphertextPermutations(b, input, initType, permutations);
+      }
+
+      SmallVector<Value> operands = {accumulator ? accumulator : init,
+                                     aligned};
+      SmallVector<Type> newResultTypes = {initType};
       Operation *nextOp = rewriter.create(
           OperationState(op->getLoc(), innerOp->getName().getStringRef(),
                          operands, newResultTypes));
-      permuteOp->setAttr(kLayoutAttrName, op->getAttr(kLayoutAttrName));
-      nextOp->setAttr(kLayoutAttrName, op->getAttr(kLayoutAttrName));
-      setMaterializedAttr({permuteOp, nextOp});
-      result = nextOp->getResult(0);
+      if (singleCiphertext)
+        nextOp->setAttr(kLayoutAttrName, op->getAttr(kLayoutAttrName));
+      setMaterializedAttr(nextOp);
+      accumulator = nextOp->getResult(0);
+    }
+
+    Value result = accumulator ? accumulator : init;
+    if (!singleCiphertext && result != init) {
+      setAttributeAssociatedWith(result, kLayoutAttrName,
+                                 op->getAttr(kLayoutAttrName));
     }
 
     // TODO(#1591): post-process the layout properly for padding
     rewriter.replaceOp(op, result);
     return success();
   }
+
+ private:
+  // The layout of the result of reducing the given dimensions in place, with
+  // the reduced dimensions dropped from the domain.
+  static AffineMap getReducedLayoutMap(LayoutAttr layout,
+                                       ArrayRef<int64_t> reducedDims) {
+    llvm::SmallBitVector dimsBV(layout.getMap().getNumDims(), false);
+    for (int64_t dim : reducedDims) dimsBV.set(dim);
+    return projectDims(layout.getMap(), dimsBV, /*compressDims=*/true);
+  }
+
+  // If incrementing the index of an entry along each reduced dimension moves
+  // its slot by a fixed (cyclic) stride, and the reduced dimensions have
+  // power-of-two sizes, return the stride of each reduced dimension.
+  static std::optional<SmallVector<int64_t>> getReducedDimStrides(
+      RankedTensorType dataSemanticType, LayoutAttr layout,
+      ArrayRef<int64_t> reducedDims, int64_t numSlots) {
+    SmallVector<int64_t> strides;
+    for (int64_t dim : reducedDims) {
+      int64_t dimSize = dataSemanticType.getDimSize(dim);
+      if (!isPowerOfTwo(dimSize)) return std::nullopt;
+
+      std::optional<int64_t> stride;
+      bool isStrided = true;
+      iterateIndices(
+          dataSemanticType.getShape(),
+          [&](const std::vector<int64_t> &indices) {
+            if (!isStrided || indices[dim] + 1 >= dimSize) return;
+            std::vector<int64_t> nextIndices(indices);
+            ++nextIndices[dim];
+            SmallVector<int64_t> results;
+            SmallVector<int64_t> nextResults;
+            evaluateStatic(layout.getMap(), indices, results);
+            evaluateStatic(layout.getMap(), nextIndices, nextResults);
+            int64_t slotDiff =
+                ((nextResults.back() - results.back()) % numSlots + numSlots) %
+                numSlots;
+            if (!stride.has_value()) stride = slotDiff;
+            isStrided &= results.size() == 1 && *stride == slotDiff;
+          });
+      if (!isStrided || (dimSize > 1 && stride == 0)) return std::nullopt;
+      strides.push_back(stride.value_or(0));
+    }
+    return strides;
+  }
+
+  // Reduce a single ciphertext along each reduced dimension with a tree of
+  // log2(dimSize) rotations by halving multiples of the dimension's stride.
+  // The reductions compose: the tree for each dimension combines the partial
+  // results of the previous ones, so that the slot of the entry whose reduced
+  // indices are all zero ends up holding the reduction over all of them.
+  Value rotateAndReduce(ImplicitLocOpBuilder &b, linalg::ReduceOp op,
+                        Value input, Value init, ArrayRef<int64_t> strides,
+                        RankedTensorType ciphertextType) const {
+    auto dataSemanticType = cast<RankedTensorType>(op.getInputs()[0].getType());
+    int64_t numSlots = ciphertextType.getDimSize(0);
+    StringRef opName =
+        op.getBlock()->getOperations().front().getName().getStringRef();
+    auto createCombine = [&](Value lhs, Value rhs) {
+      Operation *combineOp = b.create(
+          OperationState(op->getLoc(), opName, {lhs, rhs}, {ciphertextType}));
+      setMaterializedAttr(combineOp);
+      return combineOp->getResult(0);
+    };
+
+    Value accumulator = input;
+    for (const auto &[dim, stride] : llvm::zip(op.getDimensions(), strides)) {
+      for (int64_t step = dataSemanticType.getDimSize(dim) / 2; step >= 1;
+           step /= 2) {
+        accumulator = createCombine(
+            accumulator,
+            createRotate(b, accumulator, (step * stride) % numSlots));
+      }
+    }
+
+    Value result = createCombine(init, accumulator);
+    setAttributeAssociatedWith(result, kLayoutAttrName,
+                               op->getAttr(kLayoutAttrName));
+    return result;
+  }
 };
 
 struct ConvertLinalgMatvec
@@ -646,14 +1169,6 @@ struct ConvertLinalgMatvec
   using ContextAwareOpConversionPattern<
       linalg::MatvecOp>::ContextAwareOpConversionPattern;
 
-  LayoutAttr getLayoutAttr(Value value) const {
-    auto layoutLookup = getTypeConverter()->getContextualAttr(value);
-    if (failed(layoutLookup)) {
-      return nullptr;
-    }
-    return cast<LayoutAttr>(layoutLookup.value());
-  }
-
   bool supportsHaleviShoup(linalg::MatvecOp op, OpAdaptor adaptor) const {
     Value matrix = adaptor.getInputs()[0];
     Value vector = adaptor.getInputs()[1];
@@ -673,8 +1188,8 @@ struct ConvertLinalgMatvec
       return false;
     }
 
-    LayoutAttr matrixLayout = getLayoutAttr(matrix);
-    LayoutAttr vectorLayout = getLayoutAttr(vector);
+    LayoutAttr matrixLayout = getLayoutAttr(getTypeConverter(), matrix);
+    LayoutAttr vectorLayout = getLayoutAttr(getTypeConverter(), vector);
     bool isSquatDiagonal = isLayoutSquatDiagonal(
         matrixType, materializedMatrixType, matrixLayout.getMap());
     bool isRowMajor = isLayoutRowMajor(vectorType, materializedVectorType,
@@ -684,8 +1199,8 @@ struct ConvertLinalgMatvec
                << "supportsHaleviShoup: " << "isSquatDiagonal="
                << isSquatDiagonal << " isRowMajor=" << isRowMajor << "\n");
 
-    // TODO(#1578): If the matrix has more rows than columns, what kernel
-    // should be used?
+    // Matrices with more rows than columns use the extended diagonal layout
+    // instead (see supportsExtendedDiagonal).
     bool dimensionsCompatible = numRows <= numCols;
     return isSquatDiagonal && isRowMajor && dimensionsCompatible;
   }
@@ -761,26 +1276,29 @@ struct ConvertLinalgMatvec
     }
 
     // else, necessarily matrixNumRows < matrixNumCols due to the precondition
-    // applied earlier. This is the post-processing partial-rotate-and-reduce
-    // step required for squat-diagonal packing.
+    // applied earlier.
     int64_t matrixNumRows = packedMatrixType.getShape()[0];
-    int64_t matrixNumCols = packedMatrixType.getShape()[1];
+    rewriter.replaceOp(
+        op, reduceSquatPartialSums(b, summedShifts, matrixNumRows, layoutAttr));
+  }
+
+  // The post-processing partial-rotate-and-reduce step required for
+  // squat-diagonal packing of a matrix with numRows diagonals, followed by
+  // masking if the output layout requires a particular padding.
+  Value reduceSquatPartialSums(ImplicitLocOpBuilder &b, Value summedShifts,
+                               int64_t matrixNumRows,
+                               LayoutAttr layoutAttr) const {
+    auto packedType = cast<RankedTensorType>(summedShifts.getType());
+    Type elementType = packedType.getElementType();
+    int64_t matrixNumCols = packedType.getShape()[0];
 
     int64_t numShifts = (int64_t)(log2(matrixNumCols) - log2(matrixNumRows));
     int64_t shift = matrixNumCols / 2;
 
     for (int64_t i = 0; i < numShifts; ++i) {
-      auto shiftAmountOp = b.create<arith::ConstantIntOp>(shift, 64);
-      auto rotateOp =
-          b.create<tensor_ext::RotateOp>(summedShifts, shiftAmountOp);
-      setMaterializedAttr(rotateOp);
-      auto *addOp = b.create(OperationState(
-          op->getLoc(), addOpName, {summedShifts, rotateOp.getResult()},
-          {rotateOp.getResult().getType()}));
-      setMaterializedAttr({shiftAmountOp, rotateOp, addOp});
-      setAttributeAssociatedWith(addOp->getResult(0), kLayoutAttrName,
-                                 layoutAttr);
-      summedShifts = addOp->getResult(0);
+      summedShifts =
+          createAdd(b, summedShifts, createRotate(b, summedShifts, shift));
+      setAttributeAssociatedWith(summedShifts, kLayoutAttrName, layoutAttr);
       shift /= 2;
     }
 
@@ -791,17 +1309,15 @@ struct ConvertLinalgMatvec
     if (!layoutAttr.getAlignment() ||
         layoutAttr.getAlignment().getPadding().empty()) {
       // TODO(#1569): also hit this branch if the padding value is dont_care
-      rewriter.replaceOp(op, summedShifts);
-      return;
+      return summedShifts;
     }
 
     // Otherwise, the output layout requires a particular padding, and we
     // need to force the replicated values to be zero. This is done by
     // applying a plaintext-ciphertext mask.
-    TypedAttr padAttr =
-        DenseElementsAttr::get(cast<ShapedType>(result.getType()),
-                               layoutAttr.getAlignment().getPaddingValue());
-    auto zeroOp = b.create<arith::ConstantOp>(result.getType(), padAttr);
+    TypedAttr padAttr = DenseElementsAttr::get(
+        packedType, layoutAttr.getAlignment().getPaddingValue());
+    auto zeroOp = b.create<arith::ConstantOp>(packedType, padAttr);
 
     // insert a slice of 1's in the first n of the zeros tensor to make a mask
     SmallVector<int64_t> prefixShape = {matrixNumRows};
@@ -813,14 +1329,387 @@ struct ConvertLinalgMatvec
         oneOp, zeroOp, ArrayRef<Value>{}, ArrayRef<Value>{}, ArrayRef<Value>{},
         /*offsets=*/ArrayRef<int64_t>{0},
         /*sizes=*/ArrayRef{matrixNumRows}, /*strides=*/ArrayRef<int64_t>{1});
-    auto *applyMaskOp = b.create(OperationState(op->getLoc(), mulOpName,
-                                                {summedShifts, createMaskOp},
-                                                {summedShifts.getType()}));
+    setMaterializedAttr({zeroOp, oneOp, createMaskOp});
+    Value masked = createMul(b, summedShifts, createMaskOp);
+    setAttributeAssociatedWith(masked, kLayoutAttrName, layoutAttr);
+    return masked;
+  }
+
+  // Whether the matrix is split into blocks that are each packed with the
+  // squat diagonal layout, as produced by getTiledDiagonalLayoutMap, and the
+  // vector and output are row-major across as many ciphertexts as needed.
+  // This is how matrices that do not fit in a single ciphertext per diagonal
+  // are supported.
+  bool supportsTiledHaleviShoup(linalg::MatvecOp op, OpAdaptor adaptor) const {
+    auto matrixType = cast<RankedTensorType>(op.getInputs()[0].getType());
+    auto vectorType = cast<RankedTensorType>(op.getInputs()[1].getType());
+    auto outputType = cast<RankedTensorType>(op.getOutputs()[0].getType());
+    auto packedMatrixType =
+        cast<RankedTensorType>(adaptor.getInputs()[0].getType());
+    auto packedVectorType =
+        cast<RankedTensorType>(adaptor.getInputs()[1].getType());
+    auto packedOutputType =
+        cast<RankedTensorType>(adaptor.getOutputs()[0].getType());
+
+    int64_t numRows = matrixType.getDimSize(0);
+    int64_t numCols = matrixType.getDimSize(1);
+    int64_t numSlots = packedVectorType.getShape().back();
+    if (!isPowerOfTwo(numRows) || !isPowerOfTwo(numCols) ||
+        numCols < numSlots) {
+      return false;
+    }
+
+    LayoutAttr matrixLayout =
+        getLayoutAttr(getTypeConverter(), adaptor.getInputs()[0]);
+    LayoutAttr vectorLayout =
+        getLayoutAttr(getTypeConverter(), adaptor.getInputs()[1]);
+    LayoutAttr outputLayout =
+        getLayoutAttr(getTypeConverter(), adaptor.getOutputs()[0]);
+    if (!outputLayout) return false;
+
+    bool isTiledDiagonal = isLayoutTiledDiagonal(matrixType, packedMatrixType,
+                                                 matrixLayout.getMap());
+    bool isVectorRowMajor = isLayoutRowMajor(vectorType, packedVectorType,
+                                             vectorLayout.getMap());
+    // A single output ciphertext may hold the output in any layout the squat
+    // kernel supports, but multiple output ciphertexts must be row-major so
+    // that each row block of the matrix produces one output ciphertext.
+    bool isOutputCompatible =
+        numRows <= numSlots
+            ? packedOutputType.getRank() == 1
+            : packedOutputType.getRank() == 2 &&
+                  packedOutputType.getDimSize(0) == numRows / numSlots &&
+                  isLayoutRowMajor(outputType, packedOutputType,
+                                   outputLayout.getMap());
+
+    LLVM_DEBUG(llvm::dbgs()
+               << "supportsTiledHaleviShoup: isTiledDiagonal="
+               << isTiledDiagonal << " isVectorRowMajor=" << isVectorRowMajor
+               << " isOutputCompatible=" << isOutputCompatible << "\n");
+    return isTiledDiagonal && isVectorRowMajor && isOutputCompatible;
+  }
+
+  // Apply the Halevi-Shoup kernel to each block of a matrix packed by
+  // getTiledDiagonalLayoutMap. The partial products of the blocks in a row
+  // of blocks are accumulated into the output ciphertext for that row of
+  // blocks, and the rotations of each vector ciphertext are shared across
+  // all rows of blocks.
+  void tiledHaleviShoupKernel(
+      linalg::MatvecOp op, OpAdaptor adaptor,
+      ContextAwareConversionPatternRewriter &rewriter) const {
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    Value packedMatrix = adaptor.getInputs()[0];
+    Value packedVector = adaptor.getInputs()[1];
+    Value packedOutput = adaptor.getOutputs()[0];
+    auto matrixType = cast<RankedTensorType>(op.getInputs()[0].getType());
+    auto packedVectorType = cast<RankedTensorType>(packedVector.getType());
+    int64_t numSlots = packedVectorType.getShape().back();
+    auto layoutAttr = cast<LayoutAttr>(op->getAttr(kLayoutAttrName));
+
+    int64_t numRows = matrixType.getDimSize(0);
+    int64_t numCols = matrixType.getDimSize(1);
+    int64_t blockRows = std::min(numRows, numSlots);
+    int64_t numRowBlocks = numRows / blockRows;
+    int64_t numColBlocks = numCols / numSlots;
+
+    // (column block, rotation amount) -> rotated vector ciphertext
+    std::map<std::pair<int64_t, int64_t>, Value> rotations;
+    auto getRotation = [&](int64_t colBlock, int64_t shift) -> Value {
+      auto it = rotations.find({colBlock, shift});
+      if (it != rotations.end()) return it->second;
+      auto baseIt = rotations.find({colBlock, 0});
+      Value rotated =
+          baseIt != rotations.end()
+              ? baseIt->second
+              : extractCiphertext(b, packedVector, b.getIndexAttr(colBlock));
+      rotations[{colBlock, 0}] = rotated;
+      if (shift != 0) {
+        rotated = createRotate(b, rotated, shift);
+        rotations[{colBlock, shift}] = rotated;
+      }
+      return rotated;
+    };
+
+    Value result = packedOutput;
+    for (int64_t rowBlock = 0; rowBlock < numRowBlocks; ++rowBlock) {
+      Value accumulator =
+          extractCiphertext(b, packedOutput, b.getIndexAttr(rowBlock));
+      for (int64_t colBlock = 0; colBlock < numColBlocks; ++colBlock) {
+        int64_t firstDiagonal =
+            (rowBlock * numColBlocks + colBlock) * blockRows;
+        for (int64_t index = 0; index < blockRows; ++index) {
+          Value diagonal = extractCiphertext(
+              b, packedMatrix, b.getIndexAttr(firstDiagonal + index));
+          accumulator = createAdd(
+              b, accumulator,
+              createMul(b, getRotation(colBlock, index), diagonal));
+        }
+      }
+
+      if (blockRows < numSlots) {
+        accumulator =
+            reduceSquatPartialSums(b, accumulator, blockRows, layoutAttr);
+      }
+      result = insertCiphertext(b, accumulator, result,
+                                b.getIndexAttr(rowBlock));
+    }
+
+    setAttributeAssociatedWith(result, kLayoutAttrName, layoutAttr);
+    rewriter.replaceOp(op, result);
+  }
+
+  // Whether the vector is laid out as rotated replicas (see
+  // getRotatedReplicasLayoutMap) and the matrix as the matching replicated
+  // diagonals, and the output is a row-major vector in a single ciphertext.
+  bool supportsReplicatedHaleviShoup(linalg::MatvecOp op,
+                                     OpAdaptor adaptor) const {
+    auto matrixType = cast<RankedTensorType>(op.getInputs()[0].getType());
+    auto outputType = cast<RankedTensorType>(op.getOutputs()[0].getType());
+    auto packedMatrixType =
+        cast<RankedTensorType>(adaptor.getInputs()[0].getType());
+    auto packedVectorType =
+        cast<RankedTensorType>(adaptor.getInputs()[1].getType());
+    auto packedOutputType =
+        cast<RankedTensorType>(adaptor.getOutputs()[0].getType());
+
+    int64_t n = matrixType.getDimSize(0);
+    if (!isPowerOfTwo(n) || matrixType.getDimSize(1) != n ||
+        packedVectorType.getRank() != 1 || packedOutputType.getRank() != 1)
+      return false;
+
+    LayoutAttr matrixLayout =
+        getLayoutAttr(getTypeConverter(), adaptor.getInputs()[0]);
+    LayoutAttr vectorLayout =
+        getLayoutAttr(getTypeConverter(), adaptor.getInputs()[1]);
+    LayoutAttr outputLayout =
+        getLayoutAttr(getTypeConverter(), adaptor.getOutputs()[0]);
+    if (!outputLayout) return false;
+
+    if (!isLayoutReplicatedDiagonal(matrixType, packedMatrixType,
+                                    matrixLayout.getMap()))
+      return false;
+    int64_t numCopies = n / packedMatrixType.getDimSize(0);
+
+    tensor_ext::AlignmentAttr alignment = vectorLayout.getAlignment();
+    bool isRotatedReplicas =
+        alignment && alignment.getIn().asArrayRef() == ArrayRef<int64_t>{n} &&
+        alignment.getInsertedDims().asArrayRef() == ArrayRef<int64_t>{0} &&
+        alignment.getOut().asArrayRef() ==
+            ArrayRef<int64_t>{numCopies, 2 * n} &&
+        alignment.getPadding().empty() &&
+        simplifyAffineMap(vectorLayout.getMap()) ==
+            getRotatedReplicasLayoutMap(n, numCopies, op.getContext());
+
+    int64_t numSlots = packedVectorType.getDimSize(0);
+    bool isOutputRowMajor =
+        isLayoutRowMajor(outputType, packedOutputType, outputLayout.getMap());
+
+    LLVM_DEBUG(llvm::dbgs()
+               << "supportsReplicatedHaleviShoup: numCopies=" << numCopies
+               << " isRotatedReplicas=" << isRotatedReplicas
+               << " isOutputRowMajor=" << isOutputRowMajor << "\n");
+    return isRotatedReplicas && isOutputRowMajor &&
+           2 * n * numCopies <= numSlots;
+  }
+
+  // The Halevi-Shoup kernel for a vector replicated numCopies times. Block j
+  // of the vector already holds the rotation by j * (n / numCopies) that the
+  // diagonals in block j of each matrix ciphertext need, so only the
+  // n / numCopies - 1 smaller rotations are applied to the vector, followed
+  // by log2(numCopies) rotations to sum the blocks. Without replication, the
+  // kernel needs n - 1 rotations.
+  void replicatedHaleviShoupKernel(
+      linalg::MatvecOp op, OpAdaptor adaptor,
+      ContextAwareConversionPatternRewriter &rewriter) const {
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    Value packedMatrix = adaptor.getInputs()[0];
+    Value packedVector = adaptor.getInputs()[1];
+    Value packedOutput = adaptor.getOutputs()[0];
+    auto packedMatrixType = cast<RankedTensorType>(packedMatrix.getType());
+    auto packedVectorType = cast<RankedTensorType>(packedVector.getType());
+    Type elementType = packedVectorType.getElementType();
+    int64_t numSlots = packedVectorType.getDimSize(0);
+    int64_t n = cast<RankedTensorType>(op.getInputs()[0].getType())
+                    .getDimSize(0);
+    int64_t numCiphertexts = packedMatrixType.getDimSize(0);
+    int64_t numCopies = n / numCiphertexts;
+    auto layoutAttr = cast<LayoutAttr>(op->getAttr(kLayoutAttrName));
+    LayoutAttr outputLayout = getLayoutAttr(getTypeConverter(), packedOutput);
+
+    std::optional<Value> accumulator;
+    for (int64_t index = 0; index < numCiphertexts; ++index) {
+      Value rotated =
+          index == 0 ? packedVector : createRotate(b, packedVector, index);
+      Value diagonals =
+          extractCiphertext(b, packedMatrix, b.getIndexAttr(index));
+      Value product = createMul(b, rotated, diagonals);
+      accumulator = accumulator.has_value()
+                        ? createAdd(b, *accumulator, product)
+                        : product;
+    }
+
+    // Sum the blocks into the first block.
+    Value summed = *accumulator;
+    for (int64_t shift = 2 * n; shift < 2 * n * numCopies; shift *= 2) {
+      summed = createAdd(b, summed, createRotate(b, summed, shift));
+    }
+
+    // The first n slots hold the result, and the rest hold partial sums that
+    // the output layout decides what to do with. An output layout without
+    // alignment leaves them unspecified. Otherwise they are masked to the
+    // padding value, or to zero and then replaced by copies of the result if
+    // the output is replicated.
+    tensor_ext::AlignmentAttr alignment = outputLayout.getAlignment();
+    if (alignment && n < numSlots) {
+      bool padded = !alignment.getPadding().empty();
+      TypedAttr fillAttr =
+          padded ? alignment.getPaddingValue() : b.getZeroAttr(elementType);
+      auto fillOp = b.create<arith::ConstantOp>(
+          packedVectorType,
+          DenseElementsAttr::get(packedVectorType, fillAttr));
+      RankedTensorType prefixType = RankedTensorType::get({n}, elementType);
+      auto oneOp =
+          b.create<arith::ConstantOp>(prefixType, b.getOneAttr(prefixType));
+      auto maskOp = b.create<tensor::InsertSliceOp>(
+          oneOp, fillOp, ArrayRef<Value>{}, ArrayRef<Value>{},
+          ArrayRef<Value>{},
+          /*offsets=*/ArrayRef<int64_t>{0},
+          /*sizes=*/ArrayRef{n}, /*strides=*/ArrayRef<int64_t>{1});
+      setMaterializedAttr({fillOp, oneOp, maskOp});
+      summed = createMul(b, summed, maskOp);
+
+      for (int64_t shift = n; !padded && shift < alignment.getOut()[0];
+           shift *= 2) {
+        summed =
+            createAdd(b, summed, createRotate(b, summed, numSlots - shift));
+      }
+    }
+
+    Value result = createAdd(b, packedOutput, summed);
+    setAttributeAssociatedWith(result, kLayoutAttrName, layoutAttr);
+    rewriter.replaceOp(op, result);
+  }
+
+  // For a 1D tensor packed row-major in a single ciphertext, return the size
+  // it is zero-padded to and the size it is then replicated to by its
+  // alignment, or nullopt if it is packed differently.
+  std::optional<std::pair<int64_t, int64_t>> getPaddedAndReplicatedSize(
+      Value original, Value packed) const {
+    auto originalType = cast<RankedTensorType>(original.getType());
+    auto packedType = cast<RankedTensorType>(packed.getType());
+    LayoutAttr layout = getLayoutAttr(getTypeConverter(), packed);
+    if (!layout || packedType.getRank() != 1 || !isZeroPadded(layout))
+      return std::nullopt;
+
+    tensor_ext::AlignmentAttr alignment = layout.getAlignment();
+    if (alignment && !alignment.getInsertedDims().empty()) return std::nullopt;
+
+    SmallVector<int64_t> alignedShape = getAlignedShape(originalType, layout);
+    RankedTensorType alignedType =
+        RankedTensorType::get(alignedShape, originalType.getElementType());
+    if (!isLayoutRowMajor(alignedType, packedType, layout.getMap()))
+      return std::nullopt;
 
-    setMaterializedAttr({zeroOp, oneOp, createMaskOp, applyMaskOp});
-    applyMaskOp->setAttr(kLayoutAttrName, layoutAttr);
+    int64_t paddedSize = originalType.getDimSize(0);
+    if (alignment && !alignment.getPadding().empty())
+      paddedSize += alignment.getPadding()[0];
+    if (alignedShape[0] % paddedSize != 0) return std::nullopt;
+    return std::make_pair(paddedSize, alignedShape[0]);
+  }
 
-    rewriter.replaceOp(op, applyMaskOp);
+  // Whether the matrix is zero-padded to m x n and laid out in n extended
+  // diagonals of m slots each (see getExtendedDiagonalLayoutMap). This
+  // supports tall matrices and, through the padding, dimensions that are not
+  // powers of two. The vector must be zero-padded to n and replicated so that
+  // rotations by less than n read the padded vector cyclically, and the output
+  // must be zero-padded to m and row-major.
+  bool supportsExtendedDiagonal(linalg::MatvecOp op, OpAdaptor adaptor) const {
+    Value packedMatrix = adaptor.getInputs()[0];
+    auto matrixType = cast<RankedTensorType>(op.getInputs()[0].getType());
+    auto packedMatrixType = cast<RankedTensorType>(packedMatrix.getType());
+    LayoutAttr matrixLayout = getLayoutAttr(getTypeConverter(), packedMatrix);
+    if (!isZeroPadded(matrixLayout) ||
+        (matrixLayout.getAlignment() &&
+         !matrixLayout.getAlignment().getInsertedDims().empty()))
+      return false;
+
+    SmallVector<int64_t> alignedShape =
+        getAlignedShape(matrixType, matrixLayout);
+    RankedTensorType alignedMatrixType =
+        RankedTensorType::get(alignedShape, matrixType.getElementType());
+    if (!isLayoutExtendedDiagonal(alignedMatrixType, packedMatrixType,
+                                  matrixLayout.getMap()))
+      return false;
+    int64_t m = alignedShape[0];
+    int64_t n = alignedShape[1];
+
+    auto vectorSizes =
+        getPaddedAndReplicatedSize(op.getInputs()[1], adaptor.getInputs()[1]);
+    auto outputSizes =
+        getPaddedAndReplicatedSize(op.getOutputs()[0], adaptor.getOutputs()[0]);
+    if (!vectorSizes.has_value() || !outputSizes.has_value()) return false;
+
+    // The rotations of the vector read slots i + d for i < m and d < n, which
+    // must either be in range or wrap around a fully replicated ciphertext.
+    int64_t numSlots = packedMatrixType.getDimSize(1);
+    auto [vectorPadded, vectorReplicated] = vectorSizes.value();
+    bool isVectorCompatible =
+        vectorPadded == n &&
+        (vectorReplicated == numSlots || vectorReplicated >= m + n - 1);
+    // The output is replicated by doubling.
+    auto [outputPadded, outputReplicated] = outputSizes.value();
+    bool isOutputCompatible =
+        outputPadded == m && isPowerOfTwo(outputReplicated / m);
+
+    LLVM_DEBUG(llvm::dbgs() << "supportsExtendedDiagonal: m=" << m
+                            << " n=" << n
+                            << " isVectorCompatible=" << isVectorCompatible
+                            << " isOutputCompatible=" << isOutputCompatible
+                            << "\n");
+    return isVectorCompatible && isOutputCompatible;
+  }
+
+  // The Halevi-Shoup kernel over the n extended diagonals of a zero-padded
+  // m x n matrix: the product of diagonal d and the vector rotated by d
+  // contributes M[i][(i + d) mod n] * v[(i + d) mod n] to slot i, so the sum
+  // over all diagonals holds the result in the first m slots and zeros after
+  // them. The result is then replicated as required by the output layout.
+  void extendedDiagonalKernel(
+      linalg::MatvecOp op, OpAdaptor adaptor,
+      ContextAwareConversionPatternRewriter &rewriter) const {
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    Value packedMatrix = adaptor.getInputs()[0];
+    Value packedVector = adaptor.getInputs()[1];
+    Value packedOutput = adaptor.getOutputs()[0];
+    auto packedMatrixType = cast<RankedTensorType>(packedMatrix.getType());
+    auto packedVectorType = cast<RankedTensorType>(packedVector.getType());
+    int64_t numSlots = packedVectorType.getDimSize(0);
+    int64_t numDiagonals = packedMatrixType.getDimSize(0);
+    auto [m, replicatedSize] =
+        getPaddedAndReplicatedSize(op.getOutputs()[0], packedOutput).value();
+    auto layoutAttr = cast<LayoutAttr>(op->getAttr(kLayoutAttrName));
+
+    std::optional<Value> accumulator;
+    for (int64_t index = 0; index < numDiagonals; ++index) {
+      Value rotated =
+          index == 0 ? packedVector : createRotate(b, packedVector, index);
+      Value diagonal =
+          extractCiphertext(b, packedMatrix, b.getIndexAttr(index));
+      Value product = createMul(b, rotated, diagonal);
+      accumulator = accumulator.has_value()
+                        ? createAdd(b, *accumulator, product)
+                        : product;
+    }
+
+    // Copy the first m slots into the zeros after them by rotating right.
+    Value summed = *accumulator;
+    for (int64_t shift = m; shift < replicatedSize; shift *= 2) {
+      summed = createAdd(b, summed, createRotate(b, summed, numSlots - shift));
+    }
+
+    Value result = createAdd(b, packedOutput, summed);
+    setAttributeAssociatedWith(result, kLayoutAttrName, layoutAttr);
+    rewriter.replaceOp(op, result);
   }
 
   LogicalResult matchAndRewrite(
@@ -828,8 +1717,8 @@ struct ConvertLinalgMatvec
       ContextAwareConversionPatternRewriter &rewriter) const final {
     Value matrix = adaptor.getInputs()[0];
     Value vector = adaptor.getInputs()[1];
-    LayoutAttr vectorLayout = getLayoutAttr(vector);
-    LayoutAttr matrixLayout = getLayoutAttr(matrix);
+    LayoutAttr vectorLayout = getLayoutAttr(getTypeConverter(), vector);
+    LayoutAttr matrixLayout = getLayoutAttr(getTypeConverter(), matrix);
 
     if (!matrixLayout)
       return op.emitError() << "missing layout attribute for matrix";
@@ -842,12 +1731,225 @@ struct ConvertLinalgMatvec
       return success();
     }
 
-    // TODO(#1589): implement row-major naive matvec kernel
+    if (supportsTiledHaleviShoup(op, adaptor)) {
+      tiledHaleviShoupKernel(op, adaptor, rewriter);
+      return success();
+    }
+
+    if (supportsReplicatedHaleviShoup(op, adaptor)) {
+      replicatedHaleviShoupKernel(op, adaptor, rewriter);
+      return success();
+    }
+
+    if (supportsExtendedDiagonal(op, adaptor)) {
+      extendedDiagonalKernel(op, adaptor, rewriter);
+      return success();
+    }
+
     return op.emitError() << "unsupported layout for matrix in matvec: "
                           << matrixLayout;
   }
 };
 
+// Implements a secret-secret linalg.matmul of square row-major matrices
+// packed in a single ciphertext each, using the method of Jiang, Kim, Lauter
+// and Song (https://eprint.iacr.org/2018/1041). For d x d matrices A and B,
+//
+//   A (x) B = sum_{k=0}^{d-1} phi^k(sigma(A)) * psi^k(tau(B))
+//
+// where sigma shifts row i of A left by i, tau shifts column j of B up by j,
+// phi shifts every row left by one and psi shifts every column up by one.
+// sigma and tau are slot permutations of the packed matrix, lowered to
+// tensor_ext.permute and later to rotations by implement-shift-network.
+// phi^k and psi^k are each applied as two rotations of the matrix under
+// complementary masks.
+struct ConvertLinalgMatmul
+    : public ContextAwareOpConversionPattern<linalg::MatmulOp> {
+ public:
+  using ContextAwareOpConversionPattern<
+      linalg::MatmulOp>::ContextAwareOpConversionPattern;
+
+  // Whether the value is a d x d matrix in a single ciphertext, packed
+  // row-major and padded with zeros, if at all.
+  bool isSquareRowMajor(Value original, Value packed, int64_t d) const {
+    LayoutAttr layout = getLayoutAttr(getTypeConverter(), packed);
+    if (!layout) return false;
+    auto packedType = cast<RankedTensorType>(packed.getType());
+    if (packedType.getRank() != 1) return false;
+
+    SmallVector<int64_t> shape = getAlignedShape(original.getType(), layout);
+    if (shape.size() != 2 || shape[0] != d || shape[1] != d) return false;
+    if (!isZeroPadded(layout)) return false;
+
+    RankedTensorType alignedType =
+        RankedTensorType::get(shape, packedType.getElementType());
+    return isLayoutRowMajor(alignedType, packedType, layout.getMap());
+  }
+
+  bool supportsJiangKimLauterSong(linalg::MatmulOp op,
+                                  OpAdaptor adaptor) const {
+    Value lhs = adaptor.getInputs()[0];
+    LayoutAttr lhsLayout = getLayoutAttr(getTypeConverter(), lhs);
+    SmallVector<int64_t> shape =
+        getAlignedShape(op.getInputs()[0].getType(), lhsLayout);
+    if (shape.size() != 2) return false;
+    int64_t d = shape[0];
+    int64_t numSlots = cast<RankedTensorType>(lhs.getType()).getShape().back();
+    if (d * d > numSlots) return false;
+
+    bool isCompatible =
+        isSquareRowMajor(op.getInputs()[0], adaptor.getInputs()[0], d) &&
+        isSquareRowMajor(op.getInputs()[1], adaptor.getInputs()[1], d) &&
+        isSquareRowMajor(op.getOutputs()[0], adaptor.getOutputs()[0], d);
+    LLVM_DEBUG(llvm::dbgs() << "supportsJiangKimLauterSong: d=" << d
+                            << " isCompatible=" << isCompatible << "\n");
+    return isCompatible;
+  }
+
+  void jiangKimLauterSongKernel(
+      linalg::MatmulOp op, OpAdaptor adaptor,
+      ContextAwareConversionPatternRewriter &rewriter) const {
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    Value packedLhs = adaptor.getInputs()[0];
+    Value packedRhs = adaptor.getInputs()[1];
+    Value packedOutput = adaptor.getOutputs()[0];
+    auto packedType = cast<RankedTensorType>(packedLhs.getType());
+    Type elementType = packedType.getElementType();
+    int64_t numSlots = packedType.getDimSize(0);
+    int64_t d =
+        getAlignedShape(op.getInputs()[0].getType(),
+                        getLayoutAttr(getTypeConverter(), packedLhs))[0];
+    auto layoutAttr = cast<LayoutAttr>(op->getAttr(kLayoutAttrName));
+
+    // Permute the packed matrix so that entry (i, j) moves to
+    // target(i, j). The slots past the matrix are left in place.
+    auto createPermute = [&](Value value, auto target) -> Value {
+      SmallVector<int64_t> permutation(numSlots);
+      std::iota(permutation.begin(), permutation.end(), 0);
+      bool isIdentity = true;
+      for (int64_t i = 0; i < d; ++i) {
+        for (int64_t j = 0; j < d; ++j) {
+          auto [row, col] = target(i, j);
+          permutation[i * d + j] = row * d + col;
+          isIdentity &= row == i && col == j;
+        }
+      }
+      if (isIdentity) return value;
+      auto permuteOp = b.create<tensor_ext::PermuteOp>(
+          value, b.getI64TensorAttr(permutation));
+      setMaterializedAttr(permuteOp);
+      return permuteOp.getResult();
+    };
+    auto mod = [&](int64_t x) { return ((x % d) + d) % d; };
+
+    // Mask the packed matrix to the entries (i, j) for which keep(i, j)
+    // holds, zeroing the slots past the matrix, and rotate it left by shift.
+    auto createMaskedRotate = [&](Value value, int64_t shift,
+                                  auto keep) -> Value {
+      SmallVector<Attribute> maskValues(numSlots, b.getZeroAttr(elementType));
+      for (int64_t slot = 0; slot < d * d; ++slot) {
+        if (keep(slot / d, slot % d))
+          maskValues[slot] = b.getOneAttr(elementType);
+      }
+      auto maskOp = b.create<arith::ConstantOp>(
+          packedType, DenseElementsAttr::get(packedType, maskValues));
+      setMaterializedAttr(maskOp);
+      Value masked = createMul(b, value, maskOp);
+      shift = ((shift % numSlots) + numSlots) % numSlots;
+      return shift == 0 ? masked : createRotate(b, masked, shift);
+    };
+
+    // sigma: A'[i][j] = A[i][i + j], and tau: B'[i][j] = B[i + j][j].
+    Value sigmaLhs = createPermute(packedLhs, [&](int64_t i, int64_t j) {
+      return std::make_pair(i, mod(j - i));
+    });
+    Value tauRhs = createPermute(packedRhs, [&](int64_t i, int64_t j) {
+      return std::make_pair(mod(i - j), j);
+    });
+
+    // The first product is masked like the others, so that every product is
+    // zero past the matrix.
+    Value firstLhs = sigmaLhs;
+    if (d * d < numSlots) {
+      firstLhs = createMaskedRotate(sigmaLhs, 0,
+                                    [](int64_t i, int64_t j) { return true; });
+    }
+    Value firstProduct = createMul(b, firstLhs, tauRhs);
+    Value accumulator = createAdd(b, packedOutput, firstProduct);
+    for (int64_t k = 1; k < d; ++k) {
+      // phi^k: A''[i][j] = A'[i][j + k]. Entries with j + k < d move k slots
+      // left, and the others wrap around within their row, moving d - k
+      // slots right.
+      Value lhsHead = createMaskedRotate(
+          sigmaLhs, k, [&](int64_t i, int64_t j) { return j >= k; });
+      Value lhsTail = createMaskedRotate(
+          sigmaLhs, k - d, [&](int64_t i, int64_t j) { return j < k; });
+      Value shiftedLhs = createAdd(b, lhsHead, lhsTail);
+
+      // psi^k: B''[i][j] = B'[i + k][j]. Rows i + k < d move k rows up, and
+      // the others wrap around to the top rows, which is the same rotation
+      // if the matrix fills the ciphertext.
+      Value shiftedRhs;
+      if (d * d == numSlots) {
+        shiftedRhs = createRotate(b, tauRhs, k * d);
+      } else {
+        Value rhsHead = createMaskedRotate(
+            tauRhs, k * d, [&](int64_t i, int64_t j) { return i >= k; });
+        Value rhsTail = createMaskedRotate(
+            tauRhs, k * d - d * d, [&](int64_t i, int64_t j) { return i < k; });
+        shiftedRhs = createAdd(b, rhsHead, rhsTail);
+      }
+
+      Value product = createMul(b, shiftedLhs, shiftedRhs);
+      accumulator = createAdd(b, accumulator, product);
+    }
+
+    // The zero padding of the inputs keeps the padding within the matrix
+    // zero. Every product is zero past the matrix, so those slots keep the
+    // values of the output init, which the output layout does not use.
+    setAttributeAssociatedWith(accumulator, kLayoutAttrName, layoutAttr);
+    rewriter.replaceOp(op, accumulator);
+  }
+
+  LogicalResult matchAndRewrite(
+      linalg::MatmulOp op, OpAdaptor adaptor,
+      ContextAwareConversionPatternRewriter &rewriter) const final {
+    if (!getLayoutAttr(getTypeConverter(), adaptor.getInputs()[0]))
+      return op.emitError() << "missing layout attribute for lhs";
+
+    if (!getLayoutAttr(getTypeConverter(), adaptor.getInputs()[1]))
+      return op.emitError() << "missing layout attribute for rhs";
+
+    if (!getLayoutAttr(getTypeConverter(), adaptor.getOutputs()[0]))
+      return op.emitError() << "missing layout attribute for output";
+
+    if (supportsJiangKimLauterSong(op, adaptor)) {
+      jiangKimLauterSongKernel(op, adaptor, rewriter);
+      return success();
+    }
+
+    return op.emitError()
+           << "unsupported layouts for matmul: expected square row-major "
+              "matrices in a single ciphertext each";
+  }
+};
+
+// Materialize the layout of the entry at the given (dynamic) indices, with
+// one affine.apply per result of the layout. The last result is the slot.
+SmallVector<affine::AffineApplyOp> applyLayout(ImplicitLocOpBuilder &b,
+                                               LayoutAttr layout,
+                                               ValueRange indices) {
+  AffineMap map = layout.getMap();
+  SmallVector<affine::AffineApplyOp> applyOps;
+  for (unsigned i = 0; i < map.getNumResults(); ++i) {
+    auto applyOp =
+        b.create<affine::AffineApplyOp>(map.getSubMap({i}), indices);
+    setMaterializedAttr(applyOp);
+    applyOps.push_back(applyOp);
+  }
+  return applyOps;
+}
+
 Value makeMask(ContextAwareConversionPatternRewriter &rewriter, Location loc,
                Value index, RankedTensorType ciphertextSemanticType) {
   // The ciphertext tensor is a 1D tensor, so the applyOp's result is a
@@ -927,41 +2029,48 @@ class ConvertTensorExtract
              << "mismatching number of indices (" << adaptor.getIndices().size()
              << ") for map " << mapStr;
     }
-    auto applyOp = rewriter.create<affine::AffineApplyOp>(
-        op.getLoc(), tensorLayout.getMap(), adaptor.getIndices());
 
     RankedTensorType ciphertextSemanticType =
         cast<RankedTensorType>(adaptor.getTensor().getType());
-
-    // TODO(#1542): support multi-packed ciphertexts
-    if (ciphertextSemanticType.getRank() != 1) {
+    if (ciphertextSemanticType.getRank() > 2) {
       return op.emitError()
-             << "Does not support packing into multiple ciphertexts yet";
+             << "Does not support more than one ciphertext dimension";
     }
 
-    // The ciphertext tensor is a 1D tensor, so the applyOp's result is a
-    // single value we can use to build a mask.
+    // If the tensor spans multiple ciphertexts, select the ciphertext holding
+    // the extracted entry and apply the single-ciphertext kernel to it.
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    SmallVector<affine::AffineApplyOp> applyOps =
+        applyLayout(b, tensorLayout, adaptor.getIndices());
+    Value slotIndex = applyOps.back().getResult();
+    Value ciphertext = adaptor.getTensor();
+    if (applyOps.size() > 1) {
+      ciphertext = extractCiphertext(
+          b, ciphertext, OpFoldResult(applyOps.front().getResult()));
+    }
+    RankedTensorType ciphertextType =
+        cast<RankedTensorType>(ciphertext.getType());
+
+    // The selected ciphertext is a 1D tensor, so the slot index is a single
+    // value we can use to build a mask.
     // A tensor of zeros
-    Value mask = makeMask(rewriter, op.getLoc(), applyOp.getResult(),
-                          ciphertextSemanticType);
+    Value mask = makeMask(rewriter, op.getLoc(), slotIndex, ciphertextType);
 
     // multiply the mask by the converted value
-    StringRef mulOpName =
-        isa<IntegerType>(ciphertextSemanticType.getElementType())
-            ? "arith.muli"
-            : "arith.mulf";
-    Operation *mulOp = rewriter.create(
-        OperationState(op->getLoc(), mulOpName, {mask, adaptor.getTensor()},
-                       {ciphertextSemanticType}));
+    StringRef mulOpName = isa<IntegerType>(ciphertextType.getElementType())
+                              ? "arith.muli"
+                              : "arith.mulf";
+    Operation *mulOp = rewriter.create(OperationState(
+        op->getLoc(), mulOpName, {mask, ciphertext}, {ciphertextType}));
 
     // Rotate left to the first position
     auto rotateOp = rewriter.create<tensor_ext::RotateOp>(
-        op.getLoc(), mulOp->getResult(0), applyOp.getResult());
+        op.getLoc(), mulOp->getResult(0), slotIndex);
     Operation *result = rotateOp;
 
     // TODO(#1662): improve scalar layout materialization
 
-    setMaterializedAttr({applyOp, mulOp, rotateOp});
+    setMaterializedAttr({mulOp, rotateOp});
     setAttributeAssociatedWith(result->getResult(0), kLayoutAttrName,
                                resultLayout);
     rewriter.replaceOp(op, result);
@@ -1002,28 +2111,35 @@ class ConvertTensorInsert
     }
     LayoutAttr resultLayout = cast<LayoutAttr>(resultLayoutResult.value());
 
-    // The indices at which to insert must be materialized via the layout
-    // mapping, which corresponds to inserting an affine.apply.
-    auto applyOp = rewriter.create<affine::AffineApplyOp>(
-        op.getLoc(), tensorLayout.getMap(), adaptor.getIndices());
-
     RankedTensorType ciphertextSemanticType =
         cast<RankedTensorType>(adaptor.getDest().getType());
-
-    // TODO(#1542): support multi-packed ciphertexts
-    if (ciphertextSemanticType.getRank() != 1) {
+    if (ciphertextSemanticType.getRank() > 2) {
       return op.emitError()
-             << "Does not support packing into multiple ciphertexts yet";
+             << "Does not support more than one ciphertext dimension";
     }
 
-    StringRef mulOpName =
-        isa<IntegerType>(ciphertextSemanticType.getElementType())
-            ? "arith.muli"
-            : "arith.mulf";
-    StringRef addOpName =
-        isa<IntegerType>(ciphertextSemanticType.getElementType())
-            ? "arith.addi"
-            : "arith.addf";
+    // The indices at which to insert must be materialized via the layout
+    // mapping, which corresponds to inserting an affine.apply. If the dest
+    // spans multiple ciphertexts, the single-ciphertext kernel is applied to
+    // the ciphertext holding the target entry, which is then inserted back.
+    ImplicitLocOpBuilder b(op.getLoc(), rewriter);
+    SmallVector<affine::AffineApplyOp> applyOps =
+        applyLayout(b, tensorLayout, adaptor.getIndices());
+    Value slotIndex = applyOps.back().getResult();
+    std::optional<OpFoldResult> ciphertextIndex;
+    Value dest = adaptor.getDest();
+    if (applyOps.size() > 1) {
+      ciphertextIndex = applyOps.front().getResult();
+      dest = extractCiphertext(b, dest, *ciphertextIndex);
+    }
+    RankedTensorType ciphertextType = cast<RankedTensorType>(dest.getType());
+
+    StringRef mulOpName = isa<IntegerType>(ciphertextType.getElementType())
+                              ? "arith.muli"
+                              : "arith.mulf";
+    StringRef addOpName = isa<IntegerType>(ciphertextType.getElementType())
+                              ? "arith.addi"
+                              : "arith.addf";
 
     // TODO(#1662): support more sophisticated scalar layouts
     //
@@ -1036,29 +2152,28 @@ class ConvertTensorInsert
     //   [v, 0, 0, ..., 0]
     //
     auto zero = rewriter.create<arith::ConstantIndexOp>(op.getLoc(), 0);
-    Value mask = makeMask(rewriter, op.getLoc(), zero.getResult(),
-                          ciphertextSemanticType);
+    Value mask =
+        makeMask(rewriter, op.getLoc(), zero.getResult(), ciphertextType);
     Operation *scalarMul = rewriter.create(
         OperationState(op->getLoc(), mulOpName, {mask, adaptor.getScalar()},
-                       {ciphertextSemanticType}));
+                       {ciphertextType}));
 
     // Rotate to the (materialized) index to insert
     //
     //   [0, ..., 0, v, 0, ..., 0]
     //
     auto rotateOp = rewriter.create<tensor_ext::RotateOp>(
-        op.getLoc(), scalarMul->getResult(0), applyOp.getResult());
+        op.getLoc(), scalarMul->getResult(0), slotIndex);
 
     // Inverse-mask the destination tensor so there's a zero at the target
     // value
     //
     //   [a1, a2, ..., an] --> [a1, ..., a_{k-1}, 0, a_{k+1}, ..., an]
     //
-    Value inverseMask = makeInverseMask(
-        rewriter, op.getLoc(), applyOp.getResult(), ciphertextSemanticType);
+    Value inverseMask =
+        makeInverseMask(rewriter, op.getLoc(), slotIndex, ciphertextType);
     Operation *destMul = rewriter.create(OperationState(
-        op->getLoc(), mulOpName, {inverseMask, adaptor.getDest()},
-        {ciphertextSemanticType}));
+        op->getLoc(), mulOpName, {inverseMask, dest}, {ciphertextType}));
 
     // Add the two masked tensors together
     // value
@@ -1069,11 +2184,14 @@ class ConvertTensorInsert
     Operation *finalAdd = rewriter.create(
         OperationState(op->getLoc(), addOpName,
                        {scalarMul->getResult(0), destMul->getResult(0)},
-                       {ciphertextSemanticType}));
+                       {ciphertextType}));
+    setMaterializedAttr({zero, scalarMul, rotateOp, destMul, finalAdd});
     Value result = finalAdd->getResult(0);
+    if (ciphertextIndex.has_value()) {
+      result =
+          insertCiphertext(b, result, adaptor.getDest(), *ciphertextIndex);
+    }
 
-    setMaterializedAttr(
-        {applyOp, zero, scalarMul, rotateOp, destMul, finalAdd});
     setAttributeAssociatedWith(result, kLayoutAttrName, resultLayout);
     rewriter.replaceOp(op, result);
     return success();
@@ -1102,7 +2220,7 @@ struct ConvertToCiphertextSemantics
                  // tensor_ext ops
                  ConvertConvertLayout,
                  // linalg ops
-                 ConvertLinalgReduce, ConvertLinalgMatvec,
+                 ConvertLinalgReduce, ConvertLinalgMatvec, ConvertLinalgMatmul,
                  // tensor ops
                  ConvertTensorExtract, ConvertTensorInsert,
                  // default
@@ -1,5 +1,6 @@
 #include "lib/Analysis/DimensionAnalysis/DimensionAnalysis.h"
 #include "lib/Analysis/LevelAnalysis/LevelAnalysis.h"
+#include "lib/Analysis/LoopCarriedAnalysis/LoopCarriedAnalysis.h"
 #include "lib/Analysis/NoiseAnalysis/BFV/NoiseByBoundCoeffModel.h"
 #include "lib/Analysis/NoiseAnalysis/BFV/NoiseByVarianceCoeffModel.h"
 #include "lib/Analysis/NoiseAnalysis/NoiseAnalysis.h"
@@ -140,21 +141,34 @@ struct GenerateParamBFV : impl::GenerateParamBFVBase<GenerateParamBFV> {
     LLVM_DEBUG(llvm::dbgs() << "Conservative Scheme Param:\n"
                             << schemeParam << "\n");
 
-    DataFlowSolver solver;
-    solver.load<dataflow::DeadCodeAnalysis>();
-    solver.load<dataflow::SparseConstantPropagation>();
-    // NoiseAnalysis depends on SecretnessAnalysis
-    solver.load<SecretnessAnalysis>();
-    solver.load<NoiseAnalysis<NoiseModel>>(schemeParam, model);
-    if (failed(solver.initializeAndRun(getOperation()))) {
+    // Loop bodies are analysed once, with the noise of the iter_args bounded
+    // over all iterations of the loop.
+    auto &secretness = getAnalysis<SecretnessAnalysisCache>();
+    if (failed(secretness.getStatus())) {
       getOperation()->emitOpError() << "Failed to run the analysis.\n";
       signalPassFailure();
+      return;
+    }
+
+    using NoiseLatticeType = typename NoiseAnalysis<NoiseModel>::LatticeType;
+    auto solver = solveWithLoopCarriedStates<NoiseLatticeType>(
+        getOperation(), [&](DataFlowSolver &solver) {
+          solver.load<dataflow::DeadCodeAnalysis>();
+          solver.load<dataflow::SparseConstantPropagation>();
+          // NoiseAnalysis depends on the cached secretness
+          secretness.seedSolver(solver);
+          solver.load<NoiseAnalysis<NoiseModel>>(schemeParam, model);
+        });
+    if (failed(solver)) {
+      getOperation()->emitOpError() << "Failed to run the analysis.\n";
+      signalPassFailure();
+      return;
     }
 
     // use previous analysis result to generate concrete scheme param
     auto concreteSchemeParam =
-        generateParamByMaxNoise<NoiseAnalysis<NoiseModel>>(&solver, schemeParam,
-                                                           model);
+        generateParamByMaxNoise<NoiseAnalysis<NoiseModel>>(solver->get(),
+                                                           schemeParam, model);
 
     LLVM_DEBUG(llvm::dbgs() << "Concrete Scheme Param:\n"
                             << concreteSchemeParam << "\n");
@@ -176,6 +190,9 @@ struct GenerateParamBFV : impl::GenerateParamBFVBase<GenerateParamBFV> {
   }
 
   void runOnOperation() override {
+    // Only attributes are added, so the secretness of every value is unchanged.
+    markAnalysesPreserved<SecretnessAnalysisCache>();
+
     if (auto schemeParamAttr =
             getOperation()->getAttrOfType<bgv::SchemeParamAttr>(
                 bgv::BGVDialect::kSchemeParamAttrName)) {
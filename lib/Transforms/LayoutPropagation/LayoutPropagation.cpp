@@ -1,5 +1,6 @@
 #include "lib/Transforms/LayoutPropagation/LayoutPropagation.h"
 
+#include <algorithm>
 #include <cmath>
 #include <cstdint>
 #include <optional>
@@ -18,8 +19,6 @@
 #include "llvm/include/llvm/ADT/SmallVectorExtras.h"  // from @llvm-project
 #include "llvm/include/llvm/ADT/TypeSwitch.h"         // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"          // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
-#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"   // from @llvm-project
@@ -44,6 +43,8 @@
 namespace mlir {
 namespace heir {
 
+using linalg::MatmulOp;
+using linalg::MatvecOp;
 using linalg::ReduceOp;
 using linalg::VecmatOp;
 using secret::GenericOp;
@@ -69,6 +70,14 @@ struct CompatibilityResult {
   std::optional<InFlightDiagnostic> diag;
 };
 
+// The layouts of the operands of a linalg.matvec required by the kernel that
+// is chosen for it. The output layout is also the layout of the result.
+struct MatvecLayouts {
+  LayoutAttr matrix;
+  LayoutAttr vector;
+  LayoutAttr output;
+};
+
 struct LayoutPropagation : impl::LayoutPropagationBase<LayoutPropagation> {
   using LayoutPropagationBase::LayoutPropagationBase;
 
@@ -80,6 +89,8 @@ struct LayoutPropagation : impl::LayoutPropagationBase<LayoutPropagation> {
   LogicalResult visitOperation(CollapseShapeOp op);
   LogicalResult visitOperation(ExpandShapeOp op);
   LogicalResult visitOperation(GenericOp op);
+  LogicalResult visitOperation(MatmulOp op);
+  LogicalResult visitOperation(MatvecOp op);
   LogicalResult visitOperation(ReduceOp op);
   LogicalResult visitOperation(VecmatOp op);
   LogicalResult visitOperation(YieldOp op);
@@ -95,6 +106,8 @@ struct LayoutPropagation : impl::LayoutPropagationBase<LayoutPropagation> {
   CompatibilityResult hasCompatibleArgumentLayouts(Operation *op);
 
   // Op-specific compatibility functions
+  CompatibilityResult hasCompatibleArgumentLayouts(MatmulOp op);
+  CompatibilityResult hasCompatibleArgumentLayouts(MatvecOp op);
   CompatibilityResult hasCompatibleArgumentLayouts(ReduceOp op);
   CompatibilityResult hasCompatibleArgumentLayouts(VecmatOp op);
 
@@ -102,12 +115,44 @@ struct LayoutPropagation : impl::LayoutPropagationBase<LayoutPropagation> {
   void rectifyIncompatibleOperandLayouts(Operation *op);
 
   // Op-specific overrides
+  void rectifyIncompatibleOperandLayouts(MatmulOp op);
+  void rectifyIncompatibleOperandLayouts(MatvecOp op);
   void rectifyIncompatibleOperandLayouts(ReduceOp op);
 
   // Return the default layout for a given type
   FailureOr<LayoutAttr> defaultLayoutForType(Type type);
   FailureOr<LayoutAttr> defaultLayoutForScalarType(Type type);
 
+  // Return the row-major layout of a tensor zero-padded to size x size, as
+  // required by the operands and result of a linalg.matmul.
+  LayoutAttr squareLayoutForType(Type type, int64_t size);
+
+  // Return the alignment that zero-pads each dimension of the given tensor
+  // type by `padding` and then replicates it to `alignedShape`.
+  AlignmentAttr zeroPaddedAlignment(RankedTensorType tensorType,
+                                    ArrayRef<int64_t> padding,
+                                    ArrayRef<int64_t> alignedShape);
+
+  // Return the layouts of the operands of a linalg.matvec with a plaintext
+  // matrix, as required by the matvec kernel chosen for the matrix shape, or
+  // failure if no kernel supports the shape.
+  //
+  // - A matrix whose power-of-two dimensions are at least as wide as a
+  //   ciphertext uses the (tiled) Halevi-Shoup diagonal layout, split into
+  //   blocks of one ciphertext width when it exceeds the ciphertext size.
+  // - A square power-of-two matrix that is at most a quarter of a ciphertext
+  //   wide uses the replicated diagonal layout, and the vector is laid out as
+  //   rotated replicas, which saves most of the rotations of the vector.
+  // - Any other matrix that fits in a ciphertext per diagonal after padding
+  //   its dimensions to powers of two uses the extended diagonal layout.
+  //
+  // Otherwise the vector uses its default layout, and the output always does.
+  FailureOr<MatvecLayouts> matvecLayouts(MatvecOp op);
+
+  // Return the size of the square matrices the operands of a linalg.matmul
+  // are padded to.
+  int64_t squareMatmulSize(MatmulOp op);
+
   // Create an assign_layout op for the given value, and return the resulting
   // op. The given builder should have its insertion point set before calling.
   FailureOr<AssignLayoutOp> assignDefaultLayoutForOpOperand(
@@ -270,7 +315,8 @@ LogicalResult LayoutPropagation::visitOperation(Operation *op) {
       // secret ops
       .Case<GenericOp, YieldOp>([&](auto op) { return visitOperation(op); })
       // linalg ops
-      .Case<VecmatOp, ReduceOp>([&](auto op) { return visitOperation(op); })
+      .Case<MatmulOp, MatvecOp, VecmatOp, ReduceOp>(
+          [&](auto op) { return visitOperation(op); })
       // affine ops
       .Case<affine::AffineForOp>([&](auto op) { return visitOperation(op); })
       // tensor ops
@@ -496,6 +542,30 @@ LogicalResult LayoutPropagation::visitOperation(VecmatOp op) {
   return success();
 }
 
+LogicalResult LayoutPropagation::visitOperation(MatmulOp op) {
+  // The operands were converted to square row-major layouts by
+  // rectifyIncompatibleOperandLayouts, and the result has the same layout.
+  Value result = op->getResult(0);
+  LayoutAttr resultLayout =
+      squareLayoutForType(result.getType(), squareMatmulSize(op));
+  assignedLayouts.insert({result, resultLayout});
+  setResultLayoutAttr(op);
+  debugAssignLayout(result, resultLayout);
+  return success();
+}
+
+LogicalResult LayoutPropagation::visitOperation(MatvecOp op) {
+  // The operands were converted to the layouts of the chosen kernel by
+  // rectifyIncompatibleOperandLayouts, and the result has the layout of the
+  // output operand.
+  Value result = op->getResult(0);
+  LayoutAttr resultLayout = assignedLayouts.at(op.getOutputs()[0]);
+  assignedLayouts.insert({result, resultLayout});
+  setResultLayoutAttr(op);
+  debugAssignLayout(result, resultLayout);
+  return success();
+}
+
 LogicalResult LayoutPropagation::visitOperation(ReduceOp op) {
   for (const auto &[tensor, result] :
        llvm::zip(op.getInputs(), op.getResults())) {
@@ -570,7 +640,7 @@ CompatibilityResult LayoutPropagation::hasCompatibleArgumentLayouts(
             affine::AffineYieldOp>(
           [&](auto op) { return CompatibilityResult{true, std::nullopt}; })
       // Ops with special rules
-      .Case<ReduceOp, VecmatOp>(
+      .Case<MatmulOp, MatvecOp, ReduceOp, VecmatOp>(
           [&](auto op) { return hasCompatibleArgumentLayouts(op); })
       // By default, assume operands must all have the same layout.
       .Default([&](Operation *op) {
@@ -597,6 +667,62 @@ CompatibilityResult LayoutPropagation::hasCompatibleArgumentLayouts(
       });
 }
 
+CompatibilityResult LayoutPropagation::hasCompatibleArgumentLayouts(
+    MatmulOp op) {
+  // The matmul kernel multiplies square row-major matrices that each fit in
+  // a single ciphertext.
+  int64_t size = squareMatmulSize(op);
+  if (size * size > ciphertextSize) {
+    return {false, op->emitError()
+                       << "linalg.matmul operands padded to " << size << "x"
+                       << size << " do not fit in a ciphertext of size "
+                       << ciphertextSize};
+  }
+
+  for (Value operand : op->getOperands()) {
+    if (!assignedLayouts.contains(operand)) {
+      return {false, op->emitError("operand has no assigned layout")};
+    }
+    if (assignedLayouts.at(operand) !=
+        squareLayoutForType(operand.getType(), size)) {
+      return {false, std::nullopt};
+    }
+  }
+  return {true, std::nullopt};
+}
+
+CompatibilityResult LayoutPropagation::hasCompatibleArgumentLayouts(
+    MatvecOp op) {
+  // Currently only support secret vectors and plaintext matrices.
+  Value matrix = op.getInputs()[0];
+  if (isSecret(matrix, solver)) {
+    return {false,
+            op->emitError("Only secret vectors and plaintext matrices are "
+                          "supported for linalg.matvec")};
+  }
+
+  FailureOr<MatvecLayouts> layouts = matvecLayouts(op);
+  if (failed(layouts)) {
+    return {false, op->emitError()
+                       << "no matvec kernel supports a matrix of type "
+                       << matrix.getType() << " in a ciphertext of size "
+                       << ciphertextSize};
+  }
+
+  for (auto [value, layout] : llvm::zip(
+           op->getOperands(), SmallVector<LayoutAttr>{layouts->matrix,
+                                                      layouts->vector,
+                                                      layouts->output})) {
+    if (!assignedLayouts.contains(value)) {
+      return {false, op->emitError("operand has no assigned layout")};
+    }
+    if (assignedLayouts.at(value) != layout) {
+      return {false, std::nullopt};
+    }
+  }
+  return {true, std::nullopt};
+}
+
 CompatibilityResult LayoutPropagation::hasCompatibleArgumentLayouts(
     ReduceOp op) {
   // The arguments of a ReduceOp are the tensor(s) to reduce and the
@@ -657,7 +783,7 @@ void LayoutPropagation::rectifyIncompatibleOperandLayouts(Operation *op) {
 
   TypeSwitch<Operation *>(op)
       // Ops with special rules
-      .Case<ReduceOp>(
+      .Case<MatmulOp, MatvecOp, ReduceOp>(
           [&](auto op) { return rectifyIncompatibleOperandLayouts(op); })
       .Default([&](Operation *op) {
         // Default target layout is chosen arbitrarily as the first operand's
@@ -690,6 +816,65 @@ void LayoutPropagation::rectifyIncompatibleOperandLayouts(Operation *op) {
       });
 }
 
+void LayoutPropagation::rectifyIncompatibleOperandLayouts(MatmulOp op) {
+  mlir::IRRewriter builder(&getContext());
+  builder.setInsertionPoint(op);
+  int64_t size = squareMatmulSize(op);
+
+  for (OpOperand &opOperand : op->getOpOperands()) {
+    LayoutAttr sourceLayout = assignedLayouts.at(opOperand.get());
+    LayoutAttr targetLayout =
+        squareLayoutForType(opOperand.get().getType(), size);
+    if (sourceLayout == targetLayout) continue;
+
+    ConvertLayoutOp convertOp = builder.create<ConvertLayoutOp>(
+        op->getLoc(), opOperand.get(), sourceLayout, targetLayout);
+    assignedLayouts.insert({convertOp.getResult(), targetLayout});
+    setResultLayoutAttr(convertOp);
+    op->setOperand(opOperand.getOperandNumber(), convertOp.getResult());
+  }
+}
+
+void LayoutPropagation::rectifyIncompatibleOperandLayouts(MatvecOp op) {
+  mlir::IRRewriter builder(&getContext());
+  builder.setInsertionPoint(op);
+  MatvecLayouts layouts = matvecLayouts(op).value();
+
+  for (auto [opOperand, targetLayout] : llvm::zip(
+           op->getOpOperands(),
+           SmallVector<LayoutAttr>{layouts.matrix, layouts.vector,
+                                   layouts.output})) {
+    Value operand = opOperand.get();
+    LayoutAttr sourceLayout = assignedLayouts.at(operand);
+    if (sourceLayout == targetLayout) continue;
+
+    // A plaintext operand is packed in the target layout directly, rather
+    // than packed in the default layout and then converted.
+    if (auto assignLayoutOp = operand.getDefiningOp<AssignLayoutOp>()) {
+      AssignLayoutOp newAssignLayoutOp = builder.create<AssignLayoutOp>(
+          op->getLoc(), assignLayoutOp.getValue(), targetLayout);
+      setAttributeAssociatedWith(newAssignLayoutOp.getResult(),
+                                 tensor_ext::TensorExtDialect::kLayoutAttrName,
+                                 targetLayout);
+      assignedLayouts.insert({newAssignLayoutOp.getResult(), targetLayout});
+      op->setOperand(opOperand.getOperandNumber(),
+                     newAssignLayoutOp.getResult());
+      debugAssignLayout(newAssignLayoutOp.getResult(), targetLayout);
+      if (assignLayoutOp->use_empty()) {
+        assignedLayouts.erase(assignLayoutOp.getResult());
+        assignLayoutOp->erase();
+      }
+      continue;
+    }
+
+    ConvertLayoutOp convertOp = builder.create<ConvertLayoutOp>(
+        op->getLoc(), operand, sourceLayout, targetLayout);
+    assignedLayouts.insert({convertOp.getResult(), targetLayout});
+    setResultLayoutAttr(convertOp);
+    op->setOperand(opOperand.getOperandNumber(), convertOp.getResult());
+  }
+}
+
 void LayoutPropagation::rectifyIncompatibleOperandLayouts(ReduceOp op) {
   mlir::IRRewriter builder(&getContext());
   builder.setInsertionPoint(op);
@@ -802,6 +987,36 @@ FailureOr<LayoutAttr> LayoutPropagation::defaultLayoutForType(Type type) {
     return LayoutAttr::get(map);
   }
 
+  return LayoutAttr::get(map, zeroPaddedAlignment(tensorType, padding,
+                                                  alignmentOutType.getShape()));
+}
+
+LayoutAttr LayoutPropagation::squareLayoutForType(Type type, int64_t size) {
+  Type ty = type;
+  if (SecretType secretType = dyn_cast<SecretType>(type)) {
+    ty = secretType.getValueType();
+  }
+  RankedTensorType tensorType = cast<RankedTensorType>(ty);
+  Type elementType = tensorType.getElementType();
+
+  SmallVector<int64_t> padding;
+  for (int64_t dim : tensorType.getShape()) {
+    padding.push_back(size - dim);
+  }
+  RankedTensorType alignmentOutType =
+      RankedTensorType::get({size, size}, elementType);
+  AffineMap map = getRowMajorLayoutMap(
+      alignmentOutType, RankedTensorType::get({ciphertextSize}, elementType));
+
+  // Match the construction in defaultLayoutForType, so that a square
+  // power-of-two matrix keeps its default layout.
+  return LayoutAttr::get(map, zeroPaddedAlignment(tensorType, padding,
+                                                  alignmentOutType.getShape()));
+}
+
+AlignmentAttr LayoutPropagation::zeroPaddedAlignment(
+    RankedTensorType tensorType, ArrayRef<int64_t> padding,
+    ArrayRef<int64_t> alignedShape) {
   mlir::IRRewriter builder(&getContext());
   bool emptyPadding = llvm::all_of(padding, [](int64_t p) { return p == 0; });
   TypedAttr paddingValueAttr =
@@ -809,11 +1024,80 @@ FailureOr<LayoutAttr> LayoutPropagation::defaultLayoutForType(Type type) {
   DenseI64ArrayAttr paddingAttr = emptyPadding
                                       ? builder.getDenseI64ArrayAttr({})
                                       : builder.getDenseI64ArrayAttr(padding);
-  AlignmentAttr alignment = AlignmentAttr::get(
+  return AlignmentAttr::get(
       &getContext(), builder.getDenseI64ArrayAttr(tensorType.getShape()),
-      builder.getDenseI64ArrayAttr(alignmentOutType.getShape()),
+      builder.getDenseI64ArrayAttr(alignedShape),
       builder.getDenseI64ArrayAttr({}), paddingAttr, paddingValueAttr);
-  return LayoutAttr::get(map, alignment);
+}
+
+FailureOr<MatvecLayouts> LayoutPropagation::matvecLayouts(MatvecOp op) {
+  auto matrixType = cast<RankedTensorType>(op.getInputs()[0].getType());
+  int64_t numRows = matrixType.getDimSize(0);
+  int64_t numCols = matrixType.getDimSize(1);
+  FailureOr<LayoutAttr> vectorLayout =
+      defaultLayoutForType(op.getInputs()[1].getType());
+  FailureOr<LayoutAttr> outputLayout =
+      defaultLayoutForType(op.getOutputs()[0].getType());
+  if (failed(vectorLayout) || failed(outputLayout)) return failure();
+
+  if (isPowerOfTwo(numRows) && isPowerOfTwo(numCols) &&
+      numCols >= ciphertextSize) {
+    AffineMap map = getTiledDiagonalLayoutMap(matrixType, ciphertextSize);
+    return MatvecLayouts{LayoutAttr::get(map), vectorLayout.value(),
+                         outputLayout.value()};
+  }
+
+  if (isPowerOfTwo(numRows) && numRows == numCols) {
+    int64_t numCopies = std::min(numRows, ciphertextSize / (2 * numRows));
+    if (numCopies >= 2) {
+      mlir::IRRewriter builder(&getContext());
+      AlignmentAttr alignment = AlignmentAttr::get(
+          &getContext(), builder.getDenseI64ArrayAttr({numRows}),
+          builder.getDenseI64ArrayAttr({numCopies, 2 * numRows}),
+          builder.getDenseI64ArrayAttr({0}), builder.getDenseI64ArrayAttr({}),
+          /*paddingValue=*/nullptr);
+      AffineMap vectorMap =
+          getRotatedReplicasLayoutMap(numRows, numCopies, &getContext());
+      AffineMap matrixMap =
+          getReplicatedDiagonalLayoutMap(matrixType, numCopies);
+      return MatvecLayouts{LayoutAttr::get(matrixMap),
+                           LayoutAttr::get(vectorMap, alignment),
+                           outputLayout.value()};
+    }
+  }
+
+  int64_t paddedRows = nextPowerOfTwo(numRows);
+  int64_t paddedCols = nextPowerOfTwo(numCols);
+  if (paddedRows > ciphertextSize || paddedCols > ciphertextSize) {
+    return failure();
+  }
+  RankedTensorType alignedType = RankedTensorType::get(
+      {paddedRows, paddedCols}, matrixType.getElementType());
+  AffineMap map = getExtendedDiagonalLayoutMap(alignedType);
+  LayoutAttr matrixLayout = LayoutAttr::get(map);
+  if (alignedType != matrixType) {
+    matrixLayout = LayoutAttr::get(
+        map, zeroPaddedAlignment(
+                 matrixType,
+                 {paddedRows - numRows, paddedCols - numCols},
+                 alignedType.getShape()));
+  }
+  return MatvecLayouts{matrixLayout, vectorLayout.value(),
+                       outputLayout.value()};
+}
+
+int64_t LayoutPropagation::squareMatmulSize(MatmulOp op) {
+  int64_t maxDim = 1;
+  for (Value operand : op->getOperands()) {
+    Type ty = operand.getType();
+    if (SecretType secretType = dyn_cast<SecretType>(ty)) {
+      ty = secretType.getValueType();
+    }
+    for (int64_t dim : cast<RankedTensorType>(ty).getShape()) {
+      maxDim = std::max(maxDim, dim);
+    }
+  }
+  return nextPowerOfTwo(maxDim);
 }
 
 void LayoutPropagation::setResultLayoutAttr(Operation *op) {
@@ -832,16 +1116,13 @@ void LayoutPropagation::setResultLayoutAttr(Operation *op) {
 }
 
 void LayoutPropagation::runOnOperation() {
-  DataFlowSolver solver;
-  solver.load<dataflow::DeadCodeAnalysis>();
-  solver.load<dataflow::SparseConstantPropagation>();
-  solver.load<SecretnessAnalysis>();
-  if (failed(solver.initializeAndRun(getOperation()))) {
+  auto &secretness = getAnalysis<SecretnessAnalysisCache>();
+  if (failed(secretness.getStatus())) {
     getOperation()->emitOpError() << "Failed to run secretness analysis.\n";
     signalPassFailure();
     return;
   }
-  this->solver = &solver;
+  this->solver = secretness.getSolver();
 
   LLVM_DEBUG(llvm::dbgs() << "Running layout propagation on operation: "
                           << getOperation()->getName() << "\n");
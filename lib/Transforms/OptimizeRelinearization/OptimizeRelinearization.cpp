@@ -69,10 +69,18 @@ struct OptimizeRelinearization
   void runOnOperation() override {
     Operation *module = getOperation();
 
+    auto &secretness = getAnalysis<SecretnessAnalysisCache>();
+    if (failed(secretness.getStatus())) {
+      getOperation()->emitOpError() << "Failed to run the analysis.\n";
+      signalPassFailure();
+      return;
+    }
+
     DataFlowSolver solver;
     solver.load<dataflow::DeadCodeAnalysis>();
     solver.load<dataflow::SparseConstantPropagation>();
-    solver.load<SecretnessAnalysis>();
+    // DimensionAnalysis depends on the cached secretness
+    secretness.seedSolver(solver);
     solver.load<DimensionAnalysis>();
 
     if (failed(solver.initializeAndRun(getOperation()))) {
@@ -84,6 +92,15 @@ struct OptimizeRelinearization
     module->walk(
         [&](secret::GenericOp op) { processSecretGenericOp(op, &solver); });
 
+    // Relinearizations were erased and inserted, so the cached secretness is
+    // brought up to date for the AnnotateMgmt run below and later passes.
+    if (failed(secretness.recompute())) {
+      getOperation()->emitOpError() << "Failed to run the analysis.\n";
+      signalPassFailure();
+      return;
+    }
+    markAnalysesPreserved<SecretnessAnalysisCache>();
+
     // optimize-relinearization will invalidate mgmt attr
     // so re-annotate it
 
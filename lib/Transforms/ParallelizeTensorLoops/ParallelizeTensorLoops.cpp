@@ -0,0 +1,286 @@
+#include "lib/Transforms/ParallelizeTensorLoops/ParallelizeTensorLoops.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <optional>
+#include <utility>
+
+#include "llvm/include/llvm/ADT/STLExtras.h"    // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Linalg/IR/Linalg.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/SCF/IR/SCF.h"        // from @llvm-project
+#include "mlir/include/mlir/Dialect/SCF/Transforms/TileUsingInterface.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/AffineExpr.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/AffineMap.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinTypes.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/IRMapping.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/OpDefinition.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/PatternMatch.h"           // from @llvm-project
+#include "mlir/include/mlir/IR/SymbolTable.h"            // from @llvm-project
+#include "mlir/include/mlir/IR/Visitors.h"               // from @llvm-project
+#include "mlir/include/mlir/Interfaces/SideEffectInterfaces.h"  // from @llvm-project
+#include "mlir/include/mlir/Interfaces/TilingInterface.h"  // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+
+#define GEN_PASS_DEF_PARALLELIZETENSORLOOPS
+#include "lib/Transforms/ParallelizeTensorLoops/ParallelizeTensorLoops.h.inc"
+
+// The largest divisor of tripCount that is at most tileSize.
+static int64_t getTileSize(int64_t tripCount, int64_t tileSize) {
+  int64_t result = std::max<int64_t>(1, std::min(tileSize, tripCount));
+  while (tripCount % result != 0) --result;
+  return result;
+}
+
+// Returns true if op has no memory effects, treating a call as effect free if
+// its callee's body is, as for the helper functions generated when lowering
+// polynomial multiplication.
+static bool isEffectFreeOrPureCall(Operation *op) {
+  if (isMemoryEffectFree(op)) return true;
+  auto callOp = dyn_cast<func::CallOp>(op);
+  if (!callOp) return false;
+  auto callee = SymbolTable::lookupNearestSymbolFrom<func::FuncOp>(
+      callOp, callOp.getCalleeAttr());
+  if (!callee || callee.isExternal()) return false;
+  return llvm::all_of(callee.getBody().getOps(), [](Operation &calleeOp) {
+    return isMemoryEffectFree(&calleeOp);
+  });
+}
+
+// The final write of an independent loop: the insertion of the iteration's
+// result into the iter_arg at the induction variable, in dimension `dim`.
+struct IndependentWrite {
+  Operation *insertOp;
+  unsigned dim;
+};
+
+// Returns the write performed by each iteration of `forOp` if its iterations
+// are independent, i.e., the only use of its iter_arg is a tensor.insert or
+// tensor.insert_slice of extent 1 at the induction variable whose result is
+// yielded, and the rest of the body has no memory effects.
+static std::optional<IndependentWrite> getIndependentWrite(
+    affine::AffineForOp forOp) {
+  if (!forOp.hasConstantBounds() || forOp.getConstantLowerBound() != 0 ||
+      forOp.getStepAsInt() != 1 || forOp.getNumRegionIterArgs() != 1)
+    return std::nullopt;
+
+  Value iterArg = forOp.getRegionIterArgs()[0];
+  Value iv = forOp.getInductionVar();
+  if (!isa<RankedTensorType>(iterArg.getType()) || !iterArg.hasOneUse())
+    return std::nullopt;
+
+  Operation *insertOp = *iterArg.getUsers().begin();
+  Operation *yieldOp = forOp.getBody()->getTerminator();
+  if (!insertOp->hasOneUse() || *insertOp->getUsers().begin() != yieldOp)
+    return std::nullopt;
+
+  std::optional<unsigned> dim;
+  if (auto insert = dyn_cast<tensor::InsertOp>(insertOp)) {
+    if (insert.getDest() != iterArg) return std::nullopt;
+    for (auto [i, index] : llvm::enumerate(insert.getIndices())) {
+      if (index == iv) dim = i;
+    }
+  } else if (auto insertSlice = dyn_cast<tensor::InsertSliceOp>(insertOp)) {
+    if (insertSlice.getDest() != iterArg) return std::nullopt;
+    for (auto [i, offset] : llvm::enumerate(insertSlice.getMixedOffsets())) {
+      if (dyn_cast<Value>(offset) == iv &&
+          insertSlice.getStaticSizes()[i] == 1)
+        dim = i;
+    }
+  }
+  if (!dim.has_value()) return std::nullopt;
+
+  for (Operation &op : forOp.getBody()->without_terminator()) {
+    if (!isEffectFreeOrPureCall(&op)) return std::nullopt;
+  }
+  return IndependentWrite{insertOp, dim.value()};
+}
+
+static SmallVector<OpFoldResult> getTileOffsets(OpBuilder &b, unsigned rank,
+                                                unsigned dim, Value offset) {
+  SmallVector<OpFoldResult> offsets(rank, b.getIndexAttr(0));
+  offsets[dim] = offset;
+  return offsets;
+}
+
+static SmallVector<OpFoldResult> getTileSizes(OpBuilder &b,
+                                              RankedTensorType type,
+                                              unsigned dim, int64_t tileSize) {
+  SmallVector<OpFoldResult> sizes;
+  for (int64_t size : type.getShape()) sizes.push_back(b.getIndexAttr(size));
+  sizes[dim] = b.getIndexAttr(tileSize);
+  return sizes;
+}
+
+// Rewrite an independent loop into a scf.forall over tiles of tileSize
+// iterations, each running a sequential affine.for over its tile.
+static void parallelizeLoop(IRRewriter &rewriter, affine::AffineForOp forOp,
+                            const IndependentWrite &write, int64_t tileSize) {
+  int64_t tripCount = forOp.getConstantUpperBound();
+  Location loc = forOp.getLoc();
+  auto tensorType = cast<RankedTensorType>(forOp.getResult(0).getType());
+  unsigned rank = tensorType.getRank();
+  SmallVector<int64_t> tileShape(tensorType.getShape());
+  tileShape[write.dim] = tileSize;
+  auto tileType = tensorType.clone(tileShape);
+  SmallVector<OpFoldResult> strides(rank, rewriter.getIndexAttr(1));
+
+  rewriter.setInsertionPoint(forOp);
+  auto forallOp = rewriter.create<scf::ForallOp>(
+      loc, ArrayRef<OpFoldResult>{rewriter.getIndexAttr(tripCount / tileSize)},
+      ValueRange{forOp.getInits()[0]}, /*mapping=*/std::nullopt);
+
+  rewriter.setInsertionPointToStart(forallOp.getBody());
+  AffineExpr d0, d1;
+  bindDims(rewriter.getContext(), d0, d1);
+  Value tileIndex = forallOp.getInductionVars()[0];
+  Value sharedOut = forallOp.getRegionIterArgs()[0];
+  Value tileOffset = rewriter.create<affine::AffineApplyOp>(
+      loc, AffineMap::get(1, 0, d0 * tileSize), ValueRange{tileIndex});
+  SmallVector<OpFoldResult> offsets =
+      getTileOffsets(rewriter, rank, write.dim, tileOffset);
+  SmallVector<OpFoldResult> sizes =
+      getTileSizes(rewriter, tensorType, write.dim, tileSize);
+  Value tile = rewriter.create<tensor::ExtractSliceOp>(
+      loc, tileType, sharedOut, offsets, sizes, strides);
+
+  auto tileLoop = rewriter.create<affine::AffineForOp>(
+      loc, /*lowerBound=*/0, /*upperBound=*/tileSize, /*step=*/1,
+      /*iterArgs=*/tile,
+      /*bodyBuilder=*/
+      [&](OpBuilder &b, Location nestedLoc, Value localIndex,
+          ValueRange args) {
+        Value globalIndex = b.create<affine::AffineApplyOp>(
+            nestedLoc, AffineMap::get(2, 0, d0 + d1 * tileSize),
+            ValueRange{localIndex, tileIndex});
+        IRMapping mapping;
+        mapping.map(forOp.getInductionVar(), globalIndex);
+        mapping.map(forOp.getRegionIterArgs()[0], args[0]);
+
+        Value result;
+        for (Operation &op : forOp.getBody()->without_terminator()) {
+          if (&op != write.insertOp) {
+            b.clone(op, mapping);
+            continue;
+          }
+          // Re-target the final write at the tile, indexed by the position
+          // within the tile.
+          if (auto insert = dyn_cast<tensor::InsertOp>(op)) {
+            SmallVector<Value> indices;
+            for (Value index : insert.getIndices())
+              indices.push_back(mapping.lookupOrDefault(index));
+            indices[write.dim] = localIndex;
+            result = b.create<tensor::InsertOp>(
+                nestedLoc, mapping.lookupOrDefault(insert.getScalar()), args[0],
+                indices);
+          } else {
+            auto insertSlice = cast<tensor::InsertSliceOp>(op);
+            auto remap = [&](ArrayRef<OpFoldResult> values) {
+              SmallVector<OpFoldResult> remapped;
+              for (OpFoldResult value : values) {
+                if (auto v = dyn_cast<Value>(value))
+                  remapped.push_back(mapping.lookupOrDefault(v));
+                else
+                  remapped.push_back(value);
+              }
+              return remapped;
+            };
+            SmallVector<OpFoldResult> sliceOffsets =
+                remap(insertSlice.getMixedOffsets());
+            sliceOffsets[write.dim] = localIndex;
+            result = b.create<tensor::InsertSliceOp>(
+                nestedLoc, mapping.lookupOrDefault(insertSlice.getSource()),
+                args[0], sliceOffsets, remap(insertSlice.getMixedSizes()),
+                remap(insertSlice.getMixedStrides()));
+          }
+          mapping.map(op.getResult(0), result);
+        }
+        b.create<affine::AffineYieldOp>(nestedLoc, result);
+      });
+
+  rewriter.setInsertionPointToStart(forallOp.getTerminator().getBody());
+  rewriter.create<tensor::ParallelInsertSliceOp>(
+      loc, tileLoop.getResult(0), sharedOut, offsets, sizes, strides);
+
+  rewriter.replaceOp(forOp, forallOp.getResults());
+}
+
+// Returns true if the iterations of all loops of linalgOp are independent.
+static bool isParallelLinalgOp(linalg::LinalgOp linalgOp) {
+  if (!linalgOp.hasPureTensorSemantics() || linalgOp.getNumLoops() == 0 ||
+      linalgOp.getNumParallelLoops() != linalgOp.getNumLoops())
+    return false;
+  // An output indexed by e.g. (d0 + d1) is written by several iterations.
+  return llvm::all_of(linalgOp.getDpsInitsMutable(), [&](OpOperand &init) {
+    return linalgOp.getMatchingIndexingMap(&init).isProjectedPermutation();
+  });
+}
+
+static LogicalResult parallelizeLinalgOp(IRRewriter &rewriter,
+                                         linalg::LinalgOp linalgOp,
+                                         int64_t tileSize) {
+  SmallVector<int64_t> ranges = linalgOp.getStaticLoopRanges();
+  if (ShapedType::isDynamic(ranges[0])) return failure();
+  tileSize = getTileSize(ranges[0], tileSize);
+  if (tileSize == ranges[0]) return failure();
+
+  SmallVector<OpFoldResult> tileSizes(ranges.size(), rewriter.getIndexAttr(0));
+  tileSizes[0] = rewriter.getIndexAttr(tileSize);
+  scf::SCFTilingOptions options;
+  options.setLoopType(scf::SCFTilingOptions::LoopType::ForallOp);
+  options.setTileSizes(tileSizes);
+
+  auto tilingOp = dyn_cast<TilingInterface>(linalgOp.getOperation());
+  if (!tilingOp) return failure();
+  rewriter.setInsertionPoint(linalgOp);
+  auto tilingResult = scf::tileUsingSCF(rewriter, tilingOp, options);
+  if (failed(tilingResult)) return failure();
+  rewriter.replaceOp(linalgOp, tilingResult->replacements);
+  return success();
+}
+
+struct ParallelizeTensorLoops
+    : impl::ParallelizeTensorLoopsBase<ParallelizeTensorLoops> {
+  using ParallelizeTensorLoopsBase::ParallelizeTensorLoopsBase;
+
+  void runOnOperation() override {
+    IRRewriter rewriter(&getContext());
+
+    // Only the outermost independent loops are parallelized, so that each
+    // parallel task runs a whole sub-nest.
+    SmallVector<std::pair<affine::AffineForOp, IndependentWrite>> loops;
+    getOperation()->walk<WalkOrder::PreOrder>([&](affine::AffineForOp forOp) {
+      auto write = getIndependentWrite(forOp);
+      if (!write.has_value()) return WalkResult::advance();
+      loops.push_back({forOp, write.value()});
+      return WalkResult::skip();
+    });
+    for (auto &[forOp, write] : loops) {
+      int64_t tripCount = forOp.getConstantUpperBound();
+      int64_t tileSize = getTileSize(tripCount, loopTileSize);
+      if (tileSize == tripCount) continue;
+      parallelizeLoop(rewriter, forOp, write, tileSize);
+    }
+
+    // Linalg ops nested in a parallelized loop already run in parallel.
+    SmallVector<linalg::LinalgOp> linalgOps;
+    getOperation()->walk([&](linalg::LinalgOp linalgOp) {
+      if (isParallelLinalgOp(linalgOp) &&
+          !linalgOp->getParentOfType<scf::ForallOp>())
+        linalgOps.push_back(linalgOp);
+    });
+    for (linalg::LinalgOp linalgOp : linalgOps) {
+      // Ops that cannot be tiled are left sequential.
+      (void)parallelizeLinalgOp(rewriter, linalgOp, linalgTileSize);
+    }
+  }
+};
+
+}  // namespace heir
+}  // namespace mlir
@@ -0,0 +1,18 @@
+#ifndef LIB_TRANSFORMS_PARALLELIZETENSORLOOPS_PARALLELIZETENSORLOOPS_H_
+#define LIB_TRANSFORMS_PARALLELIZETENSORLOOPS_PARALLELIZETENSORLOOPS_H_
+
+#include "mlir/include/mlir/Pass/Pass.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+
+#define GEN_PASS_DECL
+#include "lib/Transforms/ParallelizeTensorLoops/ParallelizeTensorLoops.h.inc"
+
+#define GEN_PASS_REGISTRATION
+#include "lib/Transforms/ParallelizeTensorLoops/ParallelizeTensorLoops.h.inc"
+
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_TRANSFORMS_PARALLELIZETENSORLOOPS_PARALLELIZETENSORLOOPS_H_
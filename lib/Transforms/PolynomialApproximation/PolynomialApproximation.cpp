@@ -1,17 +1,28 @@
 #include "lib/Transforms/PolynomialApproximation/PolynomialApproximation.h"
 
+#include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <cstdint>
 #include <functional>
+#include <limits>
+#include <optional>
+#include <tuple>
 #include <utility>
 
+#include "lib/Analysis/RangeAnalysis/RangeAnalysis.h"
 #include "lib/Dialect/Polynomial/IR/PolynomialAttributes.h"
 #include "lib/Dialect/Polynomial/IR/PolynomialOps.h"
 #include "lib/Dialect/Polynomial/IR/PolynomialTypes.h"
 #include "lib/Utils/Approximation/CaratheodoryFejer.h"
+#include "lib/Utils/Approximation/CompositeApproximation.h"
 #include "lib/Utils/Polynomial/Polynomial.h"
 #include "llvm/include/llvm/ADT/APFloat.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"           // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"           // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
+#include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Math/IR/Math.h"    // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinAttributeInterfaces.h"  // from @llvm-project
@@ -20,6 +31,7 @@
 #include "mlir/include/mlir/IR/MLIRContext.h"        // from @llvm-project
 #include "mlir/include/mlir/IR/PatternMatch.h"       // from @llvm-project
 #include "mlir/include/mlir/IR/Value.h"              // from @llvm-project
+#include "mlir/include/mlir/IR/ValueRange.h"         // from @llvm-project
 #include "mlir/include/mlir/Support/LLVM.h"          // from @llvm-project
 #include "mlir/include/mlir/Transforms/GreedyPatternRewriteDriver.h"  // from @llvm-project
 
@@ -178,31 +190,153 @@ inline APFloat minnumf(const APFloat &lhs, const APFloat &rhs) {
   return llvm::minimumnum(lhsConverted, rhsConverted);
 }
 
+// Settings shared by the rewrite patterns for choosing the approximation
+// domain and degree of ops that do not specify them.
+struct ApproximationOptions {
+  // Non-null when domains should be inferred by RangeAnalysis.
+  DataFlowSolver *solver = nullptr;
+  // When positive, the degree is chosen to meet this maximum absolute error.
+  double maxError = 0.0;
+  int64_t maxDegree = 32;
+  // Set when sign-like ops should be approximated by composite polynomials.
+  std::optional<approximation::CompositeSignApproximation> compositeSign;
+};
+
+double evaluate(const FloatPolynomial &poly, double x) {
+  double result = 0.0;
+  for (const auto &term : poly.getTerms()) {
+    result += term.getCoefficient().convertToDouble() *
+              std::pow(x, term.getExponent().getZExtValue());
+  }
+  return result;
+}
+
+// The maximum absolute error of `poly` against `func`, sampled on a uniform
+// grid over [lower, upper].
+double maxApproximationError(const std::function<APFloat(APFloat)> &func,
+                             const FloatPolynomial &poly, double lower,
+                             double upper) {
+  constexpr int kNumSamples = 512;
+  double maxError = 0.0;
+  for (int i = 0; i <= kNumSamples; ++i) {
+    double x = lower + (upper - lower) * i / kNumSamples;
+    double error =
+        std::abs(func(APFloat(x)).convertToDouble() - evaluate(poly, x));
+    if (!std::isfinite(error)) return std::numeric_limits<double>::infinity();
+    maxError = std::max(maxError, error);
+  }
+  return maxError;
+}
+
+// Returns the range of `input` inferred by the analysis, if it is a usable
+// approximation domain for `func`.
+std::optional<std::pair<double, double>> getInferredDomain(
+    Value input, const std::function<APFloat(APFloat)> &func,
+    DataFlowSolver *solver) {
+  if (!solver) return std::nullopt;
+  std::optional<RangeState> range = getBoundedRange(input, solver);
+  if (!range.has_value()) return std::nullopt;
+
+  double lower = range->getLower();
+  double upper = range->getUpper();
+  // A constant input still needs a non-degenerate interval to interpolate on.
+  if (upper - lower < 1e-9) {
+    double pad = 1e-3 * std::max(1.0, std::abs(lower));
+    lower -= pad;
+    upper += pad;
+  }
+
+  // Ranges leaving the domain of the function (e.g., log of a value that may
+  // be negative) cannot be approximated.
+  for (double x : {lower, (lower + upper) / 2, upper}) {
+    if (!std::isfinite(func(APFloat(x)).convertToDouble())) {
+      return std::nullopt;
+    }
+  }
+  return std::make_pair(lower, upper);
+}
+
+// Chooses the domain over which to approximate `func` for the op `op` applied
+// to `input`, using the op's domain attributes where present and `options`
+// otherwise.
+void selectDomain(Operation *op, Value input,
+                  const std::function<APFloat(APFloat)> &func,
+                  const ApproximationOptions &options, double &domainLower,
+                  double &domainUpper) {
+  domainLower = kDefaultDomainLower;
+  domainUpper = kDefaultDomainUpper;
+  if (!op->hasAttr("domain_lower") && !op->hasAttr("domain_upper")) {
+    if (auto domain = getInferredDomain(input, func, options.solver)) {
+      std::tie(domainLower, domainUpper) = domain.value();
+      LLVM_DEBUG(llvm::dbgs() << "Inferred domain [" << domainLower << ", "
+                              << domainUpper << "] for " << *op << "\n");
+    }
+  }
+  if (auto attr = op->getAttrOfType<FloatAttr>("domain_lower")) {
+    domainLower = attr.getValue().convertToDouble();
+  }
+  if (auto attr = op->getAttrOfType<FloatAttr>("domain_upper")) {
+    domainUpper = attr.getValue().convertToDouble();
+  }
+}
+
+// Approximates `func` for the op `op` applied to `input`, using the op's
+// degree and domain attributes where present and `options` otherwise. The
+// chosen domain is written to `domainLower` and `domainUpper`.
+FloatPolynomial approximate(Operation *op, Value input,
+                            const std::function<APFloat(APFloat)> &func,
+                            const ApproximationOptions &options,
+                            double &domainLower, double &domainUpper) {
+  selectDomain(op, input, func, options, domainLower, domainUpper);
+
+  if (auto degreeAttr = op->getAttrOfType<IntegerAttr>("degree")) {
+    return approximation::caratheodoryFejerApproximation(
+        func, degreeAttr.getInt(), domainLower, domainUpper);
+  }
+  if (options.maxError <= 0.0) {
+    return approximation::caratheodoryFejerApproximation(
+        func, kDefaultDegree, domainLower, domainUpper);
+  }
+
+  for (int64_t degree = 1; degree < options.maxDegree; ++degree) {
+    FloatPolynomial poly = approximation::caratheodoryFejerApproximation(
+        func, degree, domainLower, domainUpper);
+    if (maxApproximationError(func, poly, domainLower, domainUpper) <=
+        options.maxError) {
+      LLVM_DEBUG(llvm::dbgs() << "Selected degree " << degree << " for "
+                              << *op << "\n");
+      return poly;
+    }
+  }
+  FloatPolynomial poly = approximation::caratheodoryFejerApproximation(
+      func, options.maxDegree, domainLower, domainUpper);
+  double error = maxApproximationError(func, poly, domainLower, domainUpper);
+  if (error > options.maxError) {
+    op->emitWarning() << "no polynomial of degree at most "
+                      << options.maxDegree << " approximates this op within "
+                      << options.maxError << " (achieved " << error << ")";
+  }
+  return poly;
+}
+
 template <typename OpTy>
 struct ConvertUnaryOp : public OpRewritePattern<OpTy> {
   ConvertUnaryOp(mlir::MLIRContext *context,
-                 const std::function<APFloat(APFloat)> &cppFunc)
-      : OpRewritePattern<OpTy>(context, /*benefit=*/1), cppFunc(cppFunc) {}
+                 const std::function<APFloat(APFloat)> &cppFunc,
+                 const ApproximationOptions &options)
+      : OpRewritePattern<OpTy>(context, /*benefit=*/1),
+        cppFunc(cppFunc),
+        options(options) {}
 
  public:
   LogicalResult matchAndRewrite(OpTy op,
                                 PatternRewriter &rewriter) const override {
     MLIRContext *ctx = op.getContext();
-    IntegerAttr degreeAttr = op->hasAttr("degree")
-                                 ? cast<IntegerAttr>(op->getAttr("degree"))
-                                 : rewriter.getI32IntegerAttr(kDefaultDegree);
-    FloatAttr domainLowerAttr =
-        op->hasAttr("domain_lower")
-            ? cast<FloatAttr>(op->getAttr("domain_lower"))
-            : rewriter.getF64FloatAttr(kDefaultDomainLower);
-    FloatAttr domainUpperAttr =
-        op->hasAttr("domain_upper")
-            ? cast<FloatAttr>(op->getAttr("domain_upper"))
-            : rewriter.getF64FloatAttr(kDefaultDomainUpper);
-    FloatPolynomial poly = approximation::caratheodoryFejerApproximation(
-        cppFunc, degreeAttr.getInt(),
-        domainLowerAttr.getValue().convertToDouble(),
-        domainUpperAttr.getValue().convertToDouble());
+    double domainLower, domainUpper;
+    FloatPolynomial poly = approximate(op, op.getOperand(), cppFunc, options,
+                                       domainLower, domainUpper);
+    FloatAttr domainLowerAttr = rewriter.getF64FloatAttr(domainLower);
+    FloatAttr domainUpperAttr = rewriter.getF64FloatAttr(domainUpper);
     PolynomialType polyType =
         PolynomialType::get(ctx, RingAttr::get(Float64Type::get(ctx)));
     TypedFloatPolynomialAttr polyAttr =
@@ -216,6 +350,7 @@ struct ConvertUnaryOp : public OpRewritePattern<OpTy> {
 
  private:
   std::function<APFloat(APFloat)> cppFunc;
+  ApproximationOptions options;
 };
 
 // Return a single value defining a constant (either a splatted tensor or a
@@ -250,8 +385,11 @@ FailureOr<APFloat> getSingleValueOrSplat(Value value) {
 template <typename OpTy>
 struct ConvertBinaryConstOp : public OpRewritePattern<OpTy> {
   ConvertBinaryConstOp(mlir::MLIRContext *context,
-                       const std::function<APFloat(APFloat, APFloat)> &cppFunc)
-      : OpRewritePattern<OpTy>(context, /*benefit=*/1), cppFunc(cppFunc) {}
+                       const std::function<APFloat(APFloat, APFloat)> &cppFunc,
+                       const ApproximationOptions &options)
+      : OpRewritePattern<OpTy>(context, /*benefit=*/1),
+        cppFunc(cppFunc),
+        options(options) {}
 
  public:
   LogicalResult matchAndRewrite(OpTy op,
@@ -291,21 +429,11 @@ struct ConvertBinaryConstOp : public OpRewritePattern<OpTy> {
     }
 
     MLIRContext *ctx = op.getContext();
-    IntegerAttr degreeAttr = op->hasAttr("degree")
-                                 ? cast<IntegerAttr>(op->getAttr("degree"))
-                                 : rewriter.getI32IntegerAttr(kDefaultDegree);
-    FloatAttr domainLowerAttr =
-        op->hasAttr("domain_lower")
-            ? cast<FloatAttr>(op->getAttr("domain_lower"))
-            : rewriter.getF64FloatAttr(kDefaultDomainLower);
-    FloatAttr domainUpperAttr =
-        op->hasAttr("domain_upper")
-            ? cast<FloatAttr>(op->getAttr("domain_upper"))
-            : rewriter.getF64FloatAttr(kDefaultDomainUpper);
-    FloatPolynomial poly = approximation::caratheodoryFejerApproximation(
-        unaryFunc, degreeAttr.getInt(),
-        domainLowerAttr.getValue().convertToDouble(),
-        domainUpperAttr.getValue().convertToDouble());
+    double domainLower, domainUpper;
+    FloatPolynomial poly = approximate(op, nonConstOperand, unaryFunc, options,
+                                       domainLower, domainUpper);
+    FloatAttr domainLowerAttr = rewriter.getF64FloatAttr(domainLower);
+    FloatAttr domainUpperAttr = rewriter.getF64FloatAttr(domainUpper);
     PolynomialType polyType =
         PolynomialType::get(ctx, RingAttr::get(Float64Type::get(ctx)));
     TypedFloatPolynomialAttr polyAttr =
@@ -322,6 +450,209 @@ struct ConvertBinaryConstOp : public OpRewritePattern<OpTy> {
 
  private:
   std::function<APFloat(APFloat, APFloat)> cppFunc;
+  ApproximationOptions options;
+};
+
+// Emits a chain of polynomial.eval ops evaluating the composite approximation
+// of sign((x - center) / scale) for x = `input`, where scale is the largest
+// distance from `center` to the approximation domain of `op`. If `negate` is
+// set, sign((center - x) / scale) is computed instead, and if `indicator` is
+// set the last stage is rescaled to compute (1 + sign) / 2.
+FailureOr<Value> buildCompositeSign(PatternRewriter &rewriter, Operation *op,
+                                    Value input, double center, bool negate,
+                                    bool indicator,
+                                    const ApproximationOptions &options) {
+  assert(options.compositeSign.has_value() &&
+         "composite sign approximation not configured");
+  auto signFunc = [](const APFloat &x) {
+    return APFloat(x.isNegative() ? -1.0 : 1.0);
+  };
+  double domainLower, domainUpper;
+  selectDomain(op, input, signFunc, options, domainLower, domainUpper);
+  double scale = std::max(std::abs(domainLower - center),
+                          std::abs(domainUpper - center));
+  if (scale <= 0.0) return failure();
+
+  MLIRContext *ctx = op->getContext();
+  PolynomialType polyType =
+      PolynomialType::get(ctx, RingAttr::get(Float64Type::get(ctx)));
+
+  // The normalization of the input to [-1, 1] is folded into the first stage.
+  double direction = negate ? -1.0 : 1.0;
+  FloatPolynomial normalize = FloatPolynomial::fromCoefficients(
+      {-direction * center / scale, direction / scale});
+
+  ArrayRef<FloatPolynomial> stages = options.compositeSign->stages;
+  Value result = input;
+  for (const auto &[i, stage] : llvm::enumerate(stages)) {
+    FloatPolynomial poly = i == 0 ? stage.compose(normalize) : stage;
+    if (indicator && i + 1 == stages.size()) {
+      poly = poly.scale(APFloat(0.5)).add(
+          FloatPolynomial::fromCoefficients({0.5}));
+    }
+    auto evalOp = rewriter.create<EvalOp>(
+        op->getLoc(), TypedFloatPolynomialAttr::get(polyType, poly), result);
+    // Every stage after the first sees inputs normalized to [-1, 1].
+    evalOp->setAttr("domain_lower",
+                    rewriter.getF64FloatAttr(i == 0 ? domainLower : -1.0));
+    evalOp->setAttr("domain_upper",
+                    rewriter.getF64FloatAttr(i == 0 ? domainUpper : 1.0));
+    result = evalOp.getOutput();
+  }
+  return result;
+}
+
+// Approximates |x| by x * sign(x).
+struct ConvertAbsFToCompositeSign : public OpRewritePattern<math::AbsFOp> {
+  ConvertAbsFToCompositeSign(mlir::MLIRContext *context,
+                             const ApproximationOptions &options)
+      : OpRewritePattern<math::AbsFOp>(context, /*benefit=*/2),
+        options(options) {}
+
+ public:
+  LogicalResult matchAndRewrite(math::AbsFOp op,
+                                PatternRewriter &rewriter) const override {
+    FailureOr<Value> sign =
+        buildCompositeSign(rewriter, op, op.getOperand(), /*center=*/0.0,
+                           /*negate=*/false, /*indicator=*/false, options);
+    if (failed(sign)) return failure();
+    rewriter.replaceOpWithNewOp<arith::MulFOp>(op, op.getOperand(),
+                                               sign.value());
+    return success();
+  }
+
+ private:
+  ApproximationOptions options;
+};
+
+// Approximates max(x, c) = c + (x - c) * h and min(x, c) = x - (x - c) * h
+// for a constant c, where h = (1 + sign(x - c)) / 2 indicates x > c.
+template <typename OpTy, bool isMax>
+struct ConvertMaxMinToCompositeSign : public OpRewritePattern<OpTy> {
+  ConvertMaxMinToCompositeSign(mlir::MLIRContext *context,
+                               const ApproximationOptions &options)
+      : OpRewritePattern<OpTy>(context, /*benefit=*/2), options(options) {}
+
+ public:
+  LogicalResult matchAndRewrite(OpTy op,
+                                PatternRewriter &rewriter) const override {
+    Value lhs = op.getLhs();
+    Value rhs = op.getRhs();
+    auto lhsConstResult = getSingleValueOrSplat(lhs);
+    auto rhsConstResult = getSingleValueOrSplat(rhs);
+    if (failed(lhsConstResult) && failed(rhsConstResult)) return failure();
+    bool lhsIsConstant = succeeded(lhsConstResult);
+    double center = lhsIsConstant ? lhsConstResult->convertToDouble()
+                                  : rhsConstResult->convertToDouble();
+    Value constant = lhsIsConstant ? lhs : rhs;
+    Value input = lhsIsConstant ? rhs : lhs;
+
+    FailureOr<Value> indicator =
+        buildCompositeSign(rewriter, op, input, center, /*negate=*/false,
+                           /*indicator=*/true, options);
+    if (failed(indicator)) return failure();
+
+    Location loc = op.getLoc();
+    Value diff = rewriter.create<arith::SubFOp>(loc, input, constant);
+    Value scaled = rewriter.create<arith::MulFOp>(loc, diff, indicator.value());
+    if (isMax) {
+      rewriter.replaceOpWithNewOp<arith::AddFOp>(op, constant, scaled);
+    } else {
+      rewriter.replaceOpWithNewOp<arith::SubFOp>(op, input, scaled);
+    }
+    return success();
+  }
+
+ private:
+  ApproximationOptions options;
+};
+
+// Approximates uitofp(cmpf(pred, x, c)) for a constant c and an ordering
+// predicate by the indicator (1 + sign(x - c)) / 2, or (1 + sign(c - x)) / 2
+// for less-than predicates.
+struct ConvertComparisonToCompositeSign
+    : public OpRewritePattern<arith::UIToFPOp> {
+  ConvertComparisonToCompositeSign(mlir::MLIRContext *context,
+                                   const ApproximationOptions &options)
+      : OpRewritePattern<arith::UIToFPOp>(context, /*benefit=*/2),
+        options(options) {}
+
+ public:
+  LogicalResult matchAndRewrite(arith::UIToFPOp op,
+                                PatternRewriter &rewriter) const override {
+    auto cmpOp = op.getIn().getDefiningOp<arith::CmpFOp>();
+    if (!cmpOp) return failure();
+
+    bool greater;
+    switch (cmpOp.getPredicate()) {
+      case arith::CmpFPredicate::OGT:
+      case arith::CmpFPredicate::OGE:
+      case arith::CmpFPredicate::UGT:
+      case arith::CmpFPredicate::UGE:
+        greater = true;
+        break;
+      case arith::CmpFPredicate::OLT:
+      case arith::CmpFPredicate::OLE:
+      case arith::CmpFPredicate::ULT:
+      case arith::CmpFPredicate::ULE:
+        greater = false;
+        break;
+      default:
+        return failure();
+    }
+
+    Value lhs = cmpOp.getLhs();
+    Value rhs = cmpOp.getRhs();
+    auto lhsConstResult = getSingleValueOrSplat(lhs);
+    auto rhsConstResult = getSingleValueOrSplat(rhs);
+    if (failed(lhsConstResult) && failed(rhsConstResult)) return failure();
+    bool lhsIsConstant = succeeded(lhsConstResult);
+    double center = lhsIsConstant ? lhsConstResult->convertToDouble()
+                                  : rhsConstResult->convertToDouble();
+    Value input = lhsIsConstant ? rhs : lhs;
+    // c > x is x < c.
+    if (lhsIsConstant) greater = !greater;
+    if (input.getType() != op.getType()) return failure();
+
+    FailureOr<Value> indicator =
+        buildCompositeSign(rewriter, cmpOp, input, center, /*negate=*/!greater,
+                           /*indicator=*/true, options);
+    if (failed(indicator)) return failure();
+    rewriter.replaceOp(op, indicator.value());
+    return success();
+  }
+
+ private:
+  ApproximationOptions options;
+};
+
+// Keeps the ranges inferred by RangeAnalysis usable while ops are rewritten.
+// A replacement takes over the range of the value it replaces, so that, e.g.,
+// exp(tanh(x)) is still approximated over the range of tanh(x) once tanh has
+// been approximated. The ranges of erased values are forgotten, as new values
+// may be allocated in their place.
+struct RangeUpdateListener : public RewriterBase::Listener {
+  explicit RangeUpdateListener(DataFlowSolver *solver) : solver(solver) {}
+
+  void notifyOperationReplaced(Operation *op,
+                               ValueRange replacement) override {
+    for (auto [result, newValue] : llvm::zip(op->getResults(), replacement)) {
+      const auto *lattice = solver->lookupState<RangeLattice>(result);
+      if (!lattice || !lattice->getValue().isInitialized()) continue;
+      (void)solver->getOrCreateState<RangeLattice>(newValue)->join(
+          lattice->getValue());
+    }
+  }
+
+  void notifyOperationErased(Operation *op) override {
+    for (Value result : op->getResults()) {
+      if (solver->lookupState<RangeLattice>(result))
+        solver->getOrCreateState<RangeLattice>(result)->reset();
+    }
+  }
+
+ private:
+  DataFlowSolver *solver;
 };
 
 struct PolynomialApproximation
@@ -332,39 +663,84 @@ struct PolynomialApproximation
     MLIRContext *context = &getContext();
     RewritePatternSet patterns(context);
 
+    DataFlowSolver solver;
+    if (useRangeAnalysis) {
+      solver.load<dataflow::DeadCodeAnalysis>();
+      solver.load<dataflow::SparseConstantPropagation>();
+      solver.load<RangeAnalysis>();
+      if (failed(solver.initializeAndRun(getOperation()))) {
+        getOperation()->emitOpError() << "Failed to run range analysis.\n";
+        signalPassFailure();
+        return;
+      }
+    }
+    ApproximationOptions options;
+    options.solver = useRangeAnalysis ? &solver : nullptr;
+    options.maxError = maxError;
+    options.maxDegree = maxDegree;
+
+    if (useCompositeSign) {
+      auto compositeSign = approximation::optimizeCompositeSignApproximation(
+          signGap, signError, signMaxStageDegree);
+      if (failed(compositeSign)) {
+        getOperation()->emitOpError()
+            << "Failed to find a composite sign approximation with sign-error "
+            << signError << " and sign-gap " << signGap << ".\n";
+        signalPassFailure();
+        return;
+      }
+      LLVM_DEBUG(llvm::dbgs()
+                 << "Using " << compositeSign->stages.size()
+                 << " composite sign stages of depth " << compositeSign->depth
+                 << " and error " << compositeSign->maxError << "\n");
+      options.compositeSign = compositeSign.value();
+
+      patterns.add<ConvertAbsFToCompositeSign>(context, options);
+      patterns.add<ConvertComparisonToCompositeSign>(context, options);
+      patterns.add<ConvertMaxMinToCompositeSign<arith::MaximumFOp, true>>(
+          context, options);
+      patterns.add<ConvertMaxMinToCompositeSign<arith::MaxNumFOp, true>>(
+          context, options);
+      patterns.add<ConvertMaxMinToCompositeSign<arith::MinimumFOp, false>>(
+          context, options);
+      patterns.add<ConvertMaxMinToCompositeSign<arith::MinNumFOp, false>>(
+          context, options);
+    }
+
     // Math unary ops
-    patterns.add<ConvertUnaryOp<math::AbsFOp>>(context, absf);
-    patterns.add<ConvertUnaryOp<math::AcosOp>>(context, acos);
-    patterns.add<ConvertUnaryOp<math::AcoshOp>>(context, acosh);
-    patterns.add<ConvertUnaryOp<math::AsinOp>>(context, asin);
-    patterns.add<ConvertUnaryOp<math::AsinhOp>>(context, asinh);
-    patterns.add<ConvertUnaryOp<math::AtanOp>>(context, atan);
-    patterns.add<ConvertUnaryOp<math::AtanhOp>>(context, atanh);
-    patterns.add<ConvertUnaryOp<math::CbrtOp>>(context, cbrt);
-    patterns.add<ConvertUnaryOp<math::CeilOp>>(context, ceil);
-    patterns.add<ConvertUnaryOp<math::CosOp>>(context, cos);
-    patterns.add<ConvertUnaryOp<math::CoshOp>>(context, cosh);
-    patterns.add<ConvertUnaryOp<math::ErfOp>>(context, erf);
-    patterns.add<ConvertUnaryOp<math::ErfcOp>>(context, erfc);
-    patterns.add<ConvertUnaryOp<math::ExpOp>>(context, exp);
-    patterns.add<ConvertUnaryOp<math::Exp2Op>>(context, exp2);
-    patterns.add<ConvertUnaryOp<math::ExpM1Op>>(context, expm1);
-    patterns.add<ConvertUnaryOp<math::FloorOp>>(context, floor);
-    patterns.add<ConvertUnaryOp<math::LogOp>>(context, log);
-    patterns.add<ConvertUnaryOp<math::Log10Op>>(context, log10);
-    patterns.add<ConvertUnaryOp<math::Log1pOp>>(context, log1p);
-    patterns.add<ConvertUnaryOp<math::Log2Op>>(context, log2);
-    patterns.add<ConvertUnaryOp<math::RoundOp>>(context, round);
-    patterns.add<ConvertUnaryOp<math::RsqrtOp>>(context, rsqrt);
-    patterns.add<ConvertUnaryOp<math::SinOp>>(context, sin);
-    patterns.add<ConvertUnaryOp<math::SinhOp>>(context, sinh);
-    patterns.add<ConvertUnaryOp<math::SqrtOp>>(context, sqrt);
-    patterns.add<ConvertUnaryOp<math::TanOp>>(context, tan);
-    patterns.add<ConvertUnaryOp<math::TanhOp>>(context, tanh);
-    patterns.add<ConvertUnaryOp<math::TruncOp>>(context, trunc);
+    patterns.add<ConvertUnaryOp<math::AbsFOp>>(context, absf, options);
+    patterns.add<ConvertUnaryOp<math::AcosOp>>(context, acos, options);
+    patterns.add<ConvertUnaryOp<math::AcoshOp>>(context, acosh, options);
+    patterns.add<ConvertUnaryOp<math::AsinOp>>(context, asin, options);
+    patterns.add<ConvertUnaryOp<math::AsinhOp>>(context, asinh, options);
+    patterns.add<ConvertUnaryOp<math::AtanOp>>(context, atan, options);
+    patterns.add<ConvertUnaryOp<math::AtanhOp>>(context, atanh, options);
+    patterns.add<ConvertUnaryOp<math::CbrtOp>>(context, cbrt, options);
+    patterns.add<ConvertUnaryOp<math::CeilOp>>(context, ceil, options);
+    patterns.add<ConvertUnaryOp<math::CosOp>>(context, cos, options);
+    patterns.add<ConvertUnaryOp<math::CoshOp>>(context, cosh, options);
+    patterns.add<ConvertUnaryOp<math::ErfOp>>(context, erf, options);
+    patterns.add<ConvertUnaryOp<math::ErfcOp>>(context, erfc, options);
+    patterns.add<ConvertUnaryOp<math::ExpOp>>(context, exp, options);
+    patterns.add<ConvertUnaryOp<math::Exp2Op>>(context, exp2, options);
+    patterns.add<ConvertUnaryOp<math::ExpM1Op>>(context, expm1, options);
+    patterns.add<ConvertUnaryOp<math::FloorOp>>(context, floor, options);
+    patterns.add<ConvertUnaryOp<math::LogOp>>(context, log, options);
+    patterns.add<ConvertUnaryOp<math::Log10Op>>(context, log10, options);
+    patterns.add<ConvertUnaryOp<math::Log1pOp>>(context, log1p, options);
+    patterns.add<ConvertUnaryOp<math::Log2Op>>(context, log2, options);
+    patterns.add<ConvertUnaryOp<math::RoundOp>>(context, round, options);
+    patterns.add<ConvertUnaryOp<math::RsqrtOp>>(context, rsqrt, options);
+    patterns.add<ConvertUnaryOp<math::SinOp>>(context, sin, options);
+    patterns.add<ConvertUnaryOp<math::SinhOp>>(context, sinh, options);
+    patterns.add<ConvertUnaryOp<math::SqrtOp>>(context, sqrt, options);
+    patterns.add<ConvertUnaryOp<math::TanOp>>(context, tan, options);
+    patterns.add<ConvertUnaryOp<math::TanhOp>>(context, tanh, options);
+    patterns.add<ConvertUnaryOp<math::TruncOp>>(context, trunc, options);
 
     // TODO(#1514): Restore with alternative roundeven
-    // patterns.add<ConvertUnaryOp<math::RoundEvenOp>>(context, _roundeven);
+    // patterns.add<ConvertUnaryOp<math::RoundEvenOp>>(context, _roundeven,
+    //                                                 options);
 
     // Unsupported math dialect unary ops:
     // math::AbsIOp
@@ -377,21 +753,30 @@ struct PolynomialApproximation
     // math::IsnormalOp
 
     // Math binary ops (when one argument is statically constant)
-    patterns.add<ConvertBinaryConstOp<arith::MaxNumFOp>>(context, maxnumf);
-    patterns.add<ConvertBinaryConstOp<arith::MaximumFOp>>(context, maxf);
-    patterns.add<ConvertBinaryConstOp<arith::MinNumFOp>>(context, minf);
-    patterns.add<ConvertBinaryConstOp<arith::MinimumFOp>>(context, minnumf);
-    patterns.add<ConvertBinaryConstOp<math::Atan2Op>>(context, atan2);
-    patterns.add<ConvertBinaryConstOp<math::CopySignOp>>(context, copysign);
-    patterns.add<ConvertBinaryConstOp<math::FPowIOp>>(context, fpowi);
-    patterns.add<ConvertBinaryConstOp<math::PowFOp>>(context, powf);
+    patterns.add<ConvertBinaryConstOp<arith::MaxNumFOp>>(context, maxnumf,
+                                                         options);
+    patterns.add<ConvertBinaryConstOp<arith::MaximumFOp>>(context, maxf,
+                                                          options);
+    patterns.add<ConvertBinaryConstOp<arith::MinNumFOp>>(context, minf,
+                                                         options);
+    patterns.add<ConvertBinaryConstOp<arith::MinimumFOp>>(context, minnumf,
+                                                          options);
+    patterns.add<ConvertBinaryConstOp<math::Atan2Op>>(context, atan2, options);
+    patterns.add<ConvertBinaryConstOp<math::CopySignOp>>(context, copysign,
+                                                         options);
+    patterns.add<ConvertBinaryConstOp<math::FPowIOp>>(context, fpowi, options);
+    patterns.add<ConvertBinaryConstOp<math::PowFOp>>(context, powf, options);
 
     // Math ternary ops
-    // patterns.add<ConvertUnaryOp<math::FmaOp>>(context, fma);
+    // patterns.add<ConvertUnaryOp<math::FmaOp>>(context, fma, options);
+
+    RangeUpdateListener listener(&solver);
+    GreedyRewriteConfig config;
+    if (useRangeAnalysis) config.listener = &listener;
 
     // TODO (#1221): Investigate whether folding (default: on) can be skipped
     // here.
-    (void)applyPatternsGreedily(getOperation(), std::move(patterns));
+    (void)applyPatternsGreedily(getOperation(), std::move(patterns), config);
   }
 };
 
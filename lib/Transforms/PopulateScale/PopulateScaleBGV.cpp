@@ -63,12 +63,19 @@ struct PopulateScaleBGV : impl::PopulateScaleBGVBase<PopulateScaleBGV> {
         getOperation()->getAttr(bgv::BGVDialect::kSchemeParamAttrName));
     auto t = bgvSchemeParamAttr.getPlaintextModulus();
 
+    auto &secretness = getAnalysis<SecretnessAnalysisCache>();
+    if (failed(secretness.getStatus())) {
+      getOperation()->emitOpError() << "Failed to run the analysis.\n";
+      signalPassFailure();
+      return;
+    }
+
     DataFlowSolver solver;
     SymbolTableCollection symbolTable;
     solver.load<dataflow::DeadCodeAnalysis>();
     solver.load<dataflow::SparseConstantPropagation>();
-    // ScaleAnalysis depends on SecretnessAnalysis
-    solver.load<SecretnessAnalysis>();
+    // ScaleAnalysis depends on the cached secretness
+    secretness.seedSolver(solver);
     // set input scale to 1, which is arbitrary.
     solver.load<ScaleAnalysis<BGVScaleModel>>(
         bgv::SchemeParam::getSchemeParamFromAttr(bgvSchemeParamAttr),
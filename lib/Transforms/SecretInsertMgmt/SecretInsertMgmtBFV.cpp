@@ -1,6 +1,7 @@
 #include <cstdint>
 #include <utility>
 
+#include "lib/Analysis/LoopCarriedAnalysis/LoopCarriedAnalysis.h"
 #include "lib/Analysis/MulDepthAnalysis/MulDepthAnalysis.h"
 #include "lib/Analysis/SecretnessAnalysis/SecretnessAnalysis.h"
 #include "lib/Dialect/BGV/IR/BGVAttributes.h"
@@ -36,6 +37,31 @@ struct SecretInsertMgmtBFV
     : impl::SecretInsertMgmtBFVBase<SecretInsertMgmtBFV> {
   using SecretInsertMgmtBFVBase::SecretInsertMgmtBFVBase;
 
+  // The multiplicative depth of a loop-carried value may grow with the trip
+  // count. Loop bodies are analysed once, with the depth of the iter_args
+  // bounded over all iterations. The loops themselves are kept, as B/FV uses
+  // the same ciphertext type in every iteration.
+  FailureOr<int64_t> analyseMaxMulDepth() {
+    auto &secretness = getAnalysis<SecretnessAnalysisCache>();
+    if (failed(secretness.getStatus())) {
+      getOperation()->emitOpError() << "Failed to run the analysis.\n";
+      return failure();
+    }
+
+    auto solver = solveWithLoopCarriedStates<MulDepthLattice>(
+        getOperation(), [&](DataFlowSolver &solver) {
+          solver.load<dataflow::DeadCodeAnalysis>();
+          solver.load<dataflow::SparseConstantPropagation>();
+          secretness.seedSolver(solver);
+          solver.load<MulDepthAnalysis>();
+        });
+    if (failed(solver)) {
+      getOperation()->emitOpError() << "Failed to run the analysis.\n";
+      return failure();
+    }
+    return getMaxMulDepth(getOperation(), **solver);
+  }
+
   void runOnOperation() override {
     // Helper for future lowerings that want to know what scheme was used.
     moduleSetBFV(getOperation());
@@ -54,14 +80,20 @@ struct SecretInsertMgmtBFV
       maxMulDepth = schemeParam.getQ().size() - 1;
     }
 
+    if (!hasSchemeParam) {
+      // try our best to analyse mul depth
+      FailureOr<int64_t> mulDepth = analyseMaxMulDepth();
+      if (failed(mulDepth)) {
+        signalPassFailure();
+        return;
+      }
+      maxMulDepth = mulDepth.value();
+    }
+
     DataFlowSolver solver;
     solver.load<dataflow::DeadCodeAnalysis>();
     solver.load<dataflow::SparseConstantPropagation>();
     solver.load<SecretnessAnalysis>();
-    if (!hasSchemeParam) {
-      // try our best to analyse mul depth
-      solver.load<MulDepthAnalysis>();
-    }
 
     if (failed(solver.initializeAndRun(getOperation()))) {
       getOperation()->emitOpError() << "Failed to run the analysis.\n";
@@ -69,10 +101,6 @@ struct SecretInsertMgmtBFV
       return;
     }
 
-    if (!hasSchemeParam) {
-      maxMulDepth = getMaxMulDepth(getOperation(), solver);
-    }
-
     // handle plaintext operands
     RewritePatternSet patternsPlaintext(&getContext());
     patternsPlaintext.add<UseInitOpForPlaintextOperand<arith::AddIOp>,
@@ -52,6 +52,15 @@ struct SecretInsertMgmtBGV
       return;
     }
 
+    // BGV has no bootstrapping, so loops whose carried values consume levels
+    // in every iteration are unrolled.
+    if (failed(normalizeLoopCarriedDepth(
+            getOperation(), getAnalysis<SecretnessAnalysisCache>(),
+            /*useBootstrap=*/false))) {
+      signalPassFailure();
+      return;
+    }
+
     DataFlowSolver solver;
     solver.load<dataflow::DeadCodeAnalysis>();
     solver.load<dataflow::SparseConstantPropagation>();
@@ -111,6 +120,14 @@ struct SecretInsertMgmtBGV
                                              getOperation(), &solver);
     (void)walkAndApplyPatterns(getOperation(), std::move(patternsAddModReduce));
 
+    // values carried by loops must keep the same level across iterations
+    RewritePatternSet patternsLoopCarried(&getContext());
+    patternsLoopCarried.add<MatchLoopCarriedLevel>(
+        &getContext(), &idCounter,
+        /*matchMulDepth=*/!beforeMulIncludeFirstMul && !afterMul,
+        getOperation(), &solver);
+    (void)walkAndApplyPatterns(getOperation(), std::move(patternsLoopCarried));
+
     // when other binary op operands mulDepth mismatch
     // this only happen for before-mul but not include-first-mul case
     // at the first level, a Value can be both mulResult or not mulResult
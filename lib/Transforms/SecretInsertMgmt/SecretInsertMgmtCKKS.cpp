@@ -112,6 +112,15 @@ struct SecretInsertMgmtCKKS
     // Helper for future lowerings that want to know what scheme was used
     moduleSetCKKS(getOperation());
 
+    // bootstrap the loop-carried values that consume levels in every
+    // iteration, so that each iteration starts at the same level
+    if (failed(normalizeLoopCarriedDepth(
+            getOperation(), getAnalysis<SecretnessAnalysisCache>(),
+            /*useBootstrap=*/true))) {
+      signalPassFailure();
+      return;
+    }
+
     DataFlowSolver solver;
     solver.load<dataflow::DeadCodeAnalysis>();
     solver.load<dataflow::SparseConstantPropagation>();
@@ -172,7 +181,9 @@ struct SecretInsertMgmtCKKS
               &getContext(), beforeMulIncludeFirstMul, getOperation(), &solver);
       // includeFirstMul = false here
       // as before yield we only want mulResult to be mod reduced
-      patternsMultModReduce.add<ModReduceBefore<secret::YieldOp>>(
+      // the same holds for values bootstrapped at the back edge of a loop
+      patternsMultModReduce.add<ModReduceBefore<secret::YieldOp>,
+                                ModReduceBefore<mgmt::BootstrapOp>>(
           &getContext(), /*includeFirstMul*/ false, getOperation(), &solver);
       (void)walkAndApplyPatterns(getOperation(),
                                  std::move(patternsMultModReduce));
@@ -210,6 +221,14 @@ struct SecretInsertMgmtCKKS
             &getContext(), &idCounter, getOperation(), &solver);
     (void)walkAndApplyPatterns(getOperation(), std::move(patternsAddModReduce));
 
+    // values carried by loops must keep the same level across iterations
+    RewritePatternSet patternsLoopCarried(&getContext());
+    patternsLoopCarried.add<MatchLoopCarriedLevel>(
+        &getContext(), &idCounter,
+        /*matchMulDepth=*/!beforeMulIncludeFirstMul && !afterMul,
+        getOperation(), &solver);
+    (void)walkAndApplyPatterns(getOperation(), std::move(patternsLoopCarried));
+
     // when other binary op operands mulDepth mismatch
     // this only happen for before-mul but not include-first-mul case
     // at the first level, a Value can be both mulResult or not mulResult
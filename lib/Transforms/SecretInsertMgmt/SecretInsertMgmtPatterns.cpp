@@ -2,17 +2,23 @@
 
 #include <algorithm>
 #include <cstdint>
+#include <optional>
+#include <utility>
 
 #include "lib/Analysis/LevelAnalysis/LevelAnalysis.h"
 #include "lib/Analysis/MulDepthAnalysis/MulDepthAnalysis.h"
 #include "lib/Analysis/SecretnessAnalysis/SecretnessAnalysis.h"
 #include "lib/Dialect/Mgmt/IR/MgmtOps.h"
 #include "lib/Dialect/Secret/IR/SecretOps.h"
-#include "llvm/include/llvm/ADT/STLExtras.h"             // from @llvm-project
-#include "llvm/include/llvm/ADT/SmallVector.h"           // from @llvm-project
-#include "llvm/include/llvm/Support/Debug.h"             // from @llvm-project
+#include "llvm/include/llvm/ADT/DenseMap.h"     // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"    // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"  // from @llvm-project
+#include "llvm/include/llvm/Support/Debug.h"    // from @llvm-project
+#include "mlir/include/mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Affine/LoopUtils.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Arith/IR/Arith.h"    // from @llvm-project
 #include "mlir/include/mlir/Dialect/Tensor/IR/Tensor.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/Builders.h"               // from @llvm-project
 #include "mlir/include/mlir/IR/BuiltinAttributes.h"      // from @llvm-project
 #include "mlir/include/mlir/IR/PatternMatch.h"           // from @llvm-project
 #include "mlir/include/mlir/IR/Value.h"                  // from @llvm-project
@@ -24,6 +30,37 @@
 namespace mlir {
 namespace heir {
 
+namespace {
+
+// Lower `value` by levelDiff levels with (level_reduce) + adjust_scale +
+// mod_reduce. See MatchCrossLevel.
+Value createLevelMatching(PatternRewriter &rewriter, Location loc, Value value,
+                          int levelDiff, int *idCounter) {
+  Value managed = value;
+  if (levelDiff > 1) {
+    managed = rewriter.create<mgmt::LevelReduceOp>(loc, managed, levelDiff - 1);
+  }
+  // make a different adjust scale each time
+  // only after parameter selection can we decide the actual scale
+  managed = rewriter.create<mgmt::AdjustScaleOp>(
+      loc, managed, rewriter.getI64IntegerAttr((*idCounter)++));
+  return rewriter.create<mgmt::ModReduceOp>(loc, managed);
+}
+
+// Whether op raises the multiplicative depth or the level of its result, in
+// the sense of MulDepthAnalysis and LevelAnalysis.
+bool increasesDepthOrLevel(Operation *op) {
+  if (isa<arith::MulIOp, arith::MulFOp, mgmt::AdjustScaleOp, mgmt::ModReduceOp,
+          mgmt::LevelReduceOp>(op)) {
+    return true;
+  }
+  // NOTE: special case for ExtractOp... it is a mulconst+rotate
+  // if not annotated with slot_extract
+  return isa<tensor::ExtractOp>(op) && !op->getAttr("slot_extract");
+}
+
+}  // namespace
+
 template <typename MulOp>
 LogicalResult MultRelinearize<MulOp>::matchAndRewrite(
     MulOp mulOp, PatternRewriter &rewriter) const {
@@ -180,16 +217,8 @@ LogicalResult MatchCrossLevel<Op>::matchAndRewrite(
     if (level < resultLevel) {
       inserted = true;
       rewriter.setInsertionPoint(op);
-      Value managed = operand->get();
-      if (resultLevel - level > 1) {
-        managed = rewriter.create<mgmt::LevelReduceOp>(op.getLoc(), managed,
-                                                       resultLevel - level - 1);
-      }
-      // make a different adjust scale each time
-      // only after parameter selection can we decide the actual scale
-      managed = rewriter.create<mgmt::AdjustScaleOp>(
-          op.getLoc(), managed, rewriter.getI64IntegerAttr((*idCounter)++));
-      managed = rewriter.create<mgmt::ModReduceOp>(op.getLoc(), managed);
+      Value managed = createLevelMatching(rewriter, op.getLoc(), operand->get(),
+                                          resultLevel - level, idCounter);
       // NOTE that only at most one operand/Value will experience such
       // replacement. For op with two operands with same Value, such replace
       // won't happen.
@@ -261,6 +290,59 @@ LogicalResult MatchCrossMulDepth<Op>::matchAndRewrite(
   return solver->initializeAndRun(top);
 }
 
+LogicalResult MatchLoopCarriedLevel::matchAndRewrite(
+    affine::AffineForOp forOp, PatternRewriter &rewriter) const {
+  auto getLevel = [&](Value value) -> std::optional<int> {
+    const auto *lattice = solver->lookupState<LevelLattice>(value);
+    if (!lattice || !lattice->getValue().isInitialized()) return std::nullopt;
+    return lattice->getValue().getLevel();
+  };
+  auto getMulDepth = [&](Value value) -> std::optional<int64_t> {
+    const auto *lattice = solver->lookupState<MulDepthLattice>(value);
+    if (!lattice || !lattice->getValue().isInitialized()) return std::nullopt;
+    return lattice->getValue().getMulDepth();
+  };
+
+  Operation *yieldOp = forOp.getBody()->getTerminator();
+  bool inserted = false;
+  for (auto [i, iterArg] : llvm::enumerate(forOp.getRegionIterArgs())) {
+    if (!isSecret(iterArg, solver)) continue;
+    std::optional<int> iterLevel = getLevel(iterArg);
+    std::optional<int64_t> iterMulDepth = getMulDepth(iterArg);
+    if (!iterLevel) continue;
+
+    for (OpOperand *operand :
+         {&forOp.getInitsMutable()[i], &yieldOp->getOpOperand(i)}) {
+      std::optional<int> level = getLevel(operand->get());
+      if (!level) continue;
+      rewriter.setInsertionPoint(operand->getOwner());
+      if (*level < *iterLevel) {
+        operand->set(createLevelMatching(rewriter, forOp.getLoc(),
+                                         operand->get(), *iterLevel - *level,
+                                         idCounter));
+        inserted = true;
+        continue;
+      }
+      std::optional<int64_t> mulDepth = getMulDepth(operand->get());
+      if (matchMulDepth && mulDepth && iterMulDepth && *mulDepth == 0 &&
+          *iterMulDepth == 1) {
+        operand->set(rewriter.create<mgmt::AdjustScaleOp>(
+            forOp.getLoc(), operand->get(),
+            rewriter.getI64IntegerAttr((*idCounter)++)));
+        inserted = true;
+      }
+    }
+  }
+
+  if (!inserted) {
+    return failure();
+  }
+  // propagateIfChanged only push workitem to the worklist queue
+  // actually execute the transfer for the new values
+  solver->eraseAllStates();
+  return solver->initializeAndRun(top);
+}
+
 template <typename Op>
 LogicalResult UseInitOpForPlaintextOperand<Op>::matchAndRewrite(
     Op op, PatternRewriter &rewriter) const {
@@ -329,6 +411,127 @@ LogicalResult BootstrapWaterLine<Op>::matchAndRewrite(
   return solver->initializeAndRun(top);
 }
 
+SmallVector<unsigned> getDepthGrowingIterArgs(affine::AffineForOp forOp,
+                                              DataFlowSolver *solver) {
+  unsigned numIterArgs = forOp.getNumRegionIterArgs();
+  // For each secret value in the body, the largest number of depth or level
+  // increases along a def-use chain from each iter_arg, or -1 if the value
+  // does not depend on that iter_arg.
+  DenseMap<Value, SmallVector<int64_t>> weights;
+  for (auto [j, iterArg] : llvm::enumerate(forOp.getRegionIterArgs())) {
+    if (!isSecret(iterArg, solver)) continue;
+    SmallVector<int64_t> weight(numIterArgs, -1);
+    weight[j] = 0;
+    weights[iterArg] = weight;
+  }
+
+  for (Operation &op : forOp.getBody()->without_terminator()) {
+    // bootstrap resets both the level and the multiplicative depth
+    if (isa<mgmt::BootstrapOp>(op)) continue;
+
+    SmallVector<int64_t> weight(numIterArgs, -1);
+    auto accumulate = [&](Value operand) {
+      auto it = weights.find(operand);
+      if (it == weights.end()) return;
+      for (unsigned j = 0; j < numIterArgs; ++j) {
+        weight[j] = std::max(weight[j], it->second[j]);
+      }
+    };
+    // Nested regions (e.g., inner loops) are summarized conservatively: the
+    // results depend on every value the op uses, with one increase if any
+    // nested op increases depth or level.
+    bool increases = false;
+    op.walk([&](Operation *nested) {
+      increases |= increasesDepthOrLevel(nested);
+      for (Value operand : nested->getOperands()) accumulate(operand);
+    });
+    if (llvm::all_of(weight, [](int64_t w) { return w < 0; })) continue;
+    if (increases) {
+      for (int64_t &w : weight) {
+        if (w >= 0) ++w;
+      }
+    }
+    for (Value result : op.getResults()) {
+      if (isSecret(result, solver)) weights[result] = weight;
+    }
+  }
+
+  // The back edge yields the i-th value into iter_arg i, so iter_arg j
+  // reaches iter_arg i if the i-th yielded value depends on iter_arg j.
+  // An iter_arg grows iff it lies on a cycle containing an increasing edge.
+  SmallVector<SmallVector<bool>> reach(numIterArgs,
+                                       SmallVector<bool>(numIterArgs, false));
+  SmallVector<std::pair<unsigned, unsigned>> increasingEdges;
+  Operation *yieldOp = forOp.getBody()->getTerminator();
+  for (unsigned i = 0; i < numIterArgs; ++i) {
+    reach[i][i] = true;
+    auto it = weights.find(yieldOp->getOperand(i));
+    if (it == weights.end()) continue;
+    for (unsigned j = 0; j < numIterArgs; ++j) {
+      if (it->second[j] >= 0) reach[j][i] = true;
+      if (it->second[j] > 0) increasingEdges.push_back({j, i});
+    }
+  }
+  for (unsigned k = 0; k < numIterArgs; ++k) {
+    for (unsigned i = 0; i < numIterArgs; ++i) {
+      for (unsigned j = 0; j < numIterArgs; ++j) {
+        if (reach[i][k] && reach[k][j]) reach[i][j] = true;
+      }
+    }
+  }
+
+  SmallVector<unsigned> growing;
+  for (unsigned i = 0; i < numIterArgs; ++i) {
+    if (llvm::any_of(increasingEdges, [&](auto edge) {
+          return reach[i][edge.first] && reach[edge.second][i];
+        })) {
+      growing.push_back(i);
+    }
+  }
+  return growing;
+}
+
+LogicalResult normalizeLoopCarriedDepth(Operation *top,
+                                        SecretnessAnalysisCache &secretness,
+                                        bool useBootstrap) {
+  if (failed(secretness.getStatus())) {
+    return failure();
+  }
+
+  SmallVector<affine::AffineForOp> loops;
+  top->walk<WalkOrder::PostOrder>(
+      [&](affine::AffineForOp forOp) { loops.push_back(forOp); });
+
+  for (affine::AffineForOp forOp : loops) {
+    SmallVector<unsigned> growing =
+        getDepthGrowingIterArgs(forOp, secretness.getSolver());
+    if (growing.empty()) continue;
+
+    LLVM_DEBUG(llvm::dbgs() << "Loop with " << growing.size()
+                            << " depth-growing iter_args: " << forOp << "\n");
+    if (useBootstrap) {
+      Operation *yieldOp = forOp.getBody()->getTerminator();
+      OpBuilder builder(yieldOp);
+      for (unsigned i : growing) {
+        Value yielded = yieldOp->getOperand(i);
+        auto bootstrap = builder.create<mgmt::BootstrapOp>(
+            yieldOp->getLoc(), yielded.getType(), yielded);
+        yieldOp->setOperand(i, bootstrap);
+      }
+    } else if (failed(affine::loopUnrollFull(forOp))) {
+      return forOp.emitOpError()
+             << "carries a secret value whose multiplicative depth grows with "
+                "each iteration, which requires unrolling the loop, but it "
+                "has no constant trip count";
+    }
+
+    if (failed(secretness.recompute())) {
+      return failure();
+    }
+  }
+  return success();
+}
+
 // for BGV
 template struct MultRelinearize<arith::MulIOp>;
 
@@ -342,6 +545,8 @@ template struct ModReduceBefore<arith::MulIOp>;
 // TODO(#1174): decide packing earlier in the pipeline instead of annotation
 template struct ModReduceBefore<tensor::ExtractOp>;
 template struct ModReduceBefore<secret::YieldOp>;
+// rescale a multiplication result before it is bootstrapped at a back edge
+template struct ModReduceBefore<mgmt::BootstrapOp>;
 
 template struct MatchCrossLevel<arith::MulIOp>;
 template struct MatchCrossLevel<arith::AddIOp>;
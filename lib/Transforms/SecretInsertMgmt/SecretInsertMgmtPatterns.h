@@ -1,11 +1,14 @@
 #ifndef LIB_TRANSFORMS_SECRETINSERTMGMT_SECRETINSERTMGMTPATTERNS_H_
 #define LIB_TRANSFORMS_SECRETINSERTMGMT_SECRETINSERTMGMTPATTERNS_H_
 
+#include "lib/Analysis/SecretnessAnalysis/SecretnessAnalysis.h"
+#include "llvm/include/llvm/ADT/SmallVector.h"             // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
-#include "mlir/include/mlir/IR/MLIRContext.h"              // from @llvm-project
-#include "mlir/include/mlir/IR/Operation.h"                // from @llvm-project
-#include "mlir/include/mlir/IR/PatternMatch.h"             // from @llvm-project
-#include "mlir/include/mlir/Support/LLVM.h"                // from @llvm-project
+#include "mlir/include/mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/MLIRContext.h"   // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"     // from @llvm-project
+#include "mlir/include/mlir/IR/PatternMatch.h"  // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"     // from @llvm-project
 
 namespace mlir {
 namespace heir {
@@ -134,6 +137,37 @@ struct MatchCrossMulDepth : public OpRewritePattern<Op> {
   DataFlowSolver *solver;
 };
 
+/// Match the levels of the values carried by an affine.for.
+///
+/// The level of an iter_arg is the maximum of the levels of its init value and
+/// of the value yielded for it, and both must be at that level for the
+/// iter_arg to have a single ciphertext type. A lower init value is adjusted
+/// before the loop and a lower yielded value before the affine.yield, with the
+/// same sequence as MatchCrossLevel. When matchMulDepth is set, an operand at
+/// the right level that is not a multiplication result while the iter_arg is
+/// gets an adjust_scale, as in MatchCrossMulDepth.
+struct MatchLoopCarriedLevel : public OpRewritePattern<affine::AffineForOp> {
+  using OpRewritePattern<affine::AffineForOp>::OpRewritePattern;
+
+  MatchLoopCarriedLevel(MLIRContext *context, int *idCounter,
+                        bool matchMulDepth, Operation *top,
+                        DataFlowSolver *solver)
+      : OpRewritePattern<affine::AffineForOp>(context, /*benefit=*/1),
+        idCounter(idCounter),
+        matchMulDepth(matchMulDepth),
+        top(top),
+        solver(solver) {}
+
+  LogicalResult matchAndRewrite(affine::AffineForOp forOp,
+                                PatternRewriter &rewriter) const override;
+
+ private:
+  int *idCounter;
+  bool matchMulDepth;
+  Operation *top;
+  DataFlowSolver *solver;
+};
+
 /// Insert mgmt.init op for plaintext operand.
 ///
 /// See the documentation for mgmt.init for more details.
@@ -178,6 +212,27 @@ struct BootstrapWaterLine : public OpRewritePattern<Op> {
   int waterline;
 };
 
+/// Returns the indices of the secret iter_args of forOp whose multiplicative
+/// depth grows from one iteration to the next, i.e., that lie on a
+/// loop-carried dependence cycle through a multiplication or a modulus
+/// switch. The level and multiplicative depth analyses do not converge on such
+/// loops. The solver must hold the results of SecretnessAnalysis.
+::llvm::SmallVector<unsigned> getDepthGrowingIterArgs(
+    affine::AffineForOp forOp, DataFlowSolver *solver);
+
+/// Make the values carried by every affine.for under top level-homogeneous,
+/// so that the analyses converge and each iter_arg keeps the same level in
+/// every iteration. Loops are processed innermost first.
+///
+/// When useBootstrap is set, each iter_arg returned by getDepthGrowingIterArgs
+/// is bootstrapped right before the affine.yield. Otherwise, loops with such
+/// iter_args are fully unrolled, and an error is emitted for those that cannot
+/// be (i.e., without a constant trip count). The secretness cache of top is
+/// kept up to date with the rewrites.
+LogicalResult normalizeLoopCarriedDepth(Operation *top,
+                                        SecretnessAnalysisCache &secretness,
+                                        bool useBootstrap);
+
 }  // namespace heir
 }  // namespace mlir
 
@@ -7,6 +7,7 @@
 
 #include "lib/Analysis/DimensionAnalysis/DimensionAnalysis.h"
 #include "lib/Analysis/LevelAnalysis/LevelAnalysis.h"
+#include "lib/Analysis/LoopCarriedAnalysis/LoopCarriedAnalysis.h"
 #include "lib/Analysis/NoiseAnalysis/BFV/NoiseByBoundCoeffModel.h"
 #include "lib/Analysis/NoiseAnalysis/BFV/NoiseByVarianceCoeffModel.h"
 #include "lib/Analysis/NoiseAnalysis/BGV/NoiseByBoundCoeffModel.h"
@@ -24,12 +25,12 @@
 #include "mlir/include/mlir/Analysis/DataFlow/ConstantPropagationAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlow/DeadCodeAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Analysis/DataFlowFramework.h"  // from @llvm-project
-#include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"     // from @llvm-project
-#include "mlir/include/mlir/IR/BuiltinAttributes.h"        // from @llvm-project
-#include "mlir/include/mlir/IR/Operation.h"                // from @llvm-project
-#include "mlir/include/mlir/IR/Value.h"                    // from @llvm-project
-#include "mlir/include/mlir/IR/Visitors.h"                 // from @llvm-project
-#include "mlir/include/mlir/Support/LLVM.h"                // from @llvm-project
+#include "mlir/include/mlir/Dialect/Func/IR/FuncOps.h"  // from @llvm-project
+#include "mlir/include/mlir/IR/BuiltinAttributes.h"     // from @llvm-project
+#include "mlir/include/mlir/IR/Operation.h"             // from @llvm-project
+#include "mlir/include/mlir/IR/Value.h"                 // from @llvm-project
+#include "mlir/include/mlir/IR/Visitors.h"              // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"             // from @llvm-project
 
 #define DEBUG_TYPE "ValidateNoise"
 
@@ -167,27 +168,43 @@ struct ValidateNoise : impl::ValidateNoiseBase<ValidateNoise> {
       return;
     }
 
-    DataFlowSolver solver;
-    solver.load<dataflow::DeadCodeAnalysis>();
-    solver.load<dataflow::SparseConstantPropagation>();
-    // NoiseAnalysis depends on SecretnessAnalysis
-    solver.load<SecretnessAnalysis>();
-
-    solver.load<NoiseAnalysis<NoiseModel>>(schemeParam, model);
+    // Loop bodies are analysed once, with the noise of the iter_args bounded
+    // over all iterations, so the bounds inside loops hold in every iteration.
+    auto &secretness = getAnalysis<SecretnessAnalysisCache>();
+    if (failed(secretness.getStatus())) {
+      getOperation()->emitOpError() << "Failed to run the analysis.\n";
+      signalPassFailure();
+      return;
+    }
 
-    if (failed(solver.initializeAndRun(getOperation()))) {
+    using NoiseLatticeType = typename NoiseAnalysis<NoiseModel>::LatticeType;
+    auto solver = solveWithLoopCarriedStates<NoiseLatticeType>(
+        getOperation(), [&](DataFlowSolver &solver) {
+          solver.load<dataflow::DeadCodeAnalysis>();
+          solver.load<dataflow::SparseConstantPropagation>();
+          // NoiseAnalysis depends on the cached secretness
+          secretness.seedSolver(solver);
+
+          solver.load<NoiseAnalysis<NoiseModel>>(schemeParam, model);
+        });
+    if (failed(solver)) {
       getOperation()->emitOpError() << "Failed to run the analysis.\n";
       signalPassFailure();
+      return;
     }
 
-    if (failed(
-            validate<NoiseAnalysis<NoiseModel>>(&solver, schemeParam, model))) {
+    if (failed(validate<NoiseAnalysis<NoiseModel>>(solver->get(), schemeParam,
+                                                   model))) {
       getOperation()->emitOpError() << "Noise validation failed.\n";
       signalPassFailure();
     }
   }
 
   void runOnOperation() override {
+    // Only noise bounds are annotated, so the secretness of every value is
+    // unchanged.
+    markAnalysesPreserved<SecretnessAnalysisCache>();
+
     if (model == "bgv-noise-by-bound-coeff-worst-case") {
       bgv::NoiseByBoundCoeffModel model(NoiseModelVariant::WORST_CASE);
       run<bgv::NoiseByBoundCoeffModel>(model);
@@ -1,10 +1,12 @@
 #include "lib/Transforms/YosysOptimizer/YosysOptimizer.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstdint>
-#include <cstdio>
+#include <deque>
 #include <iostream>
 #include <memory>
+#include <optional>
 #include <sstream>
 #include <string>
 #include <string_view>
@@ -13,6 +15,7 @@
 #include <vector>
 
 #include "lib/Dialect/Comb/IR/CombDialect.h"
+#include "lib/Dialect/Comb/IR/CombOps.h"
 #include "lib/Dialect/Secret/IR/SecretOps.h"
 #include "lib/Dialect/Secret/IR/SecretPatterns.h"
 #include "lib/Dialect/Secret/IR/SecretTypes.h"
@@ -21,11 +24,21 @@
 #include "lib/Transforms/YosysOptimizer/LUTImporter.h"
 #include "lib/Transforms/YosysOptimizer/RTLILImporter.h"
 #include "lib/Utils/RewriteUtils/RewriteUtils.h"
+#include "llvm/include/llvm/ADT/DenseMap.h"            // from @llvm-project
 #include "llvm/include/llvm/ADT/STLExtras.h"           // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallString.h"         // from @llvm-project
 #include "llvm/include/llvm/ADT/SmallVector.h"         // from @llvm-project
 #include "llvm/include/llvm/ADT/Statistic.h"           // from @llvm-project
+#include "llvm/include/llvm/ADT/StringExtras.h"        // from @llvm-project
+#include "llvm/include/llvm/ADT/StringSet.h"           // from @llvm-project
 #include "llvm/include/llvm/Support/Debug.h"           // from @llvm-project
+#include "llvm/include/llvm/Support/ErrorHandling.h"   // from @llvm-project
+#include "llvm/include/llvm/Support/FileSystem.h"      // from @llvm-project
+#include "llvm/include/llvm/Support/FileUtilities.h"   // from @llvm-project
 #include "llvm/include/llvm/Support/FormatVariadic.h"  // from @llvm-project
+#include "llvm/include/llvm/Support/Path.h"            // from @llvm-project
+#include "llvm/include/llvm/Support/Program.h"         // from @llvm-project
+#include "llvm/include/llvm/Support/SHA256.h"          // from @llvm-project
 #include "llvm/include/llvm/Support/raw_ostream.h"     // from @llvm-project
 #include "mlir/include/mlir/Dialect/Affine/Analysis/LoopAnalysis.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Affine/IR/AffineOps.h"  // from @llvm-project
@@ -54,9 +67,9 @@
 
 // Block clang-format from reordering
 // clang-format off
-#include "kernel/log.h" // from @at_clifford_yosys
-#include "kernel/rtlil.h" // from @at_clifford_yosys
-#include "kernel/yosys.h" // from @at_clifford_yosys
+#include "kernel/log.h"    // from @at_clifford_yosys
+#include "kernel/rtlil.h"  // from @at_clifford_yosys
+#include "kernel/yosys.h"  // from @at_clifford_yosys
 // clang-format on
 
 #define DEBUG_TYPE "yosys-optimizer"
@@ -73,6 +86,7 @@ using std::string;
 // $2: yosys runfiles
 // $3: abc path
 // $4: abc fast option -fast
+// $5: abc script option, see getAbcScriptOption
 // This template uses LUTs to optimize logic. It handles Verilog modules that
 // may call submodules, utilizing splitnets to split output ports of the
 // submodule into individual bits. Note that the splitnets command uses %n to
@@ -86,7 +100,7 @@ opt_expr; opt_clean -purge; stat;
 splitnets -ports \{1} %n;
 flatten; opt_expr; opt; opt_clean -purge;
 rename -hide */w:*; rename -enumerate */w:*;
-abc -exe {3} -lut 3 {4}; stat;
+abc -exe {3} -lut 3 {4} {5}; stat;
 opt_clean -purge; stat;
 techmap -map {2}/techmap.v; opt_clean -purge;
 hierarchy -generate * o:Y i:*; opt; opt_clean -purge;
@@ -99,6 +113,7 @@ stat;
 // $2: abc path
 // $3: yosys runfiles path
 // $4: abc fast option -fast
+// $5: abc script option, see getAbcScriptOption
 constexpr std::string_view kYosysBooleanTemplate = R"(
 read_verilog -sv {0};
 hierarchy -check -top \{1};
@@ -108,15 +123,71 @@ opt_expr; opt_clean -purge; stat;
 splitnets -ports \{1} %n;
 flatten; opt_expr; opt; opt_clean -purge;
 rename -hide */w:*; rename -enumerate */w:*;
-abc -exe {2} -g AND,NAND,OR,NOR,XOR,XNOR {4};
+abc -exe {2} -g AND,NAND,OR,NOR,XOR,XNOR {4} {5};
 opt_clean -purge; stat;
 hierarchy -generate * o:Y i:*; opt; opt_clean -purge;
 clean;
 stat;
 )";
 
+// ABC scripts used in place of Yosys' default script for each synthesis
+// objective. Yosys replaces commas with spaces before passing the script to
+// ABC. The logic optimization steps mirror Yosys' defaults, and only the
+// balancing and mapping steps differ: `if -a` and `map -a` minimize the number
+// of cells, while `balance -x` followed by the default delay-oriented `if` and
+// `map` minimize the number of cells on the critical path. Unlike the AND
+// balancing done by `dc2`, `balance -x` also rebalances chains of XORs, which
+// are common in arithmetic circuits.
+constexpr std::string_view kAbcLutAreaScript =
+    "+strash;&get,-n;&fraig,-x;&put;scorr;dc2;dretime;strash;dch,-f;if,-a;"
+    "mfs2";
+constexpr std::string_view kAbcLutDepthScript =
+    "+strash;&get,-n;&fraig,-x;&put;scorr;dc2;dretime;strash;balance,-x;"
+    "dch,-f;if;mfs2";
+constexpr std::string_view kAbcGateAreaScript =
+    "+strash;&get,-n;&fraig,-x;&put;scorr;dc2;dretime;strash;dch,-f;map,-a";
+constexpr std::string_view kAbcGateDepthScript =
+    "+strash;&get,-n;&fraig,-x;&put;scorr;dc2;dretime;strash;balance,-x;"
+    "dch,-f;map";
+
 namespace {
 
+std::string getAbcScriptOption(Mode mode, SynthesisObjective objective) {
+  switch (objective) {
+    case SynthesisObjective::Balanced:
+      return "";
+    case SynthesisObjective::Area:
+      return "-script " + std::string(mode == Mode::LUT ? kAbcLutAreaScript
+                                                        : kAbcGateAreaScript);
+    case SynthesisObjective::Depth:
+      return "-script " + std::string(mode == Mode::LUT ? kAbcLutDepthScript
+                                                        : kAbcGateDepthScript);
+  }
+  llvm_unreachable("unknown synthesis objective");
+}
+
+// The number of gates on the longest path through an imported circuit. In
+// CGGI every gate but an inverter is a bootstrap, so this is the number of
+// sequential bootstraps when the gates of each level run in parallel.
+int64_t getCircuitDepth(func::FuncOp func) {
+  DenseMap<Value, int64_t> depths;
+  int64_t circuitDepth = 0;
+  func.walk([&](Operation *op) {
+    int64_t depth = 0;
+    for (Value operand : op->getOperands()) {
+      depth = std::max(depth, depths.lookup(operand));
+    }
+    if (isa<comb::CombDialect>(op->getDialect()) && !isa<comb::InvOp>(op)) {
+      ++depth;
+    }
+    for (Value result : op->getResults()) {
+      depths[result] = depth;
+    }
+    circuitDepth = std::max(circuitDepth, depth);
+  });
+  return circuitDepth;
+}
+
 int64_t countArithOps(Operation *op, ModuleOp moduleOp) {
   int64_t numArithOps = 0;
   auto isArithOp = [](Operation *op) -> bool {
@@ -137,43 +208,173 @@ int64_t countArithOps(Operation *op, ModuleOp moduleOp) {
   return numArithOps;
 }
 
+// One Yosys run: the script to execute on an emitted Verilog file, and the
+// cache entry that receives the synthesized netlist. The Verilog file and the
+// netlist are written to temporary files, which are removed along with the
+// job.
+struct SynthesisJob {
+  std::string script;
+  std::string netlistPath;
+  std::string tempNetlistPath;
+  std::unique_ptr<llvm::FileRemover> verilogRemover;
+  std::unique_ptr<llvm::FileRemover> tempNetlistRemover;
+};
+
+// Synthesize a circuit in the current process. The netlist is written to a
+// uniquely named file next to its cache entry, and only moved into place once
+// synthesis succeeded, so neither a crashed run nor another process
+// synthesizing the same circuit leaves a truncated entry behind.
+void runSynthesisJob(const SynthesisJob &job) {
+  Yosys::run_pass(job.script);
+  Yosys::run_pass("write_rtlil " + job.tempNetlistPath + ";");
+  Yosys::run_pass("delete;");
+}
+
+LogicalResult commitSynthesisJob(const SynthesisJob &job) {
+  return success(!llvm::sys::fs::rename(job.tempNetlistPath, job.netlistPath));
+}
+
+// A Yosys process synthesizing the circuit of a job, and the temporary file
+// holding its script.
+struct SynthesisWorker {
+  const SynthesisJob *job;
+  llvm::sys::ProcessInfo process;
+  std::unique_ptr<llvm::FileRemover> scriptRemover;
+};
+
+FailureOr<SynthesisWorker> startSynthesisWorker(const SynthesisJob &job,
+                                                StringRef yosysPath) {
+  SmallString<128> scriptPath;
+  int fd;
+  if (llvm::sys::fs::createTemporaryFile("heir-yosys", "ys", fd, scriptPath))
+    return failure();
+  auto scriptRemover = std::make_unique<llvm::FileRemover>(scriptPath);
+  {
+    llvm::raw_fd_ostream os(fd, /*shouldClose=*/true);
+    os << job.script << "\nwrite_rtlil " << job.tempNetlistPath << ";\n";
+  }
+
+  SmallVector<StringRef> args = {yosysPath, "-q", "-s", scriptPath};
+  llvm::sys::ProcessInfo process =
+      llvm::sys::ExecuteNoWait(yosysPath, args, /*Env=*/std::nullopt);
+  if (process.Pid == llvm::sys::ProcessInfo::InvalidPid) return failure();
+  return SynthesisWorker{&job, process, std::move(scriptRemover)};
+}
+
+// Run all jobs, at most numWorkers at a time. Yosys keeps its state in
+// globals, so concurrent syntheses run in separate Yosys processes rather
+// than threads. Without a Yosys binary, the jobs run in this process one
+// after another.
+LogicalResult runSynthesisJobs(ArrayRef<SynthesisJob> jobs, int numWorkers,
+                               StringRef yosysPath) {
+  if (numWorkers <= 1 || jobs.size() <= 1 || yosysPath.empty() ||
+      !llvm::sys::fs::can_execute(yosysPath)) {
+    for (const SynthesisJob &job : jobs) {
+      runSynthesisJob(job);
+      if (failed(commitSynthesisJob(job))) return failure();
+    }
+    return success();
+  }
+
+  bool succeeded = true;
+  std::deque<SynthesisWorker> running;
+  auto waitForOldestWorker = [&]() {
+    SynthesisWorker &worker = running.front();
+    std::string errorMessage;
+    llvm::sys::ProcessInfo result = llvm::sys::Wait(
+        worker.process, /*SecondsToWait=*/std::nullopt, &errorMessage);
+    if (result.ReturnCode != 0 || failed(commitSynthesisJob(*worker.job))) {
+      LLVM_DEBUG(llvm::dbgs() << "Yosys failed to synthesize "
+                              << worker.job->netlistPath << ": "
+                              << errorMessage << "\n");
+      succeeded = false;
+    }
+    running.pop_front();
+  };
+
+  for (const SynthesisJob &job : jobs) {
+    if (running.size() >= static_cast<size_t>(numWorkers))
+      waitForOldestWorker();
+    FailureOr<SynthesisWorker> worker = startSynthesisWorker(job, yosysPath);
+    if (failed(worker)) {
+      // Could not spawn a worker, synthesize in this process instead.
+      runSynthesisJob(job);
+      if (failed(commitSynthesisJob(job))) succeeded = false;
+      continue;
+    }
+    running.push_back(std::move(*worker));
+  }
+  while (!running.empty()) waitForOldestWorker();
+  return success(succeeded);
+}
+
 }  // namespace
 
 struct RelativeOptimizationStatistics {
   std::string originalOp;
   int64_t numArithOps;
   int64_t numCells;
+  int64_t depth = 0;
 };
 
 struct YosysOptimizer : public impl::YosysOptimizerBase<YosysOptimizer> {
   using YosysOptimizerBase::YosysOptimizerBase;
 
-  YosysOptimizer(std::string yosysFilesPath, std::string abcPath, bool abcFast,
-                 int unrollFactor, bool useSubmodules, Mode mode,
-                 bool printStats)
+  YosysOptimizer(std::string yosysFilesPath, std::string abcPath,
+                 std::string yosysPath, bool abcFast, int unrollFactor,
+                 bool useSubmodules, Mode mode, bool printStats,
+                 int numWorkers, std::string cacheDir,
+                 SynthesisObjective objective)
       : yosysFilesPath(std::move(yosysFilesPath)),
         abcPath(std::move(abcPath)),
+        yosysPath(std::move(yosysPath)),
         abcFast(abcFast),
         printStats(printStats),
         unrollFactor(unrollFactor),
         useSubmodules(useSubmodules),
-        mode(mode) {}
+        mode(mode),
+        numWorkers(numWorkers),
+        cacheDir(std::move(cacheDir)),
+        objective(objective) {}
 
   void runOnOperation() override;
 
-  LogicalResult runOnGenericOp(secret::GenericOp op);
+  // Emit the Verilog for a generic op and return the path of the netlist it
+  // synthesizes to, scheduling a synthesis job if the netlist is not cached
+  // yet. Returns an empty path if the op has nothing to optimize.
+  FailureOr<std::string> scheduleSynthesis(
+      secret::GenericOp op, StringRef netlistDir,
+      SmallVector<SynthesisJob> &jobs, llvm::StringSet<> &scheduled);
+
+  // Replace the body of a generic op with the synthesized netlist.
+  LogicalResult importNetlist(secret::GenericOp op, StringRef netlistPath,
+                              RelativeOptimizationStatistics *stats);
 
  private:
+  std::string getYosysScript(StringRef verilogPath) const;
+  // The Yosys script with the given paths to the techlibs and ABC binary.
+  std::string getYosysScript(StringRef verilogPath, StringRef yosysFilesDir,
+                             StringRef abcBinary) const;
+
   // Path to a directory containing yosys techlibs.
   std::string yosysFilesPath;
   // Path to ABC binary.
   std::string abcPath;
+  // Path to the Yosys binary that runs concurrent syntheses.
+  std::string yosysPath;
 
   bool abcFast;
   bool printStats;
   int unrollFactor;
   bool useSubmodules;
   Mode mode;
+  // The maximum number of syntheses run concurrently.
+  int numWorkers;
+  // Directory of synthesized netlists, keyed by a hash of the Verilog and the
+  // Yosys script. If empty, a temporary directory is used for a single run.
+  std::string cacheDir;
+  // Whether ABC minimizes the number of cells or the circuit depth.
+  SynthesisObjective objective;
   llvm::SmallVector<RelativeOptimizationStatistics> optStatistics;
 };
 
@@ -386,15 +587,36 @@ LogicalResult unrollAndMergeGenerics(Operation *op, int unrollFactor,
   return walkResult.wasInterrupted() ? failure() : success();
 }
 
-LogicalResult YosysOptimizer::runOnGenericOp(secret::GenericOp op) {
+std::string YosysOptimizer::getYosysScript(StringRef verilogPath) const {
+  return getYosysScript(verilogPath, yosysFilesPath, abcPath);
+}
+
+std::string YosysOptimizer::getYosysScript(StringRef verilogPath,
+                                           StringRef yosysFilesDir,
+                                           StringRef abcBinary) const {
+  std::string moduleName = "generic_body";
+  if (mode == Mode::Boolean) {
+    return llvm::formatv(kYosysBooleanTemplate.data(), verilogPath, moduleName,
+                         abcBinary, yosysFilesDir, abcFast ? "-fast" : "",
+                         getAbcScriptOption(mode, objective))
+        .str();
+  }
+  return llvm::formatv(kYosysLutTemplate.data(), verilogPath, moduleName,
+                       yosysFilesDir, abcBinary, abcFast ? "-fast" : "",
+                       getAbcScriptOption(mode, objective))
+      .str();
+}
+
+FailureOr<std::string> YosysOptimizer::scheduleSynthesis(
+    secret::GenericOp op, StringRef netlistDir,
+    SmallVector<SynthesisJob> &jobs, llvm::StringSet<> &scheduled) {
   std::string moduleName = "generic_body";
-  MLIRContext *context = op->getContext();
   auto moduleOp = op->getParentOfType<ModuleOp>();
   if (!moduleOp) return failure();
 
   // Count number of arith ops in the generic body
   int64_t numArithOps = countArithOps(op, moduleOp);
-  if (numArithOps == 0) return success();
+  if (numArithOps == 0) return std::string();
 
   optStatistics.push_back(RelativeOptimizationStatistics());
   auto &stats = optStatistics.back();
@@ -416,46 +638,74 @@ LogicalResult YosysOptimizer::runOnGenericOp(secret::GenericOp op) {
   // the instantiation of multiple rewrite patterns.
   LLVM_DEBUG(op.emitRemark() << "Emitting verilog for this op");
 
-  char *filename = std::tmpnam(nullptr);
-  std::error_code ec;
-  llvm::raw_fd_ostream of(filename, ec);
-  if (failed(translateToVerilog(op, of, moduleName,
-                                /*allowSecretOps=*/true)) ||
-      ec) {
+  std::string verilog;
+  llvm::raw_string_ostream verilogOs(verilog);
+  if (failed(translateToVerilog(op, verilogOs, moduleName,
+                                /*allowSecretOps=*/true))) {
     op.emitError() << "Failed to translate to verilog";
-    of.close();
     return failure();
   }
-  of.close();
-
-  LLVM_DEBUG({
-    std::string result;
-    llvm::raw_string_ostream os(result);
-    [[maybe_unused]] auto res =
-        translateToVerilog(op, os, moduleName, /*allowSecretOps=*/true);
-    llvm::dbgs() << "Emitted verilog:\n" << os.str() << "\n";
-  });
+  LLVM_DEBUG(llvm::dbgs() << "Emitted verilog:\n" << verilog << "\n");
+
+  // Identical circuits, e.g., the bodies of an unrolled loop, emit identical
+  // Verilog, so the netlist is keyed by a hash of the Verilog and the script
+  // (which includes the mode and ABC flags) and only synthesized once. The
+  // script is hashed with the file names of the techlibs and ABC, as their
+  // absolute paths change with the location of the runfiles.
+  llvm::SHA256 hasher;
+  hasher.update(verilog);
+  hasher.update(getYosysScript("<input>",
+                               llvm::sys::path::filename(yosysFilesPath),
+                               llvm::sys::path::filename(abcPath)));
+  std::string key = llvm::toHex(hasher.final(), /*LowerCase=*/true);
+
+  SmallString<128> netlistPath(netlistDir);
+  llvm::sys::path::append(netlistPath, key + ".rtlil");
+  if (llvm::sys::fs::exists(netlistPath) || scheduled.contains(key)) {
+    LLVM_DEBUG(llvm::dbgs() << "Reusing netlist " << netlistPath << "\n");
+    return std::string(netlistPath);
+  }
 
-  // Invoke Yosys to translate to a combinational circuit and optimize.
-  Yosys::log_errfile = stderr;
-  Yosys::log_error_stderr = true;
-  LLVM_DEBUG(Yosys::log_streams.push_back(&std::cout));
+  // Only the netlist is cached, the Verilog is removed after synthesis.
+  SmallString<128> verilogPath;
+  int fd;
+  if (std::error_code ec = llvm::sys::fs::createTemporaryFile(
+          "heir-yosys", "v", fd, verilogPath)) {
+    op.emitError() << "Failed to create a temporary verilog file: "
+                   << ec.message();
+    return failure();
+  }
+  auto verilogRemover = std::make_unique<llvm::FileRemover>(verilogPath);
+  {
+    llvm::raw_fd_ostream of(fd, /*shouldClose=*/true);
+    of << verilog;
+  }
 
-  LLVM_DEBUG(
-      llvm::dbgs() << "Using "
-                   << (mode == Mode::LUT ? "LUT cells" : "boolean gates"));
-  auto yosysTemplate =
-      llvm::formatv(kYosysLutTemplate.data(), filename, moduleName,
-                    yosysFilesPath, abcPath, abcFast ? "-fast" : "")
-          .str();
-  if (mode == Mode::Boolean) {
-    yosysTemplate =
-        llvm::formatv(kYosysBooleanTemplate.data(), filename, moduleName,
-                      abcPath, yosysFilesPath, abcFast ? "-fast" : "")
-            .str();
+  // Concurrent runs sharing a cache directory may synthesize the same
+  // netlist, so each writes it to its own file before renaming it into place.
+  SmallString<128> tempNetlistPath;
+  if (std::error_code ec = llvm::sys::fs::createUniqueFile(
+          Twine(netlistPath) + "-%%%%%%%%.tmp", tempNetlistPath)) {
+    op.emitError() << "Failed to create a temporary netlist file: "
+                   << ec.message();
+    return failure();
   }
+  auto tempNetlistRemover =
+      std::make_unique<llvm::FileRemover>(tempNetlistPath);
+
+  scheduled.insert(key);
+  jobs.push_back({getYosysScript(verilogPath), std::string(netlistPath),
+                  std::string(tempNetlistPath), std::move(verilogRemover),
+                  std::move(tempNetlistRemover)});
+  return std::string(netlistPath);
+}
 
-  Yosys::run_pass(yosysTemplate);
+LogicalResult YosysOptimizer::importNetlist(
+    secret::GenericOp op, StringRef netlistPath,
+    RelativeOptimizationStatistics *stats) {
+  MLIRContext *context = op->getContext();
+
+  Yosys::run_pass("read_rtlil " + netlistPath.str() + ";");
 
   // Translate Yosys result back to MLIR and insert into the func
   LLVM_DEBUG(Yosys::run_pass("dump;"));
@@ -469,7 +719,7 @@ LogicalResult YosysOptimizer::runOnGenericOp(secret::GenericOp op) {
   auto numCells = design->top_module()->cells().size();
   totalCircuitSize += numCells;
   if (printStats) {
-    stats.numCells = numCells;
+    stats->numCells = numCells;
   }
 
   LLVM_DEBUG(llvm::dbgs() << "Importing RTLIL module\n");
@@ -486,6 +736,12 @@ LogicalResult YosysOptimizer::runOnGenericOp(secret::GenericOp op) {
       })));
   Yosys::run_pass("delete;");
 
+  int64_t depth = getCircuitDepth(func);
+  totalCircuitDepth += depth;
+  if (printStats) {
+    stats->depth = depth;
+  }
+
   LLVM_DEBUG(llvm::dbgs() << "Done importing RTLIL, now type-coverting ops\n");
 
   // The pass changes the yielded value types, e.g., from an i8 to a
@@ -547,6 +803,8 @@ LogicalResult YosysOptimizer::runOnGenericOp(secret::GenericOp op) {
 // Optimize the body of a secret.generic op.
 void YosysOptimizer::runOnOperation() {
   Yosys::yosys_setup();
+  Yosys::log_errfile = stderr;
+  Yosys::log_error_stderr = true;
   auto *ctx = &getContext();
   auto *op = getOperation();
 
@@ -643,18 +901,67 @@ void YosysOptimizer::runOnOperation() {
     getOperation()->dump();
   });
 
+  SmallString<128> netlistDir(cacheDir);
+  bool useTemporaryDir = netlistDir.empty();
+  std::error_code ec =
+      useTemporaryDir
+          ? llvm::sys::fs::createUniqueDirectory("heir-yosys", netlistDir)
+          : llvm::sys::fs::create_directories(netlistDir);
+  if (ec) {
+    getOperation()->emitError() << "Failed to create netlist directory "
+                                << netlistDir << ": " << ec.message();
+    Yosys::yosys_shutdown();
+    signalPassFailure();
+    return;
+  }
+
+  // Emit every generic first, so that the distinct circuits can be
+  // synthesized concurrently.
+  SmallVector<SynthesisJob> jobs;
+  llvm::StringSet<> scheduled;
+  SmallVector<std::pair<secret::GenericOp, std::string>> netlists;
+  SmallVector<size_t> statsIndices;
   auto result = op->walk([&](secret::GenericOp op) {
     // Now pass through any constants used after capturing the ambient scope.
     // This way Yosys can optimize constants away instead of treating them as
     // variables to the optimized body.
     genericAbsorbConstants(op, builder);
 
-    if (failed(runOnGenericOp(op))) {
+    FailureOr<std::string> netlistPath =
+        scheduleSynthesis(op, netlistDir, jobs, scheduled);
+    if (failed(netlistPath)) {
       return WalkResult::interrupt();
     }
+    if (!netlistPath->empty()) {
+      netlists.push_back({op, *netlistPath});
+      statsIndices.push_back(optStatistics.size() - 1);
+    }
     return WalkResult::advance();
   });
+
+  LLVM_DEBUG(llvm::dbgs() << "Synthesizing " << jobs.size()
+                          << " distinct circuits for " << netlists.size()
+                          << " generics\n");
+  LLVM_DEBUG(Yosys::log_streams.push_back(&std::cout));
+  if (!result.wasInterrupted() &&
+      failed(runSynthesisJobs(jobs, numWorkers, yosysPath))) {
+    getOperation()->emitError() << "Yosys synthesis failed";
+    result = WalkResult::interrupt();
+  }
+
+  if (!result.wasInterrupted()) {
+    for (auto [netlist, statsIndex] : llvm::zip(netlists, statsIndices)) {
+      if (failed(importNetlist(netlist.first, netlist.second,
+                               &optStatistics[statsIndex]))) {
+        result = WalkResult::interrupt();
+        break;
+      }
+    }
+  }
   Yosys::yosys_shutdown();
+  if (useTemporaryDir) {
+    (void)llvm::sys::fs::remove_directories(netlistDir);
+  }
 
   if (printStats && !optStatistics.empty()) {
     for (auto &stats : optStatistics) {
@@ -663,7 +970,8 @@ void YosysOptimizer::runOnOperation() {
                    << stats.originalOp
                    << "\n\n  Starting arith op count: " << stats.numArithOps
                    << "\n  Ending cell count: " << stats.numCells
-                   << "\n  Ratio: " << ratio << "\n\n";
+                   << "\n  Ratio: " << ratio
+                   << "\n  Ending circuit depth: " << stats.depth << "\n\n";
     }
   }
 
@@ -673,22 +981,27 @@ void YosysOptimizer::runOnOperation() {
 }
 
 std::unique_ptr<mlir::Pass> createYosysOptimizer(
-    const std::string &yosysFilesPath, const std::string &abcPath, bool abcFast,
-    int unrollFactor, bool useSubmodules, Mode mode, bool printStats) {
-  return std::make_unique<YosysOptimizer>(yosysFilesPath, abcPath, abcFast,
-                                          unrollFactor, useSubmodules, mode,
-                                          printStats);
+    const std::string &yosysFilesPath, const std::string &abcPath,
+    const std::string &yosysPath, bool abcFast, int unrollFactor,
+    bool useSubmodules, Mode mode, bool printStats, int numWorkers,
+    const std::string &cacheDir, SynthesisObjective objective) {
+  return std::make_unique<YosysOptimizer>(
+      yosysFilesPath, abcPath, yosysPath, abcFast, unrollFactor, useSubmodules,
+      mode, printStats, numWorkers, cacheDir, objective);
 }
 
 void registerYosysOptimizerPipeline(const std::string &yosysFilesPath,
-                                    const std::string &abcPath) {
+                                    const std::string &abcPath,
+                                    const std::string &yosysPath) {
   PassPipelineRegistration<YosysOptimizerPipelineOptions>(
       "yosys-optimizer", "The yosys optimizer pipeline.",
-      [yosysFilesPath, abcPath](OpPassManager &pm,
-                                const YosysOptimizerPipelineOptions &options) {
+      [yosysFilesPath, abcPath, yosysPath](
+          OpPassManager &pm, const YosysOptimizerPipelineOptions &options) {
         pm.addPass(createYosysOptimizer(
-            yosysFilesPath, abcPath, options.abcFast, options.unrollFactor,
-            options.useSubmodules, options.mode, options.printStats));
+            yosysFilesPath, abcPath, yosysPath, options.abcFast,
+            options.unrollFactor, options.useSubmodules, options.mode,
+            options.printStats, options.numWorkers, options.cacheDir,
+            options.objective));
         pm.addPass(mlir::createCSEPass());
       });
 }
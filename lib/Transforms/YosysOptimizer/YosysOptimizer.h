@@ -13,10 +13,14 @@ namespace heir {
 
 enum Mode { Boolean, LUT };
 
+enum SynthesisObjective { Balanced, Area, Depth };
+
 std::unique_ptr<mlir::Pass> createYosysOptimizer(
-    const std::string &yosysFilesPath, const std::string &abcPath, bool abcFast,
-    int unrollFactor = 0, bool useSubmodules = true, Mode mode = LUT,
-    bool printStats = false);
+    const std::string &yosysFilesPath, const std::string &abcPath,
+    const std::string &yosysPath, bool abcFast, int unrollFactor = 0,
+    bool useSubmodules = true, Mode mode = LUT, bool printStats = false,
+    int numWorkers = 1, const std::string &cacheDir = "",
+    SynthesisObjective objective = SynthesisObjective::Balanced);
 
 #define GEN_PASS_DECL
 #include "lib/Transforms/YosysOptimizer/YosysOptimizer.h.inc"
@@ -46,17 +50,45 @@ struct YosysOptimizerPipelineOptions
       llvm::cl::values(clEnumVal(Boolean, "use boolean gates"),
                        clEnumVal(LUT, "use lookup tables"))};
 
+  PassOptions::Option<enum SynthesisObjective> objective{
+      *this, "objective",
+      llvm::cl::desc("What ABC optimizes for. In CGGI every gate is a "
+                     "bootstrap, so the cell count is the total work and the "
+                     "circuit depth is the latency when gates of a level run "
+                     "in parallel."),
+      llvm::cl::init(Balanced),
+      llvm::cl::values(
+          clEnumVal(Balanced, "Yosys' default ABC script"),
+          clEnumVal(Area, "minimize the number of cells"),
+          clEnumVal(Depth, "minimize the number of cells on the critical "
+                           "path"))};
+
   PassOptions::Option<bool> printStats{
       *this, "print-stats",
       llvm::cl::desc("Prints statistics about the optimized circuit"),
       llvm::cl::init(false)};
+
+  PassOptions::Option<int> numWorkers{
+      *this, "num-workers",
+      llvm::cl::desc("The maximum number of circuits synthesized concurrently, "
+                     "each in its own Yosys process. Default is 1."),
+      llvm::cl::init(1)};
+
+  PassOptions::Option<std::string> cacheDir{
+      *this, "cache-dir",
+      llvm::cl::desc("A directory in which synthesized netlists are cached "
+                     "across runs, keyed by a hash of the circuit and the "
+                     "Yosys script. If unset, netlists are only shared "
+                     "within a single run."),
+      llvm::cl::init("")};
 };
 
 // registerYosysOptimizerPipeline registers a Yosys pipeline pass using
-// runfiles, the location of Yosys techlib files, and abcPath, the location of
-// the abc binary.
+// runfiles, the location of Yosys techlib files, abcPath, the location of
+// the abc binary, and yosysPath, the location of the yosys binary.
 void registerYosysOptimizerPipeline(const std::string &yosysFilesPath,
-                                    const std::string &abcPath);
+                                    const std::string &abcPath,
+                                    const std::string &yosysPath);
 
 }  // namespace heir
 }  // namespace mlir
@@ -1,5 +1,6 @@
 #include "lib/Utils/AffineMapUtils.h"
 
+#include <algorithm>
 #include <cassert>
 #include <cstddef>
 #include <cstdint>
@@ -75,23 +76,36 @@ AffineMap getRowMajorLayoutMap(RankedTensorType inputType,
         result ? result + inputType.getDimSize(dim + 1) * dims[dim] : dims[dim];
   }
 
+  // When the data spans multiple ciphertexts, consecutive chunks of the
+  // flattened index fill consecutive ciphertexts:
+  // x -> (x floordiv numSlots, x mod numSlots).
+  if (outputType.getRank() == 2) {
+    int64_t numSlots = outputType.getDimSize(1);
+    AffineMap layout = AffineMap::get(
+        dims.size(), 0, {result.floorDiv(numSlots), result % numSlots},
+        inputType.getContext());
+    return simplifyAffineMap(layout);
+  }
+
   AffineMap layout = AffineMap::get(dims.size(), 0, {result});
   return simplifyAffineMap(layout);
 }
 
 bool isLayoutRowMajor(RankedTensorType inputType, RankedTensorType outputType,
                       const AffineMap &layout) {
-  // For now, only support 1D output; not sure what a "row major" multi-dim
-  // output would mean (the trailing input dims collapsed on the trailing
-  // output dim, with all other dims matching?).
-  if (outputType.getRank() != 1) return false;
+  // For now, only support a 1D output, or a 2D output whose first dimension
+  // indexes the ciphertext; not sure what a "row major" layout with more
+  // dims would mean (the trailing input dims collapsed on the trailing output
+  // dim, with all other dims matching?).
+  if (outputType.getRank() != 1 && outputType.getRank() != 2) return false;
 
   AffineMap expected = getRowMajorLayoutMap(inputType, outputType);
+  auto simplified = simplifyAffineMap(layout);
+  if (outputType.getRank() == 2) return simplified == expected;
+
   AffineMap expected2 =
       AffineMap::get(expected.getNumDims(), 0,
                      {expected.getResults()[0] % outputType.getNumElements()});
-  auto simplified = simplifyAffineMap(layout);
-
   return (simplified == expected || simplified == expected2);
 }
 
@@ -117,6 +131,98 @@ bool isLayoutSquatDiagonal(RankedTensorType inputType,
   return simplified == expected;
 }
 
+AffineMap getTiledDiagonalLayoutMap(RankedTensorType inputType,
+                                    int64_t ciphertextSize) {
+  int64_t numRows = inputType.getDimSize(0);
+  int64_t numCols = inputType.getDimSize(1);
+  int64_t blockRows = std::min(numRows, ciphertextSize);
+  int64_t numColBlocks = numCols / ciphertextSize;
+  AffineExpr i, j;
+  bindDims(inputType.getContext(), i, j);
+  // The block (i floordiv blockRows, j floordiv ciphertextSize) occupies
+  // blockRows consecutive ciphertexts, and within the block the entries are
+  // laid out in the squat diagonal layout.
+  AffineExpr blockIndex =
+      i.floorDiv(blockRows) * numColBlocks + j.floorDiv(ciphertextSize);
+  AffineExpr row = blockIndex * blockRows + j % blockRows;
+  AffineExpr slot = (i % blockRows + j % ciphertextSize) % ciphertextSize;
+  AffineMap layout =
+      AffineMap::get(2, 0, {row, slot}, inputType.getContext());
+  return simplifyAffineMap(layout);
+}
+
+bool isLayoutTiledDiagonal(RankedTensorType inputType,
+                           RankedTensorType outputType,
+                           const AffineMap &layout) {
+  if (outputType.getRank() != 2 || inputType.getRank() != 2) return false;
+  int64_t ciphertextSize = outputType.getDimSize(1);
+  if (inputType.getDimSize(1) % ciphertextSize != 0) return false;
+  auto simplified = simplifyAffineMap(layout);
+  auto expected = getTiledDiagonalLayoutMap(inputType, ciphertextSize);
+  return simplified == expected;
+}
+
+AffineMap getRotatedReplicasLayoutMap(int64_t vectorSize, int64_t numCopies,
+                                      MLIRContext *context) {
+  int64_t blockSize = 2 * vectorSize;
+  int64_t stride = vectorSize / numCopies;
+  AffineExpr copy, i;
+  bindDims(context, copy, i);
+  // Entry i of copy j lands in slot 2nj + (i - j * stride) mod 2n, so slot s
+  // of block j holds entry (s + j * stride) mod n.
+  AffineMap layout = AffineMap::get(
+      2, 0, {copy * blockSize + (i - copy * stride) % blockSize}, context);
+  return simplifyAffineMap(layout);
+}
+
+AffineMap getReplicatedDiagonalLayoutMap(RankedTensorType inputType,
+                                         int64_t numCopies) {
+  int64_t n = inputType.getDimSize(0);
+  int64_t numCiphertexts = n / numCopies;
+  AffineExpr i, j;
+  bindDims(inputType.getContext(), i, j);
+  AffineExpr diagonal = (j - i) % n;
+  AffineExpr slot = diagonal.floorDiv(numCiphertexts) * (2 * n) + i;
+  AffineMap layout = AffineMap::get(2, 0, {diagonal % numCiphertexts, slot},
+                                    inputType.getContext());
+  return simplifyAffineMap(layout);
+}
+
+bool isLayoutReplicatedDiagonal(RankedTensorType inputType,
+                                RankedTensorType outputType,
+                                const AffineMap &layout) {
+  if (outputType.getRank() != 2 || inputType.getRank() != 2) return false;
+  int64_t n = inputType.getDimSize(0);
+  int64_t numCiphertexts = outputType.getDimSize(0);
+  if (inputType.getDimSize(1) != n || n % numCiphertexts != 0) return false;
+  auto simplified = simplifyAffineMap(layout);
+  auto expected =
+      getReplicatedDiagonalLayoutMap(inputType, n / numCiphertexts);
+  return simplified == expected;
+}
+
+AffineMap getExtendedDiagonalLayoutMap(RankedTensorType inputType) {
+  int64_t n = inputType.getDimSize(1);
+  AffineExpr i, j;
+  bindDims(inputType.getContext(), i, j);
+  AffineMap layout =
+      AffineMap::get(2, 0, {(j - i) % n, i}, inputType.getContext());
+  return simplifyAffineMap(layout);
+}
+
+bool isLayoutExtendedDiagonal(RankedTensorType inputType,
+                              RankedTensorType outputType,
+                              const AffineMap &layout) {
+  if (outputType.getRank() != 2 || inputType.getRank() != 2) return false;
+  if (outputType.getDimSize(0) != inputType.getDimSize(1) ||
+      outputType.getDimSize(1) < inputType.getDimSize(0)) {
+    return false;
+  }
+  auto simplified = simplifyAffineMap(layout);
+  auto expected = getExtendedDiagonalLayoutMap(inputType);
+  return simplified == expected;
+}
+
 inline Attribute getIndexAttr(MLIRContext *ctx, int64_t value) {
   return IntegerAttr::get(IndexType::get(ctx), value);
 }
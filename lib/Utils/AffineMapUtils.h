@@ -56,6 +56,50 @@ bool isLayoutSquatDiagonal(RankedTensorType inputType,
                            RankedTensorType outputType,
                            const AffineMap &layout);
 
+// Returns the layout that splits a matrix into blocks of
+// min(numRows, ciphertextSize) rows and ciphertextSize columns, each laid out
+// in the squat diagonal layout in its own consecutive run of ciphertexts.
+// Blocks are ordered row-major. Requires numCols to be a multiple of
+// ciphertextSize.
+AffineMap getTiledDiagonalLayoutMap(RankedTensorType inputType,
+                                    int64_t ciphertextSize);
+
+bool isLayoutTiledDiagonal(RankedTensorType inputType,
+                           RankedTensorType outputType,
+                           const AffineMap &layout);
+
+// Returns the layout of numCopies rotated replicas of a vector of size n,
+// each in its own block of 2n slots. Block j holds the vector rotated left by
+// j * (n / numCopies), twice in a row, so that rotating the whole ciphertext
+// left by less than n rotates the first n slots of every block cyclically.
+//
+// The map is defined on the aligned `tensor<numCopies x 2n>` whose rows are
+// copies of the (twice repeated) vector, i.e., an alignment with in = [n],
+// insertedDims = [0] and out = [numCopies, 2n].
+AffineMap getRotatedReplicasLayoutMap(int64_t vectorSize, int64_t numCopies,
+                                      MLIRContext *context);
+
+// Returns the layout of an n x n matrix matching
+// getRotatedReplicasLayoutMap: the diagonal d = j * (n / numCopies) + r,
+// whose entry i is M[i][(i + d) mod n], is stored in slots [2nj, 2nj + n) of
+// ciphertext r. There are n / numCopies ciphertexts.
+AffineMap getReplicatedDiagonalLayoutMap(RankedTensorType inputType,
+                                         int64_t numCopies);
+
+bool isLayoutReplicatedDiagonal(RankedTensorType inputType,
+                                RankedTensorType outputType,
+                                const AffineMap &layout);
+
+// Returns the layout of an m x n matrix as n extended diagonals: the diagonal
+// d, whose entry i is M[i][(i + d) mod n], is stored in the first m slots of
+// ciphertext d. Unlike the squat diagonal layout, m may exceed n, and the
+// matrix is expected to be zero-padded to powers of two by its alignment.
+AffineMap getExtendedDiagonalLayoutMap(RankedTensorType inputType);
+
+bool isLayoutExtendedDiagonal(RankedTensorType inputType,
+                              RankedTensorType outputType,
+                              const AffineMap &layout);
+
 template void printPermutation(::llvm::ArrayRef<int64_t>,
                                ::llvm::raw_ostream &);
 template void printPermutation(::llvm::ArrayRef<int64_t>, ::mlir::Diagnostic &);
@@ -0,0 +1,193 @@
+#include "lib/Utils/Approximation/CompositeApproximation.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+#include "Eigen/Core"   // from @eigen
+#include "Eigen/Dense"  // from @eigen
+#include "lib/Utils/Approximation/Chebyshev.h"
+#include "lib/Utils/Polynomial/Polynomial.h"
+#include "llvm/include/llvm/ADT/APFloat.h"      // from @llvm-project
+#include "llvm/include/llvm/ADT/SmallVector.h"  // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"     // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace approximation {
+
+using ::Eigen::MatrixXd;
+using ::Eigen::VectorXd;
+using ::llvm::APFloat;
+using ::llvm::SmallVector;
+using ::mlir::heir::polynomial::FloatPolynomial;
+
+// When we move to C++20, we can use std::numbers::pi
+inline constexpr double kPi = 3.14159265358979323846;
+
+// The number of points on which the Remez error function is sampled.
+constexpr int64_t kNumGridPoints = 2000;
+constexpr int64_t kMaxRemezIterations = 100;
+
+namespace {
+
+// Evaluate sum_j coeffs[j] T_j(s) using the three-term recurrence.
+double evalChebyshevSeries(const VectorXd &coeffs, double s) {
+  double result = coeffs(0);
+  double prev = 1.0;
+  double curr = s;
+  for (int64_t j = 1; j < coeffs.size(); ++j) {
+    result += coeffs(j) * curr;
+    double next = 2 * s * curr - prev;
+    prev = curr;
+    curr = next;
+  }
+  return result;
+}
+
+int64_t depthOfDegree(int64_t degree) {
+  return static_cast<int64_t>(std::ceil(std::log2(degree + 1)));
+}
+
+}  // namespace
+
+FloatPolynomial oddSignMinimaxApproximation(double epsilon, int64_t degree,
+                                            double &maxError) {
+  assert(degree % 2 == 1 && "degree must be odd");
+  assert(epsilon > 0 && epsilon < 1 && "epsilon must be in (0, 1)");
+
+  // Substituting t = x^2, we want q of degree m minimizing
+  // max |1 - sqrt(t) q(t)| over t in [a, b]. q is represented in the
+  // Chebyshev basis of s, the affine image of t in [-1, 1].
+  int64_t m = (degree - 1) / 2;
+  double a = epsilon * epsilon;
+  double b = 1.0;
+  auto toT = [&](double s) { return (a + b) / 2 + (b - a) / 2 * s; };
+
+  SmallVector<double> grid;
+  grid.reserve(kNumGridPoints);
+  for (int64_t i = 0; i < kNumGridPoints; ++i) {
+    grid.push_back(-std::cos(kPi * i / (kNumGridPoints - 1)));
+  }
+
+  // Start from the Chebyshev extrema, which are optimal for the unweighted
+  // problem.
+  SmallVector<double> reference;
+  for (int64_t i = 0; i < m + 2; ++i) {
+    reference.push_back(-std::cos(kPi * i / (m + 1)));
+  }
+
+  VectorXd coeffs = VectorXd::Zero(m + 1);
+  SmallVector<double> errors(kNumGridPoints);
+  maxError = 1.0;
+  for (int64_t iter = 0; iter < kMaxRemezIterations; ++iter) {
+    // Solve sqrt(t_i) q(t_i) + (-1)^i E = 1 for the coefficients of q and the
+    // levelled error E.
+    MatrixXd system(m + 2, m + 2);
+    for (int64_t i = 0; i < m + 2; ++i) {
+      double s = reference[i];
+      double weight = std::sqrt(toT(s));
+      double prev = 1.0;
+      double curr = s;
+      system(i, 0) = weight;
+      for (int64_t j = 1; j <= m; ++j) {
+        system(i, j) = weight * curr;
+        double next = 2 * s * curr - prev;
+        prev = curr;
+        curr = next;
+      }
+      system(i, m + 1) = (i % 2 == 0) ? 1.0 : -1.0;
+    }
+    VectorXd solution = system.partialPivLu().solve(VectorXd::Ones(m + 2));
+    coeffs = solution.head(m + 1);
+    double levelledError = std::abs(solution(m + 1));
+
+    maxError = 0.0;
+    for (int64_t i = 0; i < kNumGridPoints; ++i) {
+      double s = grid[i];
+      errors[i] = 1.0 - std::sqrt(toT(s)) * evalChebyshevSeries(coeffs, s);
+      maxError = std::max(maxError, std::abs(errors[i]));
+    }
+    if (maxError - levelledError <= 1e-9 * maxError) break;
+
+    // Exchange: take the extremum of each run of same-signed errors, then
+    // trim the runs at the ends with the smallest extrema.
+    SmallVector<int64_t> extrema;
+    for (int64_t i = 0; i < kNumGridPoints;) {
+      int64_t best = i;
+      int64_t j = i;
+      for (; j < kNumGridPoints && (errors[j] >= 0) == (errors[i] >= 0); ++j) {
+        if (std::abs(errors[j]) > std::abs(errors[best])) best = j;
+      }
+      extrema.push_back(best);
+      i = j;
+    }
+    if (extrema.size() < static_cast<size_t>(m + 2)) break;
+    while (extrema.size() > static_cast<size_t>(m + 2)) {
+      if (std::abs(errors[extrema.front()]) < std::abs(errors[extrema.back()]))
+        extrema.erase(extrema.begin());
+      else
+        extrema.pop_back();
+    }
+    for (int64_t i = 0; i < m + 2; ++i) {
+      reference[i] = grid[extrema[i]];
+    }
+  }
+
+  // Convert q(s) to the monomial basis, substitute s = (2x^2 - (a+b)) / (b-a),
+  // and multiply by x.
+  SmallVector<APFloat> chebCoeffs;
+  for (int64_t j = 0; j <= m; ++j) {
+    chebCoeffs.push_back(APFloat(coeffs(j)));
+  }
+  FloatPolynomial q = chebyshevToMonomial(chebCoeffs);
+  FloatPolynomial s =
+      FloatPolynomial::fromCoefficients({-(a + b) / (b - a), 0.0, 2 / (b - a)});
+  return q.compose(s).monomialMul(1);
+}
+
+FailureOr<CompositeSignApproximation> compositeSignApproximation(
+    double epsilon, double errorTarget, int64_t degree, int64_t maxStages) {
+  CompositeSignApproximation result;
+  double currentEpsilon = epsilon;
+  for (int64_t stage = 0; stage < maxStages; ++stage) {
+    double error;
+    FloatPolynomial poly =
+        oddSignMinimaxApproximation(currentEpsilon, degree, error);
+    result.depth += depthOfDegree(degree);
+    if (error <= errorTarget) {
+      result.stages.push_back(poly);
+      result.maxError = error;
+      return result;
+    }
+
+    // The stage maps [epsilon, 1] into [1 - error, 1 + error]. Scale it so the
+    // next stage sees inputs in [(1 - error) / (1 + error), 1].
+    result.stages.push_back(poly.scale(APFloat(1.0 / (1.0 + error))));
+    currentEpsilon = (1.0 - error) / (1.0 + error);
+  }
+  return failure();
+}
+
+FailureOr<CompositeSignApproximation> optimizeCompositeSignApproximation(
+    double epsilon, double errorTarget, int64_t maxDegree) {
+  FailureOr<CompositeSignApproximation> best = failure();
+  int64_t bestTotalDegree = 0;
+  for (int64_t degree = 3; degree <= maxDegree; degree += 2) {
+    auto candidate = compositeSignApproximation(epsilon, errorTarget, degree);
+    if (failed(candidate)) continue;
+    int64_t totalDegree = degree * candidate->stages.size();
+    if (failed(best) || candidate->depth < best->depth ||
+        (candidate->depth == best->depth && totalDegree < bestTotalDegree)) {
+      best = candidate;
+      bestTotalDegree = totalDegree;
+    }
+  }
+  return best;
+}
+
+}  // namespace approximation
+}  // namespace heir
+}  // namespace mlir
@@ -0,0 +1,57 @@
+#ifndef LIB_UTILS_APPROXIMATION_COMPOSITEAPPROXIMATION_H_
+#define LIB_UTILS_APPROXIMATION_COMPOSITEAPPROXIMATION_H_
+
+#include <cstdint>
+
+#include "lib/Utils/Polynomial/Polynomial.h"
+#include "llvm/include/llvm/ADT/SmallVector.h"  // from @llvm-project
+#include "mlir/include/mlir/Support/LLVM.h"     // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace approximation {
+
+/// Construct the odd polynomial of the given odd degree that best approximates
+/// sign(x) in the minimax sense on [-1, -epsilon] U [epsilon, 1]. The maximum
+/// absolute error on that set is stored in the outparameter maxError.
+///
+/// The polynomial is computed with the Remez exchange algorithm applied to
+/// the equivalent weighted problem of approximating 1 / sqrt(t) by a
+/// polynomial q(t) of degree (degree - 1) / 2 on [epsilon^2, 1], with the
+/// result x * q(x^2) returned in the monomial basis.
+::mlir::heir::polynomial::FloatPolynomial oddSignMinimaxApproximation(
+    double epsilon, int64_t degree, double &maxError);
+
+/// A composite approximation of sign(x): a sequence of odd polynomials p_1,
+/// ..., p_k such that p_k(...(p_1(x))) is within maxError of sign(x) for all
+/// epsilon <= |x| <= 1.
+struct CompositeSignApproximation {
+  ::llvm::SmallVector<::mlir::heir::polynomial::FloatPolynomial> stages;
+  double maxError = 1.0;
+  /// The multiplicative depth of evaluating all stages, assuming a degree d
+  /// polynomial costs ceil(log2(d + 1)) levels.
+  int64_t depth = 0;
+};
+
+/// Construct a composite approximation of sign(x) on [-1, -epsilon] U
+/// [epsilon, 1] from odd minimax stages of the given degree, adding stages
+/// until the error is at most errorTarget. Each stage but the last is scaled
+/// so that its output lies in [-1, 1]. Fails if maxStages is exceeded.
+///
+/// Cf. Lee, Lee, Kim, No, "Minimax Approximation of Sign Function by Composite
+/// Polynomial for Homomorphic Comparison" https://eprint.iacr.org/2020/834
+FailureOr<CompositeSignApproximation> compositeSignApproximation(
+    double epsilon, double errorTarget, int64_t degree, int64_t maxStages = 32);
+
+/// Construct the composite approximation of sign(x) with the smallest
+/// multiplicative depth among all odd per-stage degrees in [3, maxDegree],
+/// breaking ties by the sum of the stage degrees (a proxy for the number of
+/// ciphertext multiplications).
+FailureOr<CompositeSignApproximation> optimizeCompositeSignApproximation(
+    double epsilon, double errorTarget, int64_t maxDegree = 15);
+
+}  // namespace approximation
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_UTILS_APPROXIMATION_COMPOSITEAPPROXIMATION_H_
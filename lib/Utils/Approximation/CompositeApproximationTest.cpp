@@ -0,0 +1,81 @@
+#include <cmath>
+#include <cstdint>
+
+#include "gmock/gmock.h"  // from @googletest
+#include "gtest/gtest.h"  // from @googletest
+#include "lib/Utils/Approximation/CompositeApproximation.h"
+#include "lib/Utils/Polynomial/Polynomial.h"
+#include "mlir/include/mlir/Support/LLVM.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace approximation {
+namespace {
+
+using ::mlir::heir::polynomial::FloatPolynomial;
+using ::testing::DoubleNear;
+using ::testing::Le;
+
+double evaluate(const FloatPolynomial& poly, double x) {
+  double result = 0.0;
+  for (const auto& term : poly.getTerms()) {
+    result += term.getCoefficient().convertToDouble() *
+              std::pow(x, term.getExponent().getZExtValue());
+  }
+  return result;
+}
+
+double evaluate(const CompositeSignApproximation& approx, double x) {
+  for (const FloatPolynomial& stage : approx.stages) {
+    x = evaluate(stage, x);
+  }
+  return x;
+}
+
+TEST(CompositeApproximationTest, OddSignMinimaxIsOdd) {
+  double maxError;
+  FloatPolynomial poly = oddSignMinimaxApproximation(0.1, 7, maxError);
+  for (const auto& term : poly.getTerms()) {
+    EXPECT_EQ(term.getExponent().getZExtValue() % 2, 1u);
+  }
+  EXPECT_EQ(poly.getDegree(), 7u);
+}
+
+TEST(CompositeApproximationTest, OddSignMinimaxEquioscillates) {
+  double maxError;
+  FloatPolynomial poly = oddSignMinimaxApproximation(0.5, 3, maxError);
+  EXPECT_THAT(maxError, Le(0.1));
+  // The error is maximal at both ends of [epsilon, 1], with opposite signs.
+  EXPECT_THAT(std::abs(1.0 - evaluate(poly, 0.5)), DoubleNear(maxError, 1e-6));
+  EXPECT_THAT(std::abs(1.0 - evaluate(poly, 1.0)), DoubleNear(maxError, 1e-6));
+  EXPECT_THAT(evaluate(poly, -1.0), DoubleNear(-evaluate(poly, 1.0), 1e-12));
+}
+
+TEST(CompositeApproximationTest, CompositeMeetsErrorTarget) {
+  auto approx = compositeSignApproximation(0.01, 1e-3, 7);
+  ASSERT_TRUE(succeeded(approx));
+  EXPECT_GT(approx->stages.size(), 1u);
+  EXPECT_THAT(approx->maxError, Le(1e-3));
+  for (int64_t i = 0; i <= 1000; ++i) {
+    double x = 0.01 + 0.99 * i / 1000;
+    EXPECT_THAT(evaluate(*approx, x), DoubleNear(1.0, 1.01e-3));
+    EXPECT_THAT(evaluate(*approx, -x), DoubleNear(-1.0, 1.01e-3));
+  }
+}
+
+TEST(CompositeApproximationTest, OptimizerMinimizesDepth) {
+  auto optimized = optimizeCompositeSignApproximation(0.01, 1e-3, 15);
+  ASSERT_TRUE(succeeded(optimized));
+  EXPECT_THAT(optimized->maxError, Le(1e-3));
+  for (int64_t degree = 3; degree <= 15; degree += 2) {
+    auto fixed = compositeSignApproximation(0.01, 1e-3, degree);
+    if (succeeded(fixed)) {
+      EXPECT_LE(optimized->depth, fixed->depth);
+    }
+  }
+}
+
+}  // namespace
+}  // namespace approximation
+}  // namespace heir
+}  // namespace mlir
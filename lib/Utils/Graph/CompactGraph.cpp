@@ -0,0 +1,159 @@
+#include "lib/Utils/Graph/CompactGraph.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+#include "llvm/include/llvm/ADT/ArrayRef.h"           // from @llvm-project
+#include "llvm/include/llvm/ADT/STLExtras.h"          // from @llvm-project
+#include "mlir/include/mlir/Support/LogicalResult.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace graph {
+
+void CompactGraph::build() {
+  if (built) return;
+
+  // Keep the edges of the previous build, now that new vertices and edges may
+  // have been added.
+  int64_t numOldVertices = outOffsets.size() - 1;
+  for (VertexId source = 0; source < numOldVertices; ++source) {
+    for (int64_t i = outOffsets[source]; i < outOffsets[source + 1]; ++i) {
+      pendingEdges.emplace_back(source, outTargets[i]);
+    }
+  }
+
+  // Counting sort of the edges by source.
+  outOffsets.assign(numVertices + 1, 0);
+  for (auto [source, target] : pendingEdges) {
+    ++outOffsets[source + 1];
+  }
+  for (VertexId v = 0; v < numVertices; ++v) {
+    outOffsets[v + 1] += outOffsets[v];
+  }
+  outTargets.resize(pendingEdges.size());
+  std::vector<int64_t> next(outOffsets.begin(), outOffsets.end() - 1);
+  for (auto [source, target] : pendingEdges) {
+    outTargets[next[source]++] = target;
+  }
+  pendingEdges.clear();
+  pendingEdges.shrink_to_fit();
+
+  // Sort each row, drop duplicate edges and compact the rows in place.
+  int64_t end = 0;
+  for (VertexId v = 0; v < numVertices; ++v) {
+    auto rowBegin = outTargets.begin() + outOffsets[v];
+    auto rowEnd = outTargets.begin() + outOffsets[v + 1];
+    std::sort(rowBegin, rowEnd);
+    rowEnd = std::unique(rowBegin, rowEnd);
+    outOffsets[v] = end;
+    end = std::move(rowBegin, rowEnd, outTargets.begin() + end) -
+          outTargets.begin();
+  }
+  outOffsets[numVertices] = end;
+  outTargets.resize(end);
+
+  // Transpose to find the edges into each vertex. Visiting the sources in
+  // increasing order leaves each row of the transpose sorted.
+  inOffsets.assign(numVertices + 1, 0);
+  for (VertexId target : outTargets) {
+    ++inOffsets[target + 1];
+  }
+  for (VertexId v = 0; v < numVertices; ++v) {
+    inOffsets[v + 1] += inOffsets[v];
+  }
+  inSources.resize(outTargets.size());
+  next.assign(inOffsets.begin(), inOffsets.end() - 1);
+  for (VertexId source = 0; source < numVertices; ++source) {
+    for (int64_t i = outOffsets[source]; i < outOffsets[source + 1]; ++i) {
+      inSources[next[outTargets[i]]++] = source;
+    }
+  }
+
+  built = true;
+}
+
+llvm::ArrayRef<CompactGraph::VertexId> CompactGraph::edgesOutOf(
+    VertexId vertex) {
+  if (!contains(vertex)) return {};
+  build();
+  return llvm::ArrayRef<VertexId>(outTargets)
+      .slice(outOffsets[vertex], outOffsets[vertex + 1] - outOffsets[vertex]);
+}
+
+llvm::ArrayRef<CompactGraph::VertexId> CompactGraph::edgesInto(
+    VertexId vertex) {
+  if (!contains(vertex)) return {};
+  build();
+  return llvm::ArrayRef<VertexId>(inSources)
+      .slice(inOffsets[vertex], inOffsets[vertex + 1] - inOffsets[vertex]);
+}
+
+FailureOr<std::vector<CompactGraph::VertexId>>
+CompactGraph::topologicalSort() {
+  build();
+  std::vector<VertexId> result;
+  result.reserve(numVertices);
+
+  // Kahn's algorithm
+  std::vector<VertexId> active;
+  std::vector<int64_t> edgeCount(numVertices);
+  for (VertexId vertex = 0; vertex < numVertices; ++vertex) {
+    edgeCount[vertex] = inOffsets[vertex + 1] - inOffsets[vertex];
+    if (edgeCount[vertex] == 0) {
+      active.push_back(vertex);
+    }
+  }
+
+  while (!active.empty()) {
+    VertexId source = active.back();
+    active.pop_back();
+    result.push_back(source);
+    for (int64_t i = outOffsets[source]; i < outOffsets[source + 1]; ++i) {
+      VertexId target = outTargets[i];
+      if (--edgeCount[target] == 0) {
+        active.push_back(target);
+      }
+    }
+  }
+
+  if (result.size() != static_cast<size_t>(numVertices)) {
+    return failure();
+  }
+
+  return result;
+}
+
+FailureOr<std::vector<std::vector<CompactGraph::VertexId>>>
+CompactGraph::sortGraphByLevels() {
+  auto result = topologicalSort();
+  if (failed(result)) {
+    return failure();
+  }
+
+  // Working backwards from the outputs, the level of each vertex counted from
+  // the outputs is one more than the maximum level of its targets.
+  std::vector<int> levels(numVertices, 0);
+  int maxLevel = 0;
+  for (VertexId vertex : llvm::reverse(result.value())) {
+    int maxTargetLevel = -1;
+    for (int64_t i = outOffsets[vertex]; i < outOffsets[vertex + 1]; ++i) {
+      maxTargetLevel = std::max(maxTargetLevel, levels[outTargets[i]]);
+    }
+    levels[vertex] = 1 + maxTargetLevel;
+    maxLevel = std::max(levels[vertex], maxLevel);
+  }
+
+  // Reverse the levels, such that input vertices have smaller level values.
+  std::vector<std::vector<VertexId>> output(maxLevel + 1);
+  for (VertexId vertex = 0; vertex < numVertices; ++vertex) {
+    output[maxLevel - levels[vertex]].push_back(vertex);
+  }
+  return output;
+}
+
+}  // namespace graph
+}  // namespace heir
+}  // namespace mlir
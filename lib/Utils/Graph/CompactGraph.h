@@ -0,0 +1,211 @@
+#ifndef LIB_UTILS_GRAPH_COMPACTGRAPH_H_
+#define LIB_UTILS_GRAPH_COMPACTGRAPH_H_
+
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "llvm/include/llvm/ADT/ArrayRef.h"           // from @llvm-project
+#include "mlir/include/mlir/Support/LogicalResult.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace graph {
+
+// A directed graph on the dense vertex ids 0, 1, ..., size() - 1, stored in
+// compressed sparse row (CSR) form.
+//
+// Unlike `Graph`, which keeps ordered sets of edges per vertex and copies
+// them on every query, this graph keeps each vertex's sorted edges in one
+// contiguous array, which is meant for large graphs such as gate-level
+// netlists. Edges are buffered by `addEdge`, and the CSR arrays are rebuilt
+// by the first query after a change. Duplicate edges are stored once.
+class CompactGraph {
+ public:
+  using VertexId = int32_t;
+
+  CompactGraph() = default;
+  explicit CompactGraph(VertexId numVertices)
+      : numVertices(numVertices),
+        outOffsets(numVertices + 1, 0),
+        inOffsets(numVertices + 1, 0) {}
+
+  // Adds a vertex to the graph and returns its id, which is the number of
+  // vertices added before it.
+  VertexId addVertex() {
+    built = false;
+    return numVertices++;
+  }
+
+  // Adds an edge from the given `source` to the given `target`. Returns false
+  // if either the source or target is not a vertex of the graph, and returns
+  // true otherwise. The graph is unchanged if false is returned.
+  bool addEdge(VertexId source, VertexId target) {
+    if (!contains(source) || !contains(target)) {
+      return false;
+    }
+    pendingEdges.emplace_back(source, target);
+    built = false;
+    return true;
+  }
+
+  bool contains(VertexId vertex) const {
+    return 0 <= vertex && vertex < numVertices;
+  }
+
+  bool empty() const { return numVertices == 0; }
+
+  VertexId size() const { return numVertices; }
+
+  // Returns the targets of the edges out of the given vertex in increasing
+  // order. The result is invalidated by adding vertices or edges.
+  llvm::ArrayRef<VertexId> edgesOutOf(VertexId vertex);
+
+  // Returns the sources of the edges into the given vertex in increasing
+  // order. The result is invalidated by adding vertices or edges.
+  llvm::ArrayRef<VertexId> edgesInto(VertexId vertex);
+
+  // Returns a topological sort of the vertices if the graph is acyclic,
+  // otherwise returns failure(). The order is the same as that of
+  // `Graph<VertexId>::topologicalSort` on the same vertices and edges.
+  FailureOr<std::vector<VertexId>> topologicalSort();
+
+  // Find the level of each vertex, where the level is the length of the
+  // longest path from any input vertex to that vertex, as in
+  // `Graph::sortGraphByLevels`. The vertices of each level are in increasing
+  // order.
+  FailureOr<std::vector<std::vector<VertexId>>> sortGraphByLevels();
+
+ private:
+  // Merge the pending edges into the CSR arrays.
+  void build();
+
+  VertexId numVertices = 0;
+  bool built = true;
+  std::vector<std::pair<VertexId, VertexId>> pendingEdges;
+
+  // The targets of the edges out of vertex v are
+  // outTargets[outOffsets[v]:outOffsets[v + 1]], and likewise for the sources
+  // of the edges into v.
+  std::vector<int64_t> outOffsets = {0};
+  std::vector<VertexId> outTargets;
+  std::vector<int64_t> inOffsets = {0};
+  std::vector<VertexId> inSources;
+};
+
+// A `CompactGraph` whose vertices are values of type `V`, which are assigned
+// dense ids in the order they are added.
+//
+// Parameter `V` is the vertex type, which must be hashable with `Hash`. Each
+// vertex is stored once, in the map from vertices to ids.
+template <typename V, typename Hash = std::hash<V>>
+class IdMappedGraph {
+ public:
+  using VertexId = CompactGraph::VertexId;
+
+  IdMappedGraph() = default;
+  // The id-to-vertex table points into the vertex-to-id map, so copies would
+  // point into the original. Moves keep the map's nodes and are safe.
+  IdMappedGraph(const IdMappedGraph&) = delete;
+  IdMappedGraph& operator=(const IdMappedGraph&) = delete;
+  IdMappedGraph(IdMappedGraph&&) = default;
+  IdMappedGraph& operator=(IdMappedGraph&&) = default;
+
+  // Adds a vertex to the graph if it is not already present, and returns its
+  // id.
+  VertexId addVertex(const V& vertex) {
+    auto [it, inserted] = ids.try_emplace(vertex, graph.size());
+    if (inserted) {
+      graph.addVertex();
+      vertices.push_back(&it->first);
+    }
+    return it->second;
+  }
+
+  // Adds an edge from the given `source` to the given `target`. Returns false
+  // if either the source or target is not a previously inserted vertex, and
+  // returns true otherwise. The graph is unchanged if false is returned.
+  bool addEdge(const V& source, const V& target) {
+    auto sourceIt = ids.find(source);
+    auto targetIt = ids.find(target);
+    if (sourceIt == ids.end() || targetIt == ids.end()) {
+      return false;
+    }
+    return graph.addEdge(sourceIt->second, targetIt->second);
+  }
+
+  bool contains(const V& vertex) const { return ids.count(vertex) > 0; }
+
+  bool empty() const { return graph.empty(); }
+
+  VertexId size() const { return graph.size(); }
+
+  VertexId getId(const V& vertex) const { return ids.at(vertex); }
+
+  const V& getVertex(VertexId id) const { return *vertices[id]; }
+
+  // The underlying graph, for queries and edge insertion by id.
+  CompactGraph& getGraph() { return graph; }
+
+  // Returns the vertices the edges out of the given vertex point to, in
+  // increasing order of their ids.
+  std::vector<V> edgesOutOf(const V& vertex) {
+    if (!contains(vertex)) return {};
+    return toVertices(graph.edgesOutOf(getId(vertex)));
+  }
+
+  // Returns the vertices of the edges into the given vertex, in increasing
+  // order of their ids.
+  std::vector<V> edgesInto(const V& vertex) {
+    if (!contains(vertex)) return {};
+    return toVertices(graph.edgesInto(getId(vertex)));
+  }
+
+  // Returns a topological sort of the vertices if the graph is acyclic,
+  // otherwise returns failure().
+  FailureOr<std::vector<V>> topologicalSort() {
+    auto result = graph.topologicalSort();
+    if (failed(result)) {
+      return failure();
+    }
+    return toVertices(result.value());
+  }
+
+  // Find the level of each vertex, as in `CompactGraph::sortGraphByLevels`.
+  // The vertices of each level are in the order they were added to the
+  // graph.
+  FailureOr<std::vector<std::vector<V>>> sortGraphByLevels() {
+    auto result = graph.sortGraphByLevels();
+    if (failed(result)) {
+      return failure();
+    }
+    std::vector<std::vector<V>> levels;
+    levels.reserve(result.value().size());
+    for (llvm::ArrayRef<VertexId> level : result.value()) {
+      levels.push_back(toVertices(level));
+    }
+    return levels;
+  }
+
+ private:
+  std::vector<V> toVertices(llvm::ArrayRef<VertexId> vertexIds) const {
+    std::vector<V> result;
+    result.reserve(vertexIds.size());
+    for (VertexId id : vertexIds) {
+      result.push_back(getVertex(id));
+    }
+    return result;
+  }
+
+  CompactGraph graph;
+  std::unordered_map<V, VertexId, Hash> ids;
+  std::vector<const V*> vertices;
+};
+
+}  // namespace graph
+}  // namespace heir
+}  // namespace mlir
+
+#endif  // LIB_UTILS_GRAPH_COMPACTGRAPH_H_
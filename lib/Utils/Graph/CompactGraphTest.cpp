@@ -0,0 +1,134 @@
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "gmock/gmock.h"  // from @googletest
+#include "gtest/gtest.h"  // from @googletest
+#include "lib/Utils/Graph/CompactGraph.h"
+#include "lib/Utils/Graph/Graph.h"
+#include "mlir/include/mlir/Support/LogicalResult.h"  // from @llvm-project
+
+namespace mlir {
+namespace heir {
+namespace graph {
+namespace {
+
+using ::testing::ElementsAre;
+using ::testing::IsEmpty;
+
+TEST(CompactGraphTest, EdgesAreSortedAndDeduplicated) {
+  CompactGraph graph(4);
+  EXPECT_TRUE(graph.addEdge(0, 3));
+  EXPECT_TRUE(graph.addEdge(0, 1));
+  EXPECT_TRUE(graph.addEdge(0, 3));
+  EXPECT_TRUE(graph.addEdge(2, 1));
+  EXPECT_FALSE(graph.addEdge(0, 4));
+  EXPECT_FALSE(graph.addEdge(-1, 0));
+
+  EXPECT_THAT(graph.edgesOutOf(0), ElementsAre(1, 3));
+  EXPECT_THAT(graph.edgesOutOf(1), IsEmpty());
+  EXPECT_THAT(graph.edgesInto(1), ElementsAre(0, 2));
+  EXPECT_THAT(graph.edgesInto(3), ElementsAre(0));
+
+  // Edges added after a query are merged with the existing ones.
+  CompactGraph::VertexId vertex = graph.addVertex();
+  EXPECT_EQ(vertex, 4);
+  EXPECT_TRUE(graph.addEdge(0, 2));
+  EXPECT_TRUE(graph.addEdge(4, 0));
+  EXPECT_THAT(graph.edgesOutOf(0), ElementsAre(1, 2, 3));
+  EXPECT_THAT(graph.edgesInto(0), ElementsAre(4));
+  EXPECT_THAT(graph.edgesInto(1), ElementsAre(0, 2));
+}
+
+TEST(CompactGraphTest, SizedGraphWithoutEdges) {
+  CompactGraph graph(3);
+  EXPECT_THAT(graph.edgesOutOf(2), IsEmpty());
+  EXPECT_THAT(graph.edgesInto(0), IsEmpty());
+  auto sorted = graph.topologicalSort();
+  ASSERT_TRUE(succeeded(sorted));
+  EXPECT_THAT(sorted.value(), ElementsAre(2, 1, 0));
+  auto levels = graph.sortGraphByLevels();
+  ASSERT_TRUE(succeeded(levels));
+  EXPECT_THAT(levels.value(), ElementsAre(ElementsAre(0, 1, 2)));
+}
+
+TEST(CompactGraphTest, CyclicGraphHasNoSort) {
+  CompactGraph graph(3);
+  EXPECT_TRUE(graph.addEdge(0, 1));
+  EXPECT_TRUE(graph.addEdge(1, 2));
+  EXPECT_TRUE(graph.addEdge(2, 1));
+  EXPECT_TRUE(failed(graph.topologicalSort()));
+  EXPECT_TRUE(failed(graph.sortGraphByLevels()));
+}
+
+TEST(CompactGraphTest, MatchesGraphOnMultiInputGraph) {
+  // The multi-input example of LevelSortTest:
+  // 0 → 5 → 6 → 7 → 8 → 9 → 10
+  //     1 ↗    ↑    ↑   ↑
+  //         2 ↗     ↑   ↑
+  //             3 ↗     ↑
+  //                 4 ↗
+  std::vector<std::pair<int, int>> edges = {
+      {0, 5}, {1, 6}, {2, 7}, {3, 8}, {4, 9},
+      {5, 6}, {6, 7}, {7, 8}, {8, 9}, {9, 10}};
+  Graph<int> expected;
+  CompactGraph graph(11);
+  for (int i = 0; i < 11; ++i) expected.addVertex(i);
+  for (auto [source, target] : edges) {
+    expected.addEdge(source, target);
+    EXPECT_TRUE(graph.addEdge(source, target));
+  }
+
+  auto sorted = graph.topologicalSort();
+  EXPECT_TRUE(succeeded(sorted));
+  EXPECT_EQ(sorted.value(), expected.topologicalSort().value());
+
+  auto levelSorted = graph.sortGraphByLevels();
+  EXPECT_TRUE(succeeded(levelSorted));
+  EXPECT_EQ(levelSorted.value(), expected.sortGraphByLevels().value());
+  EXPECT_EQ(levelSorted.value().size(), 7);
+  EXPECT_THAT(levelSorted.value()[1], ElementsAre(1, 5));
+  EXPECT_THAT(levelSorted.value()[4], ElementsAre(4, 8));
+}
+
+TEST(IdMappedGraphTest, SimpleGraphLevelSort) {
+  //       ↗ b ↘
+  // a → c → d → e
+  //   ↘ → → → ↗
+  IdMappedGraph<std::string> graph;
+  EXPECT_EQ(graph.addVertex("a"), 0);
+  EXPECT_EQ(graph.addVertex("c"), 1);
+  EXPECT_EQ(graph.addVertex("b"), 2);
+  EXPECT_EQ(graph.addVertex("d"), 3);
+  EXPECT_EQ(graph.addVertex("e"), 4);
+  EXPECT_EQ(graph.addVertex("a"), 0);
+  EXPECT_EQ(graph.size(), 5);
+  EXPECT_TRUE(graph.addEdge("a", "c"));
+  EXPECT_TRUE(graph.addEdge("c", "b"));
+  EXPECT_TRUE(graph.addEdge("c", "d"));
+  EXPECT_TRUE(graph.addEdge("c", "e"));
+  EXPECT_TRUE(graph.addEdge("b", "e"));
+  EXPECT_TRUE(graph.addEdge("d", "e"));
+  EXPECT_FALSE(graph.addEdge("d", "f"));
+
+  EXPECT_THAT(graph.edgesOutOf("c"), ElementsAre("b", "d", "e"));
+  EXPECT_THAT(graph.edgesInto("e"), ElementsAre("c", "b", "d"));
+
+  auto sorted = graph.topologicalSort();
+  EXPECT_TRUE(succeeded(sorted));
+  EXPECT_THAT(sorted.value(), ElementsAre("a", "c", "d", "b", "e"));
+
+  auto levelSorted = graph.sortGraphByLevels();
+  EXPECT_TRUE(succeeded(levelSorted));
+  std::vector<std::vector<std::string>> levelUnwrapped = levelSorted.value();
+  EXPECT_EQ(levelUnwrapped.size(), 4);
+  EXPECT_THAT(levelUnwrapped[0], ElementsAre("a"));
+  EXPECT_THAT(levelUnwrapped[1], ElementsAre("c"));
+  EXPECT_THAT(levelUnwrapped[2], ElementsAre("b", "d"));
+  EXPECT_THAT(levelUnwrapped[3], ElementsAre("e"));
+}
+
+}  // namespace
+}  // namespace graph
+}  // namespace heir
+}  // namespace mlir
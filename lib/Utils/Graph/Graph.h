@@ -4,7 +4,9 @@
 #include <algorithm>
 #include <cstdint>
 #include <map>
+#include <numeric>
 #include <queue>
+#include <random>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -311,6 +313,373 @@ class GreedyGraphColoring {
   std::priority_queue<VertexInfo> queue;
 };
 
+// Returns the number of distinct colors used by a coloring.
+template <typename V>
+int numColors(const std::unordered_map<V, int>& coloring) {
+  int result = 0;
+  for (const auto& entry : coloring) {
+    result = std::max(result, entry.second + 1);
+  }
+  return result;
+}
+
+namespace detail {
+
+// The vertices of an undirected graph numbered 0..n-1 in sorted order, with
+// adjacency lists over those numbers. The colorers below work on this form
+// to avoid repeated map lookups and copies of the adjacency sets.
+template <typename V>
+struct IndexedGraph {
+  explicit IndexedGraph(const UndirectedGraph<V>& graph) {
+    vertices.assign(graph.getVertices().begin(), graph.getVertices().end());
+    std::map<V, int> index;
+    for (int i = 0; i < static_cast<int>(vertices.size()); ++i) {
+      index[vertices[i]] = i;
+    }
+    adjacency.resize(vertices.size());
+    for (int i = 0; i < static_cast<int>(vertices.size()); ++i) {
+      for (const V& neighbor : graph.edgesIncidentTo(vertices[i])) {
+        adjacency[i].push_back(index.at(neighbor));
+      }
+    }
+  }
+
+  int size() const { return vertices.size(); }
+
+  // Colors the vertices in the given order with the smallest color not used
+  // by an already colored neighbor, and returns the number of colors used.
+  int firstFit(const std::vector<int>& order, std::vector<int>& colors) const {
+    colors.assign(size(), -1);
+    std::vector<int> usedBy(size() + 1, -1);
+    int numUsed = 0;
+    for (int vertex : order) {
+      for (int neighbor : adjacency[vertex]) {
+        if (colors[neighbor] >= 0) usedBy[colors[neighbor]] = vertex;
+      }
+      int color = 0;
+      while (usedBy[color] == vertex) ++color;
+      colors[vertex] = color;
+      numUsed = std::max(numUsed, color + 1);
+    }
+    return numUsed;
+  }
+
+  std::unordered_map<V, int> toColoring(const std::vector<int>& colors) const {
+    std::unordered_map<V, int> result;
+    for (int i = 0; i < size(); ++i) {
+      result[vertices[i]] = colors[i];
+    }
+    return result;
+  }
+
+  std::vector<int> fromColoring(
+      const std::unordered_map<V, int>& coloring) const {
+    std::vector<int> colors(size());
+    for (int i = 0; i < size(); ++i) {
+      colors[i] = coloring.at(vertices[i]);
+    }
+    return colors;
+  }
+
+  std::vector<V> vertices;
+  std::vector<std::vector<int>> adjacency;
+};
+
+}  // namespace detail
+
+/// The iterated greedy graph coloring algorithm of Culberson.
+///
+/// Starting from a DSatur coloring, the vertices are repeatedly recolored by
+/// first-fit in an order that lists the color classes of the previous
+/// coloring one after the other. Any such order never needs more colors than
+/// the previous coloring, and reordering the classes (reversed, largest
+/// first, or shuffled) lets the number of colors decrease. After a number of
+/// iterations without improvement, the search restarts from a first-fit
+/// coloring of a random vertex order. The best coloring found is returned
+/// when the iteration limit is reached. With a fixed seed the result only
+/// depends on the graph.
+template <typename V>
+class IteratedGreedyGraphColoring {
+ public:
+  IteratedGreedyGraphColoring(int maxIterations = 1000, unsigned seed = 0)
+      : maxIterations(maxIterations), seed(seed) {}
+
+  std::unordered_map<V, int> color(const UndirectedGraph<V>& graph) {
+    detail::IndexedGraph<V> indexed(graph);
+    std::mt19937 rng(seed);
+
+    GreedyGraphColoring<V> dsatur;
+    std::vector<int> best = indexed.fromColoring(dsatur.color(graph));
+    int bestNumColors = numColorsOf(best);
+
+    std::vector<int> current = best;
+    int currentNumColors = bestNumColors;
+    int sinceImprovement = 0;
+    std::vector<int> order(indexed.size());
+    for (int iteration = 0; iteration < maxIterations; ++iteration) {
+      if (bestNumColors <= 1) break;
+
+      if (sinceImprovement >= kRestartAfter) {
+        std::iota(order.begin(), order.end(), 0);
+        std::shuffle(order.begin(), order.end(), rng);
+        currentNumColors = indexed.firstFit(order, current);
+        sinceImprovement = 0;
+      } else {
+        classOrder(current, currentNumColors, iteration, rng, order);
+        std::vector<int> next;
+        int nextNumColors = indexed.firstFit(order, next);
+        ++sinceImprovement;
+        if (nextNumColors < currentNumColors) sinceImprovement = 0;
+        current = std::move(next);
+        currentNumColors = nextNumColors;
+      }
+
+      if (currentNumColors < bestNumColors) {
+        best = current;
+        bestNumColors = currentNumColors;
+      }
+    }
+
+    return indexed.toColoring(best);
+  }
+
+ private:
+  // The number of iterations without improvement before a random restart.
+  static constexpr int kRestartAfter = 50;
+
+  static int numColorsOf(const std::vector<int>& colors) {
+    int result = 0;
+    for (int color : colors) result = std::max(result, color + 1);
+    return result;
+  }
+
+  // Lists the vertices class by class, cycling between reversing the order of
+  // the classes, placing the largest classes first, and shuffling them.
+  static void classOrder(const std::vector<int>& colors, int numClasses,
+                         int iteration, std::mt19937& rng,
+                         std::vector<int>& order) {
+    std::vector<std::vector<int>> classes(numClasses);
+    for (int vertex = 0; vertex < static_cast<int>(colors.size()); ++vertex) {
+      classes[colors[vertex]].push_back(vertex);
+    }
+    switch (iteration % 3) {
+      case 0:
+        std::reverse(classes.begin(), classes.end());
+        break;
+      case 1:
+        std::stable_sort(classes.begin(), classes.end(),
+                         [](const std::vector<int>& a,
+                            const std::vector<int>& b) {
+                           return a.size() > b.size();
+                         });
+        break;
+      default:
+        std::shuffle(classes.begin(), classes.end(), rng);
+        break;
+    }
+    order.clear();
+    for (const std::vector<int>& colorClass : classes) {
+      order.insert(order.end(), colorClass.begin(), colorClass.end());
+    }
+  }
+
+  int maxIterations;
+  unsigned seed;
+};
+
+/// An exact graph coloring by DSatur-based branch and bound.
+///
+/// Vertices whose degree is smaller than the size of a greedily found clique
+/// can always be colored last, so they are peeled off before the search. The
+/// remaining core is searched if it has at most `maxVertices` vertices, and
+/// the search stops after visiting `maxNodes` nodes of the search tree, so
+/// the result does not depend on the speed of the machine. The best coloring
+/// found so far, which is never worse than DSatur, is returned in either case,
+/// and `isOptimal` reports whether the search completed.
+template <typename V>
+class ExactGraphColoring {
+ public:
+  ExactGraphColoring(int maxVertices = 256, int64_t maxNodes = 100000)
+      : maxVertices(maxVertices), maxNodes(maxNodes) {}
+
+  std::unordered_map<V, int> color(const UndirectedGraph<V>& graph) {
+    numNodes = 0;
+    outOfNodes = false;
+    detail::IndexedGraph<V> indexed(graph);
+
+    GreedyGraphColoring<V> dsatur;
+    std::unordered_map<V, int> upper = dsatur.color(graph);
+    int upperNumColors = numColors(upper);
+
+    int lowerBound = greedyCliqueSize(indexed);
+    optimal = lowerBound == upperNumColors;
+    if (optimal) return upper;
+
+    // Peel off vertices of degree less than the lower bound.
+    std::vector<int> degree(indexed.size());
+    std::vector<bool> peeled(indexed.size(), false);
+    std::vector<int> peelOrder;
+    for (int v = 0; v < indexed.size(); ++v) {
+      degree[v] = indexed.adjacency[v].size();
+    }
+    for (bool changed = true; changed;) {
+      changed = false;
+      for (int v = 0; v < indexed.size(); ++v) {
+        if (peeled[v] || degree[v] >= lowerBound) continue;
+        peeled[v] = true;
+        peelOrder.push_back(v);
+        for (int neighbor : indexed.adjacency[v]) --degree[neighbor];
+        changed = true;
+      }
+    }
+    core.clear();
+    for (int v = 0; v < indexed.size(); ++v) {
+      if (!peeled[v]) core.push_back(v);
+    }
+    if (static_cast<int>(core.size()) > maxVertices) return upper;
+
+    // Branch and bound on the core, with the DSatur coloring as the initial
+    // incumbent.
+    graphPtr = &indexed;
+    coreIndex.assign(indexed.size(), -1);
+    for (int i = 0; i < static_cast<int>(core.size()); ++i) {
+      coreIndex[core[i]] = i;
+    }
+    bestNumColors = upperNumColors;
+    improved = false;
+    coreColors.assign(core.size(), -1);
+    neighborColorCount.assign(core.size(),
+                              std::vector<int>(upperNumColors, 0));
+    saturation.assign(core.size(), 0);
+    if (!core.empty()) search(0, 0, lowerBound);
+    optimal = !outOfNodes;
+
+    // If the core is empty, every vertex is peeled and the result uses at
+    // most `lowerBound` colors.
+    if (!core.empty() && !improved) return upper;
+
+    // Color the peeled vertices in reverse peeling order; each has fewer
+    // colored neighbors than the lower bound when it is colored.
+    std::vector<int> colors(indexed.size(), -1);
+    for (int i = 0; i < static_cast<int>(core.size()); ++i) {
+      colors[core[i]] = bestCoreColors[i];
+    }
+    std::vector<int> usedBy(indexed.size() + 1, -1);
+    for (auto it = peelOrder.rbegin(); it != peelOrder.rend(); ++it) {
+      for (int neighbor : indexed.adjacency[*it]) {
+        if (colors[neighbor] >= 0) usedBy[colors[neighbor]] = *it;
+      }
+      int color = 0;
+      while (usedBy[color] == *it) ++color;
+      colors[*it] = color;
+    }
+    return indexed.toColoring(colors);
+  }
+
+  // Whether the last call to `color` proved its result optimal.
+  bool isOptimal() const { return optimal; }
+
+ private:
+  static int greedyCliqueSize(const detail::IndexedGraph<V>& graph) {
+    int best = graph.size() > 0 ? 1 : 0;
+    std::vector<int> byDegree(graph.size());
+    std::iota(byDegree.begin(), byDegree.end(), 0);
+    std::stable_sort(byDegree.begin(), byDegree.end(), [&](int a, int b) {
+      return graph.adjacency[a].size() > graph.adjacency[b].size();
+    });
+    std::vector<int> mark(graph.size(), -1);
+    int stamp = 0;
+    for (int start : byDegree) {
+      if (static_cast<int>(graph.adjacency[start].size()) < best) break;
+      // Grow a clique from `start`, keeping the candidates adjacent to every
+      // member so far.
+      std::vector<int> candidates = graph.adjacency[start];
+      int size = 1;
+      while (!candidates.empty()) {
+        int next = candidates.front();
+        ++size;
+        ++stamp;
+        for (int neighbor : graph.adjacency[next]) mark[neighbor] = stamp;
+        std::vector<int> remaining;
+        for (int candidate : candidates) {
+          if (mark[candidate] == stamp)
+            remaining.push_back(candidate);
+        }
+        candidates = std::move(remaining);
+      }
+      best = std::max(best, size);
+    }
+    return best;
+  }
+
+  void search(int numColored, int numUsed, int lowerBound) {
+    if (bestNumColors <= lowerBound) return;
+    if (++numNodes > maxNodes) {
+      outOfNodes = true;
+      return;
+    }
+    if (numColored == static_cast<int>(core.size())) {
+      bestNumColors = numUsed;
+      bestCoreColors = coreColors;
+      improved = true;
+      return;
+    }
+
+    // Branch on the uncolored vertex with the most distinct neighbor colors,
+    // breaking ties by degree.
+    int vertex = -1;
+    for (int i = 0; i < static_cast<int>(core.size()); ++i) {
+      if (coreColors[i] >= 0) continue;
+      if (vertex < 0 || saturation[i] > saturation[vertex] ||
+          (saturation[i] == saturation[vertex] &&
+           graphPtr->adjacency[core[i]].size() >
+               graphPtr->adjacency[core[vertex]].size())) {
+        vertex = i;
+      }
+    }
+
+    // A new color is only worth trying if it still beats the incumbent.
+    int maxColor = std::min(numUsed, bestNumColors - 2);
+    for (int color = 0; color <= maxColor; ++color) {
+      if (neighborColorCount[vertex][color] > 0) continue;
+      assign(vertex, color, 1);
+      search(numColored + 1, std::max(numUsed, color + 1), lowerBound);
+      assign(vertex, color, -1);
+      if (outOfNodes || bestNumColors <= lowerBound) return;
+    }
+  }
+
+  // Colors (delta = 1) or uncolors (delta = -1) a core vertex and updates
+  // the saturation of its neighbors.
+  void assign(int vertex, int color, int delta) {
+    coreColors[vertex] = delta > 0 ? color : -1;
+    for (int neighbor : graphPtr->adjacency[core[vertex]]) {
+      int i = coreIndex[neighbor];
+      if (i < 0) continue;
+      int& count = neighborColorCount[i][color];
+      if (delta > 0 && count++ == 0) ++saturation[i];
+      if (delta < 0 && --count == 0) --saturation[i];
+    }
+  }
+
+  int maxVertices;
+  int64_t maxNodes;
+
+  // Search state for the current call to `color`.
+  int64_t numNodes = 0;
+  bool outOfNodes = false;
+  bool optimal = false;
+  bool improved = false;
+  const detail::IndexedGraph<V>* graphPtr = nullptr;
+  std::vector<int> core;
+  std::vector<int> coreIndex;
+  std::vector<int> coreColors;
+  std::vector<int> bestCoreColors;
+  int bestNumColors = 0;
+  std::vector<std::vector<int>> neighborColorCount;
+  std::vector<int> saturation;
+};
+
 }  // namespace graph
 }  // namespace heir
 }  // namespace mlir
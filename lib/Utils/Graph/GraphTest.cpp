@@ -1,4 +1,5 @@
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include "gmock/gmock.h"  // from @googletest
@@ -223,6 +224,103 @@ TEST(DSATURColorTest, StarGraph) {
   }
 }
 
+// A graph on which DSatur uses four colors, but three suffice.
+UndirectedGraph<int> dsaturHardGraph() {
+  UndirectedGraph<int> graph;
+  for (int i = 0; i < 8; i++) graph.addVertex(i);
+  std::vector<std::pair<int, int>> edges = {
+      {0, 2}, {0, 3}, {0, 4}, {0, 5}, {1, 2}, {1, 4}, {1, 6},
+      {1, 7}, {2, 6}, {3, 5}, {3, 6}, {4, 7}, {5, 6}};
+  for (auto [source, target] : edges) {
+    EXPECT_TRUE(graph.addEdge(source, target));
+  }
+  return graph;
+}
+
+void expectProperColoring(const UndirectedGraph<int>& graph,
+                          std::unordered_map<int, int>& colors) {
+  for (int vertex : graph.getVertices()) {
+    ASSERT_TRUE(colors.count(vertex));
+    for (int neighbor : graph.edgesIncidentTo(vertex)) {
+      EXPECT_NE(colors[vertex], colors[neighbor]);
+    }
+  }
+}
+
+TEST(DSATURColorTest, SuboptimalGraph) {
+  UndirectedGraph<int> graph = dsaturHardGraph();
+  GreedyGraphColoring<int> greedy;
+  auto colors = greedy.color(graph);
+  expectProperColoring(graph, colors);
+  EXPECT_EQ(numColors(colors), 4);
+}
+
+TEST(IteratedGreedyColorTest, ImprovesOnDSatur) {
+  UndirectedGraph<int> graph = dsaturHardGraph();
+  IteratedGreedyGraphColoring<int> iterated;
+  auto colors = iterated.color(graph);
+  expectProperColoring(graph, colors);
+  EXPECT_EQ(numColors(colors), 3);
+}
+
+TEST(ExactColorTest, ImprovesOnDSatur) {
+  UndirectedGraph<int> graph = dsaturHardGraph();
+  ExactGraphColoring<int> exact;
+  auto colors = exact.color(graph);
+  expectProperColoring(graph, colors);
+  EXPECT_EQ(numColors(colors), 3);
+  EXPECT_TRUE(exact.isOptimal());
+}
+
+TEST(ExactColorTest, CompleteGraph) {
+  UndirectedGraph<int> graph;
+  for (int i = 0; i < 5; i++) graph.addVertex(i);
+  for (int i = 0; i < 5; i++) {
+    for (int j = i + 1; j < 5; j++) EXPECT_TRUE(graph.addEdge(i, j));
+  }
+
+  ExactGraphColoring<int> exact;
+  auto colors = exact.color(graph);
+  expectProperColoring(graph, colors);
+  EXPECT_EQ(numColors(colors), 5);
+  EXPECT_TRUE(exact.isOptimal());
+}
+
+TEST(ExactColorTest, PeelsLowDegreeVertices) {
+  // Repeatedly removing vertices with fewer than three neighbors, the size of
+  // the triangle {0, 3, 5}, removes the whole graph, so no search is needed.
+  UndirectedGraph<int> graph = dsaturHardGraph();
+  ExactGraphColoring<int> exact(/*maxVertices=*/0);
+  auto colors = exact.color(graph);
+  expectProperColoring(graph, colors);
+  EXPECT_EQ(numColors(colors), 3);
+  EXPECT_TRUE(exact.isOptimal());
+}
+
+TEST(ExactColorTest, SearchStopsAtNodeBudget) {
+  // The Groetzsch graph is triangle-free and needs 4 colors, so the greedy
+  // clique bound of 2 cannot prove any coloring optimal without a search.
+  UndirectedGraph<int> graph;
+  for (int i = 0; i < 11; i++) graph.addVertex(i);
+  for (int i = 0; i < 5; i++) {
+    EXPECT_TRUE(graph.addEdge(i, (i + 1) % 5));
+    EXPECT_TRUE(graph.addEdge(i + 5, (i + 1) % 5));
+    EXPECT_TRUE(graph.addEdge(i + 5, (i + 4) % 5));
+    EXPECT_TRUE(graph.addEdge(i + 5, 10));
+  }
+
+  ExactGraphColoring<int> truncated(/*maxVertices=*/256, /*maxNodes=*/1);
+  auto truncatedColors = truncated.color(graph);
+  expectProperColoring(graph, truncatedColors);
+  EXPECT_FALSE(truncated.isOptimal());
+
+  ExactGraphColoring<int> exact;
+  auto colors = exact.color(graph);
+  expectProperColoring(graph, colors);
+  EXPECT_EQ(numColors(colors), 4);
+  EXPECT_TRUE(exact.isOptimal());
+}
+
 }  // namespace
 }  // namespace graph
 }  // namespace heir
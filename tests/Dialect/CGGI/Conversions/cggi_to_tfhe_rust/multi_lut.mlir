@@ -0,0 +1,31 @@
+// RUN: heir-opt --cggi-to-tfhe-rust -cse %s | FileCheck %s
+
+#encoding = #lwe.unspecified_bit_field_encoding<cleartext_bitwidth = 3>
+!ct_ty = !lwe.lwe_ciphertext<encoding = #encoding>
+
+// CHECK: @multi_lut_lincomb
+// CHECK-SAME: %[[sks:.*]]: [[sks_ty:!tfhe_rust.server_key]], %[[arg1:.*]]: [[ct_ty:!tfhe_rust.eui3]], %[[arg2:.*]]: [[ct_ty]]
+func.func @multi_lut_lincomb(%arg1: !ct_ty, %arg2: !ct_ty) -> (!ct_ty, !ct_ty) {
+  // CHECK: %[[luts:.*]] = tfhe_rust.generate_many_lookup_table %[[sks]] {truthTables = array<i32: 8, 6>}
+  // CHECK: %[[v0:.*]] = tfhe_rust.scalar_left_shift %[[sks]], %[[arg1]] {shiftAmount = 1 : index}
+  // CHECK: %[[v1:.*]] = tfhe_rust.add %[[sks]], %[[v0]], %[[arg2]]
+  // CHECK: %[[res:.*]]:2 = tfhe_rust.apply_many_lookup_table %[[sks]], %[[v1]], %[[luts]]
+  // CHECK-SAME: -> ([[ct_ty]], [[ct_ty]])
+  %0:2 = cggi.multi_lut_lincomb %arg1, %arg2 {
+      coefficients = array<i32: 2, 1>, lookup_tables = array<i32: 8, 6>
+  } : (!ct_ty, !ct_ty) -> (!ct_ty, !ct_ty)
+  // CHECK: return %[[res]]#0, %[[res]]#1
+  return %0#0, %0#1 : !ct_ty, !ct_ty
+}
+
+// CHECK: @multi_programmable_bootstrap
+// CHECK-SAME: %[[sks:.*]]: [[sks_ty:!tfhe_rust.server_key]], %[[arg1:.*]]: [[ct_ty:!tfhe_rust.eui3]]
+func.func @multi_programmable_bootstrap(%arg1: !ct_ty) -> (!ct_ty, !ct_ty) {
+  // CHECK: %[[luts:.*]] = tfhe_rust.generate_many_lookup_table %[[sks]] {truthTables = array<i32: 2, 1>}
+  // CHECK: %[[res:.*]]:2 = tfhe_rust.apply_many_lookup_table %[[sks]], %[[arg1]], %[[luts]]
+  %0:2 = cggi.multi_programmable_bootstrap %arg1 {
+      lookup_tables = array<i32: 2, 1>
+  } : !ct_ty -> (!ct_ty, !ct_ty)
+  // CHECK: return %[[res]]#0, %[[res]]#1
+  return %0#0, %0#1 : !ct_ty, !ct_ty
+}
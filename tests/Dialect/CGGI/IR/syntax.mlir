@@ -27,6 +27,10 @@ module {
       lookup_tables = array<i32: 68, 70, 4, 8, 1>
     } : (!ciphertext, !ciphertext, !ciphertext, !ciphertext) -> (!ciphertext, !ciphertext, !ciphertext, !ciphertext, !ciphertext)
 
+    %15, %16 = cggi.multi_programmable_bootstrap %8 {
+      lookup_tables = array<i32: 8, 6>
+    } : !ciphertext -> (!ciphertext, !ciphertext)
+
     return %14 : !ciphertext
   }
 }
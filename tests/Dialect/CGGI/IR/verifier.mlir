@@ -38,3 +38,15 @@ func.func @test_too_large_lut(%a: !ciphertext, %b: !ciphertext) -> () {
   %0 = cggi.lut_lincomb %a, %b {coefficients = array<i32: 1, 1>, lookup_table = 172836 : index} : !ciphertext
   return
 }
+
+// -----
+
+#encoding = #lwe.bit_field_encoding<cleartext_start=30, cleartext_bitwidth=3>
+#params = #lwe.lwe_params<cmod=7917, dimension=4>
+!ciphertext = !lwe.lwe_ciphertext<encoding = #encoding, lwe_params = #params>
+
+func.func @test_multi_pbs_lut_count(%a: !ciphertext) -> () {
+  // expected-error@below {{number of outputs must match number of LUTs}}
+  %0, %1 = cggi.multi_programmable_bootstrap %a {lookup_tables = array<i32: 8>} : !ciphertext -> (!ciphertext, !ciphertext)
+  return
+}
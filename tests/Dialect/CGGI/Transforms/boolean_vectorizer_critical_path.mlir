@@ -0,0 +1,31 @@
+// RUN: heir-opt --cggi-boolean-vectorize="parallelism=2 prioritize-critical-path=true" %s | FileCheck %s
+// RUN: heir-opt --cggi-boolean-vectorize="parallelism=2 prioritize-critical-path=true" --mlir-pass-statistics -o /dev/null %s 2>&1 | FileCheck %s --check-prefix=STATS
+// RUN: heir-opt --cggi-boolean-vectorize="parallelism=2" --mlir-pass-statistics -o /dev/null %s 2>&1 | FileCheck %s --check-prefix=LEVELS
+
+#encoding = #lwe.unspecified_bit_field_encoding<cleartext_bitwidth = 1>
+!ct_ty = !lwe.lwe_ciphertext<encoding = #encoding>
+
+// The critical path is %c1 -> %c2 -> %c3. By level, %n1 and %n2 are scheduled
+// with %c3, which overflows the batch width. Scheduling the critical path
+// first fills the batches of %c1 and %c2 with %n1 and %n2 instead.
+
+// CHECK: @critical_path
+// CHECK-COUNT-2: cggi.packed_gates
+// CHECK-NOT: cggi.packed_gates
+// CHECK: cggi.or
+
+// STATS-DAG: 2 num-batches
+// STATS-DAG: 4 num-batched-gates
+// STATS-DAG: 100 batch-occupancy
+
+// LEVELS-DAG: 2 num-batches
+// LEVELS-DAG: 3 num-batched-gates
+// LEVELS-DAG: 75 batch-occupancy
+func.func @critical_path(%a: !ct_ty, %b: !ct_ty, %c: !ct_ty, %d: !ct_ty) -> (!ct_ty, !ct_ty, !ct_ty) {
+  %c1 = cggi.and %a, %b : !ct_ty
+  %c2 = cggi.xor %c1, %c : !ct_ty
+  %c3 = cggi.or %c2, %d : !ct_ty
+  %n1 = cggi.and %a, %c : !ct_ty
+  %n2 = cggi.xor %b, %d : !ct_ty
+  return %c3, %n1, %n2 : !ct_ty, !ct_ty, !ct_ty
+}
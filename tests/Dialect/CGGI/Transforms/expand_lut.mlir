@@ -60,3 +60,17 @@ func.func @lut_bitwidth_4(%arg0: !ct_ty4, %arg1: !ct_ty4) -> !ct_ty4 {
   %r1 = cggi.lut_lincomb %arg0, %arg1 {coefficients = array<i32: 3, 6>, lookup_table = 68 : index} : !ct_ty4
   return %r1 : !ct_ty4
 }
+
+// CHECK: @multi_lut_lincomb
+// CHECK-SAME: %[[arg0:.*]]: ![[ct:.*]], %[[arg1:.*]]: ![[ct]]
+func.func @multi_lut_lincomb(%arg0: !ct_ty, %arg1: !ct_ty) -> (!ct_ty, !ct_ty) {
+  // CHECK-DAG: %[[const2:.*]] = arith.constant 2 : i3
+  // CHECK-DAG: %[[const1:.*]] = arith.constant 1 : i3
+  // CHECK: %[[mul_b:.*]] = lwe.mul_scalar %[[arg0]], %[[const2]]
+  // CHECK: %[[mul_a:.*]] = lwe.mul_scalar %[[arg1]], %[[const1]]
+  // CHECK: %[[res:.*]] = lwe.add %[[mul_b]], %[[mul_a]]
+  // CHECK: %[[pbs:.*]]:2 = cggi.multi_programmable_bootstrap %[[res]] {lookup_tables = array<i32: 8, 6>}
+  // CHECK: return %[[pbs]]#0, %[[pbs]]#1
+  %r:2 = cggi.multi_lut_lincomb %arg0, %arg1 {coefficients = array<i32: 2, 1>, lookup_tables = array<i32: 8, 6>} : (!ct_ty, !ct_ty) -> (!ct_ty, !ct_ty)
+  return %r#0, %r#1 : !ct_ty, !ct_ty
+}
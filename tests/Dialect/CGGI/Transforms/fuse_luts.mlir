@@ -0,0 +1,109 @@
+// RUN: heir-opt --split-input-file --cggi-fuse-luts %s | FileCheck %s
+// RUN: heir-opt --split-input-file --cggi-fuse-luts=max-inputs=2 %s | FileCheck %s --check-prefix=NARROW
+
+#encoding = #lwe.unspecified_bit_field_encoding<cleartext_bitwidth = 4>
+!ct_ty = !lwe.lwe_ciphertext<encoding = #encoding>
+
+// (arg0 & arg1) ^ arg2 as a single 3-input LUT.
+// CHECK: @and_xor
+// CHECK-SAME: %[[arg0:.*]]: ![[ct:.*]], %[[arg1:.*]]: ![[ct]], %[[arg2:.*]]: ![[ct]]
+// CHECK-NOT: cggi.lut2
+// CHECK: %[[res:.*]] = cggi.lut_lincomb %[[arg2]], %[[arg0]], %[[arg1]]
+// CHECK-SAME: coefficients = array<i32: 4, 2, 1>
+// CHECK-SAME: lookup_table = 120 : index
+// CHECK: return %[[res]]
+
+// NARROW: @and_xor
+// NARROW-COUNT-2: cggi.lut2
+func.func @and_xor(%arg0: !ct_ty, %arg1: !ct_ty, %arg2: !ct_ty) -> !ct_ty {
+  %x = cggi.lut2 %arg0, %arg1 {lookup_table = 8 : ui8} : !ct_ty
+  %y = cggi.lut2 %x, %arg2 {lookup_table = 6 : ui8} : !ct_ty
+  return %y : !ct_ty
+}
+
+// -----
+
+#encoding = #lwe.unspecified_bit_field_encoding<cleartext_bitwidth = 4>
+!ct_ty = !lwe.lwe_ciphertext<encoding = #encoding>
+
+// (arg0 & arg1) ^ (arg2 | arg3) as a single 4-input LUT.
+// CHECK: @tree
+// CHECK-SAME: %[[arg0:.*]]: ![[ct:.*]], %[[arg1:.*]]: ![[ct]], %[[arg2:.*]]: ![[ct]], %[[arg3:.*]]: ![[ct]]
+// CHECK-NOT: cggi.lut2
+// CHECK: %[[res:.*]] = cggi.lut_lincomb %[[arg0]], %[[arg1]], %[[arg2]], %[[arg3]]
+// CHECK-SAME: coefficients = array<i32: 8, 4, 2, 1>
+// CHECK-SAME: lookup_table = 7918 : index
+// CHECK: return %[[res]]
+func.func @tree(%arg0: !ct_ty, %arg1: !ct_ty, %arg2: !ct_ty, %arg3: !ct_ty) -> !ct_ty {
+  %x = cggi.lut2 %arg0, %arg1 {lookup_table = 8 : ui8} : !ct_ty
+  %y = cggi.lut2 %arg2, %arg3 {lookup_table = 14 : ui8} : !ct_ty
+  %z = cggi.lut2 %x, %y {lookup_table = 6 : ui8} : !ct_ty
+  return %z : !ct_ty
+}
+
+// -----
+
+#encoding = #lwe.unspecified_bit_field_encoding<cleartext_bitwidth = 3>
+!ct_ty = !lwe.lwe_ciphertext<encoding = #encoding>
+
+// A 4-input LUT does not fit in 3 cleartext bits.
+// CHECK: @too_wide
+// CHECK-NOT: cggi.lut_lincomb
+// CHECK: cggi.lut3
+// CHECK: cggi.lut2
+func.func @too_wide(%arg0: !ct_ty, %arg1: !ct_ty, %arg2: !ct_ty, %arg3: !ct_ty) -> !ct_ty {
+  %x = cggi.lut3 %arg0, %arg1, %arg2 {lookup_table = 150 : ui8} : !ct_ty
+  %y = cggi.lut2 %x, %arg3 {lookup_table = 6 : ui8} : !ct_ty
+  return %y : !ct_ty
+}
+
+// -----
+
+#encoding = #lwe.unspecified_bit_field_encoding<cleartext_bitwidth = 4>
+!ct_ty = !lwe.lwe_ciphertext<encoding = #encoding>
+
+// Fusing %x would duplicate its bootstrap.
+// CHECK: @multiple_users
+// CHECK-NOT: cggi.lut_lincomb
+// CHECK-COUNT-3: cggi.lut2
+func.func @multiple_users(%arg0: !ct_ty, %arg1: !ct_ty, %arg2: !ct_ty) -> (!ct_ty, !ct_ty) {
+  %x = cggi.lut2 %arg0, %arg1 {lookup_table = 8 : ui8} : !ct_ty
+  %y = cggi.lut2 %x, %arg2 {lookup_table = 6 : ui8} : !ct_ty
+  %z = cggi.lut2 %x, %arg2 {lookup_table = 8 : ui8} : !ct_ty
+  return %y, %z : !ct_ty, !ct_ty
+}
+
+// -----
+
+#encoding = #lwe.unspecified_bit_field_encoding<cleartext_bitwidth = 6>
+!ct_ty = !lwe.lwe_ciphertext<encoding = #encoding>
+
+// Two bootstraps of 3 cleartext bits are cheaper than one of 5 bits.
+// CHECK: @rejected_on_cost
+// CHECK-NOT: cggi.lut_lincomb
+// CHECK-COUNT-2: cggi.lut3
+func.func @rejected_on_cost(%arg0: !ct_ty, %arg1: !ct_ty, %arg2: !ct_ty, %arg3: !ct_ty, %arg4: !ct_ty) -> !ct_ty {
+  %x = cggi.lut3 %arg0, %arg1, %arg2 {lookup_table = 150 : ui8} : !ct_ty
+  %y = cggi.lut3 %x, %arg3, %arg4 {lookup_table = 232 : ui8} : !ct_ty
+  return %y : !ct_ty
+}
+
+// -----
+
+#encoding = #lwe.unspecified_bit_field_encoding<cleartext_bitwidth = 6>
+!ct_ty = !lwe.lwe_ciphertext<encoding = #encoding>
+
+// The lut2 ops fuse into a 3-input LUT, which does not fuse further as the
+// lut3 already requires 3 cleartext bits.
+// CHECK: @fused_up_to_cost
+// CHECK-NOT: cggi.lut2
+// CHECK: %[[fused:.*]] = cggi.lut_lincomb
+// CHECK-SAME: coefficients = array<i32: 4, 2, 1>
+// CHECK: %[[res:.*]] = cggi.lut3 %[[fused]]
+// CHECK: return %[[res]]
+func.func @fused_up_to_cost(%arg0: !ct_ty, %arg1: !ct_ty, %arg2: !ct_ty, %arg3: !ct_ty, %arg4: !ct_ty) -> !ct_ty {
+  %x = cggi.lut2 %arg0, %arg1 {lookup_table = 8 : ui8} : !ct_ty
+  %y = cggi.lut2 %x, %arg2 {lookup_table = 6 : ui8} : !ct_ty
+  %z = cggi.lut3 %y, %arg3, %arg4 {lookup_table = 232 : ui8} : !ct_ty
+  return %z : !ct_ty
+}
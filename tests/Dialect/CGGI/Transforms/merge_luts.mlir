@@ -0,0 +1,69 @@
+// RUN: heir-opt --cggi-merge-luts %s | FileCheck %s
+
+#encoding = #lwe.unspecified_bit_field_encoding<cleartext_bitwidth = 3>
+!ct_ty = !lwe.lwe_ciphertext<encoding = #encoding>
+
+#encoding4 = #lwe.unspecified_bit_field_encoding<cleartext_bitwidth = 4>
+!ct_ty4 = !lwe.lwe_ciphertext<encoding = #encoding4>
+
+// CHECK: @lut2_pair
+// CHECK-SAME: %[[arg0:.*]]: ![[ct:.*]], %[[arg1:.*]]: ![[ct]]
+func.func @lut2_pair(%arg0: !ct_ty, %arg1: !ct_ty) -> (!ct_ty, !ct_ty) {
+  // CHECK: %[[res:.*]]:2 = cggi.multi_lut_lincomb %[[arg0]], %[[arg1]]
+  // CHECK-SAME: coefficients = array<i32: 2, 1>
+  // CHECK-SAME: lookup_tables = array<i32: 8, 6>
+  // CHECK-NOT: cggi.lut2
+  // CHECK: return %[[res]]#0, %[[res]]#1
+  %r1 = cggi.lut2 %arg0, %arg1 {lookup_table = 8 : ui8} : !ct_ty
+  %r2 = cggi.lut2 %arg0, %arg1 {lookup_table = 6 : ui8} : !ct_ty
+  return %r1, %r2 : !ct_ty, !ct_ty
+}
+
+// With 3 cleartext bits, a LUT2 input takes 4 values, so only two tables fit
+// in the message space.
+// CHECK: @lut2_over_budget
+// CHECK-SAME: %[[arg0:.*]]: ![[ct:.*]], %[[arg1:.*]]: ![[ct]]
+func.func @lut2_over_budget(%arg0: !ct_ty, %arg1: !ct_ty) -> (!ct_ty, !ct_ty, !ct_ty) {
+  // CHECK: %[[res:.*]]:2 = cggi.multi_lut_lincomb %[[arg0]], %[[arg1]]
+  // CHECK-SAME: lookup_tables = array<i32: 8, 6>
+  // CHECK: %[[r3:.*]] = cggi.lut2 %[[arg0]], %[[arg1]] {lookup_table = 1 : ui8}
+  // CHECK: return %[[res]]#0, %[[res]]#1, %[[r3]]
+  %r1 = cggi.lut2 %arg0, %arg1 {lookup_table = 8 : ui8} : !ct_ty
+  %r2 = cggi.lut2 %arg0, %arg1 {lookup_table = 6 : ui8} : !ct_ty
+  %r3 = cggi.lut2 %arg0, %arg1 {lookup_table = 1 : ui8} : !ct_ty
+  return %r1, %r2, %r3 : !ct_ty, !ct_ty, !ct_ty
+}
+
+// CHECK: @different_inputs
+func.func @different_inputs(%arg0: !ct_ty, %arg1: !ct_ty, %arg2: !ct_ty) -> (!ct_ty, !ct_ty) {
+  // CHECK-NOT: cggi.multi_lut_lincomb
+  // CHECK-COUNT-2: cggi.lut2
+  %r1 = cggi.lut2 %arg0, %arg1 {lookup_table = 8 : ui8} : !ct_ty
+  %r2 = cggi.lut2 %arg0, %arg2 {lookup_table = 6 : ui8} : !ct_ty
+  return %r1, %r2 : !ct_ty, !ct_ty
+}
+
+// A LUT3 input takes 8 values, which leaves no room for a second table with 3
+// cleartext bits.
+// CHECK: @lut3_no_room
+func.func @lut3_no_room(%arg0: !ct_ty, %arg1: !ct_ty, %arg2: !ct_ty) -> (!ct_ty, !ct_ty) {
+  // CHECK-NOT: cggi.multi_lut_lincomb
+  // CHECK-COUNT-2: cggi.lut3
+  %r1 = cggi.lut3 %arg0, %arg1, %arg2 {lookup_table = 150 : ui8} : !ct_ty
+  %r2 = cggi.lut3 %arg0, %arg1, %arg2 {lookup_table = 232 : ui8} : !ct_ty
+  return %r1, %r2 : !ct_ty, !ct_ty
+}
+
+// A full adder: the sum and carry share one linear combination, which may be
+// written with a permuted operand order.
+// CHECK: @full_adder
+// CHECK-SAME: %[[arg0:.*]]: ![[ct:.*]], %[[arg1:.*]]: ![[ct]], %[[arg2:.*]]: ![[ct]]
+func.func @full_adder(%arg0: !ct_ty4, %arg1: !ct_ty4, %arg2: !ct_ty4) -> (!ct_ty4, !ct_ty4) {
+  // CHECK: %[[res:.*]]:2 = cggi.multi_lut_lincomb %[[arg0]], %[[arg1]], %[[arg2]]
+  // CHECK-SAME: coefficients = array<i32: 4, 2, 1>
+  // CHECK-SAME: lookup_tables = array<i32: 150, 232>
+  // CHECK: return %[[res]]#0, %[[res]]#1
+  %sum = cggi.lut3 %arg0, %arg1, %arg2 {lookup_table = 150 : ui8} : !ct_ty4
+  %carry = cggi.lut_lincomb %arg2, %arg1, %arg0 {coefficients = array<i32: 1, 2, 4>, lookup_table = 232 : index} : !ct_ty4
+  return %sum, %carry : !ct_ty4, !ct_ty4
+}
@@ -0,0 +1,85 @@
+// RUN: heir-translate --emit-jaxite --jaxite-batch-levels %s | FileCheck %s
+
+!bsks = !jaxite.server_key_set
+!params = !jaxite.params
+#unspecified_encoding = #lwe.unspecified_bit_field_encoding<
+  cleartext_bitwidth=3>
+#params = #lwe.lwe_params<cmod=7917, dimension=10>
+!eb = !lwe.lwe_ciphertext<encoding = #unspecified_encoding, lwe_params = #params>
+
+// CHECK: @jax.jit
+// CHECK: def run_lut3_level(
+
+// CHECK: def test_levels(
+// CHECK-NEXT:   [[v0:v[0-9]+]]: list[types.LweCiphertext],
+// CHECK-NEXT:   [[sks:v[0-9]+]]: jaxite_bool.ServerKeySet,
+// CHECK-NEXT:   [[params:v[0-9]+]]: jaxite_bool.Parameters,
+// CHECK-NEXT: ) -> list[types.LweCiphertext]:
+// CHECK:        [[x0:temp_nodes\[[0-9]+\]]] = [[v0]][0]
+// CHECK-NEXT:   [[x1:temp_nodes\[[0-9]+\]]] = [[v0]][1]
+// CHECK-NEXT:   [[x2:temp_nodes\[[0-9]+\]]] = [[v0]][2]
+// CHECK-NEXT:   {{\[}}[[t0:temp_nodes\[[0-9]+\]]]{{\]}} = run_lut3_level({{\[}}[[x0]]{{\]}}, {{\[}}[[x1]]{{\]}}, {{\[}}[[x2]]{{\]}}, {{\[}}128{{\]}}, [[sks]], [[params]])
+// CHECK-NEXT:   {{\[}}[[t1:temp_nodes\[[0-9]+\]]], [[r0:temp_nodes\[[0-9]+\]]]{{\]}} = run_lut3_level({{\[}}[[t0]], [[x0]]{{\]}}, {{\[}}[[x1]], [[x1]]{{\]}}, {{\[}}[[x2]], [[x2]]{{\]}}, {{\[}}6, 120{{\]}}, [[sks]], [[params]])
+// CHECK-NEXT:   {{\[}}[[r1:temp_nodes\[[0-9]+\]]]{{\]}} = run_lut3_level({{\[}}[[t1]]{{\]}}, {{\[}}[[r0]]{{\]}}, {{\[}}[[x0]]{{\]}}, {{\[}}1{{\]}}, [[sks]], [[params]])
+// CHECK-NOT:    jaxite_bool.lut3
+// CHECK:        return
+func.func @test_levels(%arg0: tensor<3x!eb>, %bsks : !bsks, %params : !params) -> tensor<2x!eb> {
+  %c2 = arith.constant 2 : index
+  %c1 = arith.constant 1 : index
+  %c0 = arith.constant 0 : index
+  %x_00 = tensor.extract %arg0[%c0] : tensor<3x!eb>
+  %x_01 = tensor.extract %arg0[%c1] : tensor<3x!eb>
+  %x_02 = tensor.extract %arg0[%c2] : tensor<3x!eb>
+
+  %tt_1 = arith.constant 1 : i8
+  %tt_6 = arith.constant 6 : i8
+  %tt_120 = arith.constant 120 : i8
+  %tt_128 = arith.constant 128 : i8
+
+  %t_0 = jaxite.lut3 %x_00, %x_01, %x_02, %tt_128, %bsks, %params : (!eb, !eb, !eb, i8, !bsks, !params) -> !eb
+  %t_1 = jaxite.lut3 %t_0, %x_01, %x_02, %tt_6, %bsks, %params : (!eb, !eb, !eb, i8, !bsks, !params) -> !eb
+  %r_0 = jaxite.lut3 %x_00, %x_01, %x_02, %tt_120, %bsks, %params : (!eb, !eb, !eb, i8, !bsks, !params) -> !eb
+  %r_1 = jaxite.lut3 %t_1, %r_0, %x_00, %tt_1, %bsks, %params : (!eb, !eb, !eb, i8, !bsks, !params) -> !eb
+
+  %from_elements = tensor.from_elements %t_1, %r_1 : tensor<2x!eb>
+  return %from_elements : tensor<2x!eb>
+}
+
+// The levels span the whole block: the lut3 op after the last load still
+// joins the first level, and every load and store is emitted before the
+// level that uses it.
+// CHECK: def test_interleaved_loads(
+// CHECK-NEXT:   [[in:v[0-9]+]]: list[types.LweCiphertext],
+// CHECK-NEXT:   [[sks:v[0-9]+]]: jaxite_bool.ServerKeySet,
+// CHECK-NEXT:   [[params:v[0-9]+]]: jaxite_bool.Parameters,
+// CHECK-NEXT: ) -> list[types.LweCiphertext]:
+// CHECK-NEXT:   temp_nodes: Dict[int, Any] = {}
+// CHECK-NEXT:   [[x0:temp_nodes\[[0-9]+\]]] = [[in]][0]
+// CHECK-NEXT:   [[x1:temp_nodes\[[0-9]+\]]] = [[in]][1]
+// CHECK-NEXT:   [[x2:temp_nodes\[[0-9]+\]]] = [[in]][2]
+// CHECK-NEXT:   [[alloc:temp_nodes\[[0-9]+\]]] = np.full((2), None)
+// CHECK-NEXT:   {{\[}}[[t0:temp_nodes\[[0-9]+\]]], [[t1:temp_nodes\[[0-9]+\]]]{{\]}} = run_lut3_level({{\[}}[[x0]], [[x0]]{{\]}}, {{\[}}[[x1]], [[x1]]{{\]}}, {{\[}}[[x1]], [[x2]]{{\]}}, {{\[}}6, 120{{\]}}, [[sks]], [[params]])
+// CHECK-NEXT:   [[alloc]][0] = [[t0]]
+// CHECK-NEXT:   {{\[}}[[t2:temp_nodes\[[0-9]+\]]]{{\]}} = run_lut3_level({{\[}}[[t0]]{{\]}}, {{\[}}[[t1]]{{\]}}, {{\[}}[[x2]]{{\]}}, {{\[}}1{{\]}}, [[sks]], [[params]])
+// CHECK-NEXT:   [[alloc]][1] = [[t2]]
+// CHECK-NEXT:   return [[alloc]]
+func.func @test_interleaved_loads(%arg0: memref<3x!eb>, %bsks : !bsks, %params : !params) -> memref<2x!eb> {
+  %c2 = arith.constant 2 : index
+  %c1 = arith.constant 1 : index
+  %c0 = arith.constant 0 : index
+  %tt_1 = arith.constant 1 : i8
+  %tt_6 = arith.constant 6 : i8
+  %tt_120 = arith.constant 120 : i8
+
+  %x_00 = memref.load %arg0[%c0] : memref<3x!eb>
+  %x_01 = memref.load %arg0[%c1] : memref<3x!eb>
+  %t_0 = jaxite.lut3 %x_00, %x_01, %x_01, %tt_6, %bsks, %params : (!eb, !eb, !eb, i8, !bsks, !params) -> !eb
+  %x_02 = memref.load %arg0[%c2] : memref<3x!eb>
+  %t_1 = jaxite.lut3 %x_00, %x_01, %x_02, %tt_120, %bsks, %params : (!eb, !eb, !eb, i8, !bsks, !params) -> !eb
+  %t_2 = jaxite.lut3 %t_0, %t_1, %x_02, %tt_1, %bsks, %params : (!eb, !eb, !eb, i8, !bsks, !params) -> !eb
+
+  %alloc = memref.alloc() : memref<2x!eb>
+  memref.store %t_0, %alloc[%c0] : memref<2x!eb>
+  memref.store %t_2, %alloc[%c1] : memref<2x!eb>
+  return %alloc : memref<2x!eb>
+}
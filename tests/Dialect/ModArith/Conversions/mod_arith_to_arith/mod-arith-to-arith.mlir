@@ -145,6 +145,23 @@ func.func @test_lower_mul_vec(%lhs : !Zpv, %rhs : !Zpv) -> !Zpv {
   return %res : !Zpv
 }
 
+// CHECK: @test_lower_mul_shoup
+// CHECK-SAME: (%[[LHS:.*]]: [[T:.*]], %[[RHS:.*]]: [[T]], %[[SHOUP:.*]]: [[T]]) -> [[T]] {
+func.func @test_lower_mul_shoup(%lhs : !Zp, %rhs : !Zp, %rhs_shoup : i32) -> !Zp {
+  // CHECK-NOT: mod_arith.mul_shoup
+  // CHECK: %[[CMOD:.*]] = arith.constant 65537 : [[T]]
+  // CHECK: %[[LOW:.*]], %[[HIGH:.*]] = arith.mului_extended %[[LHS]], %[[SHOUP]] : [[T]]
+  // CHECK: %[[MUL:.*]] = arith.muli %[[LHS]], %[[RHS]] : [[T]]
+  // CHECK: %[[QMUL:.*]] = arith.muli %[[HIGH]], %[[CMOD]] : [[T]]
+  // CHECK: %[[REM:.*]] = arith.subi %[[MUL]], %[[QMUL]] : [[T]]
+  // CHECK: %[[CMP:.*]] = arith.cmpi uge, %[[REM]], %[[CMOD]] : [[T]]
+  // CHECK: %[[SUB:.*]] = arith.subi %[[REM]], %[[CMOD]] : [[T]]
+  // CHECK: %[[SEL:.*]] = arith.select %[[CMP]], %[[SUB]], %[[REM]] : [[T]]
+  // CHECK: return %[[SEL]] : [[T]]
+  %res = mod_arith.mul_shoup %lhs, %rhs, %rhs_shoup : !Zp, i32
+  return %res : !Zp
+}
+
 // CHECK: @test_lower_mac
 // CHECK-SAME: (%[[LHS:.*]]: [[T:.*]], %[[RHS:.*]]: [[T]], %[[ACC:.*]]: [[T]]) -> [[T]] {
 func.func @test_lower_mac(%lhs : !Zp, %rhs : !Zp, %acc : !Zp) -> !Zp {
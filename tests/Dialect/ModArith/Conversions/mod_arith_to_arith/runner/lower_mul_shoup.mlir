@@ -0,0 +1,28 @@
+// RUN: heir-opt %s --mod-arith-to-arith --heir-polynomial-to-llvm \
+// RUN:   | mlir-runner -e test_lower_mul_shoup -entry-point-result=void \
+// RUN:      --shared-libs="%mlir_lib_dir/libmlir_c_runner_utils%shlibext,%mlir_runner_utils" > %t
+// RUN: FileCheck %s --check-prefix=CHECK_TEST_MUL_SHOUP < %t
+
+func.func private @printMemrefI32(memref<*xi32>) attributes { llvm.emit_c_interface }
+
+!Zp = !mod_arith.int<7681 : i26>
+!Zpv = tensor<4x!Zp>
+
+func.func @test_lower_mul_shoup() {
+  %x = arith.constant dense<[1600, 42, 7680, 0]> : tensor<4xi26>
+  %w = arith.constant dense<[3383, 7234, 7680, 1925]> : tensor<4xi26>
+  // floor(w * 2^26 / 7681)
+  %w_shoup = arith.constant dense<[29557256, 63203426, 67100127, 16818716]> : tensor<4xi26>
+  %ex = mod_arith.encapsulate %x : tensor<4xi26> -> !Zpv
+  %ew = mod_arith.encapsulate %w : tensor<4xi26> -> !Zpv
+  %m1 = mod_arith.mul_shoup %ex, %ew, %w_shoup : !Zpv, tensor<4xi26>
+  %1 = mod_arith.extract %m1 : !Zpv -> tensor<4xi26>
+
+  %2 = arith.extui %1 : tensor<4xi26> to tensor<4xi32>
+  %3 = bufferization.to_memref %2 : tensor<4xi32> to memref<4xi32>
+  %U = memref.cast %3 : memref<4xi32> to memref<*xi32>
+  func.call @printMemrefI32(%U) : (memref<*xi32>) -> ()
+  return
+}
+
+// CHECK_TEST_MUL_SHOUP: [5376, 4269, 1, 0]
@@ -63,6 +63,11 @@ func.func @test_arith_syntax() {
   %mul = mod_arith.mul %m5, %m6 : !Zp
   %mul_vec = mod_arith.mul %m_vec, %m_vec2 : !Zp_vec
 
+  // CHECK: mod_arith.mul_shoup
+  // CHECK: mod_arith.mul_shoup
+  %mul_shoup = mod_arith.mul_shoup %m5, %m6, %c6 : !Zp, i10
+  %mul_shoup_vec = mod_arith.mul_shoup %m_vec, %m_vec2, %c_vec2 : !Zp_vec, tensor<4xi10>
+
   // CHECK: mod_arith.mac
   // CHECK: mod_arith.mac
   %mac = mod_arith.mac %m5, %m6, %m4 : !Zp
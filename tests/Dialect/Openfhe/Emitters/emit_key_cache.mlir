@@ -0,0 +1,38 @@
+// RUN: heir-translate %s --emit-openfhe-pke | FileCheck %s
+
+// CHECK: #include "src/pke/include/cryptocontext-ser.h"
+// CHECK: #include "src/pke/include/key/key-ser.h"
+// CHECK: #include "src/pke/include/scheme/ckksrns/ckksrns-ser.h"
+// CHECK: std::string HeirKeyCachePath(const std::string& key) {
+// CHECK: HEIR_OPENFHE_KEY_CACHE_DIR
+
+module attributes {scheme.ckks} {
+  // CHECK: CryptoContextT test_save(CryptoContextT [[CC:.*]]) {
+  // CHECK-NEXT: {
+  // CHECK-NEXT: const std::string prefix = HeirKeyCachePath("test_0123456789abcdef");
+  // CHECK-NEXT: if (!Serial::SerializeToFile(prefix + ".cc", [[CC]], SerType::BINARY)) {
+  // CHECK: std::ofstream multKeyFile(prefix + ".multkey", std::ios::out | std::ios::binary);
+  // CHECK-NEXT: if (!multKeyFile.is_open() || ![[CC]]->SerializeEvalMultKey(multKeyFile, SerType::BINARY)) {
+  // CHECK: std::ofstream rotKeyFile(prefix + ".rotkey", std::ios::out | std::ios::binary);
+  // CHECK-NEXT: if (!rotKeyFile.is_open() || ![[CC]]->SerializeEvalAutomorphismKey(rotKeyFile, SerType::BINARY)) {
+  // CHECK: return [[CC]];
+  func.func @test_save(%cc: !openfhe.crypto_context) -> !openfhe.crypto_context {
+    openfhe.save_crypto_context %cc {key = "test_0123456789abcdef"} : (!openfhe.crypto_context) -> ()
+    return %cc : !openfhe.crypto_context
+  }
+
+  // CHECK: CryptoContextT test_load() {
+  // CHECK-NEXT: CryptoContextT [[CC:.*]];
+  // CHECK-NEXT: {
+  // CHECK-NEXT: const std::string prefix = HeirKeyCachePath("test_0123456789abcdef");
+  // CHECK-NEXT: if (!Serial::DeserializeFromFile(prefix + ".cc", [[CC]], SerType::BINARY)) {
+  // CHECK: std::ifstream multKeyFile(prefix + ".multkey", std::ios::in | std::ios::binary);
+  // CHECK-NEXT: if (!multKeyFile.is_open() || ![[CC]]->DeserializeEvalMultKey(multKeyFile, SerType::BINARY)) {
+  // CHECK: std::ifstream rotKeyFile(prefix + ".rotkey", std::ios::in | std::ios::binary);
+  // CHECK-NEXT: if (!rotKeyFile.is_open() || ![[CC]]->DeserializeEvalAutomorphismKey(rotKeyFile, SerType::BINARY)) {
+  // CHECK: return [[CC]];
+  func.func @test_load() -> !openfhe.crypto_context {
+    %cc = openfhe.load_crypto_context {key = "test_0123456789abcdef"} : () -> !openfhe.crypto_context
+    return %cc : !openfhe.crypto_context
+  }
+}
@@ -0,0 +1,40 @@
+// RUN: heir-opt --openfhe-configure-crypto-context="entry-function=simple_rot emit-key-cache=true" %s | FileCheck %s
+
+!Z1032955396097_i64_ = !mod_arith.int<1032955396097 : i64>
+!Z1095233372161_i64_ = !mod_arith.int<1095233372161 : i64>
+!Z65537_i64_ = !mod_arith.int<65537 : i64>
+#full_crt_packing_encoding = #lwe.full_crt_packing_encoding<scaling_factor = 0>
+#key = #lwe.key<>
+#modulus_chain_L5_C0_ = #lwe.modulus_chain<elements = <1095233372161 : i64, 1032955396097 : i64, 1005037682689 : i64, 998595133441 : i64, 972824936449 : i64, 959939837953 : i64>, current = 0>
+#modulus_chain_L5_C1_ = #lwe.modulus_chain<elements = <1095233372161 : i64, 1032955396097 : i64, 1005037682689 : i64, 998595133441 : i64, 972824936449 : i64, 959939837953 : i64>, current = 1>
+!rns_L0_ = !rns.rns<!Z1095233372161_i64_>
+!rns_L1_ = !rns.rns<!Z1095233372161_i64_, !Z1032955396097_i64_>
+#ring_Z65537_i64_1_x32_ = #polynomial.ring<coefficientType = !Z65537_i64_, polynomialModulus = <1 + x**32>>
+#plaintext_space = #lwe.plaintext_space<ring = #ring_Z65537_i64_1_x32_, encoding = #full_crt_packing_encoding>
+#ring_rns_L0_1_x32_ = #polynomial.ring<coefficientType = !rns_L0_, polynomialModulus = <1 + x**32>>
+#ring_rns_L1_1_x32_ = #polynomial.ring<coefficientType = !rns_L1_, polynomialModulus = <1 + x**32>>
+!pt = !lwe.new_lwe_plaintext<application_data = <message_type = tensor<32xi16>>, plaintext_space = #plaintext_space>
+!pt1 = !lwe.new_lwe_plaintext<application_data = <message_type = i16>, plaintext_space = #plaintext_space>
+#ciphertext_space_L0_ = #lwe.ciphertext_space<ring = #ring_rns_L0_1_x32_, encryption_type = lsb>
+#ciphertext_space_L1_ = #lwe.ciphertext_space<ring = #ring_rns_L1_1_x32_, encryption_type = lsb>
+!ct_L0_ = !lwe.new_lwe_ciphertext<application_data = <message_type = i16>, plaintext_space = #plaintext_space, ciphertext_space = #ciphertext_space_L0_, key = #key, modulus_chain = #modulus_chain_L5_C0_>
+!ct_L1_ = !lwe.new_lwe_ciphertext<application_data = <message_type = tensor<32xi16>>, plaintext_space = #plaintext_space, ciphertext_space = #ciphertext_space_L1_, key = #key, modulus_chain = #modulus_chain_L5_C1_>
+!ct_L1_1 = !lwe.new_lwe_ciphertext<application_data = <message_type = i16>, plaintext_space = #plaintext_space, ciphertext_space = #ciphertext_space_L1_, key = #key, modulus_chain = #modulus_chain_L5_C1_>
+
+func.func @simple_rot(%arg0: !openfhe.crypto_context, %arg1: !ct_L1_) -> !ct_L1_ {
+  %0 = openfhe.rot %arg0, %arg1 {index = 16 : index} : (!openfhe.crypto_context, !ct_L1_) -> !ct_L1_
+  %1 = openfhe.rot %arg0, %0 {index = 8 : index} : (!openfhe.crypto_context, !ct_L1_) -> !ct_L1_
+  return %1 : !ct_L1_
+}
+
+// CHECK: @simple_rot
+// CHECK: @simple_rot__generate_crypto_context
+// CHECK: @simple_rot__configure_crypto_context
+
+// CHECK: func.func @simple_rot__save_crypto_context(%[[CC:.*]]: !openfhe.crypto_context) -> !openfhe.crypto_context
+// CHECK-NEXT: openfhe.save_crypto_context %[[CC]] {key = "[[KEY:simple_rot_[0-9a-f]+]]"}
+// CHECK-NEXT: return %[[CC]]
+
+// CHECK: func.func @simple_rot__load_crypto_context() -> !openfhe.crypto_context
+// CHECK-NEXT: %[[LOADED:.*]] = openfhe.load_crypto_context {key = "[[KEY]]"}
+// CHECK-NEXT: return %[[LOADED]]
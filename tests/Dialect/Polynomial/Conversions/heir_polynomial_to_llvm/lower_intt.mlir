@@ -15,7 +15,7 @@
 // CHECK-DAG: #[[MUL_MAP:.*]] = affine_map<(d0, d1) -> (d0 * d1)>
 // CHECK-DAG: #[[DIV_MAP:.*]] = affine_map<(d0, d1) -> (d0 floordiv d1)>
 // CHECK-DAG: #[[ADD_DIV_MAP:.*]] = affine_map<(d0, d1) -> (d0 + d1 floordiv 2)>
-// CHECK-DAG: #[[ROOT_MAP:.*]] = affine_map<(d0, d1) -> ((d0 * 2 + 1) * d1)>
+// CHECK-DAG: #[[ROOT_MAP:.*]] = affine_map<(d0, d1) -> (d0 + d1 floordiv 2 - 1)>
 
 // CHECK:     func.func @lower_intt() -> [[MOD_TYPE:.*]] {
 // CHECK:      %[[COEFFS:.*]] = arith.constant dense<[1, 2, 3, 4]> : [[INPUT_TYPE:.*]]
@@ -23,16 +23,16 @@
 // CHECK:      %[[COEFFS_CAST:.*]] = tensor.cast %[[COEFFS_ENC]] : [[RING_MOD_TYPE]] to [[MOD_TYPE:.*]]
 
 // CHECK-DAG:  %[[INITIAL_VALUE:.*]] = mod_arith.reduce %[[COEFFS_CAST]] : [[MOD_TYPE]]
-// CHECK-DAG:  %[[ROOTS:.*]] = arith.constant dense<[1, 1213, 4298, 5756]> : [[INT_TYPE:.*]]
-// CHECK-DAG:  %[[ROOTS_ENC:.*]] = mod_arith.encapsulate %[[ROOTS]] : [[INT_TYPE]] -> [[MOD_TYPE]]
+// CHECK-DAG:  %[[TWIDDLES:.*]] = arith.constant dense<[4298, 1213, 5756]> : [[TWIDDLES_TYPE:.*]]
+// CHECK-DAG:  %[[TWIDDLES_ENC:.*]] = mod_arith.encapsulate %[[TWIDDLES]] : [[TWIDDLES_TYPE]] -> [[TWIDDLES_MOD_TYPE:.*]]
+// CHECK-DAG:  %[[TWIDDLES_SHOUP:.*]] = arith.constant dense<[-1891664414, 678270450, -1076397871]> : [[TWIDDLES_TYPE]]
 
 // CHECK-DAG:    %[[ZERO:.*]] = arith.constant 0 : index
-// CHECK-DAG:    %[[ONE:.*]] = arith.constant 1 : index
 // CHECK-DAG:    %[[TWO:.*]] = arith.constant 2 : index
 // CHECK-DAG:    %[[N:.*]] = arith.constant 4 : index
 
-// CHECK:        %[[RES:.]]:3 = affine.for %[[_:.*]] = 0 to 2
-// CHECK-SAME:     iter_args(%[[TARGET:.*]] = %[[INITIAL_VALUE]], %[[BATCH_SIZE:.*]] = %[[N]], %[[ROOT_EXP:.*]] = %[[ONE]]) -> ([[MOD_TYPE]], index, index) {
+// CHECK:        %[[RES:.]]:2 = affine.for %[[_:.*]] = 0 to 2
+// CHECK-SAME:     iter_args(%[[TARGET:.*]] = %[[INITIAL_VALUE]], %[[BATCH_SIZE:.*]] = %[[N]]) -> ([[MOD_TYPE]], index) {
 // CHECK:          %[[INNER_RES:.]] = affine.for %[[INDEX:.*]] = #[[ID_MAP]](%[[ZERO]]) to #[[DIV_MAP]](%[[N]], %[[BATCH_SIZE]])
 // CHECK-SAME:       iter_args(%[[INNER_TARGET:.*]] = %[[TARGET]]) -> ([[MOD_TYPE]]) {
 // CHECK:            %[[INDEX_K:.*]] = affine.apply #[[MUL_MAP]](%[[BATCH_SIZE]], %[[INDEX]])
@@ -45,12 +45,13 @@
 // CHECK:              %[[INDEX_B:.*]] = affine.apply #[[ADD_DIV_MAP]](%[[INDEX_A]], %[[BATCH_SIZE]])
 // CHECK:              %[[B:.*]] = tensor.extract %[[ARITH_TARGET]][%[[INDEX_B]]] : [[MOD_TYPE]]
 
-// CHECK:              %[[ROOT_INDEX:.*]] = affine.apply #[[ROOT_MAP]](%[[INDEX_J]], %[[ROOT_EXP]])
-// CHECK:              %[[ROOT:.*]] = tensor.extract %[[ROOTS_ENC]][%[[ROOT_INDEX]]] : [[MOD_TYPE]]
+// CHECK:              %[[ROOT_INDEX:.*]] = affine.apply #[[ROOT_MAP]](%[[INDEX_J]], %[[BATCH_SIZE]])
+// CHECK:              %[[ROOT:.*]] = tensor.extract %[[TWIDDLES_ENC]][%[[ROOT_INDEX]]] : [[TWIDDLES_MOD_TYPE]]
+// CHECK:              %[[ROOT_SHOUP:.*]] = tensor.extract %[[TWIDDLES_SHOUP]][%[[ROOT_INDEX]]] : [[TWIDDLES_TYPE]]
 
 // CHECK:              %[[GSPLUS:.*]] = mod_arith.add %[[A]], %[[B]] : [[coeff_ty:.*]]
 // CHECK:              %[[AMINUSB:.*]] = mod_arith.sub %[[A]], %[[B]] : [[coeff_ty]]
-// CHECK:              %[[GSMINUS:.*]] = mod_arith.mul %[[AMINUSB]], %[[ROOT]] : [[coeff_ty]]
+// CHECK:              %[[GSMINUS:.*]] = mod_arith.mul_shoup %[[AMINUSB]], %[[ROOT]], %[[ROOT_SHOUP]] : [[coeff_ty]], i32
 
 // CHECK:              %[[INSERT_PLUS:.*]] = tensor.insert %[[GSPLUS]] into %[[ARITH_TARGET]][%[[INDEX_A]]] : [[MOD_TYPE]]
 // CHECK:              %[[INSERT_MINUS:.*]] = tensor.insert %[[GSMINUS]] into %[[INSERT_PLUS]][%[[INDEX_B]]] : [[MOD_TYPE]]
@@ -59,10 +60,9 @@
 // CHECK:            affine.yield %[[ARITH_RES]] : [[MOD_TYPE]]
 
 // CHECK:          %[[NEXT_BATCH_SIZE:.*]] = arith.divui %[[BATCH_SIZE]], %[[TWO]] : index
-// CHECK:          %[[NEXT_ROOT_EXP:.*]] = arith.muli %[[ROOT_EXP]], %[[TWO]] : index
-// CHECK:          affine.yield %[[INNER_RES]], %[[NEXT_BATCH_SIZE]], %[[NEXT_ROOT_EXP]] : [[MOD_TYPE]], index, index
+// CHECK:          affine.yield %[[INNER_RES]], %[[NEXT_BATCH_SIZE]] : [[MOD_TYPE]], index
 
-// CHECK:       %[[N_INV_VEC:.*]] = arith.constant dense<5761> : [[INT_TYPE]]
+// CHECK:       %[[N_INV_VEC:.*]] = arith.constant dense<5761> : [[INT_TYPE:.*]]
 // CHECK:       %[[N_INV_VEC_ENC:.*]] = mod_arith.encapsulate %[[N_INV_VEC]] : [[INT_TYPE]] -> [[MOD_TYPE]]
 
 // CHECK:       %[[RES_INTT:.*]] = mod_arith.mul %[[RES]]#0, %[[N_INV_VEC_ENC]] : [[MOD_TYPE]]
@@ -15,7 +15,7 @@
 // CHECK-DAG: #[[MUL_MAP:.*]] = affine_map<(d0, d1) -> (d0 * d1)>
 // CHECK-DAG: #[[DIV_MAP:.*]] = affine_map<(d0, d1) -> (d0 floordiv d1)>
 // CHECK-DAG: #[[ADD_DIV_MAP:.*]] = affine_map<(d0, d1) -> (d0 + d1 floordiv 2)>
-// CHECK-DAG: #[[ROOT_MAP:.*]] = affine_map<(d0, d1) -> ((d0 * 2 + 1) * d1)>
+// CHECK-DAG: #[[ROOT_MAP:.*]] = affine_map<(d0, d1) -> (d0 + d1 floordiv 2 - 1)>
 
 // CHECK:     func.func @lower_ntt() -> [[OUTPUT_TYPE:.*]] {
 // CHECK:      %[[COEFFS:.*]] = arith.constant dense<[1, 2, 3, 4]> : [[INT_TYPE:.*]]
@@ -31,15 +31,16 @@
 // CHECK:       } -> [[MOD_TYPE]]
 
 // CHECK-DAG:  %[[INITIAL_VALUE:.*]] = mod_arith.reduce %[[ORDERED_INPUT]] : [[MOD_TYPE]]
-// CHECK-DAG:  %[[ROOTS:.*]] = arith.constant dense<[1, 1925, 3383, 6468]> : [[INT_TYPE]]
-// CHECK-DAG:  %[[ROOTS_ENC:.*]] = mod_arith.encapsulate %[[ROOTS]] : [[INT_TYPE]] -> [[MOD_TYPE]]
+// CHECK-DAG:  %[[TWIDDLES:.*]] = arith.constant dense<[3383, 1925, 6468]> : [[TWIDDLES_TYPE:.*]]
+// CHECK-DAG:  %[[TWIDDLES_ENC:.*]] = mod_arith.encapsulate %[[TWIDDLES]] : [[TWIDDLES_TYPE]] -> [[TWIDDLES_MOD_TYPE:.*]]
+// CHECK-DAG:  %[[TWIDDLES_SHOUP:.*]] = arith.constant dense<[1891664413, 1076397870, -678270451]> : [[TWIDDLES_TYPE]]
 
 // CHECK-DAG:    %[[ZERO:.*]] = arith.constant 0 : index
 // CHECK-DAG:    %[[TWO:.*]] = arith.constant 2 : index
 // CHECK-DAG:    %[[N:.*]] = arith.constant 4 : index
 
-// CHECK:        %[[RES:.]]:3 = affine.for %[[_:.*]] = 0 to 2
-// CHECK-SAME:     iter_args(%[[TARGET:.*]] = %[[INITIAL_VALUE]], %[[BATCH_SIZE:.*]] = %[[TWO]], %[[ROOT_EXP:.*]] = %[[TWO]]) -> ([[MOD_TYPE]], index, index) {
+// CHECK:        %[[RES:.]]:2 = affine.for %[[_:.*]] = 0 to 2
+// CHECK-SAME:     iter_args(%[[TARGET:.*]] = %[[INITIAL_VALUE]], %[[BATCH_SIZE:.*]] = %[[TWO]]) -> ([[MOD_TYPE]], index) {
 // CHECK:          %[[INNER_RES:.]] = affine.for %[[INDEX:.*]] = #[[ID_MAP]](%[[ZERO]]) to #[[DIV_MAP]](%[[N]], %[[BATCH_SIZE]])
 // CHECK-SAME:       iter_args(%[[INNER_TARGET:.*]] = %[[TARGET]]) -> ([[MOD_TYPE]]) {
 // CHECK:            %[[INDEX_K:.*]] = affine.apply #[[MUL_MAP]](%[[BATCH_SIZE]], %[[INDEX]])
@@ -51,10 +52,11 @@
 // CHECK:              %[[INDEX_B:.*]] = affine.apply #[[ADD_DIV_MAP]](%[[INDEX_A]], %[[BATCH_SIZE]])
 // CHECK:              %[[B:.*]] = tensor.extract %[[ARITH_TARGET]][%[[INDEX_B]]] : [[MOD_TYPE]]
 
-// CHECK:              %[[ROOT_INDEX:.*]] = affine.apply #[[ROOT_MAP]](%[[INDEX_J]], %[[ROOT_EXP]])
-// CHECK:              %[[ROOT:.*]] = tensor.extract %[[ROOTS_ENC]][%[[ROOT_INDEX]]] : [[MOD_TYPE]]
+// CHECK:              %[[ROOT_INDEX:.*]] = affine.apply #[[ROOT_MAP]](%[[INDEX_J]], %[[BATCH_SIZE]])
+// CHECK:              %[[ROOT:.*]] = tensor.extract %[[TWIDDLES_ENC]][%[[ROOT_INDEX]]] : [[TWIDDLES_MOD_TYPE]]
+// CHECK:              %[[ROOT_SHOUP:.*]] = tensor.extract %[[TWIDDLES_SHOUP]][%[[ROOT_INDEX]]] : [[TWIDDLES_TYPE]]
 
-// CHECK:              %[[ROOTSB:.*]] = mod_arith.mul %[[B]], %[[ROOT]] : [[COEFF_TYPE]]
+// CHECK:              %[[ROOTSB:.*]] = mod_arith.mul_shoup %[[B]], %[[ROOT]], %[[ROOT_SHOUP]] : [[COEFF_TYPE]], i32
 // CHECK:              %[[CTPLUS:.*]] = mod_arith.add %[[A]], %[[ROOTSB]] : [[COEFF_TYPE]]
 // CHECK:              %[[CTMINUS:.*]] = mod_arith.sub %[[A]], %[[ROOTSB]] : [[COEFF_TYPE]]
 
@@ -65,8 +67,7 @@
 // CHECK:            affine.yield %[[ARITH_RES]] : [[MOD_TYPE]]
 
 // CHECK:          %[[NEXT_BATCH_SIZE:.*]] = arith.muli %[[BATCH_SIZE]], %[[TWO]] : index
-// CHECK:          %[[NEXT_ROOT_EXP:.*]] = arith.divui %[[ROOT_EXP]], %[[TWO]] : index
-// CHECK:          affine.yield %[[INNER_RES]], %[[NEXT_BATCH_SIZE]], %[[NEXT_ROOT_EXP]] : [[MOD_TYPE]], index, index
+// CHECK:          affine.yield %[[INNER_RES]], %[[NEXT_BATCH_SIZE]] : [[MOD_TYPE]], index
 
 // CHECK:       %[[RES_CAST:.*]] = tensor.cast %[[RES]]#0 : [[MOD_TYPE]] to [[OUTPUT_TYPE]]
 // CHECK:       return %[[RES_CAST]] : [[OUTPUT_TYPE]]
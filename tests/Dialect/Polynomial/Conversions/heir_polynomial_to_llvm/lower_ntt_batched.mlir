@@ -0,0 +1,33 @@
+// RUN: heir-opt --polynomial-to-mod-arith=ntt-schedule=radix2 --cse %s | FileCheck %s
+
+#cycl = #polynomial.int_polynomial<1 + x**4>
+!coeff_ty = !mod_arith.int<7681:i32>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#cycl>
+#root = #polynomial.primitive_root<value=1925:i32, degree=8:i32>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+// The batch is transposed so that each row holds one coefficient of every
+// polynomial. Each butterfly then loads a single twiddle, broadcasts it over
+// the row, and multiplies whole rows.
+
+// CHECK: @lower_ntt_batched
+// CHECK-SAME: (%[[INPUT:.*]]: tensor<2x4x!Z7681_i32>)
+// CHECK: %[[TRANSPOSED:.*]] = linalg.generic
+// CHECK-SAME: ins(%[[INPUT]] : tensor<2x4x!Z7681_i32>)
+// CHECK-SAME: -> tensor<4x2x!Z7681_i32>
+// CHECK: affine.for
+// CHECK: tensor.extract %{{.*}} : tensor<3xi32>
+// CHECK: tensor.splat
+// CHECK: mod_arith.encapsulate
+// CHECK-SAME: -> tensor<2x!Z7681_i32>
+// CHECK: tensor.extract_slice %{{.*}} : tensor<4x2x!Z7681_i32> to tensor<2x!Z7681_i32>
+// CHECK: mod_arith.mul_shoup
+// CHECK-SAME: tensor<2x!Z7681_i32>
+// CHECK: tensor.insert_slice %{{.*}} : tensor<2x!Z7681_i32> into tensor<4x2x!Z7681_i32>
+// CHECK: linalg.generic
+// CHECK-SAME: -> tensor<2x4x!Z7681_i32>
+// CHECK: return %{{.*}} : tensor<2x4x!Z7681_i32, #ring>
+func.func @lower_ntt_batched(%polys: tensor<2x!poly_ty>) -> tensor<2x4x!coeff_ty, #ring> {
+  %0 = polynomial.ntt %polys {root=#root} : tensor<2x!poly_ty> -> tensor<2x4x!coeff_ty, #ring>
+  return %0 : tensor<2x4x!coeff_ty, #ring>
+}
@@ -0,0 +1,67 @@
+// RUN: heir-opt %s --heir-polynomial-to-llvm \
+// RUN:   | mlir-runner -e test_poly_ntt_batched -entry-point-result=void \
+// RUN:      --shared-libs="%mlir_lib_dir/libmlir_c_runner_utils%shlibext,%mlir_runner_utils" > %t
+// RUN: FileCheck %s --check-prefix=CHECK_TEST_POLY_NTT_BATCHED < %t
+// RUN: heir-opt %s --polynomial-to-mod-arith=ntt-schedule=radix4 --heir-polynomial-to-llvm \
+// RUN:   | mlir-runner -e test_poly_ntt_batched -entry-point-result=void \
+// RUN:      --shared-libs="%mlir_lib_dir/libmlir_c_runner_utils%shlibext,%mlir_runner_utils" > %t
+// RUN: FileCheck %s --check-prefix=CHECK_TEST_POLY_NTT_BATCHED < %t
+// RUN: heir-opt %s --polynomial-to-mod-arith="ntt-schedule=blocked ntt-block-bytes=16" --heir-polynomial-to-llvm \
+// RUN:   | mlir-runner -e test_poly_ntt_batched -entry-point-result=void \
+// RUN:      --shared-libs="%mlir_lib_dir/libmlir_c_runner_utils%shlibext,%mlir_runner_utils" > %t
+// RUN: FileCheck %s --check-prefix=CHECK_TEST_POLY_NTT_BATCHED < %t
+
+// Each row of the batched transform must match the single-polynomial NTT
+// (cf. lower_ntt_runner.mlir), and the batched INTT must invert it, with every
+// schedule. With 2 polynomials, 16 bytes per block hold 2 coefficients of each
+// polynomial, so the blocked schedule has a block-local and a global stage.
+
+func.func private @printMemrefI32(memref<*xi32>) attributes { llvm.emit_c_interface }
+
+#cycl = #polynomial.int_polynomial<1 + x**4>
+!coeff_ty = !mod_arith.int<7681:i32>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#cycl>
+#root = #polynomial.primitive_root<value=1925:i32, degree=8:i32>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+func.func @print_row(%row: tensor<4xi32>) {
+  %0 = bufferization.to_memref %row : tensor<4xi32> to memref<4xi32>
+  %U = memref.cast %0 : memref<4xi32> to memref<*xi32>
+  func.call @printMemrefI32(%U) : (memref<*xi32>) -> ()
+  return
+}
+
+func.func @test_poly_ntt_batched() {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %raw0 = arith.constant dense<[1,2,3,4]> : tensor<4xi32>
+  %raw1 = arith.constant dense<[5,6,7,8]> : tensor<4xi32>
+  %coeffs0 = mod_arith.encapsulate %raw0 : tensor<4xi32> -> tensor<4x!coeff_ty>
+  %coeffs1 = mod_arith.encapsulate %raw1 : tensor<4xi32> -> tensor<4x!coeff_ty>
+  %poly0 = polynomial.from_tensor %coeffs0 : tensor<4x!coeff_ty> -> !poly_ty
+  %poly1 = polynomial.from_tensor %coeffs1 : tensor<4x!coeff_ty> -> !poly_ty
+  %polys = tensor.from_elements %poly0, %poly1 : tensor<2x!poly_ty>
+
+  %ntt = polynomial.ntt %polys {root=#root} : tensor<2x!poly_ty> -> tensor<2x4x!coeff_ty, #ring>
+  %extract = mod_arith.extract %ntt : tensor<2x4x!coeff_ty, #ring> -> tensor<2x4xi32, #ring>
+  %evals = tensor.cast %extract : tensor<2x4xi32, #ring> to tensor<2x4xi32>
+  %evals0 = tensor.extract_slice %evals[0, 0] [1, 4] [1, 1] : tensor<2x4xi32> to tensor<4xi32>
+  %evals1 = tensor.extract_slice %evals[1, 0] [1, 4] [1, 1] : tensor<2x4xi32> to tensor<4xi32>
+  func.call @print_row(%evals0) : (tensor<4xi32>) -> ()
+  func.call @print_row(%evals1) : (tensor<4xi32>) -> ()
+
+  %intt = polynomial.intt %ntt {root=#root} : tensor<2x4x!coeff_ty, #ring> -> tensor<2x!poly_ty>
+  %back0 = tensor.extract %intt[%c0] : tensor<2x!poly_ty>
+  %back1 = tensor.extract %intt[%c1] : tensor<2x!poly_ty>
+  %t0 = polynomial.to_tensor %back0 : !poly_ty -> tensor<4x!coeff_ty>
+  %t1 = polynomial.to_tensor %back1 : !poly_ty -> tensor<4x!coeff_ty>
+  %r0 = mod_arith.extract %t0 : tensor<4x!coeff_ty> -> tensor<4xi32>
+  %r1 = mod_arith.extract %t1 : tensor<4x!coeff_ty> -> tensor<4xi32>
+  func.call @print_row(%r0) : (tensor<4xi32>) -> ()
+  func.call @print_row(%r1) : (tensor<4xi32>) -> ()
+  return
+}
+// CHECK_TEST_POLY_NTT_BATCHED: [1467, 2807, 3471, 7621]
+// CHECK_TEST_POLY_NTT_BATCHED: [2489, 7489, 6478, 6607]
+// CHECK_TEST_POLY_NTT_BATCHED: [1, 2, 3, 4]
+// CHECK_TEST_POLY_NTT_BATCHED: [5, 6, 7, 8]
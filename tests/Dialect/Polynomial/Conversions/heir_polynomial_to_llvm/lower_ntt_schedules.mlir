@@ -0,0 +1,89 @@
+// RUN: heir-opt --split-input-file --polynomial-to-mod-arith=ntt-schedule=radix4 --cse %s | FileCheck %s --check-prefix=RADIX4
+// RUN: heir-opt --split-input-file --polynomial-to-mod-arith="ntt-schedule=blocked ntt-block-bytes=8" --cse %s | FileCheck %s --check-prefix=BLOCKED
+// RUN: heir-opt --split-input-file --polynomial-to-mod-arith %s | FileCheck %s --check-prefix=AUTO
+
+#cycl = #polynomial.int_polynomial<1 + x**4>
+!coeff_ty = !mod_arith.int<7681:i32>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#cycl>
+#root = #polynomial.primitive_root<value=1925:i32, degree=8:i32>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+// Both stages of a degree 4 transform are fused into a single radix-4 pass,
+// which loads four coefficients and applies four butterflies.
+
+// RADIX4: @lower_ntt
+// RADIX4-DAG: %[[ONE:.*]] = arith.constant 1 : index
+// RADIX4-DAG: %[[FOUR:.*]] = arith.constant 4 : index
+// RADIX4: affine.for %{{.*}} = 0 to 1 iter_args(%{{.*}} = %{{.*}}, %[[QUARTER:.*]] = %[[ONE]])
+// RADIX4: affine.for
+// RADIX4: affine.for
+// RADIX4-COUNT-4: tensor.extract %{{.*}}[%{{.*}}] : tensor<4x!Z7681_i32>
+// RADIX4-COUNT-4: mod_arith.mul_shoup
+// RADIX4-COUNT-4: tensor.insert
+// RADIX4: arith.muli %[[QUARTER]], %[[FOUR]] : index
+
+// The blocked schedule with blocks of two coefficients runs the first stage
+// on extracted slices and the second stage on the whole tensor.
+
+// BLOCKED: @lower_ntt
+// BLOCKED: affine.for %[[BLOCK:.*]] = 0 to 2 iter_args(%[[TARGET:.*]] = %{{.*}})
+// BLOCKED: %[[OFFSET:.*]] = affine.apply #{{.*}}(%[[BLOCK]])
+// BLOCKED: %[[SLICE:.*]] = tensor.extract_slice %[[TARGET]][%[[OFFSET]]] [2] [1] : tensor<4x!Z7681_i32> to tensor<2x!Z7681_i32>
+// BLOCKED: affine.for %{{.*}} = 0 to 1 iter_args(%{{.*}} = %[[SLICE]]
+// BLOCKED: mod_arith.mul_shoup
+// BLOCKED: tensor.insert_slice %{{.*}} into %[[TARGET]][%[[OFFSET]]] [2] [1] : tensor<2x!Z7681_i32> into tensor<4x!Z7681_i32>
+// BLOCKED: affine.for %{{.*}} = 0 to 1
+// BLOCKED: mod_arith.mul_shoup
+
+// Small transforms default to radix-2.
+
+// AUTO: @lower_ntt
+// AUTO: affine.for %{{.*}} = 0 to 2
+// AUTO-NOT: tensor.extract_slice
+
+func.func @lower_ntt() -> tensor<4x!coeff_ty, #ring> {
+  %coeffsRaw = arith.constant dense<[1, 2, 3, 4]> : tensor<4xi32>
+  %coeffs = mod_arith.encapsulate %coeffsRaw : tensor<4xi32> -> tensor<4x!coeff_ty>
+  %poly = polynomial.from_tensor %coeffs : tensor<4x!coeff_ty> -> !poly_ty
+  %ret = polynomial.ntt %poly {root=#root} : !poly_ty -> tensor<4x!coeff_ty, #ring>
+  return %ret : tensor<4x!coeff_ty, #ring>
+}
+
+// -----
+
+#cycl = #polynomial.int_polynomial<1 + x**4>
+!coeff_ty = !mod_arith.int<7681:i32>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#cycl>
+#root = #polynomial.primitive_root<value=1925:i32, degree=8:i32>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+// The inverse radix-4 pass starts from a quarter of the degree and shrinks.
+
+// RADIX4: @lower_intt
+// RADIX4-DAG: %[[ONE:.*]] = arith.constant 1 : index
+// RADIX4-DAG: %[[FOUR:.*]] = arith.constant 4 : index
+// RADIX4: affine.for %{{.*}} = 0 to 1 iter_args(%{{.*}} = %{{.*}}, %[[QUARTER:.*]] = %[[ONE]])
+// RADIX4-COUNT-4: mod_arith.mul_shoup
+// RADIX4: arith.divui %[[QUARTER]], %[[FOUR]] : index
+
+// The inverse blocked schedule runs the global stage first.
+
+// BLOCKED: @lower_intt
+// BLOCKED: affine.for %{{.*}} = 0 to 1
+// BLOCKED: mod_arith.mul_shoup
+// BLOCKED: affine.for %{{.*}} = 0 to 2
+// BLOCKED: tensor.extract_slice
+// BLOCKED: mod_arith.mul_shoup
+// BLOCKED: tensor.insert_slice
+
+// AUTO: @lower_intt
+// AUTO: affine.for %{{.*}} = 0 to 2
+// AUTO-NOT: tensor.extract_slice
+
+func.func @lower_intt() -> !poly_ty {
+  %coeffsRaw = arith.constant dense<[1467, 2807, 3471, 7621]> : tensor<4xi32>
+  %coeffs = tensor.cast %coeffsRaw : tensor<4xi32> to tensor<4xi32, #ring>
+  %coeffs_enc = mod_arith.encapsulate %coeffs : tensor<4xi32, #ring> -> tensor<4x!coeff_ty, #ring>
+  %ret = polynomial.intt %coeffs_enc {root=#root} : tensor<4x!coeff_ty, #ring> -> !poly_ty
+  return %ret : !poly_ty
+}
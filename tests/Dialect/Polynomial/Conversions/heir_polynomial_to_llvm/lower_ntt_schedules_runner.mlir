@@ -0,0 +1,51 @@
+// RUN: heir-opt %s --polynomial-to-mod-arith=ntt-schedule=radix2 --heir-polynomial-to-llvm \
+// RUN:   | mlir-runner -e test_ntt_schedules -entry-point-result=void \
+// RUN:      --shared-libs="%mlir_lib_dir/libmlir_c_runner_utils%shlibext,%mlir_runner_utils" > %t
+// RUN: FileCheck %s < %t
+// RUN: heir-opt %s --polynomial-to-mod-arith=ntt-schedule=radix4 --heir-polynomial-to-llvm \
+// RUN:   | mlir-runner -e test_ntt_schedules -entry-point-result=void \
+// RUN:      --shared-libs="%mlir_lib_dir/libmlir_c_runner_utils%shlibext,%mlir_runner_utils" > %t
+// RUN: FileCheck %s < %t
+// RUN: heir-opt %s --polynomial-to-mod-arith="ntt-schedule=blocked ntt-block-bytes=16" --heir-polynomial-to-llvm \
+// RUN:   | mlir-runner -e test_ntt_schedules -entry-point-result=void \
+// RUN:      --shared-libs="%mlir_lib_dir/libmlir_c_runner_utils%shlibext,%mlir_runner_utils" > %t
+// RUN: FileCheck %s < %t
+// RUN: heir-opt %s --polynomial-to-mod-arith="ntt-schedule=blocked ntt-block-bytes=8" --heir-polynomial-to-llvm \
+// RUN:   | mlir-runner -e test_ntt_schedules -entry-point-result=void \
+// RUN:      --shared-libs="%mlir_lib_dir/libmlir_c_runner_utils%shlibext,%mlir_runner_utils" > %t
+// RUN: FileCheck %s < %t
+
+// All schedules compute the same transform. The blocked schedules use blocks
+// of 4 and 2 coefficients respectively, so that both even and odd numbers of
+// block-local and global stages are exercised.
+
+func.func private @printMemrefI32(memref<*xi32>) attributes { llvm.emit_c_interface }
+
+#cycl = #polynomial.int_polynomial<1 + x**16>
+!coeff_ty = !mod_arith.int<7681:i32>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#cycl>
+#root = #polynomial.primitive_root<value=6315:i32, degree=32:i32>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+func.func @test_ntt_schedules() {
+  %coeffsRaw = arith.constant dense<[1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16]> : tensor<16xi32>
+  %coeffs = mod_arith.encapsulate %coeffsRaw : tensor<16xi32> -> tensor<16x!coeff_ty>
+  %poly = polynomial.from_tensor %coeffs : tensor<16x!coeff_ty> -> !poly_ty
+  %ntt = polynomial.ntt %poly {root=#root} : !poly_ty -> tensor<16x!coeff_ty, #ring>
+
+  %0 = mod_arith.extract %ntt : tensor<16x!coeff_ty, #ring> -> tensor<16xi32, #ring>
+  %1 = tensor.cast %0 : tensor<16xi32, #ring> to tensor<16xi32>
+  %2 = bufferization.to_memref %1 : tensor<16xi32> to memref<16xi32>
+  %U = memref.cast %2 : memref<16xi32> to memref<*xi32>
+  func.call @printMemrefI32(%U) : (memref<*xi32>) -> ()
+
+  %intt = polynomial.intt %ntt {root=#root} : tensor<16x!coeff_ty, #ring> -> !poly_ty
+  %3 = polynomial.to_tensor %intt : !poly_ty -> tensor<16x!coeff_ty>
+  %4 = mod_arith.extract %3 : tensor<16x!coeff_ty> -> tensor<16xi32>
+  %5 = bufferization.to_memref %4 : tensor<16xi32> to memref<16xi32>
+  %V = memref.cast %5 : memref<16xi32> to memref<*xi32>
+  func.call @printMemrefI32(%V) : (memref<*xi32>) -> ()
+  return
+}
+// CHECK: [2106, 5121, 6987, 6929, 1920, 6399, 4670, 4357, 68, 907, 3537, 3237, 5669, 3364, 310, 5883]
+// CHECK: [1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15, 16]
@@ -0,0 +1,21 @@
+// RUN: heir-opt --heir-polynomial-to-llvm="parallelize=true num-threads=4" %s | FileCheck %s
+
+// The multiplications of the polynomials of a tensor, and the pointwise
+// addition over the coefficients of a polynomial, run in OpenMP parallel
+// loops.
+
+#cycl = #polynomial.int_polynomial<1 + x**1024>
+!coeff_ty = !mod_arith.int<7681:i32>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#cycl>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+// CHECK: @test_parallel
+// CHECK: omp.parallel num_threads
+// CHECK: omp.wsloop
+// CHECK: omp.parallel num_threads
+// CHECK: omp.wsloop
+func.func @test_parallel(%x: tensor<2x!poly_ty>, %y: tensor<2x!poly_ty>, %a: !poly_ty, %b: !poly_ty) -> (tensor<2x!poly_ty>, !poly_ty) {
+  %0 = polynomial.mul %x, %y : tensor<2x!poly_ty>
+  %1 = polynomial.add %a, %b : !poly_ty
+  return %0, %1 : tensor<2x!poly_ty>, !poly_ty
+}
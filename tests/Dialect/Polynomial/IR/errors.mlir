@@ -41,3 +41,30 @@ func.func @test_monomial() {
   %0 = polynomial.monomial %five, %deg : (i32, index) -> !polynomial.polynomial<ring=#ring>
   return
 }
+
+// -----
+
+#poly = #polynomial.int_polynomial<1 + x**4>
+!coeff_ty = !mod_arith.int<7681:i32>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#poly>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+func.func @test_batched_ntt_shape(%p0 : tensor<2x!poly_ty>) {
+  // expected-error@below {{does not match output type}}
+  // expected-note@below {{the tensor must have shape [d], or [k, d] for a tensor of k polynomials}}
+  %0 = polynomial.ntt %p0 : tensor<2x!poly_ty> -> tensor<4x!coeff_ty, #ring>
+  return
+}
+
+// -----
+
+#poly = #polynomial.int_polynomial<1 + x**4>
+!coeff_ty = !mod_arith.int<7681:i32>
+#ring = #polynomial.ring<coefficientType=!coeff_ty, polynomialModulus=#poly>
+!poly_ty = !polynomial.polynomial<ring=#ring>
+
+func.func @test_unranked_ntt(%p0 : tensor<*x!poly_ty>) {
+  // expected-error@below {{expects a polynomial or a ranked tensor of polynomials}}
+  %0 = polynomial.ntt %p0 : tensor<*x!poly_ty> -> tensor<4x!coeff_ty, #ring>
+  return
+}
@@ -113,4 +113,10 @@ module {
     %1 = polynomial.intt %0 {root=#polynomial.primitive_root<value=31:i32, degree=8:index>} : tensor<8x!coeff_ty2, #ntt_ring> -> !ntt_poly_ty
     return
   }
+
+  func.func @test_batched_ntt(%0 : tensor<2x!ntt_poly_ty>) {
+    %1 = polynomial.ntt %0 {root=#polynomial.primitive_root<value=31:i32, degree=8:index>} : tensor<2x!ntt_poly_ty> -> tensor<2x8x!coeff_ty2, #ntt_ring>
+    %2 = polynomial.intt %1 {root=#polynomial.primitive_root<value=31:i32, degree=8:index>} : tensor<2x8x!coeff_ty2, #ntt_ring> -> tensor<2x!ntt_poly_ty>
+    return
+  }
 }
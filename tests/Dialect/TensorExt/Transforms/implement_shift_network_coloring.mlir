@@ -0,0 +1,19 @@
+// RUN: heir-opt --implement-shift-network="ciphertext-size=16 coloring-strategy=dsatur" %s | FileCheck %s
+// RUN: heir-opt --implement-shift-network="ciphertext-size=16 coloring-strategy=iterated-greedy" %s | FileCheck %s
+// RUN: heir-opt --implement-shift-network="ciphertext-size=16 coloring-strategy=exact" %s | FileCheck %s
+// RUN: heir-opt --implement-shift-network="ciphertext-size=16 coloring-strategy=best" %s | FileCheck %s
+// RUN: heir-opt --implement-shift-network="ciphertext-size=16 coloring-strategy=best coloring-max-iterations=1 coloring-max-search-nodes=1" %s | FileCheck %s
+
+// Figure 3 of Vos-Vos-Erkin needs three rotation groups, which DSatur already
+// finds, so every strategy produces the same 12 rotations. The search budgets
+// are deterministic, and a coloring is never worse than DSatur even when the
+// budgets run out.
+#map = dense<[13, 8, 4, 0, 11, 7, 14, 5, 15, 3, 12, 6, 10, 2, 9, 1]> : tensor<16xi64>
+// CHECK: @figure3
+// CHECK-COUNT-12: tensor_ext.rotate
+// CHECK-NOT: tensor_ext.rotate
+// CHECK: return
+func.func @figure3(%0: tensor<16xi32>) -> tensor<16xi32> {
+  %1 = tensor_ext.permute %0 {permutation = #map} : tensor<16xi32>
+  return %1 : tensor<16xi32>
+}
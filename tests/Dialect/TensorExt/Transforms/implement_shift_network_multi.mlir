@@ -0,0 +1,48 @@
+// RUN: heir-opt --implement-shift-network=ciphertext-size=8 %s | FileCheck %s
+
+// Swapping two ciphertexts needs no rotations or masks.
+#swap = affine_map<(d0) -> ((d0 + 8) mod 16)>
+// CHECK: @test_swap
+// CHECK-SAME: [[arg0:%[^:]*]]: tensor<2x8xi32>
+// CHECK-DAG: [[ct0:%[^ ]*]] = tensor.extract_slice [[arg0]][0, 0] [1, 8] [1, 1]
+// CHECK-DAG: [[ct1:%[^ ]*]] = tensor.extract_slice [[arg0]][1, 0] [1, 8] [1, 1]
+// CHECK-NOT: tensor_ext.rotate
+// CHECK-NOT: arith.muli
+// CHECK: [[zero:%[^ ]*]] = arith.constant dense<0> : tensor<2x8xi32>
+// CHECK: [[ins0:%[^ ]*]] = tensor.insert_slice [[ct1]] into [[zero]][0, 0]
+// CHECK: [[ins1:%[^ ]*]] = tensor.insert_slice [[ct0]] into [[ins0]][1, 0]
+// CHECK: return [[ins1]]
+func.func @test_swap(%0: tensor<2x8xi32>) -> tensor<2x8xi32> {
+  %1 = tensor_ext.permute %0 {permutation = #swap} : tensor<2x8xi32>
+  return %1 : tensor<2x8xi32>
+}
+
+// Shifting the flattened tensor by one slot moves the last slot of each
+// ciphertext into the next ciphertext. Each ciphertext is rotated once by the
+// shift network, and the rotated ciphertext is masked into its two targets.
+#shift = affine_map<(d0) -> ((d0 + 1) mod 16)>
+// CHECK: @test_shift
+// CHECK-SAME: [[arg0:%[^:]*]]: tensor<2x8xi32>
+// CHECK: tensor.extract_slice [[arg0]][0, 0]
+// CHECK-COUNT-3: tensor_ext.rotate
+// CHECK: [[rot0:%[^ ]*]] = arith.addi
+// CHECK: [[mask00:%[^ ]*]] = arith.constant dense<[0, 1, 1, 1, 1, 1, 1, 1]>
+// CHECK: [[piece00:%[^ ]*]] = arith.muli [[rot0]], [[mask00]]
+// CHECK: [[mask01:%[^ ]*]] = arith.constant dense<[1, 0, 0, 0, 0, 0, 0, 0]>
+// CHECK: [[piece01:%[^ ]*]] = arith.muli [[rot0]], [[mask01]]
+// CHECK: tensor.extract_slice [[arg0]][1, 0]
+// CHECK-COUNT-3: tensor_ext.rotate
+// CHECK: [[rot1:%[^ ]*]] = arith.addi
+// CHECK: [[mask10:%[^ ]*]] = arith.constant dense<[1, 0, 0, 0, 0, 0, 0, 0]>
+// CHECK: [[piece10:%[^ ]*]] = arith.muli [[rot1]], [[mask10]]
+// CHECK: [[out0:%[^ ]*]] = arith.addi [[piece00]], [[piece10]]
+// CHECK: [[mask11:%[^ ]*]] = arith.constant dense<[0, 1, 1, 1, 1, 1, 1, 1]>
+// CHECK: [[piece11:%[^ ]*]] = arith.muli [[rot1]], [[mask11]]
+// CHECK: [[out1:%[^ ]*]] = arith.addi [[piece01]], [[piece11]]
+// CHECK: [[ins0:%[^ ]*]] = tensor.insert_slice [[out0]] into %{{.*}}[0, 0]
+// CHECK: [[ins1:%[^ ]*]] = tensor.insert_slice [[out1]] into [[ins0]][1, 0]
+// CHECK: return [[ins1]]
+func.func @test_shift(%0: tensor<2x8xi32>) -> tensor<2x8xi32> {
+  %1 = tensor_ext.permute %0 {permutation = #shift} : tensor<2x8xi32>
+  return %1 : tensor<2x8xi32>
+}
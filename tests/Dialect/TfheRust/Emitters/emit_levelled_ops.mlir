@@ -47,3 +47,23 @@ func.func @test_levelled_op_break(%sks : !sks, %lut: !lut, %input1 : !eui3, %inp
   %v4 = tfhe_rust.apply_lookup_table %sks, %v3, %lut : (!sks, !eui3, !lut) -> !eui3
   return %v4 : !eui3
 }
+
+// A multi-output lookup table reads its input from and writes its outputs to
+// temp_nodes when levelled ops produce or use them.
+// CHECK: pub fn test_levelled_many_lookup_table(
+// CHECK: ) -> Ciphertext {
+// CHECK: run_level
+// CHECK: let [[luts:v[0-9]+]] = {{.*}}.generate_many_lookup_table(
+// CHECK-NEXT: let {{\[}}[[v0:v[0-9]+]], [[v1:v[0-9]+]]{{\]}} : [Ciphertext; 2] = {{.*}}.apply_many_lookup_table(&temp_nodes[&{{[0-9]+}}], &[[luts]])
+// CHECK-NEXT: temp_nodes.insert({{[0-9]+}}, [[v0]].clone());
+// CHECK-NEXT: temp_nodes.insert({{[0-9]+}}, [[v1]].clone());
+// CHECK: run_level
+// CHECK:  temp_nodes[
+// CHECK-NEXT: }
+func.func @test_levelled_many_lookup_table(%sks : !sks, %input1 : !eui3, %input2 : !eui3) -> !eui3 {
+  %v0 = tfhe_rust.add %sks, %input1, %input2 : (!sks, !eui3, !eui3) -> !eui3
+  %luts = tfhe_rust.generate_many_lookup_table %sks {truthTables = array<i32: 8, 6>} : (!sks) -> !tfhe_rust.many_lookup_table
+  %v1:2 = tfhe_rust.apply_many_lookup_table %sks, %v0, %luts : (!sks, !eui3, !tfhe_rust.many_lookup_table) -> (!eui3, !eui3)
+  %v2 = tfhe_rust.add %sks, %v1#0, %v1#1 : (!sks, !eui3, !eui3) -> !eui3
+  return %v2 : !eui3
+}
@@ -111,3 +111,17 @@ func.func @test_plaintext_arith_ops(%sks : !sks, %input : i64) -> (!eui3) {
   %5 = tfhe_rust.create_trivial %sks, %4 : (!tfhe_rust.server_key, i1) -> !eui3
   return %5 : !eui3
 }
+
+// CHECK: pub fn test_apply_many_lookup_table(
+// CHECK-NEXT:   [[sks:v[0-9]+]]: &ServerKey,
+// CHECK-NEXT:   [[input:v[0-9]+]]: &Ciphertext,
+// CHECK-NEXT: ) -> (Ciphertext, Ciphertext) {
+// CHECK:      let [[luts:v[0-9]+]] = [[sks]].generate_many_lookup_table(&[&|x: u64| (8 >> x) & 1, &|x: u64| (6 >> x) & 1]);
+// CHECK-NEXT: let {{\[}}[[v0:v[0-9]+]], [[v1:v[0-9]+]]{{\]}} : [Ciphertext; 2] = [[sks]].apply_many_lookup_table(&[[input]], &[[luts]]).try_into().ok().unwrap();
+// CHECK-NEXT:   ([[v0]], [[v1]])
+// CHECK-NEXT: }
+func.func @test_apply_many_lookup_table(%sks : !sks, %input : !eui3) -> (!eui3, !eui3) {
+  %luts = tfhe_rust.generate_many_lookup_table %sks {truthTables = array<i32: 8, 6>} : (!sks) -> !tfhe_rust.many_lookup_table
+  %out:2 = tfhe_rust.apply_many_lookup_table %sks, %input, %luts : (!sks, !eui3, !tfhe_rust.many_lookup_table) -> (!eui3, !eui3)
+  return %out#0, %out#1 : !eui3, !eui3
+}
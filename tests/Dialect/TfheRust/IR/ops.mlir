@@ -44,4 +44,12 @@ module {
     %out = tfhe_rust.apply_lookup_table %sks, %eCombined, %lut : (!sks, !tfhe_rust.eui3, !tfhe_rust.lookup_table) -> !tfhe_rust.eui3
     return
   }
+
+  // CHECK: func @test_apply_many_lookup_table
+  // RS-LABEL: pub fn test_apply_many_lookup_table
+  func.func @test_apply_many_lookup_table(%sks : !sks, %input : !tfhe_rust.eui3) {
+    %luts = tfhe_rust.generate_many_lookup_table %sks {truthTables = array<i32: 8, 6>} : (!sks) -> !tfhe_rust.many_lookup_table
+    %out:2 = tfhe_rust.apply_many_lookup_table %sks, %input, %luts : (!sks, !tfhe_rust.eui3, !tfhe_rust.many_lookup_table) -> (!tfhe_rust.eui3, !tfhe_rust.eui3)
+    return
+  }
 }
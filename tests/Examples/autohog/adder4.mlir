@@ -1,4 +1,5 @@
 // RUN: heir-translate --import-autohog %S/adder4.json | FileCheck %s
+// RUN: heir-translate --import-autohog --autohog-streaming %S/adder4.json | FileCheck %s
 
 // CHECK: func private @"4bit-4bit-adder"
 // CHECK-SAME: (%[[arg0:.*]]: tensor<8x!lwe.lwe_ciphertext
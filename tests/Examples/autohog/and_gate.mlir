@@ -1,4 +1,5 @@
 // RUN: heir-translate --import-autohog %S/and_gate.json | FileCheck %s
+// RUN: heir-translate --import-autohog --autohog-streaming %S/and_gate.json | FileCheck %s
 
 // CHECK: and_gate
 // CHECK: cggi.and
@@ -1,4 +1,5 @@
 // RUN: heir-translate --import-autohog %S/direct_io_connection.json | FileCheck %s
+// RUN: heir-translate --import-autohog --autohog-streaming %S/direct_io_connection.json | FileCheck %s
 
 // CHECK: func.func private @direct_io_connection(
 // CHECK-SAME: %[[arg0:.*]]: tensor<2x!lwe.lwe_ciphertext
@@ -1,4 +1,5 @@
 // RUN: heir-translate --import-autohog %S/toposort.json | FileCheck %s
+// RUN: heir-translate --import-autohog --autohog-streaming %S/toposort.json | FileCheck %s
 
 // CHECK: func.func private @toposort(
 // CHECK: %[[v1:.*]] = cggi.or
@@ -0,0 +1,32 @@
+#include <cstdint>
+
+#include "gtest/gtest.h"  // from @googletest
+
+// Generated headers (block clang-format from messing up order)
+#include "tests/Examples/openfhe/bfv/power_loop/power_loop_lib.h"
+
+namespace mlir {
+namespace heir {
+namespace openfhe {
+
+TEST(PowerLoopTest, RunTest) {
+  auto cryptoContext = power__generate_crypto_context();
+  auto keyPair = cryptoContext->KeyGen();
+  auto publicKey = keyPair.publicKey;
+  auto secretKey = keyPair.secretKey;
+  cryptoContext = power__configure_crypto_context(cryptoContext, secretKey);
+
+  int16_t arg0 = 2;
+  int16_t expected = 256;
+
+  auto arg0Encrypted = power__encrypt__arg0(cryptoContext, arg0, publicKey);
+  auto outputEncrypted = power(cryptoContext, arg0Encrypted);
+  auto actual =
+      power__decrypt__result0(cryptoContext, outputEncrypted, secretKey);
+
+  EXPECT_EQ(expected, actual);
+}
+
+}  // namespace openfhe
+}  // namespace heir
+}  // namespace mlir
@@ -0,0 +1,14 @@
+// RUN: heir-opt --cggi-merge-luts --cggi-to-tfhe-rust --canonicalize --cse %s | heir-translate --emit-tfhe-rust > %S/src/fn_under_test.rs
+// RUN: cargo run --release --manifest-path %S/Cargo.toml --bin main_merge_luts -- 1 1 --message_bits=3 | FileCheck %s
+
+#encoding = #lwe.unspecified_bit_field_encoding<cleartext_bitwidth = 3>
+!ct_ty = !lwe.lwe_ciphertext<encoding = #encoding>
+
+// A half adder, whose sum and carry are computed by a single bootstrap.
+// 1 + 1 = 0b10
+// CHECK: 0 1
+func.func @fn_under_test(%a: !ct_ty, %b: !ct_ty) -> (!ct_ty, !ct_ty) {
+  %sum = cggi.lut2 %a, %b {lookup_table = 6 : ui8} : !ct_ty
+  %carry = cggi.lut2 %a, %b {lookup_table = 8 : ui8} : !ct_ty
+  return %sum, %carry : !ct_ty, !ct_ty
+}
@@ -0,0 +1,60 @@
+// RUN: heir-opt %s --convert-to-ciphertext-semantics=ciphertext-size=16 | FileCheck %s
+
+// A tall 6x3 matrix is zero-padded to 8x4 and laid out in four extended
+// diagonals of eight slots each. The vector is zero-padded to 4 and
+// replicated, and the output is zero-padded to 8 and replicated.
+#vec_alignment = #tensor_ext.alignment<in = [3], out = [16], padding = [1], paddingValue = 0:i16>
+#vec_layout = #tensor_ext.layout<map = (d0) -> (d0), alignment = #vec_alignment>
+#matrix_alignment = #tensor_ext.alignment<in = [6, 3], out = [8, 4], padding = [2, 1], paddingValue = 0:i16>
+#diagonals = #tensor_ext.layout<map = (d0, d1) -> ((d1 - d0) mod 4, d0), alignment = #matrix_alignment>
+#output_alignment = #tensor_ext.alignment<in = [6], out = [16], padding = [2], paddingValue = 0:i16>
+#output = #tensor_ext.layout<map = (d0) -> (d0), alignment = #output_alignment>
+
+// CHECK: @tall_matvec
+// CHECK-SAME: [[arg0:%[^:]*]]: !secret.secret<tensor<16xi16>>
+func.func @tall_matvec(
+    %arg0: !secret.secret<tensor<3xi16>> {tensor_ext.layout = #vec_layout}) ->
+       (!secret.secret<tensor<6xi16>> {tensor_ext.layout = #output}) {
+  %cst = arith.constant dense<1> : tensor<6x3xi16>
+  %out = arith.constant dense<0> : tensor<6xi16>
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<3xi16>>)
+                      attrs = {
+                        __argattrs = [{tensor_ext.layout = #vec_layout}],
+                        __resattrs = [{tensor_ext.layout = #output}]
+                      } {
+  // CHECK: ^body([[vec:%[^ ]+]]: tensor<16xi16>):
+  ^body(%input0: tensor<3xi16>):
+    // CHECK: [[enc_out:%[^ ]+]] = linalg.generic
+    %enc_out = tensor_ext.assign_layout %out {layout = #output, tensor_ext.layout = #output} : tensor<6xi16>
+    // CHECK: [[enc_matrix:%[^ ]+]] = linalg.generic
+    // CHECK-SAME: -> tensor<4x16xi16>
+    %enc_matrix = tensor_ext.assign_layout %cst {layout = #diagonals, tensor_ext.layout = #diagonals} : tensor<6x3xi16>
+
+    // One product per diagonal, with the vector rotated by the diagonal index.
+    // CHECK: [[diag0:%[^ ]+]] = tensor.extract_slice [[enc_matrix]][0, 0] [1, 16] [1, 1]
+    // CHECK: [[prod0:%[^ ]+]] = arith.muli [[vec]], [[diag0]]
+    // CHECK: [[c1:%[^ ]+]] = arith.constant 1 : i64
+    // CHECK: [[rot1:%[^ ]+]] = tensor_ext.rotate [[vec]], [[c1]]
+    // CHECK: [[diag1:%[^ ]+]] = tensor.extract_slice [[enc_matrix]][1, 0] [1, 16] [1, 1]
+    // CHECK: [[prod1:%[^ ]+]] = arith.muli [[rot1]], [[diag1]]
+    // CHECK: [[sum1:%[^ ]+]] = arith.addi [[prod0]], [[prod1]]
+    // CHECK: [[c2:%[^ ]+]] = arith.constant 2 : i64
+    // CHECK: tensor_ext.rotate [[vec]], [[c2]]
+    // CHECK: [[c3:%[^ ]+]] = arith.constant 3 : i64
+    // CHECK: tensor_ext.rotate [[vec]], [[c3]]
+    // CHECK: [[sum3:%[^ ]+]] = arith.addi
+
+    // The eight result slots are copied into the zeros after them.
+    // CHECK: [[c8:%[^ ]+]] = arith.constant 8 : i64
+    // CHECK: [[rot8:%[^ ]+]] = tensor_ext.rotate [[sum3]], [[c8]]
+    // CHECK: [[replicated:%[^ ]+]] = arith.addi [[sum3]], [[rot8]]
+    // CHECK: [[result:%[^ ]+]] = arith.addi [[enc_out]], [[replicated]]
+    // CHECK-NOT: tensor_ext.rotate
+    // CHECK: secret.yield [[result]]
+    %1 = linalg.matvec {tensor_ext.layout = #output}
+          ins(%enc_matrix, %input0 : tensor<6x3xi16>, tensor<3xi16>)
+          outs(%enc_out : tensor<6xi16>) -> tensor<6xi16>
+    secret.yield %1 : tensor<6xi16>
+  } -> !secret.secret<tensor<6xi16>>
+  return %0 : !secret.secret<tensor<6xi16>>
+}
@@ -0,0 +1,108 @@
+// RUN: heir-opt %s --convert-to-ciphertext-semantics=ciphertext-size=16 | FileCheck %s
+
+#row_major = #tensor_ext.layout<map = (d0, d1) -> (d0 * 4 + d1)>
+
+// CHECK: @secret_matmul
+// CHECK-SAME: [[arg0:%[^:]*]]: !secret.secret<tensor<16xi16>>
+// CHECK-SAME: [[arg1:%[^:]*]]: !secret.secret<tensor<16xi16>>
+func.func @secret_matmul(
+    %arg0: !secret.secret<tensor<4x4xi16>> {tensor_ext.layout = #row_major},
+    %arg1: !secret.secret<tensor<4x4xi16>> {tensor_ext.layout = #row_major}) ->
+       (!secret.secret<tensor<4x4xi16>> {tensor_ext.layout = #row_major}) {
+  %out = arith.constant dense<0> : tensor<4x4xi16>
+  %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<tensor<4x4xi16>>, !secret.secret<tensor<4x4xi16>>)
+                      attrs = {
+                        __argattrs = [{tensor_ext.layout = #row_major}, {tensor_ext.layout = #row_major}],
+                        __resattrs = [{tensor_ext.layout = #row_major}]
+                      } {
+  // CHECK: ^body([[lhs:%[^ ]+]]: tensor<16xi16>, [[rhs:%[^ ]+]]: tensor<16xi16>):
+  ^body(%input0: tensor<4x4xi16>, %input1: tensor<4x4xi16>):
+    // CHECK: [[enc_out:%[^ ]+]] = linalg.generic
+    %enc_out = tensor_ext.assign_layout %out {layout = #row_major, tensor_ext.layout = #row_major} : tensor<4x4xi16>
+
+    // Row i of the lhs is shifted left by i, column j of the rhs up by j.
+    // CHECK: [[sigma:%[^ ]+]] = tensor_ext.permute [[lhs]]
+    // CHECK-SAME: [0, 1, 2, 3, 7, 4, 5, 6, 10, 11, 8, 9, 13, 14, 15, 12
+    // CHECK: [[tau:%[^ ]+]] = tensor_ext.permute [[rhs]]
+    // CHECK-SAME: [0, 13, 10, 7, 4, 1, 14, 11, 8, 5, 2, 15, 12, 9, 6, 3
+    // CHECK: [[prod0:%[^ ]+]] = arith.muli [[sigma]], [[tau]]
+    // CHECK: [[acc0:%[^ ]+]] = arith.addi [[enc_out]], [[prod0]]
+
+    // Then rows of sigma(lhs) shift left by one more for each of the
+    // remaining three products, as two rotations under complementary masks.
+    // CHECK: [[head_mask:%[^ ]+]] = arith.constant dense<[0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1, 0, 1, 1, 1]>
+    // CHECK: [[head:%[^ ]+]] = arith.muli [[sigma]], [[head_mask]]
+    // CHECK: [[c1:%[^ ]+]] = arith.constant 1 : i64
+    // CHECK: [[head_rot:%[^ ]+]] = tensor_ext.rotate [[head]], [[c1]]
+    // CHECK: [[tail_mask:%[^ ]+]] = arith.constant dense<[1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0, 1, 0, 0, 0]>
+    // CHECK: [[tail:%[^ ]+]] = arith.muli [[sigma]], [[tail_mask]]
+    // CHECK: [[c13:%[^ ]+]] = arith.constant 13 : i64
+    // CHECK: [[tail_rot:%[^ ]+]] = tensor_ext.rotate [[tail]], [[c13]]
+    // CHECK: [[phi1:%[^ ]+]] = arith.addi [[head_rot]], [[tail_rot]]
+
+    // Columns of tau(rhs) shift up by one more, which is a single rotation
+    // because the matrix fills the ciphertext.
+    // CHECK: [[c4:%[^ ]+]] = arith.constant 4 : i64
+    // CHECK: [[psi1:%[^ ]+]] = tensor_ext.rotate [[tau]], [[c4]]
+    // CHECK: [[prod1:%[^ ]+]] = arith.muli [[phi1]], [[psi1]]
+    // CHECK: [[acc1:%[^ ]+]] = arith.addi [[acc0]], [[prod1]]
+    // CHECK-COUNT-3: tensor_ext.rotate
+    // CHECK: arith.muli
+    // CHECK: arith.addi
+    // CHECK-COUNT-3: tensor_ext.rotate
+    // CHECK: arith.muli
+    // CHECK: [[result:%[^ ]+]] = arith.addi
+    // CHECK-NOT: tensor_ext.permute
+    // CHECK-NOT: tensor_ext.rotate
+    %1 = linalg.matmul {tensor_ext.layout = #row_major}
+          ins(%input0, %input1 : tensor<4x4xi16>, tensor<4x4xi16>)
+          outs(%enc_out : tensor<4x4xi16>) -> tensor<4x4xi16>
+    // CHECK: secret.yield [[result]]
+    secret.yield %1 : tensor<4x4xi16>
+  } -> !secret.secret<tensor<4x4xi16>>
+  return %0 : !secret.secret<tensor<4x4xi16>>
+}
+
+#small_row_major = #tensor_ext.layout<map = (d0, d1) -> (d0 * 2 + d1)>
+
+// A matrix that does not fill the ciphertext is masked in every product, so
+// that the slots past the matrix stay zero, and psi also needs two rotations.
+// CHECK: @small_matmul
+func.func @small_matmul(
+    %arg0: !secret.secret<tensor<2x2xi16>> {tensor_ext.layout = #small_row_major},
+    %arg1: !secret.secret<tensor<2x2xi16>> {tensor_ext.layout = #small_row_major}) ->
+       (!secret.secret<tensor<2x2xi16>> {tensor_ext.layout = #small_row_major}) {
+  %out = arith.constant dense<0> : tensor<2x2xi16>
+  %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<tensor<2x2xi16>>, !secret.secret<tensor<2x2xi16>>)
+                      attrs = {
+                        __argattrs = [{tensor_ext.layout = #small_row_major}, {tensor_ext.layout = #small_row_major}],
+                        __resattrs = [{tensor_ext.layout = #small_row_major}]
+                      } {
+  // CHECK: ^body([[lhs:%[^ ]+]]: tensor<16xi16>, [[rhs:%[^ ]+]]: tensor<16xi16>):
+  ^body(%input0: tensor<2x2xi16>, %input1: tensor<2x2xi16>):
+    %enc_out = tensor_ext.assign_layout %out {layout = #small_row_major, tensor_ext.layout = #small_row_major} : tensor<2x2xi16>
+    // CHECK: [[sigma:%[^ ]+]] = tensor_ext.permute [[lhs]]
+    // CHECK: [[tau:%[^ ]+]] = tensor_ext.permute [[rhs]]
+    // CHECK: [[matrix_mask:%[^ ]+]] = arith.constant dense<[1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0]>
+    // CHECK: [[masked_sigma:%[^ ]+]] = arith.muli [[sigma]], [[matrix_mask]]
+    // CHECK: arith.muli [[masked_sigma]], [[tau]]
+
+    // phi
+    // CHECK: arith.constant dense<[0, 1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0]>
+    // CHECK: arith.constant 1 : i64
+    // CHECK: arith.constant dense<[1, 0, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0]>
+    // CHECK: arith.constant 15 : i64
+
+    // psi
+    // CHECK: arith.constant dense<[0, 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0]>
+    // CHECK: arith.constant 2 : i64
+    // CHECK: arith.constant dense<[1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0]>
+    // CHECK: arith.constant 14 : i64
+    // CHECK-NOT: tensor_ext.permute
+    %1 = linalg.matmul {tensor_ext.layout = #small_row_major}
+          ins(%input0, %input1 : tensor<2x2xi16>, tensor<2x2xi16>)
+          outs(%enc_out : tensor<2x2xi16>) -> tensor<2x2xi16>
+    secret.yield %1 : tensor<2x2xi16>
+  } -> !secret.secret<tensor<2x2xi16>>
+  return %0 : !secret.secret<tensor<2x2xi16>>
+}
@@ -0,0 +1,110 @@
+// RUN: heir-opt %s --convert-to-ciphertext-semantics=ciphertext-size=32 | FileCheck %s
+
+#row_major = #tensor_ext.layout<map = (d0, d1, d2) -> (d0 * 16 + d1 * 4 + d2)>
+#channels = #tensor_ext.layout<map = (d0) -> (d0 * 16)>
+#odd_row_major = #tensor_ext.layout<map = (d0, d1, d2) -> (d0 * 8 + d1 * 2 + d2)>
+#odd_channels = #tensor_ext.layout<map = (d0) -> (d0 * 8)>
+
+// Global sum pooling of two 4x4 channels: each reduced dimension is a tree of
+// two rotations, and the second tree sums the partial sums of the first.
+
+// CHECK: @pooling
+func.func @pooling(
+    %arg0: !secret.secret<tensor<2x4x4xi16>> {tensor_ext.layout = #row_major}) ->
+       (!secret.secret<tensor<2xi16>> {tensor_ext.layout = #channels}) {
+  %cst = arith.constant dense<0> : tensor<2xi16>
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<2x4x4xi16>>)
+                      attrs = {
+                        __argattrs = [{tensor_ext.layout = #row_major}],
+                        __resattrs = [{tensor_ext.layout = #channels}]
+                      } {
+  // CHECK: ^body([[input:%[^ ]+]]: tensor<32xi16>):
+  ^body(%input0: tensor<2x4x4xi16>):
+    // CHECK: [[init:%[^ ]+]] = linalg.generic
+    %1 = tensor_ext.assign_layout %cst {layout = #channels, tensor_ext.layout = #channels} : tensor<2xi16>
+
+    // CHECK-NOT: tensor_ext.permute
+    // CHECK: [[c8:%[^ ]+]] = arith.constant 8 : i64
+    // CHECK: [[rot8:%[^ ]+]] = tensor_ext.rotate [[input]], [[c8]]
+    // CHECK: [[sum8:%[^ ]+]] = arith.addi [[input]], [[rot8]]
+    // CHECK: [[c4:%[^ ]+]] = arith.constant 4 : i64
+    // CHECK: [[rot4:%[^ ]+]] = tensor_ext.rotate [[sum8]], [[c4]]
+    // CHECK: [[sum4:%[^ ]+]] = arith.addi [[sum8]], [[rot4]]
+    // CHECK: [[c2:%[^ ]+]] = arith.constant 2 : i64
+    // CHECK: [[rot2:%[^ ]+]] = tensor_ext.rotate [[sum4]], [[c2]]
+    // CHECK: [[sum2:%[^ ]+]] = arith.addi [[sum4]], [[rot2]]
+    // CHECK: [[c1:%[^ ]+]] = arith.constant 1 : i64
+    // CHECK: [[rot1:%[^ ]+]] = tensor_ext.rotate [[sum2]], [[c1]]
+    // CHECK: [[sum1:%[^ ]+]] = arith.addi [[sum2]], [[rot1]]
+    // CHECK: [[result:%[^ ]+]] = arith.addi [[init]], [[sum1]]
+    // CHECK-NOT: tensor_ext.rotate
+    // CHECK: secret.yield [[result]]
+    %reduced = linalg.reduce { arith.addi }
+      ins(%input0 : tensor<2x4x4xi16>)
+      outs(%1 : tensor<2xi16>)
+      dimensions = [1, 2]  {tensor_ext.layout = #channels}
+    secret.yield %reduced : tensor<2xi16>
+  } -> !secret.secret<tensor<2xi16>>
+  return %0 : !secret.secret<tensor<2xi16>>
+}
+
+// A reduced dimension of size 3 has no rotation tree, so each of the 3x2
+// summands is aligned with its own permutation.
+
+// CHECK: @odd_pooling
+func.func @odd_pooling(
+    %arg0: !secret.secret<tensor<2x3x2xi16>> {tensor_ext.layout = #odd_row_major}) ->
+       (!secret.secret<tensor<2xi16>> {tensor_ext.layout = #odd_channels}) {
+  %cst = arith.constant dense<0> : tensor<2xi16>
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<2x3x2xi16>>)
+                      attrs = {
+                        __argattrs = [{tensor_ext.layout = #odd_row_major}],
+                        __resattrs = [{tensor_ext.layout = #odd_channels}]
+                      } {
+  ^body(%input0: tensor<2x3x2xi16>):
+    %1 = tensor_ext.assign_layout %cst {layout = #odd_channels, tensor_ext.layout = #odd_channels} : tensor<2xi16>
+
+    // CHECK-COUNT-6: tensor_ext.permute
+    // CHECK-NOT: tensor_ext.permute
+    %reduced = linalg.reduce { arith.addi }
+      ins(%input0 : tensor<2x3x2xi16>)
+      outs(%1 : tensor<2xi16>)
+      dimensions = [1, 2]  {tensor_ext.layout = #odd_channels}
+    secret.yield %reduced : tensor<2xi16>
+  } -> !secret.secret<tensor<2xi16>>
+  return %0 : !secret.secret<tensor<2xi16>>
+}
+
+// The same pooling with an init that is not laid out like the input with the
+// reduced dimensions projected out: the rotation trees would leave the sums in
+// the wrong slots, so each of the 4x4 summands is permuted into the slots of
+// the init layout instead.
+#shifted_channels = #tensor_ext.layout<map = (d0) -> (d0 * 16 + 1)>
+
+// CHECK: @shifted_pooling
+func.func @shifted_pooling(
+    %arg0: !secret.secret<tensor<2x4x4xi16>> {tensor_ext.layout = #row_major}) ->
+       (!secret.secret<tensor<2xi16>> {tensor_ext.layout = #shifted_channels}) {
+  %cst = arith.constant dense<0> : tensor<2xi16>
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<2x4x4xi16>>)
+                      attrs = {
+                        __argattrs = [{tensor_ext.layout = #row_major}],
+                        __resattrs = [{tensor_ext.layout = #shifted_channels}]
+                      } {
+  ^body(%input0: tensor<2x4x4xi16>):
+    %1 = tensor_ext.assign_layout %cst {layout = #shifted_channels, tensor_ext.layout = #shifted_channels} : tensor<2xi16>
+
+    // The first summand moves entry (c, 0, 0) from slot 16c to slot 16c + 1.
+    // CHECK: tensor_ext.permute
+    // CHECK-SAME: [1, {{.*}}, 17,
+    // CHECK-COUNT-15: tensor_ext.permute
+    // CHECK-NOT: tensor_ext.permute
+    // CHECK-NOT: tensor_ext.rotate
+    %reduced = linalg.reduce { arith.addi }
+      ins(%input0 : tensor<2x4x4xi16>)
+      outs(%1 : tensor<2xi16>)
+      dimensions = [1, 2]  {tensor_ext.layout = #shifted_channels}
+    secret.yield %reduced : tensor<2xi16>
+  } -> !secret.secret<tensor<2xi16>>
+  return %0 : !secret.secret<tensor<2xi16>>
+}
@@ -0,0 +1,217 @@
+// RUN: heir-opt %s --split-input-file --convert-to-ciphertext-semantics=ciphertext-size=16 | FileCheck %s
+
+#row_major = #tensor_ext.layout<map = (d0) -> (d0 floordiv 16, d0 mod 16)>
+#swapped = #tensor_ext.layout<map = (d0) -> ((d0 floordiv 16 + 1) mod 2, d0 mod 16)>
+
+// Swapping the two ciphertexts is a single permutation of the flattened list
+// of ciphertexts.
+// CHECK: @swap_ciphertexts
+// CHECK-SAME: [[arg0:%[^:]*]]: !secret.secret<tensor<2x16xi16>>
+func.func @swap_ciphertexts(
+    %arg0: !secret.secret<tensor<32xi16>> {tensor_ext.layout = #row_major}) ->
+       (!secret.secret<tensor<32xi16>> {tensor_ext.layout = #swapped}) {
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<32xi16>>)
+                      attrs = {
+                        __argattrs = [{tensor_ext.layout = #row_major}],
+                        __resattrs = [{tensor_ext.layout = #swapped}]
+                      } {
+  // CHECK: ^body([[pt_arg0:%[^ ]+]]: tensor<2x16xi16>):
+  ^body(%input0: tensor<32xi16>):
+    // CHECK: [[result:%[^ ]+]] = tensor_ext.permute [[pt_arg0]]
+    // CHECK-SAME: [16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 0, 1,
+    // CHECK-SAME: tensor<2x16xi16>
+    // CHECK-NOT: tensor.extract_slice
+    // CHECK: secret.yield [[result]]
+    %1 = tensor_ext.convert_layout %input0 {from_layout = #row_major, tensor_ext.layout = #swapped, to_layout = #swapped} : tensor<32xi16>
+    secret.yield %1 : tensor<32xi16>
+  } -> !secret.secret<tensor<32xi16>>
+  return %0 : !secret.secret<tensor<32xi16>>
+}
+
+// -----
+
+#halves = #tensor_ext.layout<map = (d0) -> (d0 floordiv 8, d0 mod 8)>
+#row_major = #tensor_ext.layout<map = (d0) -> (d0 mod 16)>
+
+// Combining two half-full ciphertexts into one permutes the list of both
+// ciphertexts, and keeps the first.
+// CHECK: @combine_ciphertexts
+// CHECK-SAME: [[arg0:%[^:]*]]: !secret.secret<tensor<2x16xi16>>
+// CHECK-SAME: -> (!secret.secret<tensor<16xi16>>
+func.func @combine_ciphertexts(
+    %arg0: !secret.secret<tensor<16xi16>> {tensor_ext.layout = #halves}) ->
+       (!secret.secret<tensor<16xi16>> {tensor_ext.layout = #row_major}) {
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<16xi16>>)
+                      attrs = {
+                        __argattrs = [{tensor_ext.layout = #halves}],
+                        __resattrs = [{tensor_ext.layout = #row_major}]
+                      } {
+  // CHECK: ^body([[pt_arg0:%[^ ]+]]: tensor<2x16xi16>):
+  ^body(%input0: tensor<16xi16>):
+    // CHECK: [[permuted:%[^ ]+]] = tensor_ext.permute [[pt_arg0]]
+    // CHECK-SAME: [0, 1, 2, 3, 4, 5, 6, 7,
+    // CHECK-SAME: tensor<2x16xi16>
+    // CHECK-NOT: arith.muli
+    // CHECK: [[result:%[^ ]+]] = tensor.extract_slice [[permuted]][0, 0] [1, 16] [1, 1]
+    // CHECK: secret.yield [[result]]
+    %1 = tensor_ext.convert_layout %input0 {from_layout = #halves, tensor_ext.layout = #row_major, to_layout = #row_major} : tensor<16xi16>
+    secret.yield %1 : tensor<16xi16>
+  } -> !secret.secret<tensor<16xi16>>
+  return %0 : !secret.secret<tensor<16xi16>>
+}
+
+// -----
+
+#layout = #tensor_ext.layout<map = (d0) -> (d0 floordiv 16, d0 mod 16)>
+#scalar_alignment = #tensor_ext.alignment<in = [], out = [16], insertedDims = [0]>
+#scalar_layout = #tensor_ext.layout<map = (d0) -> (d0 mod 16), alignment = #scalar_alignment>
+
+// CHECK: @extract
+// CHECK-SAME: [[arg0:%[^:]*]]: !secret.secret<tensor<2x16xi16>>
+func.func @extract(
+    %arg0: !secret.secret<tensor<32xi16>> {tensor_ext.layout = #layout},
+    %index: index) -> (!secret.secret<i16> {tensor_ext.layout = #scalar_layout}) {
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<32xi16>>) attrs = {__argattrs = [{tensor_ext.layout = #layout}], __resattrs = [{tensor_ext.layout = #scalar_layout}]} {
+  // CHECK: ^body([[pt_arg0:%[^ ]+]]: tensor<2x16xi16>):
+  ^body(%input0: tensor<32xi16>):
+    // CHECK: [[ct_index:%[^ ]+]] = affine.apply
+    // CHECK: [[slot_index:%[^ ]+]] = affine.apply
+    // CHECK: [[ct:%[^ ]+]] = tensor.extract_slice [[pt_arg0]]{{\[}}[[ct_index]], 0] [1, 16] [1, 1]
+    // CHECK: [[mask:%[^ ]+]] = tensor.insert
+    // CHECK-SAME: [[slot_index]]
+    // CHECK: [[masked:%[^ ]+]] = arith.muli [[mask]], [[ct]]
+    // CHECK: [[result:%[^ ]+]] = tensor_ext.rotate [[masked]], [[slot_index]]
+    // CHECK: secret.yield [[result]]
+    %1 = tensor.extract %input0[%index] {tensor_ext.layout = #scalar_layout} : tensor<32xi16>
+    secret.yield %1 : i16
+  } -> !secret.secret<i16>
+  return %0 : !secret.secret<i16>
+}
+
+// -----
+
+#layout = #tensor_ext.layout<map = (d0) -> (d0 floordiv 16, d0 mod 16)>
+#scalar_alignment = #tensor_ext.alignment<in = [], out = [16], insertedDims = [0]>
+#scalar_layout = #tensor_ext.layout<map = (d0) -> (d0 mod 16), alignment = #scalar_alignment>
+
+// CHECK: @insert
+// CHECK-SAME: [[arg0:%[^:]*]]: !secret.secret<tensor<2x16xi16>>
+func.func @insert(
+    %arg0: !secret.secret<tensor<32xi16>> {tensor_ext.layout = #layout},
+    %arg1: !secret.secret<i16> {tensor_ext.layout = #scalar_layout},
+    %index: index) -> (!secret.secret<tensor<32xi16>> {tensor_ext.layout = #layout}) {
+  %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<tensor<32xi16>>, !secret.secret<i16>) attrs = {__argattrs = [{tensor_ext.layout = #layout}, {tensor_ext.layout = #scalar_layout}], __resattrs = [{tensor_ext.layout = #layout}]} {
+  // CHECK: ^body([[pt_arg0:%[^ ]+]]: tensor<2x16xi16>, [[pt_arg1:%[^ ]+]]: tensor<16xi16>):
+  ^body(%input0: tensor<32xi16>, %input1: i16):
+    // CHECK: [[ct_index:%[^ ]+]] = affine.apply
+    // CHECK: [[slot_index:%[^ ]+]] = affine.apply
+    // CHECK: [[ct:%[^ ]+]] = tensor.extract_slice [[pt_arg0]]{{\[}}[[ct_index]], 0] [1, 16] [1, 1]
+    // CHECK: tensor_ext.rotate
+    // CHECK: [[masked_ct:%[^ ]+]] = arith.muli {{.*}}, [[ct]]
+    // CHECK: [[updated:%[^ ]+]] = arith.addi {{.*}}, [[masked_ct]]
+    // CHECK: [[result:%[^ ]+]] = tensor.insert_slice [[updated]] into [[pt_arg0]]{{\[}}[[ct_index]], 0] [1, 16] [1, 1]
+    // CHECK: secret.yield [[result]]
+    %1 = tensor.insert %input1 into %input0[%index] {tensor_ext.layout = #layout} : tensor<32xi16>
+    secret.yield %1 : tensor<32xi16>
+  } -> !secret.secret<tensor<32xi16>>
+  return %0 : !secret.secret<tensor<32xi16>>
+}
+
+// -----
+
+#row_major_matrix = #tensor_ext.layout<map = (d0, d1) -> ((d0 * 8 + d1) floordiv 16, (d0 * 8 + d1) mod 16)>
+#row_major_vec_align = #tensor_ext.alignment<in = [8], out = [16]>
+#row_major_vec = #tensor_ext.layout<map = (d0) -> (d0), alignment = #row_major_vec_align>
+
+// Reducing the rows of a 4x8 matrix spread across two ciphertexts. Each
+// summand is a single permutation of both ciphertexts, of which the first
+// holds the aligned row.
+// CHECK: @reduce
+// CHECK-SAME: [[arg0:%[^:]*]]: !secret.secret<tensor<2x16xi16>>
+func.func @reduce(
+    %arg0: !secret.secret<tensor<4x8xi16>> {tensor_ext.layout = #row_major_matrix}) ->
+       (!secret.secret<tensor<8xi16>> {tensor_ext.layout = #row_major_vec}) {
+  %cst = arith.constant dense<0> : tensor<8xi16>
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<4x8xi16>>)
+                      attrs = {
+                        __argattrs = [{tensor_ext.layout = #row_major_matrix}],
+                        __resattrs = [{tensor_ext.layout = #row_major_vec}]
+                      } {
+  // CHECK: ^body([[pt_arg0:%[^ ]+]]: tensor<2x16xi16>):
+  ^body(%input0: tensor<4x8xi16>):
+    %1 = tensor_ext.assign_layout %cst {layout = #row_major_vec, tensor_ext.layout = #row_major_vec} : tensor<8xi16>
+    // The first row is already aligned.
+    // CHECK-NOT: tensor_ext.permute
+    // CHECK: [[ct0:%[^ ]+]] = tensor.extract_slice [[pt_arg0]][0, 0] [1, 16] [1, 1]
+    // CHECK: [[s0:%[^ ]+]] = arith.addi {{.*}}, [[ct0]]
+    // CHECK: [[p1:%[^ ]+]] = tensor_ext.permute [[pt_arg0]]
+    // CHECK-SAME: tensor<2x16xi16>
+    // CHECK: [[ct1:%[^ ]+]] = tensor.extract_slice [[p1]][0, 0] [1, 16] [1, 1]
+    // CHECK: [[s1:%[^ ]+]] = arith.addi [[s0]], [[ct1]]
+    // CHECK: [[p2:%[^ ]+]] = tensor_ext.permute [[pt_arg0]]
+    // CHECK-SAME: tensor<2x16xi16>
+    // CHECK: [[ct2:%[^ ]+]] = tensor.extract_slice [[p2]][0, 0] [1, 16] [1, 1]
+    // CHECK: [[s2:%[^ ]+]] = arith.addi [[s1]], [[ct2]]
+    // CHECK: [[p3:%[^ ]+]] = tensor_ext.permute [[pt_arg0]]
+    // CHECK-SAME: tensor<2x16xi16>
+    // CHECK: [[ct3:%[^ ]+]] = tensor.extract_slice [[p3]][0, 0] [1, 16] [1, 1]
+    // CHECK: [[s3:%[^ ]+]] = arith.addi [[s2]], [[ct3]]
+    // CHECK: secret.yield [[s3]]
+    %reduced = linalg.reduce { arith.addi {overflowFlags = #arith.overflow<none>} }
+      ins(%input0:tensor<4x8xi16>)
+      outs(%1:tensor<8xi16>)
+      dimensions = [0]  {tensor_ext.layout = #row_major_vec}
+    secret.yield %reduced : tensor<8xi16>
+  } -> !secret.secret<tensor<8xi16>>
+  return %0 : !secret.secret<tensor<8xi16>>
+}
+
+// -----
+
+#vec_layout = #tensor_ext.layout<map = (d0) -> (d0 floordiv 16, d0 mod 16)>
+#out_layout = #tensor_ext.layout<map = (d0) -> (d0 mod 16)>
+#tiled_diagonal = #tensor_ext.layout<map = (d0, d1) -> (((d0 floordiv 16) * 2 + d1 floordiv 16) * 16 + d1 mod 16, (d0 mod 16 + d1 mod 16) mod 16)>
+
+// A 16x32 matrix does not fit in 16 diagonals of 16 slots, so it is split
+// into two 16x16 blocks whose products are accumulated.
+// CHECK: @tiled_matvec
+// CHECK-SAME: [[arg0:%[^:]*]]: !secret.secret<tensor<2x16xi16>>
+// CHECK-SAME: -> (!secret.secret<tensor<16xi16>>
+func.func @tiled_matvec(
+    %arg0: !secret.secret<tensor<32xi16>> {tensor_ext.layout = #vec_layout}) ->
+       (!secret.secret<tensor<16xi16>> {tensor_ext.layout = #out_layout}) {
+  %cst = arith.constant dense<1> : tensor<16x32xi16>
+  %out = arith.constant dense<0> : tensor<16xi16>
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<32xi16>>)
+                      attrs = {
+                        __argattrs = [{tensor_ext.layout = #vec_layout}],
+                        __resattrs = [{tensor_ext.layout = #out_layout}]
+                      } {
+  // CHECK: ^body([[pt_arg0:%[^ ]+]]: tensor<2x16xi16>):
+  ^body(%input0: tensor<32xi16>):
+    %enc_out = tensor_ext.assign_layout %out {layout = #out_layout, tensor_ext.layout = #out_layout} : tensor<16xi16>
+    // CHECK: [[enc_matrix:%[^ ]+]] = linalg.generic
+    // CHECK-SAME: -> tensor<32x16xi16>
+    %enc_matrix = tensor_ext.assign_layout %cst {layout = #tiled_diagonal, tensor_ext.layout = #tiled_diagonal} : tensor<16x32xi16>
+
+    // The first block uses diagonals 0..15 and the first vector ciphertext.
+    // CHECK: [[diag0:%[^ ]+]] = tensor.extract_slice [[enc_matrix]][0, 0] [1, 16] [1, 1]
+    // CHECK: [[vec0:%[^ ]+]] = tensor.extract_slice [[pt_arg0]][0, 0] [1, 16] [1, 1]
+    // CHECK: arith.muli [[vec0]], [[diag0]]
+    // CHECK-COUNT-15: tensor_ext.rotate [[vec0]]
+
+    // The second block uses diagonals 16..31 and the second vector
+    // ciphertext.
+    // CHECK: [[diag16:%[^ ]+]] = tensor.extract_slice [[enc_matrix]][16, 0] [1, 16] [1, 1]
+    // CHECK: [[vec1:%[^ ]+]] = tensor.extract_slice [[pt_arg0]][1, 0] [1, 16] [1, 1]
+    // CHECK: arith.muli [[vec1]], [[diag16]]
+    // CHECK-COUNT-15: tensor_ext.rotate [[vec1]]
+    // CHECK: [[last:%[^ ]+]] = arith.addi
+    // CHECK-NEXT: secret.yield [[last]]
+    %3 = linalg.matvec {tensor_ext.layout = #out_layout}
+          ins(%enc_matrix, %input0 : tensor<16x32xi16>, tensor<32xi16>)
+          outs(%enc_out : tensor<16xi16>) -> tensor<16xi16>
+    secret.yield %3 : tensor<16xi16>
+  } -> !secret.secret<tensor<16xi16>>
+  return %0 : !secret.secret<tensor<16xi16>>
+}
@@ -0,0 +1,64 @@
+// RUN: heir-opt %s --split-input-file --convert-to-ciphertext-semantics=ciphertext-size=16 \
+// RUN:   --implement-shift-network=ciphertext-size=16 | FileCheck %s
+
+#row_major = #tensor_ext.layout<map = (d0) -> (d0 floordiv 16, d0 mod 16)>
+#swapped = #tensor_ext.layout<map = (d0) -> ((d0 floordiv 16 + 1) mod 2, d0 mod 16)>
+
+// The single permutation of a swap of two ciphertexts is implemented without
+// rotations.
+// CHECK: @swap_ciphertexts
+// CHECK-SAME: [[arg0:%[^:]*]]: !secret.secret<tensor<2x16xi16>>
+func.func @swap_ciphertexts(
+    %arg0: !secret.secret<tensor<32xi16>> {tensor_ext.layout = #row_major}) ->
+       (!secret.secret<tensor<32xi16>> {tensor_ext.layout = #swapped}) {
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<32xi16>>)
+                      attrs = {
+                        __argattrs = [{tensor_ext.layout = #row_major}],
+                        __resattrs = [{tensor_ext.layout = #swapped}]
+                      } {
+  // CHECK: ^body([[pt_arg0:%[^ ]+]]: tensor<2x16xi16>):
+  ^body(%input0: tensor<32xi16>):
+    // CHECK-DAG: [[ct0:%[^ ]+]] = tensor.extract_slice [[pt_arg0]][0, 0] [1, 16] [1, 1]
+    // CHECK-DAG: [[ct1:%[^ ]+]] = tensor.extract_slice [[pt_arg0]][1, 0] [1, 16] [1, 1]
+    // CHECK-NOT: tensor_ext.rotate
+    // CHECK: [[inserted:%[^ ]+]] = tensor.insert_slice [[ct1]] into %{{[^ ]+}}[0, 0] [1, 16] [1, 1]
+    // CHECK: [[result:%[^ ]+]] = tensor.insert_slice [[ct0]] into [[inserted]][1, 0] [1, 16] [1, 1]
+    // CHECK-NOT: tensor_ext.permute
+    // CHECK: secret.yield [[result]]
+    %1 = tensor_ext.convert_layout %input0 {from_layout = #row_major, tensor_ext.layout = #swapped, to_layout = #swapped} : tensor<32xi16>
+    secret.yield %1 : tensor<32xi16>
+  } -> !secret.secret<tensor<32xi16>>
+  return %0 : !secret.secret<tensor<32xi16>>
+}
+
+// -----
+
+#halves = #tensor_ext.layout<map = (d0) -> (d0 floordiv 8, d0 mod 8)>
+#row_major = #tensor_ext.layout<map = (d0) -> (d0 mod 16)>
+
+// Combining two half-full ciphertexts moves the second half into the upper
+// slots of the first ciphertext with rotations.
+// CHECK: @combine_ciphertexts
+// CHECK-SAME: -> (!secret.secret<tensor<16xi16>>
+func.func @combine_ciphertexts(
+    %arg0: !secret.secret<tensor<16xi16>> {tensor_ext.layout = #halves}) ->
+       (!secret.secret<tensor<16xi16>> {tensor_ext.layout = #row_major}) {
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<16xi16>>)
+                      attrs = {
+                        __argattrs = [{tensor_ext.layout = #halves}],
+                        __resattrs = [{tensor_ext.layout = #row_major}]
+                      } {
+  // CHECK: ^body([[pt_arg0:%[^ ]+]]: tensor<2x16xi16>):
+  ^body(%input0: tensor<16xi16>):
+    // CHECK-NOT: tensor_ext.permute
+    // CHECK: tensor.extract_slice [[pt_arg0]][0, 0] [1, 16] [1, 1]
+    // CHECK: tensor.extract_slice [[pt_arg0]][1, 0] [1, 16] [1, 1]
+    // CHECK: tensor_ext.rotate
+    // CHECK: [[result:%[^ ]+]] = tensor.extract_slice %{{[^ ]+}}[0, 0] [1, 16] [1, 1] : tensor<2x16xi16> to tensor<16xi16>
+    // CHECK-NOT: tensor_ext.permute
+    // CHECK: secret.yield [[result]]
+    %1 = tensor_ext.convert_layout %input0 {from_layout = #halves, tensor_ext.layout = #row_major, to_layout = #row_major} : tensor<16xi16>
+    secret.yield %1 : tensor<16xi16>
+  } -> !secret.secret<tensor<16xi16>>
+  return %0 : !secret.secret<tensor<16xi16>>
+}
@@ -0,0 +1,63 @@
+// RUN: heir-opt %s --convert-to-ciphertext-semantics=ciphertext-size=64 | FileCheck %s
+
+// Four rotated replicas of an 8-element vector, each in a block of 16 slots.
+// Block j holds the vector rotated left by 2 * j, twice in a row.
+#replicas_alignment = #tensor_ext.alignment<in = [8], out = [4, 16], insertedDims = [0]>
+#replicas = #tensor_ext.layout<map = (d0, d1) -> (d0 * 16 + (d1 - d0 * 2) mod 16), alignment = #replicas_alignment>
+// Diagonal 2 * j + r of the matrix is in block j of ciphertext r.
+#diagonals = #tensor_ext.layout<map = (d0, d1) -> (((d1 - d0) mod 8) mod 2, (((d1 - d0) mod 8) floordiv 2) * 16 + d0)>
+#output_alignment = #tensor_ext.alignment<in = [8], out = [64], padding = [56], paddingValue = 0:i16>
+#output = #tensor_ext.layout<map = (d0) -> (d0), alignment = #output_alignment>
+
+// CHECK: @replicated_matvec
+// CHECK-SAME: [[arg0:%[^:]*]]: !secret.secret<tensor<64xi16>>
+func.func @replicated_matvec(
+    %arg0: !secret.secret<tensor<8xi16>> {tensor_ext.layout = #replicas}) ->
+       (!secret.secret<tensor<8xi16>> {tensor_ext.layout = #output}) {
+  %cst = arith.constant dense<1> : tensor<8x8xi16>
+  %out = arith.constant dense<0> : tensor<8xi16>
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<8xi16>>)
+                      attrs = {
+                        __argattrs = [{tensor_ext.layout = #replicas}],
+                        __resattrs = [{tensor_ext.layout = #output}]
+                      } {
+  // CHECK: ^body([[vec:%[^ ]+]]: tensor<64xi16>):
+  ^body(%input0: tensor<8xi16>):
+    // CHECK: [[enc_out:%[^ ]+]] = linalg.generic
+    %enc_out = tensor_ext.assign_layout %out {layout = #output, tensor_ext.layout = #output} : tensor<8xi16>
+    // CHECK: [[enc_matrix:%[^ ]+]] = linalg.generic
+    // CHECK-SAME: -> tensor<2x64xi16>
+    %enc_matrix = tensor_ext.assign_layout %cst {layout = #diagonals, tensor_ext.layout = #diagonals} : tensor<8x8xi16>
+
+    // Only one rotation of the vector is needed for the eight diagonals.
+    // CHECK: [[diag0:%[^ ]+]] = tensor.extract_slice [[enc_matrix]][0, 0] [1, 64] [1, 1]
+    // CHECK: [[prod0:%[^ ]+]] = arith.muli [[vec]], [[diag0]]
+    // CHECK: [[c1:%[^ ]+]] = arith.constant 1 : i64
+    // CHECK: [[rot1:%[^ ]+]] = tensor_ext.rotate [[vec]], [[c1]]
+    // CHECK: [[diag1:%[^ ]+]] = tensor.extract_slice [[enc_matrix]][1, 0] [1, 64] [1, 1]
+    // CHECK: [[prod1:%[^ ]+]] = arith.muli [[rot1]], [[diag1]]
+    // CHECK: [[sum:%[^ ]+]] = arith.addi [[prod0]], [[prod1]]
+
+    // Then the four blocks are summed.
+    // CHECK: [[c16:%[^ ]+]] = arith.constant 16 : i64
+    // CHECK: [[rot16:%[^ ]+]] = tensor_ext.rotate [[sum]], [[c16]]
+    // CHECK: [[sum16:%[^ ]+]] = arith.addi [[sum]], [[rot16]]
+    // CHECK: [[c32:%[^ ]+]] = arith.constant 32 : i64
+    // CHECK: [[rot32:%[^ ]+]] = tensor_ext.rotate [[sum16]], [[c32]]
+    // CHECK: [[sum32:%[^ ]+]] = arith.addi [[sum16]], [[rot32]]
+
+    // And the padding is masked out.
+    // CHECK: [[zeros:%[^ ]+]] = arith.constant dense<0> : tensor<64xi16>
+    // CHECK: [[ones:%[^ ]+]] = arith.constant dense<1> : tensor<8xi16>
+    // CHECK: [[mask:%[^ ]+]] = tensor.insert_slice [[ones]] into [[zeros]][0] [8] [1]
+    // CHECK: [[masked:%[^ ]+]] = arith.muli [[sum32]], [[mask]]
+    // CHECK: [[result:%[^ ]+]] = arith.addi [[enc_out]], [[masked]]
+    // CHECK-NOT: tensor_ext.rotate
+    // CHECK: secret.yield [[result]]
+    %3 = linalg.matvec {tensor_ext.layout = #output}
+          ins(%enc_matrix, %input0 : tensor<8x8xi16>, tensor<8xi16>)
+          outs(%enc_out : tensor<8xi16>) -> tensor<8xi16>
+    secret.yield %3 : tensor<8xi16>
+  } -> !secret.secret<tensor<8xi16>>
+  return %0 : !secret.secret<tensor<8xi16>>
+}
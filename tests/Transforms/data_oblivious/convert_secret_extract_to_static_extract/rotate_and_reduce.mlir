@@ -0,0 +1,53 @@
+// RUN: heir-opt --convert-secret-extract-to-static-extract=use-rotate-and-reduce=true %s | FileCheck %s
+
+// CHECK: @extract_at_secret_index
+func.func @extract_at_secret_index(%arg0: !secret.secret<tensor<8xi16>>, %arg1: !secret.secret<index>) -> !secret.secret<i16> {
+    %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<tensor<8xi16>>, !secret.secret<index>) {
+    ^bb0(%arg2: tensor<8xi16>, %arg3: index):
+      // CHECK: %[[POSITIONS:.*]] = arith.constant dense<[0, 1, 2, 3, 4, 5, 6, 7]> : tensor<8xindex>
+      // CHECK: %[[SPLAT:.*]] = tensor.splat %[[INDEX:.*]] : tensor<8xindex>
+      // CHECK: %[[COND:.*]] = arith.cmpi eq, %[[POSITIONS]], %[[SPLAT]] : tensor<8xindex>
+      // CHECK: %[[ONE_HOT:.*]] = arith.extui %[[COND]] : tensor<8xi1> to tensor<8xi16>
+      // CHECK: %[[MASKED:.*]] = arith.muli %[[TENSOR:.*]], %[[ONE_HOT]] : tensor<8xi16>
+      // CHECK: %[[ROT0:.*]] = tensor_ext.rotate %[[MASKED]]
+      // CHECK: %[[SUM0:.*]] = arith.addi %[[MASKED]], %[[ROT0]]
+      // CHECK: %[[ROT1:.*]] = tensor_ext.rotate %[[SUM0]]
+      // CHECK: %[[SUM1:.*]] = arith.addi %[[SUM0]], %[[ROT1]]
+      // CHECK: %[[ROT2:.*]] = tensor_ext.rotate %[[SUM1]]
+      // CHECK: %[[SUM2:.*]] = arith.addi %[[SUM1]], %[[ROT2]]
+      // CHECK: tensor.extract %[[SUM2]]
+      // CHECK-NOT: affine.for
+      // CHECK-NOT: scf.if
+      %extracted = tensor.extract %arg2[%arg3] : tensor<8xi16>
+      secret.yield %extracted : i16
+    } -> !secret.secret<i16>
+    return %0 : !secret.secret<i16>
+}
+
+// CHECK: @extract_float_at_secret_index
+func.func @extract_float_at_secret_index(%arg0: !secret.secret<tensor<4xf32>>, %arg1: !secret.secret<index>) -> !secret.secret<f32> {
+    %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<tensor<4xf32>>, !secret.secret<index>) {
+    ^bb0(%arg2: tensor<4xf32>, %arg3: index):
+      // CHECK: arith.uitofp
+      // CHECK: arith.mulf
+      // CHECK-COUNT-2: tensor_ext.rotate
+      // CHECK-NOT: scf.if
+      %extracted = tensor.extract %arg2[%arg3] : tensor<4xf32>
+      secret.yield %extracted : f32
+    } -> !secret.secret<f32>
+    return %0 : !secret.secret<f32>
+}
+
+// Non-power-of-two lengths fall back to the loop of selects.
+// CHECK: @extract_non_power_of_two
+func.func @extract_non_power_of_two(%arg0: !secret.secret<tensor<6xi16>>, %arg1: !secret.secret<index>) -> !secret.secret<i16> {
+    %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<tensor<6xi16>>, !secret.secret<index>) {
+    ^bb0(%arg2: tensor<6xi16>, %arg3: index):
+      // CHECK-NOT: tensor_ext.rotate
+      // CHECK: affine.for
+      // CHECK: scf.if
+      %extracted = tensor.extract %arg2[%arg3] : tensor<6xi16>
+      secret.yield %extracted : i16
+    } -> !secret.secret<i16>
+    return %0 : !secret.secret<i16>
+}
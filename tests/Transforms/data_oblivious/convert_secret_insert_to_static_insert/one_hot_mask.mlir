@@ -0,0 +1,23 @@
+// RUN: heir-opt --convert-secret-insert-to-static-insert=use-one-hot-mask=true %s | FileCheck %s
+
+// CHECK: @insert_at_secret_index
+func.func @insert_at_secret_index(%arg0: !secret.secret<tensor<8xi16>>, %arg1: !secret.secret<index>, %arg2: i16) -> !secret.secret<tensor<8xi16>> {
+    %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<tensor<8xi16>>, !secret.secret<index>) {
+    ^bb0(%arg3: tensor<8xi16>, %arg4: index):
+      // CHECK: %[[POSITIONS:.*]] = arith.constant dense<[0, 1, 2, 3, 4, 5, 6, 7]> : tensor<8xindex>
+      // CHECK: %[[SPLAT:.*]] = tensor.splat %[[INDEX:.*]] : tensor<8xindex>
+      // CHECK: %[[COND:.*]] = arith.cmpi eq, %[[POSITIONS]], %[[SPLAT]] : tensor<8xindex>
+      // CHECK: %[[NOT_COND:.*]] = arith.cmpi ne, %[[POSITIONS]], %[[SPLAT]] : tensor<8xindex>
+      // CHECK: %[[ONE_HOT:.*]] = arith.extui %[[COND]] : tensor<8xi1> to tensor<8xi16>
+      // CHECK: %[[COMPLEMENT:.*]] = arith.extui %[[NOT_COND]] : tensor<8xi1> to tensor<8xi16>
+      // CHECK: %[[VALUE:.*]] = tensor.splat %[[SCALAR:.*]] : tensor<8xi16>
+      // CHECK: %[[KEPT:.*]] = arith.muli %[[TENSOR:.*]], %[[COMPLEMENT]] : tensor<8xi16>
+      // CHECK: %[[INSERTED:.*]] = arith.muli %[[VALUE]], %[[ONE_HOT]] : tensor<8xi16>
+      // CHECK: arith.addi %[[KEPT]], %[[INSERTED]] : tensor<8xi16>
+      // CHECK-NOT: affine.for
+      // CHECK-NOT: scf.if
+      %inserted = tensor.insert %arg2 into %arg3[%arg4] : tensor<8xi16>
+      secret.yield %inserted : tensor<8xi16>
+    } -> !secret.secret<tensor<8xi16>>
+    return %0 : !secret.secret<tensor<8xi16>>
+}
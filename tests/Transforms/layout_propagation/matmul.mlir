@@ -0,0 +1,37 @@
+// RUN: heir-opt --layout-propagation=ciphertext-size=16 %s | FileCheck %s
+
+!lhs = tensor<2x4xi16>
+!rhs = tensor<4x4xi16>
+!slhs = !secret.secret<!lhs>
+!srhs = !secret.secret<!rhs>
+
+// The operands of a matmul are converted to row-major layouts of square
+// matrices, and the 2x4 operands are padded to 4x4.
+
+// CHECK-DAG: [[alignment_lhs:[^ ]*]] = #tensor_ext.alignment<in = [2, 4], out = [2, 4]>
+// CHECK-DAG: [[alignment_square:[^ ]*]] = #tensor_ext.alignment<in = [4, 4], out = [4, 4]>
+// CHECK-DAG: [[alignment_padded:[^ ]*]] = #tensor_ext.alignment<in = [2, 4], out = [4, 4], padding = [2, 0]
+// CHECK-DAG: [[lhs_layout:[^ ]*]] = #tensor_ext.layout<map = (d0, d1) -> (d0 * 4 + d1), alignment = [[alignment_lhs]]>
+// CHECK-DAG: [[square_layout:[^ ]*]] = #tensor_ext.layout<map = (d0, d1) -> (d0 * 4 + d1), alignment = [[alignment_square]]>
+// CHECK-DAG: [[padded_layout:[^ ]*]] = #tensor_ext.layout<map = (d0, d1) -> (d0 * 4 + d1), alignment = [[alignment_padded]]>
+
+// CHECK: @matmul
+func.func @matmul(%arg0: !slhs, %arg1: !srhs) -> !slhs {
+  %out = arith.constant dense<0> : !lhs
+  %0 = secret.generic ins(%arg0, %arg1: !slhs, !srhs) {
+  ^body(%pt_arg0: !lhs, %pt_arg1: !rhs):
+    // CHECK: [[lhs:%[^ ]+]] = tensor_ext.convert_layout
+    // CHECK-SAME: from_layout = [[lhs_layout]]
+    // CHECK-SAME: to_layout = [[padded_layout]]
+    // CHECK: [[init:%[^ ]+]] = tensor_ext.convert_layout
+    // CHECK-SAME: to_layout = [[padded_layout]]
+    // CHECK-NOT: tensor_ext.convert_layout
+    // CHECK: linalg.matmul
+    // CHECK-SAME: tensor_ext.layout = [[padded_layout]]
+    // CHECK-SAME: ins([[lhs]], %{{[^ ]+}}
+    // CHECK-SAME: outs([[init]]
+    %1 = linalg.matmul ins(%pt_arg0, %pt_arg1 : !lhs, !rhs) outs(%out : !lhs) -> !lhs
+    secret.yield %1 : !lhs
+  } -> !slhs
+  return %0 : !slhs
+}
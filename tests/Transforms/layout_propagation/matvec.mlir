@@ -0,0 +1,80 @@
+// RUN: heir-opt --layout-propagation=ciphertext-size=16 %s | FileCheck %s
+// RUN: heir-opt --layout-propagation=ciphertext-size=16 \
+// RUN:   --convert-to-ciphertext-semantics=ciphertext-size=16 %s \
+// RUN:   | FileCheck %s --check-prefix=KERNEL
+
+// The plaintext matrix of a matvec is packed in the layout of the kernel
+// chosen for its shape, and the vector and output keep their default layouts.
+
+// A 16x32 matrix is wider than a ciphertext, and is split into two blocks
+// that are each laid out in the squat diagonal layout.
+// CHECK-DAG: [[tiled:#[^ ]*]] = #tensor_ext.layout<map = (d0, d1) -> ({{.*}}floordiv 16{{.*}})>
+
+// A 6x3 matrix is zero-padded to 8x4 and laid out in extended diagonals.
+// CHECK-DAG: [[matrix_alignment:#[^ ]*]] = #tensor_ext.alignment<in = [6, 3], out = [8, 4], padding = [2, 1]
+// CHECK-DAG: [[diagonals:#[^ ]*]] = #tensor_ext.layout<map = (d0, d1) -> ((d1 - d0) mod 4, d0), alignment = [[matrix_alignment]]>
+
+// A 4x4 matrix is a quarter of a ciphertext wide, so its diagonals are
+// replicated, and the vector is converted to two rotated replicas.
+// CHECK-DAG: [[replicas_alignment:#[^ ]*]] = #tensor_ext.alignment<in = [4], out = [2, 8], insertedDims = [0]>
+// CHECK-DAG: [[replicas:#[^ ]*]] = #tensor_ext.layout<map = (d0, d1) -> ({{.*}}), alignment = [[replicas_alignment]]>
+// CHECK-DAG: [[replicated_diagonals:#[^ ]*]] = #tensor_ext.layout<map = (d0, d1) -> ({{.*}} mod 2, {{.*}})>
+
+// CHECK: @tiled_matvec
+// KERNEL: @tiled_matvec
+func.func @tiled_matvec(%arg0: !secret.secret<tensor<32xi16>>) -> !secret.secret<tensor<16xi16>> {
+  %cst = arith.constant dense<1> : tensor<16x32xi16>
+  %out = arith.constant dense<0> : tensor<16xi16>
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<32xi16>>) {
+  ^body(%input0: tensor<32xi16>):
+    // CHECK: [[matrix:%[^ ]+]] = tensor_ext.assign_layout %{{[^ ]+}} {layout = [[tiled]]
+    // CHECK-NOT: tensor_ext.convert_layout
+    // CHECK: linalg.matvec
+    // CHECK-SAME: ins([[matrix]], %{{[^ ]+}}
+    // KERNEL: tensor_ext.rotate
+    // KERNEL-NOT: linalg.matvec
+    %1 = linalg.matvec ins(%cst, %input0 : tensor<16x32xi16>, tensor<32xi16>) outs(%out : tensor<16xi16>) -> tensor<16xi16>
+    secret.yield %1 : tensor<16xi16>
+  } -> !secret.secret<tensor<16xi16>>
+  return %0 : !secret.secret<tensor<16xi16>>
+}
+
+// CHECK: @tall_matvec
+// KERNEL: @tall_matvec
+func.func @tall_matvec(%arg0: !secret.secret<tensor<3xi16>>) -> !secret.secret<tensor<6xi16>> {
+  %cst = arith.constant dense<1> : tensor<6x3xi16>
+  %out = arith.constant dense<0> : tensor<6xi16>
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<3xi16>>) {
+  ^body(%input0: tensor<3xi16>):
+    // CHECK: [[matrix:%[^ ]+]] = tensor_ext.assign_layout %{{[^ ]+}} {layout = [[diagonals]]
+    // CHECK-NOT: tensor_ext.convert_layout
+    // CHECK: linalg.matvec
+    // CHECK-SAME: ins([[matrix]], %{{[^ ]+}}
+    // KERNEL: tensor_ext.rotate
+    // KERNEL-NOT: linalg.matvec
+    %1 = linalg.matvec ins(%cst, %input0 : tensor<6x3xi16>, tensor<3xi16>) outs(%out : tensor<6xi16>) -> tensor<6xi16>
+    secret.yield %1 : tensor<6xi16>
+  } -> !secret.secret<tensor<6xi16>>
+  return %0 : !secret.secret<tensor<6xi16>>
+}
+
+// CHECK: @square_matvec
+// KERNEL: @square_matvec
+func.func @square_matvec(%arg0: !secret.secret<tensor<4xi16>>) -> !secret.secret<tensor<4xi16>> {
+  %cst = arith.constant dense<1> : tensor<4x4xi16>
+  %out = arith.constant dense<0> : tensor<4xi16>
+  %0 = secret.generic ins(%arg0 : !secret.secret<tensor<4xi16>>) {
+  ^body(%input0: tensor<4xi16>):
+    // CHECK: [[matrix:%[^ ]+]] = tensor_ext.assign_layout %{{[^ ]+}} {layout = [[replicated_diagonals]]
+    // CHECK: [[vector:%[^ ]+]] = tensor_ext.convert_layout
+    // CHECK-SAME: to_layout = [[replicas]]
+    // CHECK: linalg.matvec
+    // CHECK-SAME: ins([[matrix]], [[vector]]
+    // KERNEL: tensor_ext.permute
+    // KERNEL: tensor_ext.rotate
+    // KERNEL-NOT: linalg.matvec
+    %1 = linalg.matvec ins(%cst, %input0 : tensor<4x4xi16>, tensor<4xi16>) outs(%out : tensor<4xi16>) -> tensor<4xi16>
+    secret.yield %1 : tensor<4xi16>
+  } -> !secret.secret<tensor<4xi16>>
+  return %0 : !secret.secret<tensor<4xi16>>
+}
@@ -0,0 +1,19 @@
+// RUN: heir-opt --layout-propagation=ciphertext-size=1024 %s | FileCheck %s
+
+!stensor = !secret.secret<tensor<2048xi16>>
+
+// A tensor that does not fit in one ciphertext is split row-major across
+// consecutive ciphertexts.
+// CHECK-DAG: [[alignment:#[^ ]*]] = #tensor_ext.alignment<in = [2048], out = [2048]>
+// CHECK-DAG: [[layout:#[^ ]*]] = #tensor_ext.layout<map = (d0) -> (d0 floordiv 1024, d0 mod 1024), alignment = [[alignment]]>
+
+// CHECK: func @elementwise_sum
+// CHECK-SAME: {tensor_ext.layout = [[layout]]}
+func.func @elementwise_sum(%arg0: !stensor, %arg1: !stensor) -> !stensor {
+  %0 = secret.generic ins(%arg0, %arg1: !stensor, !stensor) {
+  ^body(%pt_arg0: tensor<2048xi16>, %pt_arg1: tensor<2048xi16>):
+    %3 = arith.addi %pt_arg0, %pt_arg1: tensor<2048xi16>
+    secret.yield %3 : tensor<2048xi16>
+  } -> !stensor
+  return %0 : !stensor
+}
@@ -0,0 +1,20 @@
+// RUN: heir-opt --annotate-module="backend=openfhe scheme=bfv" --mlir-to-bfv='ciphertext-degree=8 experimental-disable-loop-unroll=true' --scheme-to-openfhe %s | heir-translate --emit-openfhe-pke | FileCheck %s
+
+// The loop squaring the carried value survives to the emitted code, and the
+// multiplicative depth accounts for all of its iterations.
+
+// CHECK: CiphertextT power(
+// CHECK: for (
+// CHECK: EvalMult
+// CHECK-NOT: EvalMult
+// CHECK: return
+
+// CHECK: power__generate_crypto_context
+// CHECK: SetMultiplicativeDepth(3)
+func.func @power(%arg0: i16 {secret.secret}) -> i16 {
+  %0 = affine.for %i = 0 to 3 iter_args(%acc = %arg0) -> (i16) {
+    %1 = arith.muli %acc, %acc : i16
+    affine.yield %1 : i16
+  }
+  return %0 : i16
+}
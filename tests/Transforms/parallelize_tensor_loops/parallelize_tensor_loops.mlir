@@ -0,0 +1,102 @@
+// RUN: heir-opt --split-input-file --parallelize-tensor-loops="loop-tile-size=2 linalg-tile-size=4" %s | FileCheck %s
+
+// CHECK-DAG: #[[TILE_MAP:.*]] = affine_map<(d0) -> (d0 * 2)>
+// CHECK-DAG: #[[INDEX_MAP:.*]] = affine_map<(d0, d1) -> (d0 + d1 * 2)>
+// CHECK: @test_batch_loop
+// CHECK-SAME: (%[[X:.*]]: tensor<4x8xi32>)
+// CHECK: %[[INIT:.*]] = tensor.empty
+// CHECK: %[[RES:.*]] = scf.forall (%[[T:.*]]) in (2) shared_outs(%[[OUT:.*]] = %[[INIT]]) -> (tensor<4x8xi32>)
+// CHECK:   %[[OFFSET:.*]] = affine.apply #[[TILE_MAP]](%[[T]])
+// CHECK:   %[[TILE:.*]] = tensor.extract_slice %[[OUT]][%[[OFFSET]], 0] [2, 8] [1, 1]
+// CHECK:   %[[TILE_RES:.*]] = affine.for %[[J:.*]] = 0 to 2 iter_args(%[[ACC:.*]] = %[[TILE]]) -> (tensor<2x8xi32>)
+// CHECK:     %[[I:.*]] = affine.apply #[[INDEX_MAP]](%[[J]], %[[T]])
+// CHECK:     %[[A:.*]] = tensor.extract_slice %[[X]][%[[I]], 0] [1, 8] [1, 1]
+// CHECK:     %[[B:.*]] = arith.addi %[[A]], %[[A]]
+// CHECK:     %[[C:.*]] = tensor.insert_slice %[[B]] into %[[ACC]][%[[J]], 0] [1, 8] [1, 1]
+// CHECK:     affine.yield %[[C]]
+// CHECK:   scf.forall.in_parallel
+// CHECK:     tensor.parallel_insert_slice %[[TILE_RES]] into %[[OUT]][%[[OFFSET]], 0] [2, 8] [1, 1]
+// CHECK: return %[[RES]]
+func.func @test_batch_loop(%x: tensor<4x8xi32>) -> tensor<4x8xi32> {
+  %init = tensor.empty() : tensor<4x8xi32>
+  %0 = affine.for %i = 0 to 4 iter_args(%t = %init) -> (tensor<4x8xi32>) {
+    %a = tensor.extract_slice %x[%i, 0] [1, 8] [1, 1] : tensor<4x8xi32> to tensor<8xi32>
+    %b = arith.addi %a, %a : tensor<8xi32>
+    %c = tensor.insert_slice %b into %t[%i, 0] [1, 8] [1, 1] : tensor<8xi32> into tensor<4x8xi32>
+    affine.yield %c : tensor<4x8xi32>
+  }
+  return %0 : tensor<4x8xi32>
+}
+
+// -----
+
+// CHECK: @test_scalar_loop
+// CHECK: scf.forall (%{{.*}}) in (3)
+// CHECK:   affine.for %[[J:.*]] = 0 to 2 iter_args(%[[ACC:.*]] = %{{.*}}) -> (tensor<2xi32>)
+// CHECK:     tensor.insert %{{.*}} into %[[ACC]][%[[J]]]
+func.func @test_scalar_loop(%x: tensor<6xi32>) -> tensor<6xi32> {
+  %init = tensor.empty() : tensor<6xi32>
+  %0 = affine.for %i = 0 to 6 iter_args(%t = %init) -> (tensor<6xi32>) {
+    %a = tensor.extract %x[%i] : tensor<6xi32>
+    %b = arith.muli %a, %a : i32
+    %c = tensor.insert %b into %t[%i] : tensor<6xi32>
+    affine.yield %c : tensor<6xi32>
+  }
+  return %0 : tensor<6xi32>
+}
+
+// -----
+
+// Each iteration reads the iter_arg, so the iterations are not independent.
+
+// CHECK: @test_dependent_loop
+// CHECK-NOT: scf.forall
+func.func @test_dependent_loop(%x: tensor<4xi32>) -> tensor<4xi32> {
+  %c0 = arith.constant 0 : index
+  %0 = affine.for %i = 0 to 4 iter_args(%t = %x) -> (tensor<4xi32>) {
+    %a = tensor.extract %t[%c0] : tensor<4xi32>
+    %b = arith.addi %a, %a : i32
+    %c = tensor.insert %b into %t[%i] : tensor<4xi32>
+    affine.yield %c : tensor<4xi32>
+  }
+  return %0 : tensor<4xi32>
+}
+
+// -----
+
+// CHECK: @test_pointwise_linalg
+// CHECK: scf.forall (%{{.*}}) in (4)
+// CHECK:   linalg.generic
+// CHECK-SAME: tensor<4xi32>
+func.func @test_pointwise_linalg(%x: tensor<16xi32>, %y: tensor<16xi32>) -> tensor<16xi32> {
+  %init = tensor.empty() : tensor<16xi32>
+  %0 = linalg.generic {
+      indexing_maps = [affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>, affine_map<(d0) -> (d0)>],
+      iterator_types = ["parallel"]}
+      ins(%x, %y : tensor<16xi32>, tensor<16xi32>) outs(%init : tensor<16xi32>) {
+  ^bb0(%a: i32, %b: i32, %out: i32):
+    %s = arith.addi %a, %b : i32
+    linalg.yield %s : i32
+  } -> tensor<16xi32>
+  return %0 : tensor<16xi32>
+}
+
+// -----
+
+// Several iterations write the same output element.
+
+// CHECK: @test_overlapping_linalg
+// CHECK-NOT: scf.forall
+func.func @test_overlapping_linalg(%x: tensor<8xi32>, %y: tensor<8xi32>) -> tensor<15xi32> {
+  %init = arith.constant dense<0> : tensor<15xi32>
+  %0 = linalg.generic {
+      indexing_maps = [affine_map<(d0, d1) -> (d0)>, affine_map<(d0, d1) -> (d1)>, affine_map<(d0, d1) -> (d0 + d1)>],
+      iterator_types = ["parallel", "parallel"]}
+      ins(%x, %y : tensor<8xi32>, tensor<8xi32>) outs(%init : tensor<15xi32>) {
+  ^bb0(%a: i32, %b: i32, %out: i32):
+    %p = arith.muli %a, %b : i32
+    %s = arith.addi %p, %out : i32
+    linalg.yield %s : i32
+  } -> tensor<15xi32>
+  return %0 : tensor<15xi32>
+}
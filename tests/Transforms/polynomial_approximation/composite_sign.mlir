@@ -0,0 +1,58 @@
+// RUN: heir-opt --split-input-file --polynomial-approximation="use-composite-sign=true sign-gap=0.01 sign-error=1e-3" %s | FileCheck %s
+
+// CHECK: @test_max
+// CHECK-SAME: (%[[x:.*]]: f32)
+func.func @test_max(%x: f32) -> f32 {
+  // CHECK: %[[c:.*]] = arith.constant 5.0{{.*}}e-01
+  // CHECK: polynomial.eval {{.*}}, %[[x]]
+  // CHECK: %[[diff:.*]] = arith.subf %[[x]], %[[c]]
+  // CHECK: %[[scaled:.*]] = arith.mulf %[[diff]], %{{.*}}
+  // CHECK: %[[result:.*]] = arith.addf %[[c]], %[[scaled]]
+  // CHECK: return %[[result]]
+  %c = arith.constant 0.5 : f32
+  %0 = arith.maximumf %x, %c : f32
+  return %0 : f32
+}
+
+// -----
+
+// CHECK: @test_abs
+// CHECK-SAME: (%[[x:.*]]: tensor<8xf32>)
+func.func @test_abs(%x: tensor<8xf32>) -> tensor<8xf32> {
+  // CHECK: polynomial.eval {{.*}}, %[[x]]
+  // CHECK-SAME: domain_lower = -2.0{{.*}}domain_upper = 2.0
+  // CHECK: polynomial.eval
+  // CHECK-SAME: domain_lower = -1.0{{.*}}domain_upper = 1.0
+  // CHECK: %[[result:.*]] = arith.mulf %[[x]], %{{.*}}
+  // CHECK: return %[[result]]
+  %0 = math.absf %x {domain_lower = -2.0 : f64, domain_upper = 2.0 : f64} : tensor<8xf32>
+  return %0 : tensor<8xf32>
+}
+
+// -----
+
+// CHECK: @test_comparison
+// CHECK-SAME: (%[[x:.*]]: f32)
+func.func @test_comparison(%x: f32) -> f32 {
+  // CHECK-NOT: arith.cmpf
+  // CHECK-NOT: arith.uitofp
+  // CHECK: polynomial.eval {{.*}}, %[[x]]
+  // CHECK: %[[result:.*]] = polynomial.eval
+  // CHECK: return %[[result]]
+  %c = arith.constant 0.5 : f32
+  %0 = arith.cmpf olt, %x, %c : f32
+  %1 = arith.uitofp %0 : i1 to f32
+  return %1 : f32
+}
+
+// -----
+
+// Without a constant operand the comparison is left alone.
+// CHECK: @test_comparison_non_constant
+func.func @test_comparison_non_constant(%x: f32, %y: f32) -> f32 {
+  // CHECK: arith.cmpf
+  // CHECK: arith.uitofp
+  %0 = arith.cmpf olt, %x, %y : f32
+  %1 = arith.uitofp %0 : i1 to f32
+  return %1 : f32
+}
@@ -0,0 +1,128 @@
+// RUN: heir-opt --split-input-file --polynomial-approximation="use-range-analysis=true max-error=1e-2" %s | FileCheck %s
+
+// CHECK: @test_annotated_domain
+func.func @test_annotated_domain(%x: f32 {range.bounds = [0.0, 4.0]}) -> f32 {
+  // CHECK: polynomial.eval
+  // CHECK-SAME: domain_lower = 0.0{{.*}}domain_upper = 4.0
+  %0 = math.exp %x : f32
+  return %0 : f32
+}
+
+// -----
+
+// CHECK: @test_propagated_domain
+func.func @test_propagated_domain(%x: f32 {range.bounds = [-1.0, 2.0]}) -> f32 {
+  %c = arith.constant 0.5 : f32
+  %c1 = arith.constant 1.0 : f32
+  // The input to tanh lies in [-1.0, 2.0] * 0.5 + 1.0 = [0.5, 2.0]
+  %0 = arith.mulf %x, %c : f32
+  %1 = arith.addf %0, %c1 : f32
+  // CHECK: polynomial.eval
+  // CHECK-SAME: domain_lower = 5.0{{.*}}e-01{{.*}}domain_upper = 2.0
+  %2 = math.tanh %1 : f32
+  return %2 : f32
+}
+
+// -----
+
+// CHECK: @test_generic_execution_result
+func.func @test_generic_execution_result(%arg0: !secret.secret<f32>) -> !secret.secret<f32> {
+  %0 = secret.generic ins(%arg0 : !secret.secret<f32>) attrs = {__argattrs = [{secret.execution_result = [-3.0, 1.5, 2.0]}]} {
+  ^body(%input0: f32):
+    // CHECK: polynomial.eval
+    // CHECK-SAME: domain_lower = -3.0{{.*}}domain_upper = 2.0
+    %1 = math.exp %input0 : f32
+    secret.yield %1 : f32
+  } -> !secret.secret<f32>
+  return %0 : !secret.secret<f32>
+}
+
+// -----
+
+// exp on [-1, 1] needs degree 3 to reach an error of 1e-2.
+// CHECK: @test_degree_selection
+func.func @test_degree_selection(%x: f32 {range.bounds = [-1.0, 1.0]}) -> f32 {
+  // CHECK: polynomial.eval
+  // CHECK-SAME: x**3
+  // CHECK-NOT: x**4
+  %0 = math.exp %x : f32
+  return %0 : f32
+}
+
+// -----
+
+// CHECK: @test_explicit_attrs_take_precedence
+func.func @test_explicit_attrs_take_precedence(%x: f32 {range.bounds = [0.0, 4.0]}) -> f32 {
+  // CHECK: polynomial.eval
+  // CHECK-SAME: x**5
+  // CHECK-SAME: domain_lower = -2.0{{.*}}domain_upper = 2.0
+  // CHECK-NOT: x**6
+  %0 = math.exp %x {degree = 5 : i32, domain_lower = -2.0 : f64, domain_upper = 2.0 : f64} : f32
+  return %0 : f32
+}
+
+// -----
+
+// The range leaves the domain of asin, so the default domain is used.
+// CHECK: @test_invalid_range
+func.func @test_invalid_range(%x: f32 {range.bounds = [-2.0, 2.0]}) -> f32 {
+  // CHECK: polynomial.eval
+  // CHECK-SAME: domain_lower = -1.0{{.*}}domain_upper = 1.0
+  %0 = math.asin %x {degree = 3 : i32} : f32
+  return %0 : f32
+}
+
+// -----
+
+// Once tanh is approximated, exp is still approximated over the range of
+// tanh on [0, 4], which is [0, tanh(4)].
+// CHECK: @test_nested_approximation
+func.func @test_nested_approximation(%x: f32 {range.bounds = [0.0, 4.0]}) -> f32 {
+  // CHECK: polynomial.eval
+  // CHECK-SAME: domain_lower = 0.0{{.*}}domain_upper = 4.0
+  // CHECK: polynomial.eval
+  // CHECK-SAME: domain_lower = 0.0{{.*}}domain_upper = 9.99{{[0-9]*}}e-01
+  %0 = math.tanh %x : f32
+  %1 = math.exp %0 : f32
+  return %1 : f32
+}
+
+// -----
+
+// A range carried around a loop that shrinks reaches a fixed point without
+// widening.
+// CHECK: @test_loop_fixed_point
+func.func @test_loop_fixed_point(%x: f32 {range.bounds = [0.0, 1.0]}) -> f32 {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c10 = arith.constant 10 : index
+  %half = arith.constant 0.5 : f32
+  %0 = scf.for %i = %c0 to %c10 step %c1 iter_args(%acc = %x) -> (f32) {
+    %1 = arith.mulf %acc, %half : f32
+    scf.yield %1 : f32
+  }
+  // CHECK: polynomial.eval
+  // CHECK-SAME: domain_lower = 0.0{{.*}}domain_upper = 1.0
+  %2 = math.exp %0 : f32
+  return %2 : f32
+}
+
+// -----
+
+// A range that grows in every iteration is widened to an unbounded range, so
+// the analysis terminates and the default domain is used.
+// CHECK: @test_loop_widening
+func.func @test_loop_widening(%x: f32 {range.bounds = [0.0, 1.0]}) -> f32 {
+  %c0 = arith.constant 0 : index
+  %c1 = arith.constant 1 : index
+  %c10 = arith.constant 10 : index
+  %one = arith.constant 1.0 : f32
+  %0 = scf.for %i = %c0 to %c10 step %c1 iter_args(%acc = %x) -> (f32) {
+    %1 = arith.addf %acc, %one : f32
+    scf.yield %1 : f32
+  }
+  // CHECK: polynomial.eval
+  // CHECK-SAME: domain_lower = -1.0{{.*}}domain_upper = 1.0
+  %2 = math.exp %0 : f32
+  return %2 : f32
+}
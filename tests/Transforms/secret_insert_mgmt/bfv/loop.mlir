@@ -0,0 +1,66 @@
+// RUN: heir-opt %s --split-input-file --secret-insert-mgmt-bfv | FileCheck %s
+
+// Squaring the carried value deepens it in every iteration. The loop is kept,
+// and the multiplicative depth is bounded by the trip count.
+
+// CHECK: func @power
+// CHECK-SAME: mgmt.mgmt = #mgmt.mgmt<level = 3>
+func.func @power(%arg0: !secret.secret<i16>) -> !secret.secret<i16> {
+  %0 = secret.generic ins(%arg0 : !secret.secret<i16>) {
+  ^body(%input0: i16):
+    // CHECK: affine.for
+    // CHECK: arith.muli
+    // CHECK-NEXT: mgmt.relinearize
+    // CHECK-NEXT: affine.yield
+    // CHECK-NOT: arith.muli
+    %1 = affine.for %i = 0 to 3 iter_args(%acc = %input0) -> (i16) {
+      %2 = arith.muli %acc, %acc : i16
+      affine.yield %2 : i16
+    }
+    secret.yield %1 : i16
+  } -> !secret.secret<i16>
+  return %0 : !secret.secret<i16>
+}
+
+// -----
+
+// The depth of a nested loop is bounded by the product of the trip counts.
+
+// CHECK: func @nested_power
+// CHECK-SAME: mgmt.mgmt = #mgmt.mgmt<level = 6>
+func.func @nested_power(%arg0: !secret.secret<i16>) -> !secret.secret<i16> {
+  %0 = secret.generic ins(%arg0 : !secret.secret<i16>) {
+  ^body(%input0: i16):
+    // CHECK-COUNT-2: affine.for
+    %1 = affine.for %i = 0 to 2 iter_args(%acc = %input0) -> (i16) {
+      %2 = affine.for %j = 0 to 3 iter_args(%inner = %acc) -> (i16) {
+        %3 = arith.muli %inner, %inner : i16
+        affine.yield %3 : i16
+      }
+      affine.yield %2 : i16
+    }
+    secret.yield %1 : i16
+  } -> !secret.secret<i16>
+  return %0 : !secret.secret<i16>
+}
+
+// -----
+
+// Accumulating products does not deepen the carried value, so the depth stays
+// at one.
+
+// CHECK: func @dot
+// CHECK-SAME: mgmt.mgmt = #mgmt.mgmt<level = 1>
+func.func @dot(%arg0: !secret.secret<i16>, %arg1: !secret.secret<i16>) -> !secret.secret<i16> {
+  %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<i16>, !secret.secret<i16>) {
+  ^body(%input0: i16, %input1: i16):
+    // CHECK: affine.for
+    %1 = affine.for %i = 0 to 8 iter_args(%acc = %input0) -> (i16) {
+      %2 = arith.muli %input0, %input1 : i16
+      %3 = arith.addi %acc, %2 : i16
+      affine.yield %3 : i16
+    }
+    secret.yield %1 : i16
+  } -> !secret.secret<i16>
+  return %0 : !secret.secret<i16>
+}
@@ -0,0 +1,49 @@
+// RUN: heir-opt %s --split-input-file --secret-insert-mgmt-bgv | FileCheck %s
+
+// Accumulating products keeps the level of the carried value fixed, so the
+// loop is kept and its result is annotated like any other op.
+
+// CHECK: func @dot
+func.func @dot(%arg0: !secret.secret<i16>, %arg1: !secret.secret<i16>) -> !secret.secret<i16> {
+  %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<i16>, !secret.secret<i16>) {
+  ^body(%input0: i16, %input1: i16):
+    // CHECK: %[[INIT:.*]] = mgmt.adjust_scale
+    // CHECK: %[[LOOP:.*]] = affine.for
+    // CHECK-SAME: iter_args(%[[ACC:.*]] = %[[INIT]])
+    // CHECK: arith.muli
+    // CHECK-NEXT: mgmt.relinearize
+    // CHECK-NEXT: arith.addi %[[ACC]]
+    // CHECK-NEXT: affine.yield
+    // CHECK-NEXT: } {__resattrs = [{mgmt.mgmt = #mgmt.mgmt<level = {{[0-9]+}}>}]
+    // CHECK-NEXT: %[[v5:.*]] = mgmt.modreduce %[[LOOP]]
+    // CHECK-NEXT: secret.yield %[[v5]]
+    %1 = affine.for %i = 0 to 8 iter_args(%acc = %input0) -> (i16) {
+      %2 = arith.muli %input0, %input1 : i16
+      %3 = arith.addi %acc, %2 : i16
+      affine.yield %3 : i16
+    }
+    secret.yield %1 : i16
+  } -> !secret.secret<i16>
+  return %0 : !secret.secret<i16>
+}
+
+// -----
+
+// Squaring the carried value consumes a level in every iteration. BGV cannot
+// bootstrap, so the loop is unrolled.
+
+// CHECK: func @power
+func.func @power(%arg0: !secret.secret<i16>) -> !secret.secret<i16> {
+  // CHECK-NOT: affine.for
+  // CHECK-COUNT-3: arith.muli
+  // CHECK-NOT: affine.for
+  %0 = secret.generic ins(%arg0 : !secret.secret<i16>) {
+  ^body(%input0: i16):
+    %1 = affine.for %i = 0 to 3 iter_args(%acc = %input0) -> (i16) {
+      %2 = arith.muli %acc, %acc : i16
+      affine.yield %2 : i16
+    }
+    secret.yield %1 : i16
+  } -> !secret.secret<i16>
+  return %0 : !secret.secret<i16>
+}
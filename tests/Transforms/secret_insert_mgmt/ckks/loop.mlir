@@ -0,0 +1,51 @@
+// RUN: heir-opt %s --split-input-file --secret-insert-mgmt-ckks | FileCheck %s
+
+// The carried value is squared in every iteration, so it is rescaled and
+// bootstrapped at the back edge instead of unrolling the loop.
+
+// CHECK: func @power
+func.func @power(%arg0: !secret.secret<f32>) -> !secret.secret<f32> {
+  %0 = secret.generic ins(%arg0 : !secret.secret<f32>) {
+  ^body(%input0: f32):
+    // CHECK: affine.for
+    // CHECK-SAME: iter_args(%[[ACC:.*]] = %{{.*}})
+    // CHECK: %[[v1:.*]] = arith.mulf %[[ACC]], %[[ACC]]
+    // CHECK-NEXT: %[[v2:.*]] = mgmt.relinearize %[[v1]]
+    // CHECK-NEXT: %[[v3:.*]] = mgmt.modreduce %[[v2]]
+    // CHECK-NEXT: %[[v4:.*]] = mgmt.bootstrap %[[v3]]
+    // CHECK-NEXT: affine.yield %[[v4]]
+    %1 = affine.for %i = 0 to 8 iter_args(%acc = %input0) -> (f32) {
+      %2 = arith.mulf %acc, %acc : f32
+      affine.yield %2 : f32
+    }
+    secret.yield %1 : f32
+  } -> !secret.secret<f32>
+  return %0 : !secret.secret<f32>
+}
+
+// -----
+
+// Accumulating products does not consume levels across iterations, so no
+// bootstrap is needed. The initial value is brought to the scale of the
+// yielded products.
+
+// CHECK: func @dot
+func.func @dot(%arg0: !secret.secret<f32>, %arg1: !secret.secret<f32>) -> !secret.secret<f32> {
+  %0 = secret.generic ins(%arg0, %arg1 : !secret.secret<f32>, !secret.secret<f32>) {
+  ^body(%input0: f32, %input1: f32):
+    // CHECK: %[[INIT:.*]] = mgmt.adjust_scale
+    // CHECK: %[[LOOP:.*]] = affine.for
+    // CHECK-SAME: iter_args(%[[ACC:.*]] = %[[INIT]])
+    // CHECK-NOT: mgmt.bootstrap
+    // CHECK: affine.yield
+    // CHECK: %[[v5:.*]] = mgmt.modreduce %[[LOOP]]
+    // CHECK-NEXT: secret.yield %[[v5]]
+    %1 = affine.for %i = 0 to 8 iter_args(%acc = %input0) -> (f32) {
+      %2 = arith.mulf %input0, %input1 : f32
+      %3 = arith.addf %acc, %2 : f32
+      affine.yield %3 : f32
+    }
+    secret.yield %1 : f32
+  } -> !secret.secret<f32>
+  return %0 : !secret.secret<f32>
+}
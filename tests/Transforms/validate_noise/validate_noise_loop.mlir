@@ -0,0 +1,23 @@
+// RUN: heir-opt --secret-insert-mgmt-bfv --generate-param-bfv --validate-noise="model=bfv-noise-by-bound-coeff-average-case annotate-noise-bound=true" %s | FileCheck %s
+
+// The loop is analysed in place, so the noise bounds of its body, which hold
+// in every iteration, are annotated on the kept loop.
+
+// CHECK: @power
+// CHECK: affine.for
+// CHECK: arith.muli
+// CHECK-SAME: noise.bound
+// CHECK: affine.yield
+// CHECK-NEXT: }
+// CHECK-SAME: noise.bound
+func.func @power(%arg0: !secret.secret<i16>) -> !secret.secret<i16> {
+  %0 = secret.generic ins(%arg0 : !secret.secret<i16>) {
+  ^body(%input0: i16):
+    %1 = affine.for %i = 0 to 3 iter_args(%acc = %input0) -> (i16) {
+      %2 = arith.muli %acc, %acc : i16
+      affine.yield %2 : i16
+    }
+    secret.yield %1 : i16
+  } -> !secret.secret<i16>
+  return %0 : !secret.secret<i16>
+}
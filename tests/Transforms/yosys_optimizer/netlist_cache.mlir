@@ -0,0 +1,53 @@
+// RUN: rm -rf %t
+// RUN: heir-opt --yosys-optimizer="num-workers=2 cache-dir=%t use-submodules=false" --canonicalize --cse %s | FileCheck %s
+// RUN: ls %t | FileCheck %s --check-prefix=CACHE
+// RUN: ls %t | FileCheck %s --check-prefix=NO-VERILOG
+// A second run reuses the cached netlists without re-synthesizing them.
+// RUN: heir-opt --yosys-optimizer="cache-dir=%t use-submodules=false" --canonicalize --cse %s | FileCheck %s
+
+// The two add_one generics are identical circuits and share one netlist, the
+// add_two generic gets its own.
+// CACHE-COUNT-2: .rtlil
+// CACHE-NOT: .rtlil
+
+// Only netlists are cached, the emitted Verilog and the temporary netlists
+// are removed after synthesis.
+// NO-VERILOG-NOT: .v{{$}}
+// NO-VERILOG-NOT: .tmp{{$}}
+
+module {
+  // CHECK: @add_one_twice
+  func.func @add_one_twice(%in: !secret.secret<i8>) -> (!secret.secret<i8>) {
+    %one = arith.constant 1 : i8
+    %two = arith.constant 2 : i8
+    // CHECK: secret.generic
+    // CHECK-COUNT-11: comb.truth_table
+    // CHECK: secret.yield
+    %1 = secret.generic
+        ins(%in, %one: !secret.secret<i8>, i8) {
+        ^bb0(%IN: i8, %ONE: i8) :
+            %2 = arith.addi %IN, %ONE : i8
+            secret.yield %2 : i8
+        } -> (!secret.secret<i8>)
+    // CHECK: secret.generic
+    // CHECK-COUNT-11: comb.truth_table
+    // CHECK: secret.yield
+    %3 = secret.generic
+        ins(%1, %one: !secret.secret<i8>, i8) {
+        ^bb0(%IN: i8, %ONE: i8) :
+            %4 = arith.addi %IN, %ONE : i8
+            secret.yield %4 : i8
+        } -> (!secret.secret<i8>)
+    // CHECK: secret.generic
+    // CHECK: comb.truth_table
+    // CHECK: secret.yield
+    %5 = secret.generic
+        ins(%3, %two: !secret.secret<i8>, i8) {
+        ^bb0(%IN: i8, %TWO: i8) :
+            %6 = arith.addi %IN, %TWO : i8
+            secret.yield %6 : i8
+        } -> (!secret.secret<i8>)
+    // CHECK: return
+    return %5 : !secret.secret<i8>
+  }
+}
@@ -0,0 +1,81 @@
+// RUN: heir-opt --yosys-optimizer="objective=Area" --canonicalize --cse %s | FileCheck %s --check-prefix=CHECK --check-prefix=LUT
+// RUN: heir-opt --yosys-optimizer="objective=Depth" --canonicalize --cse %s | FileCheck %s --check-prefix=CHECK --check-prefix=LUT
+// RUN: heir-opt --yosys-optimizer="mode=Boolean objective=Area" --canonicalize --cse %s | FileCheck %s --check-prefix=CHECK --check-prefix=BOOL
+// RUN: heir-opt --yosys-optimizer="mode=Boolean objective=Depth" --canonicalize --cse %s | FileCheck %s --check-prefix=CHECK --check-prefix=BOOL
+// RUN: heir-opt --yosys-optimizer="mode=Boolean print-stats=true" -o /dev/null %s 2>&1 | FileCheck %s --check-prefix=BALANCED-STATS
+// RUN: heir-opt --yosys-optimizer="mode=Boolean objective=Depth print-stats=true" -o /dev/null %s 2>&1 | FileCheck %s --check-prefix=DEPTH-STATS
+
+// The stats of @mul_add are printed first, then those of @parity.
+// BALANCED-STATS: Ending cell count: {{[0-9]+}}
+// BALANCED-STATS: Ending circuit depth: {{[0-9]+}}
+// DEPTH-STATS: Ending cell count: {{[0-9]+}}
+// DEPTH-STATS: Ending circuit depth: {{[0-9]+}}
+
+// The parity of 8 bits is a chain of 7 XOR gates by default, and a balanced
+// tree of XOR gates of depth 3 with the depth objective.
+// BALANCED-STATS: Ending circuit depth: 7
+// DEPTH-STATS: Ending circuit depth: 3
+
+module {
+  // CHECK: @mul_add
+  func.func @mul_add(%a: !secret.secret<i8>, %b: !secret.secret<i8>) -> (!secret.secret<i8>) {
+    // CHECK: secret.generic
+    %0 = secret.generic
+        ins(%a, %b: !secret.secret<i8>, !secret.secret<i8>) {
+        ^bb0(%A: i8, %B: i8) :
+            // CHECK-NOT: arith.muli
+            // CHECK-NOT: arith.addi
+            // LUT: comb.truth_table
+            // BOOL: comb
+            %1 = arith.muli %A, %B : i8
+            %2 = arith.addi %1, %A : i8
+            secret.yield %2 : i8
+        } -> (!secret.secret<i8>)
+    // CHECK: return
+    return %0 : !secret.secret<i8>
+  }
+
+  // CHECK: @parity
+  func.func @parity(%a: !secret.secret<i8>) -> (!secret.secret<i1>) {
+    %c1 = arith.constant 1 : i8
+    %c2 = arith.constant 2 : i8
+    %c3 = arith.constant 3 : i8
+    %c4 = arith.constant 4 : i8
+    %c5 = arith.constant 5 : i8
+    %c6 = arith.constant 6 : i8
+    %c7 = arith.constant 7 : i8
+    // CHECK: secret.generic
+    %0 = secret.generic
+        ins(%a: !secret.secret<i8>) {
+        ^bb0(%A: i8) :
+            // CHECK-NOT: arith.xori
+            // LUT: comb.truth_table
+            // BOOL: comb.xor
+            %b0 = arith.trunci %A : i8 to i1
+            %s1 = arith.shrui %A, %c1 : i8
+            %b1 = arith.trunci %s1 : i8 to i1
+            %s2 = arith.shrui %A, %c2 : i8
+            %b2 = arith.trunci %s2 : i8 to i1
+            %s3 = arith.shrui %A, %c3 : i8
+            %b3 = arith.trunci %s3 : i8 to i1
+            %s4 = arith.shrui %A, %c4 : i8
+            %b4 = arith.trunci %s4 : i8 to i1
+            %s5 = arith.shrui %A, %c5 : i8
+            %b5 = arith.trunci %s5 : i8 to i1
+            %s6 = arith.shrui %A, %c6 : i8
+            %b6 = arith.trunci %s6 : i8 to i1
+            %s7 = arith.shrui %A, %c7 : i8
+            %b7 = arith.trunci %s7 : i8 to i1
+            %x1 = arith.xori %b0, %b1 : i1
+            %x2 = arith.xori %x1, %b2 : i1
+            %x3 = arith.xori %x2, %b3 : i1
+            %x4 = arith.xori %x3, %b4 : i1
+            %x5 = arith.xori %x4, %b5 : i1
+            %x6 = arith.xori %x5, %b6 : i1
+            %x7 = arith.xori %x6, %b7 : i1
+            secret.yield %x7 : i1
+        } -> (!secret.secret<i1>)
+    // CHECK: return
+    return %0 : !secret.secret<i1>
+  }
+}
@@ -54,6 +54,10 @@ abc_relpath = "edu_berkeley_abc/abc"
 config.environment["HEIR_ABC_BINARY"] = str(
     runfiles_dir.joinpath(Path(abc_relpath))
 )
+yosys_relpath = "at_clifford_yosys/yosys"
+config.environment["HEIR_YOSYS_BINARY"] = str(
+    runfiles_dir.joinpath(Path(yosys_relpath))
+)
 yosys_libs = "_main/lib/Transforms/YosysOptimizer/yosys"
 config.environment["HEIR_YOSYS_SCRIPTS_DIR"] = str(
     runfiles_dir.joinpath(Path(yosys_libs))
@@ -4,13 +4,14 @@ load("@heir//tools:heir-opt.bzl", "heir_opt")
 load("@heir//tools:heir-translate.bzl", "heir_translate")
 load("@rules_python//python:py_library.bzl", "py_library")
 
-def fhe_jaxite_lib(name, mlir_src, heir_opt_pass_flags = [], py_lib_target_name = "", tags = [], deps = [], **kwargs):
+def fhe_jaxite_lib(name, mlir_src, heir_opt_pass_flags = [], heir_translate_flags = [], py_lib_target_name = "", tags = [], deps = [], **kwargs):
     """A rule for generating Jaxite code.
 
     Args:
       name: The name of the py_test target and the generated .cc file basename.
       mlir_src: The source mlir file to run through heir-translate.
       heir_opt_pass_flags: Flags for heir-opt.
+      heir_translate_flags: Additional flags for heir-translate.
       py_lib_target_name: target_name for the py_library.
       tags: Tags to pass to py_test.
       deps: Deps to pass to py_test and py_library.
@@ -39,7 +40,7 @@ def fhe_jaxite_lib(name, mlir_src, heir_opt_pass_flags = [], py_lib_target_name
     heir_translate(
         name = py_codegen_target,
         src = generated_heir_opt_name,
-        pass_flags = ["--emit-jaxite"],
+        pass_flags = ["--emit-jaxite"] + heir_translate_flags,
         generated_filename = generated_py_filename,
         tags = tags,
     )
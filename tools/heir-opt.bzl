@@ -27,8 +27,10 @@ def _heir_opt_impl(ctx):
         runtime_dir = ctx.executable._heir_opt_binary.path + ".runfiles"
         yosys_scripts_dir = runtime_dir + "/" + HEIR_BASE_PATH + "lib/Transforms/YosysOptimizer/yosys"
         abc_path = runtime_dir + "/edu_berkeley_abc/abc"
+        yosys_path = runtime_dir + "/at_clifford_yosys/yosys"
         env_vars["HEIR_YOSYS_SCRIPTS_DIR"] = yosys_scripts_dir
         env_vars["HEIR_ABC_BINARY"] = abc_path
+        env_vars["HEIR_YOSYS_BINARY"] = yosys_path
 
     ctx.actions.run(
         inputs = ctx.attr.src.files,
@@ -76,6 +76,7 @@
 #include "lib/Transforms/LowerPolynomialEval/LowerPolynomialEval.h"
 #include "lib/Transforms/OperationBalancer/OperationBalancer.h"
 #include "lib/Transforms/OptimizeRelinearization/OptimizeRelinearization.h"
+#include "lib/Transforms/ParallelizeTensorLoops/ParallelizeTensorLoops.h"
 #include "lib/Transforms/PolynomialApproximation/PolynomialApproximation.h"
 #include "lib/Transforms/PopulateScale/PopulateScale.h"
 #include "lib/Transforms/PropagateAnnotation/PropagateAnnotation.h"
@@ -117,6 +118,7 @@
 #include "mlir/include/mlir/Dialect/Linalg/IR/Linalg.h"    // from @llvm-project
 #include "mlir/include/mlir/Dialect/Linalg/Passes.h"       // from @llvm-project
 #include "mlir/include/mlir/Dialect/Linalg/Transforms/BufferizableOpInterfaceImpl.h"  // from @llvm-project
+#include "mlir/include/mlir/Dialect/Linalg/Transforms/TilingInterfaceImpl.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/Math/IR/Math.h"      // from @llvm-project
 #include "mlir/include/mlir/Dialect/MemRef/IR/MemRef.h"  // from @llvm-project
 #include "mlir/include/mlir/Dialect/MemRef/Transforms/Passes.h"  // from @llvm-project
@@ -239,6 +241,8 @@ int main(int argc, char **argv) {
   scf::registerBufferizableOpInterfaceExternalModels(registry);
   tensor::registerBufferizableOpInterfaceExternalModels(registry);
   mlir::arith::registerConvertArithToLLVMInterface(registry);
+  // Used to tile linalg ops in --parallelize-tensor-loops
+  mlir::linalg::registerTilingInterfaceExternalModels(registry);
 
   // Custom passes in HEIR
   cggi::registerCGGIPasses();
@@ -268,6 +272,7 @@ int main(int argc, char **argv) {
   registerForwardStoreToLoadPasses();
   registerGenerateParamPasses();
   registerOperationBalancerPasses();
+  registerParallelizeTensorLoopsPasses();
   registerPopulateScalePasses();
   registerStraightLineVectorizerPasses();
   registerUnusedMemRefPasses();
@@ -290,23 +295,32 @@ int main(int argc, char **argv) {
 #ifndef HEIR_YOSYS_SCRIPTS_DIR
   llvm::errs() << "HEIR_YOSYS_SCRIPTS_DIR #define not properly set";
   return EXIT_FAILURE;
+#endif
+#ifndef HEIR_YOSYS_BINARY
+  llvm::errs() << "HEIR_YOSYS_BINARY #define not properly set";
+  return EXIT_FAILURE;
 #endif
   const char *abcEnvPath = HEIR_ABC_BINARY;
   const char *yosysRunfilesEnvPath = HEIR_YOSYS_SCRIPTS_DIR;
+  const char *yosysEnvPath = HEIR_YOSYS_BINARY;
   // When running in a lit test, these #defines must be overridden
   // by environment variables set in tests/lit.cfg.py
   char *overriddenAbcEnvPath = std::getenv("HEIR_ABC_BINARY");
   char *overriddenYosysRunfilesEnvPath = std::getenv("HEIR_YOSYS_SCRIPTS_DIR");
+  char *overriddenYosysEnvPath = std::getenv("HEIR_YOSYS_BINARY");
   if (overriddenAbcEnvPath != nullptr) abcEnvPath = overriddenAbcEnvPath;
   if (overriddenYosysRunfilesEnvPath != nullptr)
     yosysRunfilesEnvPath = overriddenYosysRunfilesEnvPath;
-  mlir::heir::registerYosysOptimizerPipeline(yosysRunfilesEnvPath, abcEnvPath);
+  if (overriddenYosysEnvPath != nullptr) yosysEnvPath = overriddenYosysEnvPath;
+  mlir::heir::registerYosysOptimizerPipeline(yosysRunfilesEnvPath, abcEnvPath,
+                                             yosysEnvPath);
 
   PassPipelineRegistration<mlir::heir::MLIRToCGGIPipelineOptions>(
       "mlir-to-cggi",
       "Convert a func using standard MLIR dialects to FHE using "
       "CGGI.",
-      mlirToCGGIPipelineBuilder(yosysRunfilesEnvPath, abcEnvPath));
+      mlirToCGGIPipelineBuilder(yosysRunfilesEnvPath, abcEnvPath,
+                                yosysEnvPath));
 #else
   PassPipelineRegistration<mlir::heir::MLIRToCGGIPipelineOptions>(
       "mlir-to-cggi",
@@ -351,10 +365,14 @@ int main(int argc, char **argv) {
         ::mlir::heir::tosaPipelineBuilder(pm, options.unroll);
       });
 
-  PassPipelineRegistration<>(
+  PassPipelineRegistration<PolynomialToLLVMOptions>(
       "heir-polynomial-to-llvm",
       "Run passes to lower the polynomial dialect to LLVM",
-      ::mlir::heir::polynomialToLLVMPipelineBuilder);
+      [](OpPassManager &pm, const PolynomialToLLVMOptions &options) {
+        ::mlir::heir::polynomialToLLVMPipelineBuilder(
+            pm, options.parallelize, options.numThreads, options.loopTileSize,
+            options.linalgTileSize);
+      });
 
   PassPipelineRegistration<>("heir-basic-mlir-to-llvm",
                              "Lower basic MLIR to LLVM",